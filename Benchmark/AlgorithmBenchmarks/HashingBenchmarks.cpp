@@ -0,0 +1,105 @@
+#include "HashingBenchmarks.h"
+#include "Hashing.h"
+#include "Mem.h"
+#include <chrono>
+#include <stdlib.h>
+
+#define XXH_INLINE_ALL
+#define XXH_NO_XXH3
+#include "ThirdParty/xxHash-0.8.2/xxhash.h"
+
+using namespace Tk;
+using namespace Core;
+
+const size_t g_hashBufferSize = 64 * 1024 * 1024;
+const size_t g_hashTotalBytes = 1024 * 1024 * 1024;
+static uint8* g_hashBuffer = nullptr;
+static volatile uint64 g_hashSink = 0;
+
+void BM_hash_Startup()
+{
+  g_hashBuffer = (uint8*)CoreMallocAligned(g_hashBufferSize, CACHE_LINE);
+  for (size_t i = 0; i < g_hashBufferSize; ++i)
+  {
+    g_hashBuffer[i] = (uint8)rand();
+  }
+}
+
+void BM_hash_Shutdown()
+{
+  CoreFreeAligned(g_hashBuffer);
+  g_hashBuffer = nullptr;
+}
+
+#define BM_HASH_FUNC(name) uint64 name(const void* data, size_t numBytes)
+typedef BM_HASH_FUNC(BM_HashFunc);
+
+static BM_HASH_FUNC(BM_HashXXH3)
+{
+  return Hash64(data, numBytes).m_val;
+}
+
+static BM_HASH_FUNC(BM_HashXXH64)
+{
+  return (uint64)XXH64(data, numBytes, DEFAULT_STRING_HASH_SEED);
+}
+
+static double BM_HashGBps(uint32 keySize, BM_HashFunc* HashFunc)
+{
+  using Clock = std::chrono::steady_clock;
+  const size_t keysPerPass = g_hashBufferSize / keySize;
+  const size_t numPasses = g_hashTotalBytes / (keysPerPass * keySize);
+
+  uint64 sink = 0;
+  auto startTime = Clock::now();
+  for (size_t pass = 0; pass < numPasses; ++pass)
+  {
+    const uint8* key = g_hashBuffer;
+    for (size_t i = 0; i < keysPerPass; ++i)
+    {
+      sink ^= HashFunc(key, keySize);
+      key += keySize;
+    }
+  }
+  std::chrono::duration<double> seconds = Clock::now() - startTime;
+  g_hashSink = sink;
+
+  const double numGB =
+    (double)(numPasses * keysPerPass * keySize) / (1024.0 * 1024.0 * 1024.0);
+  return numGB / seconds.count();
+}
+
+double BM_HashXXH3_GBps(uint32 keySize)
+{
+  return BM_HashGBps(keySize, BM_HashXXH3);
+}
+
+double BM_HashXXH64_GBps(uint32 keySize)
+{
+  return BM_HashGBps(keySize, BM_HashXXH64);
+}
+
+double BM_HashStateXXH3_GBps(uint32 chunkSize)
+{
+  using Clock = std::chrono::steady_clock;
+  const size_t chunksPerPass = g_hashBufferSize / chunkSize;
+  const size_t numPasses = g_hashTotalBytes / (chunksPerPass * chunkSize);
+
+  auto startTime = Clock::now();
+  HashState state;
+  for (size_t pass = 0; pass < numPasses; ++pass)
+  {
+    const uint8* chunk = g_hashBuffer;
+    for (size_t i = 0; i < chunksPerPass; ++i)
+    {
+      state.Update(chunk, chunkSize);
+      chunk += chunkSize;
+    }
+  }
+  g_hashSink = state.Digest().m_val;
+  std::chrono::duration<double> seconds = Clock::now() - startTime;
+
+  const double numGB =
+    (double)(numPasses * chunksPerPass * chunkSize) / (1024.0 * 1024.0 * 1024.0);
+  return numGB / seconds.count();
+}
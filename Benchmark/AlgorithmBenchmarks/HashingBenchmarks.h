@@ -0,0 +1,9 @@
+#include "CoreDefines.h"
+
+// Hashing throughput benchmarks
+// Each one hashes 1 GB of data split into keys of the given size and returns GB/s
+void BM_hash_Startup();
+void BM_hash_Shutdown();
+double BM_HashXXH3_GBps(uint32 keySize);
+double BM_HashXXH64_GBps(uint32 keySize); // the old runtime string hash, for comparison
+double BM_HashStateXXH3_GBps(uint32 chunkSize); // streaming, one state over the whole GB
@@ -0,0 +1,228 @@
+#include "SortingBenchmarks.h"
+#include "Allocators.h"
+#include "Mem.h"
+#include "Platform/ParallelSort.h"
+#include "Platform/WorkerThreadPool.h"
+#include "Sorting.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+using namespace Tk;
+using namespace Platform;
+using namespace Core;
+
+// Enough sorts of small inputs that each size sorts about this many elements in total
+const uint32 g_sortMinElesPerSize = 10'000'000;
+
+struct BM_SortItem
+{
+  float m_key;
+  uint32 m_payload;
+};
+
+static uint32* g_sortKeys = nullptr;
+static RadixSortPair32* g_sortPairs = nullptr;
+static BM_SortItem* g_sortItems = nullptr;
+// Sorted in place, with room for keys, pairs or items
+static uint8* g_sortWork = nullptr;
+static uint8* g_sortScratch = nullptr;
+// ParallelSort() takes its scratch from here and hands it back after every sort
+static LinearAllocator g_sortArena;
+static volatile uint32 g_sortSink = 0;
+
+void BM_sort_Startup(uint32 numThreads)
+{
+  ThreadPool::Startup(numThreads - 1);
+
+  g_sortKeys = (uint32*)CoreMallocAligned(BM_SortMaxEles * sizeof(uint32), CACHE_LINE);
+  g_sortPairs = (RadixSortPair32*)CoreMallocAligned(
+    BM_SortMaxEles * sizeof(RadixSortPair32), CACHE_LINE);
+  g_sortWork =
+    (uint8*)CoreMallocAligned(BM_SortMaxEles * sizeof(RadixSortPair32), CACHE_LINE);
+  g_sortScratch =
+    (uint8*)CoreMallocAligned(BM_SortMaxEles * sizeof(RadixSortPair32), CACHE_LINE);
+  g_sortItems =
+    (BM_SortItem*)CoreMallocAligned(BM_SortMaxEles * sizeof(BM_SortItem), CACHE_LINE);
+  g_sortArena.Init(BM_SortMaxEles * sizeof(BM_SortItem) + CACHE_LINE, CACHE_LINE);
+
+  uint32 state = 0x9E37'79B9u;
+  for (uint32 i = 0; i < BM_SortMaxEles; ++i)
+  {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    g_sortKeys[i] = state;
+    g_sortPairs[i] = { state, i };
+    g_sortItems[i] = { (float)(int32)state * (1.0f / 65536.0f), i };
+  }
+}
+
+void BM_sort_Shutdown()
+{
+  ThreadPool::Shutdown();
+
+  CoreFreeAligned(g_sortKeys);
+  g_sortKeys = nullptr;
+  CoreFreeAligned(g_sortPairs);
+  g_sortPairs = nullptr;
+  CoreFreeAligned(g_sortWork);
+  g_sortWork = nullptr;
+  CoreFreeAligned(g_sortScratch);
+  g_sortScratch = nullptr;
+  CoreFreeAligned(g_sortItems);
+  g_sortItems = nullptr;
+  g_sortArena.ExplicitFree();
+}
+
+#define BM_SORT_FUNC(name) void name(void* data, uint32 numEles)
+typedef BM_SORT_FUNC(BM_SortFunc);
+
+static BM_SORT_FUNC(BM_MergeSortKeys)
+{
+  MergeSort((uint32*)data, numEles, CompareLessThan_uint32);
+}
+
+static BM_SORT_FUNC(BM_StdSortKeys)
+{
+  std::sort((uint32*)data, (uint32*)data + numEles);
+}
+
+static BM_SORT_FUNC(BM_RadixSortKeys)
+{
+  RadixSort((uint32*)data, numEles, (uint32*)g_sortScratch);
+}
+
+static BM_SORT_FUNC(BM_RadixSortParallelKeys)
+{
+  RadixSortParallel((uint32*)data, numEles, (uint32*)g_sortScratch);
+}
+
+static BM_SORT_FUNC(BM_StdSortPairs)
+{
+  // Stable, like the radix sort
+  std::stable_sort((RadixSortPair32*)data, (RadixSortPair32*)data + numEles,
+                   [](const RadixSortPair32& A, const RadixSortPair32& B)
+                   {
+                     return A.m_key < B.m_key;
+                   });
+}
+
+static BM_SORT_FUNC(BM_RadixSortPairs)
+{
+  RadixSort((RadixSortPair32*)data, numEles, (RadixSortPair32*)g_sortScratch);
+}
+
+static BM_SORT_FUNC(BM_RadixSortParallelPairs)
+{
+  RadixSortParallel((RadixSortPair32*)data, numEles, (RadixSortPair32*)g_sortScratch);
+}
+
+// A lambda rather than a function, so the template sorts inline the compares
+static auto BM_SortItemLess = [](const BM_SortItem& A, const BM_SortItem& B)
+{
+  return A.m_key < B.m_key;
+};
+
+static CMP_LT_FUNC(BM_CompareLessThan_SortItem)
+{
+  return ((const BM_SortItem*)A)->m_key < ((const BM_SortItem*)B)->m_key;
+}
+
+static BM_SORT_FUNC(BM_MergeSortItems)
+{
+  MergeSort((BM_SortItem*)data, numEles, BM_CompareLessThan_SortItem);
+}
+
+static BM_SORT_FUNC(BM_StdSortItems)
+{
+  std::sort((BM_SortItem*)data, (BM_SortItem*)data + numEles, BM_SortItemLess);
+}
+
+static BM_SORT_FUNC(BM_IntroSortItems)
+{
+  IntroSort((BM_SortItem*)data, numEles, BM_SortItemLess);
+}
+
+static BM_SORT_FUNC(BM_ParallelSortItems)
+{
+  ParallelSort((BM_SortItem*)data, numEles, BM_SortItemLess, g_sortArena);
+}
+
+// Only the sorts are timed, not copying the unsorted data back in before each one
+static double BM_SortMs(uint32 numEles, const void* src, uint32 eleSize,
+                        BM_SortFunc* SortFunc)
+{
+  TINKER_ASSERT(numEles > 0 && numEles <= BM_SortMaxEles);
+  const uint32 numSorts = Max(g_sortMinElesPerSize / numEles, 1u);
+
+  std::chrono::steady_clock::duration elapsed = {};
+  for (uint32 uiSort = 0; uiSort < numSorts; ++uiSort)
+  {
+    memcpy(g_sortWork, src, (size_t)numEles * eleSize);
+    const auto start = std::chrono::steady_clock::now();
+    SortFunc(g_sortWork, numEles);
+    elapsed += std::chrono::steady_clock::now() - start;
+    g_sortSink = g_sortSink + g_sortWork[0];
+  }
+
+  const double totalMs = std::chrono::duration<double, std::milli>(elapsed).count();
+  return totalMs / numSorts;
+}
+
+double BM_MergeSortMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortKeys, sizeof(uint32), BM_MergeSortKeys);
+}
+
+double BM_StdSortMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortKeys, sizeof(uint32), BM_StdSortKeys);
+}
+
+double BM_RadixSortMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortKeys, sizeof(uint32), BM_RadixSortKeys);
+}
+
+double BM_RadixSortParallelMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortKeys, sizeof(uint32), BM_RadixSortParallelKeys);
+}
+
+double BM_StdSortPairsMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortPairs, sizeof(RadixSortPair32), BM_StdSortPairs);
+}
+
+double BM_RadixSortPairsMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortPairs, sizeof(RadixSortPair32), BM_RadixSortPairs);
+}
+
+double BM_RadixSortParallelPairsMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortPairs, sizeof(RadixSortPair32),
+                   BM_RadixSortParallelPairs);
+}
+
+double BM_MergeSortItemsMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortItems, sizeof(BM_SortItem), BM_MergeSortItems);
+}
+
+double BM_StdSortItemsMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortItems, sizeof(BM_SortItem), BM_StdSortItems);
+}
+
+double BM_IntroSortItemsMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortItems, sizeof(BM_SortItem), BM_IntroSortItems);
+}
+
+double BM_ParallelSortItemsMs(uint32 numEles)
+{
+  return BM_SortMs(numEles, g_sortItems, sizeof(BM_SortItem), BM_ParallelSortItems);
+}
@@ -0,0 +1,21 @@
+#include "CoreDefines.h"
+
+// Sorting benchmarks
+// Random uint32 keys, key/index pairs with uint32 keys, or items with a float key and a
+// payload that only a comparison sort can handle, sorted from the same unsorted data
+// every time. Small inputs get sorted many times over. Each returns ms per sort of
+// numEles elements, up to BM_SortMaxEles.
+const uint32 BM_SortMaxEles = 10'000'000;
+void BM_sort_Startup(uint32 numThreads); // the calling thread counts as one
+void BM_sort_Shutdown();
+double BM_MergeSortMs(uint32 numEles);
+double BM_StdSortMs(uint32 numEles);
+double BM_RadixSortMs(uint32 numEles);
+double BM_RadixSortParallelMs(uint32 numEles);
+double BM_StdSortPairsMs(uint32 numEles);
+double BM_RadixSortPairsMs(uint32 numEles);
+double BM_RadixSortParallelPairsMs(uint32 numEles);
+double BM_MergeSortItemsMs(uint32 numEles);
+double BM_StdSortItemsMs(uint32 numEles);
+double BM_IntroSortItemsMs(uint32 numEles);
+double BM_ParallelSortItemsMs(uint32 numEles);
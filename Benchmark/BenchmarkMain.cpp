@@ -1,10 +1,28 @@
+#include "AlgorithmBenchmarks/HashingBenchmarks.h"
+#include "AlgorithmBenchmarks/SortingBenchmarks.h"
+#include "DataStructureBenchmarks/BindlessSlotBenchmarks.h"
+#include "DataStructureBenchmarks/ConcurrentHashMapBenchmarks.h"
+#include "DataStructureBenchmarks/HandlePoolBenchmarks.h"
 #include "DataStructureBenchmarks/HashMapBenchmarks.h"
+#include "DataStructureBenchmarks/MPMCQueueBenchmarks.h"
+#include "DataStructureBenchmarks/SoAVectorBenchmarks.h"
+#include "DataStructureBenchmarks/VectorBenchmarks.h"
+#include "JobSystemBenchmarks/JobAllocationBenchmarks.h"
+#include "JobSystemBenchmarks/JobPriorityBenchmarks.h"
+#include "JobSystemBenchmarks/JobSchedulerBenchmarks.h"
+#include "JobSystemBenchmarks/ParallelForBenchmarks.h"
 #include "MathBenchmarks/VectorTypeBenchmarks.h"
+#include "MemoryBenchmarks/PoolAllocatorBenchmarks.h"
+#include "MemoryBenchmarks/TLSFHeapBenchmarks.h"
 #include "TinkerBenchmark.h"
 #include "Utility/ScopedTimer.h"
 #include <chrono>
 #include <stdio.h>
-#include <timeapi.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+  #include <timeapi.h>
+#endif
 
 int main()
 {
@@ -13,8 +31,10 @@ int main()
   //uint64 processorAffinityMask = 1ULL;
   //SetThreadAffinityMask(GetCurrentThread(), processorAffinityMask);
 
+#ifdef _WIN32
   SetPriorityClass(GetCurrentProcess(), ABOVE_NORMAL_PRIORITY_CLASS);
   //timeBeginPeriod(1);
+#endif
   //TINKER_BENCHMARK_HEADER;
 
   // Vector benchmarks
@@ -74,6 +94,428 @@ int main()
     BM_hm_Shutdown();
   }
 
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_hmLookup_Startup();
+    {
+      TIMED_SCOPED_BLOCK("Hashmap u32 find hit benchmark");
+
+      BM_HMFindHit1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Std unordered map u32 find hit benchmark");
+
+      BM_StdHMFindHit1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Hashmap u32 find miss benchmark");
+
+      BM_HMFindMiss1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Std unordered map u32 find miss benchmark");
+
+      BM_StdHMFindMiss1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Hashmap u32 erase heavy benchmark");
+
+      BM_HMEraseHeavy1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Std unordered map u32 erase heavy benchmark");
+
+      BM_StdHMEraseHeavy1M_U32();
+    }
+    BM_hmLookup_Shutdown();
+  }
+
+  // Concurrent hashmap benchmarks, same total work split across 1 to N threads
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_chm_Startup();
+    {
+      TIMED_SCOPED_BLOCK("Concurrent hashmap u32 read mostly, 1 thread");
+
+      BM_CHMReadMostly_U32(1);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Concurrent hashmap u32 write heavy, 1 thread");
+
+      BM_CHMWriteHeavy_U32(1);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Locked hashmap u32 read mostly, 1 thread");
+
+      BM_LockedHMReadMostly_U32(1);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Concurrent hashmap u32 read mostly, 2 threads");
+
+      BM_CHMReadMostly_U32(2);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Concurrent hashmap u32 write heavy, 2 threads");
+
+      BM_CHMWriteHeavy_U32(2);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Locked hashmap u32 read mostly, 2 threads");
+
+      BM_LockedHMReadMostly_U32(2);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Concurrent hashmap u32 read mostly, 4 threads");
+
+      BM_CHMReadMostly_U32(4);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Concurrent hashmap u32 write heavy, 4 threads");
+
+      BM_CHMWriteHeavy_U32(4);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Locked hashmap u32 read mostly, 4 threads");
+
+      BM_LockedHMReadMostly_U32(4);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Concurrent hashmap u32 read mostly, 8 threads");
+
+      BM_CHMReadMostly_U32(8);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Concurrent hashmap u32 write heavy, 8 threads");
+
+      BM_CHMWriteHeavy_U32(8);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Locked hashmap u32 read mostly, 8 threads");
+
+      BM_LockedHMReadMostly_U32(8);
+    }
+    BM_chm_Shutdown();
+  }
+
+  // MPMC queue throughput and latency, lock free vs a locked deque, 1 to N threads on
+  // each end
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_mpmc_Startup();
+    const uint32 threadCounts[][2] = { { 1, 1 }, { 2, 2 }, { 4, 4 }, { 1, 7 }, { 7, 1 } };
+    for (uint32 uiCount = 0; uiCount < ARRAYCOUNT(threadCounts); ++uiCount)
+    {
+      const uint32 numProducers = threadCounts[uiCount][0];
+      const uint32 numConsumers = threadCounts[uiCount][1];
+      double p99LatencyUs = 0.0;
+      double mops = BM_MPMCQueueMops(numProducers, numConsumers, &p99LatencyUs);
+      printf("MPMC queue, %u producers, %u consumers: %.1f M items/s, p99 %.2f us\n",
+             numProducers, numConsumers, mops, p99LatencyUs);
+      mops = BM_MPMCQueueBatchMops(numProducers, numConsumers, &p99LatencyUs);
+      printf(
+        "MPMC queue batched, %u producers, %u consumers: %.1f M items/s, p99 %.2f us\n",
+        numProducers, numConsumers, mops, p99LatencyUs);
+      mops = BM_LockedDequeMops(numProducers, numConsumers, &p99LatencyUs);
+      printf("Locked deque, %u producers, %u consumers: %.1f M items/s, p99 %.2f us\n",
+             numProducers, numConsumers, mops, p99LatencyUs);
+    }
+    BM_mpmc_Shutdown();
+  }
+
+  // Hashing throughput benchmarks
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_hash_Startup();
+    const uint32 keySizes[] = { 16, 64, 256, 4096, 1024 * 1024 };
+    for (uint32 uiSize = 0; uiSize < ARRAYCOUNT(keySizes); ++uiSize)
+    {
+      const uint32 keySize = keySizes[uiSize];
+      printf("XXH3 runtime hash, %u byte keys: %.2f GB/s\n", keySize,
+             BM_HashXXH3_GBps(keySize));
+      printf("XXH64 hash, %u byte keys: %.2f GB/s\n", keySize,
+             BM_HashXXH64_GBps(keySize));
+    }
+    printf("XXH3 streaming hash, 64 KB chunks: %.2f GB/s\n",
+           BM_HashStateXXH3_GBps(64 * 1024));
+    BM_hash_Shutdown();
+  }
+
+  // Sorting, radix vs comparison sorts from 1K to 10M elements
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    const uint32 numThreads = 8;
+    BM_sort_Startup(numThreads);
+    for (uint32 numEles = 1000; numEles <= BM_SortMaxEles; numEles *= 10)
+    {
+      printf("MergeSort, %u u32 keys: %.3f ms\n", numEles, BM_MergeSortMs(numEles));
+      printf("std::sort, %u u32 keys: %.3f ms\n", numEles, BM_StdSortMs(numEles));
+      printf("RadixSort, %u u32 keys: %.3f ms\n", numEles, BM_RadixSortMs(numEles));
+      printf("RadixSortParallel, %u threads, %u u32 keys: %.3f ms\n", numThreads,
+             numEles, BM_RadixSortParallelMs(numEles));
+      printf("std::stable_sort, %u key/index pairs: %.3f ms\n", numEles,
+             BM_StdSortPairsMs(numEles));
+      printf("RadixSort, %u key/index pairs: %.3f ms\n", numEles,
+             BM_RadixSortPairsMs(numEles));
+      printf("RadixSortParallel, %u threads, %u key/index pairs: %.3f ms\n", numThreads,
+             numEles, BM_RadixSortParallelPairsMs(numEles));
+      printf("MergeSort, %u float key items: %.3f ms\n", numEles,
+             BM_MergeSortItemsMs(numEles));
+      printf("std::sort, %u float key items: %.3f ms\n", numEles,
+             BM_StdSortItemsMs(numEles));
+      printf("IntroSort, %u float key items: %.3f ms\n", numEles,
+             BM_IntroSortItemsMs(numEles));
+      printf("ParallelSort, %u threads, %u float key items: %.3f ms\n", numThreads,
+             numEles, BM_ParallelSortItemsMs(numEles));
+    }
+    BM_sort_Shutdown();
+  }
+
+  // ParallelSort scaling with the number of threads, compare against the 1 thread times
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    for (uint32 numThreads = 1; numThreads <= 8; numThreads *= 2)
+    {
+      BM_sort_Startup(numThreads);
+      for (uint32 numEles = 1'000'000; numEles <= BM_SortMaxEles; numEles *= 10)
+      {
+        printf("ParallelSort, %u threads, %u float key items: %.3f ms\n", numThreads,
+               numEles, BM_ParallelSortItemsMs(numEles));
+      }
+      BM_sort_Shutdown();
+    }
+  }
+
+  // Vector (container) benchmarks
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_vec_Startup();
+    {
+      TIMED_SCOPED_BLOCK("Vector push back u32 benchmark");
+
+      BM_VecPushBack1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Std vector push back u32 benchmark");
+
+      BM_StdVecPushBack1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Vector append n u32 benchmark");
+
+      BM_VecAppendN1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Vector iterate u32 benchmark");
+
+      BM_VecIterate1M_U32();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Std vector iterate u32 benchmark");
+
+      BM_StdVecIterate1M_U32();
+    }
+    BM_vec_Shutdown();
+  }
+
+  // Handle pool benchmarks
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_hp_Startup();
+    {
+      TIMED_SCOPED_BLOCK("Handle pool create destroy 100k benchmark");
+
+      BM_HandlePoolCreateDestroy100K();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Pool allocator create destroy 100k benchmark");
+
+      BM_PoolAllocCreateDestroy100K();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Handle pool iterate 100k, half destroyed benchmark");
+
+      BM_HandlePoolIterate100K();
+    }
+    {
+      TIMED_SCOPED_BLOCK("Sparse array iterate 100k, half destroyed benchmark");
+
+      BM_SparseArrayIterate100K();
+    }
+    BM_hp_Shutdown();
+  }
+
+  // SoA vector benchmarks
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_soa_Startup();
+    {
+      TIMED_SCOPED_BLOCK("AoS integrate positions 1M benchmark");
+
+      BM_AoSIntegrate1M();
+    }
+    {
+      TIMED_SCOPED_BLOCK("SoA vector integrate positions 1M benchmark");
+
+      BM_SoAVectorIntegrate1M();
+    }
+    {
+      TIMED_SCOPED_BLOCK("SoA vector integrate positions 1M, SSE benchmark");
+
+      BM_SoAVectorIntegrate1M_SSE();
+    }
+    BM_soa_Shutdown();
+  }
+
+  // Bindless descriptor update benchmarks, steady state scene then churn heavy scenes
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_bindless_Startup();
+    const uint32 churnPerFrame[] = { 0, 8, 64 };
+    for (uint32 uiChurn = 0; uiChurn < ARRAYCOUNT(churnPerFrame); ++uiChurn)
+    {
+      const uint32 numChurn = churnPerFrame[uiChurn];
+      double usPerFrame = 0.0;
+      double writesPerFrame = BM_BindlessRebuildWritesPerFrame(numChurn, &usPerFrame);
+      printf("Bindless full rebuild, %u rebinds/frame: %.1f writes/frame, %.2f us\n",
+             numChurn, writesPerFrame, usPerFrame);
+      writesPerFrame = BM_BindlessSlotTableWritesPerFrame(numChurn, &usPerFrame);
+      printf("Bindless slot table, %u rebinds/frame: %.1f writes/frame, %.2f us\n",
+             numChurn, writesPerFrame, usPerFrame);
+    }
+    BM_bindless_Shutdown();
+  }
+
+  // Pool allocator benchmarks, same total work split across 1 to N threads
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_pool_Startup();
+    {
+      TIMED_SCOPED_BLOCK("Pool allocator churn, 1 thread");
+
+      BM_PoolAllocChurn(1);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Malloc churn, 1 thread");
+
+      BM_MallocChurn(1);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Pool allocator churn, 8 threads");
+
+      BM_PoolAllocChurn(8);
+    }
+    {
+      TIMED_SCOPED_BLOCK("Malloc churn, 8 threads");
+
+      BM_MallocChurn(8);
+    }
+    BM_pool_Shutdown();
+  }
+
+  // TLSF heap benchmarks, same total work split across 1 to N threads
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_tlsf_Startup();
+    {
+      TIMED_SCOPED_BLOCK("TLSF heap churn, shared, 1 thread");
+
+      BM_TLSFSharedChurn(1);
+    }
+    {
+      TIMED_SCOPED_BLOCK("TLSF heap churn, per thread, 1 thread");
+
+      BM_TLSFPerThreadChurn(1);
+    }
+    {
+      TIMED_SCOPED_BLOCK("CRT malloc churn, mixed sizes, 1 thread");
+
+      BM_CRTMallocChurn(1);
+    }
+    {
+      TIMED_SCOPED_BLOCK("TLSF heap churn, shared, 8 threads");
+
+      BM_TLSFSharedChurn(8);
+    }
+    {
+      TIMED_SCOPED_BLOCK("TLSF heap churn, per thread, 8 threads");
+
+      BM_TLSFPerThreadChurn(8);
+    }
+    {
+      TIMED_SCOPED_BLOCK("CRT malloc churn, mixed sizes, 8 threads");
+
+      BM_CRTMallocChurn(8);
+    }
+    BM_tlsf_Shutdown();
+  }
+
+  // Job scheduler benchmarks, makespan of a batch with a few long jobs mixed in
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    const uint32 workerCounts[] = { 3, 7 };
+    for (uint32 uiCount = 0; uiCount < ARRAYCOUNT(workerCounts); ++uiCount)
+    {
+      const uint32 numWorkers = workerCounts[uiCount];
+      BM_jobs_Startup(numWorkers);
+      printf("Mixed 1 us / 10 ms jobs, %u workers, ideal: %.1f ms\n", numWorkers,
+             BM_JobsIdealMakespanMs());
+      printf("Mixed 1 us / 10 ms jobs, %u workers, round robin: %.1f ms\n", numWorkers,
+             BM_JobsMixedRoundRobinMs());
+      printf("Mixed 1 us / 10 ms jobs, %u workers, work stealing: %.1f ms\n",
+             numWorkers, BM_JobsMixedWorkStealingMs());
+      BM_jobs_Shutdown();
+    }
+  }
+
+  // 100k tiny jobs, heap allocated vs pooled
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    BM_jobsub_Startup(3);
+    // Warm up the job pool and queues
+    BM_JobsSubmitPooledMs();
+    printf("Submit 100k jobs, heap allocated: %.2f ms\n", BM_JobsSubmitHeapMs());
+    printf("Submit 100k jobs, pooled: %.2f ms\n", BM_JobsSubmitPooledMs());
+    BM_jobsub_Shutdown();
+  }
+
+  // Frame job latency while background jobs keep every worker busy, p99 over 500 frames
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    const uint32 workerCounts[] = { 3, 7 };
+    for (uint32 uiCount = 0; uiCount < ARRAYCOUNT(workerCounts); ++uiCount)
+    {
+      const uint32 numWorkers = workerCounts[uiCount];
+      BM_jobprio_Startup(numWorkers);
+      printf("Frame jobs p99, %u workers, no background load: %.2f ms\n", numWorkers,
+             BM_FrameJobsNoLoadP99Ms());
+      printf("Frame jobs p99, %u workers, background at the same priority: %.2f ms\n",
+             numWorkers, BM_FrameJobsSamePriorityP99Ms());
+      printf("Frame jobs p99, %u workers, background lane: %.2f ms\n", numWorkers,
+             BM_FrameJobsPriorityLanesP99Ms());
+      BM_jobprio_Shutdown();
+    }
+  }
+
+  // ParallelFor / ParallelReduce speedup over a serial loop, 1 to 8 threads
+  for (uint32 i = 0; i < 1; ++i)
+  {
+    const uint32 threadCounts[] = { 1, 2, 4, 8 };
+    for (uint32 uiCount = 0; uiCount < ARRAYCOUNT(threadCounts); ++uiCount)
+    {
+      const uint32 numThreads = threadCounts[uiCount];
+      BM_pfor_Startup(numThreads);
+      const double serialTransformMs = BM_SerialTransformMs();
+      const double transformMs = BM_ParallelForTransformMs();
+      const double serialSumMs = BM_SerialSumMs();
+      const double sumMs = BM_ParallelReduceSumMs();
+      printf("ParallelFor transform, %u threads: %.2f ms, %.2fx\n", numThreads,
+             transformMs, serialTransformMs / transformMs);
+      printf("ParallelReduce sum, %u threads: %.2f ms, %.2fx\n", numThreads, sumMs,
+             serialSumMs / sumMs);
+      BM_pfor_Shutdown();
+    }
+  }
+
   // Vector type benchmarks
 
   // V4 mul M4
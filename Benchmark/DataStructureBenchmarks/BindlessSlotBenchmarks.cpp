@@ -0,0 +1,153 @@
+#include "BindlessSlotBenchmarks.h"
+#include "DataStructures/SlotAllocator.h"
+#include <chrono>
+#include <stdlib.h>
+
+using namespace Tk;
+using namespace Core;
+
+// Same as the game's DESCRIPTOR_BINDLESS_ARRAY_LIMIT and MAX_FRAMES_IN_FLIGHT
+const uint32 g_bindlessArraySize = 1024;
+const uint32 g_bindlessFramesInFlight = 2;
+const uint32 g_bindlessNumResident = 500;
+const uint32 g_bindlessNumFrames = 10'000;
+const uint32 g_bindlessFallbackHandle = 0xFFFF;
+const uint32 g_bindlessNumChurnRandoms = 1 << 16; // power of two
+
+// Stands in for the API descriptor set of each frame in flight
+static uint32* g_bindlessDescriptors = nullptr;
+// Resource handle of each resident texture, and its index in the bindless array
+static uint32* g_bindlessResident = nullptr;
+static uint32* g_bindlessResidentIndices = nullptr;
+// Which resident texture gets swapped out, per churn per frame
+static uint32* g_bindlessChurnOrder = nullptr;
+// Dirty slot lists handed to the descriptor writes
+static uint32* g_bindlessWriteSlots = nullptr;
+static uint32* g_bindlessWriteValues = nullptr;
+
+void BM_bindless_Startup()
+{
+  g_bindlessDescriptors = new uint32[g_bindlessArraySize * g_bindlessFramesInFlight];
+  g_bindlessResident = new uint32[g_bindlessNumResident];
+  g_bindlessResidentIndices = new uint32[g_bindlessNumResident];
+  g_bindlessWriteSlots = new uint32[g_bindlessArraySize];
+  g_bindlessWriteValues = new uint32[g_bindlessArraySize];
+
+  g_bindlessChurnOrder = new uint32[g_bindlessNumChurnRandoms];
+  srand(0);
+  for (uint32 i = 0; i < g_bindlessNumChurnRandoms; ++i)
+  {
+    g_bindlessChurnOrder[i] = (uint32)rand() % g_bindlessNumResident;
+  }
+}
+
+void BM_bindless_Shutdown()
+{
+  delete[] g_bindlessDescriptors;
+  g_bindlessDescriptors = nullptr;
+  delete[] g_bindlessResident;
+  g_bindlessResident = nullptr;
+  delete[] g_bindlessResidentIndices;
+  g_bindlessResidentIndices = nullptr;
+  delete[] g_bindlessChurnOrder;
+  g_bindlessChurnOrder = nullptr;
+  delete[] g_bindlessWriteSlots;
+  g_bindlessWriteSlots = nullptr;
+  delete[] g_bindlessWriteValues;
+  g_bindlessWriteValues = nullptr;
+}
+
+static uint32 BM_BindlessNextChurn(uint32* churnRandom)
+{
+  return g_bindlessChurnOrder[(*churnRandom)++ & (g_bindlessNumChurnRandoms - 1)];
+}
+
+static void BM_BindlessWriteDescriptors(uint32 frameInFlight, uint32 numWrites,
+                                        const uint32* slots, const uint32* values)
+{
+  uint32* descriptor = g_bindlessDescriptors + frameInFlight * g_bindlessArraySize;
+  for (uint32 i = 0; i < numWrites; ++i)
+  {
+    descriptor[slots ? slots[i] : i] = values[i];
+  }
+}
+
+double BM_BindlessRebuildWritesPerFrame(uint32 numChurnPerFrame, double* usPerFrame)
+{
+  for (uint32 i = 0; i < g_bindlessNumResident; ++i)
+  {
+    g_bindlessResident[i] = i;
+  }
+  uint32 nextHandle = g_bindlessNumResident;
+  uint32 churnRandom = 0;
+  uint64 numWrites = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32 uiFrame = 0; uiFrame < g_bindlessNumFrames; ++uiFrame)
+  {
+    for (uint32 uiChurn = 0; uiChurn < numChurnPerFrame; ++uiChurn)
+    {
+      const uint32 resident = BM_BindlessNextChurn(&churnRandom);
+      g_bindlessResident[resident] = nextHandle++;
+    }
+
+    // Every resident texture is bound again, then the rest is padded with the fallback
+    uint32 numBound = 0;
+    for (uint32 i = 0; i < g_bindlessNumResident; ++i)
+    {
+      g_bindlessResidentIndices[i] = numBound;
+      g_bindlessWriteValues[numBound++] = g_bindlessResident[i];
+    }
+    while (numBound < g_bindlessArraySize)
+    {
+      g_bindlessWriteValues[numBound++] = g_bindlessFallbackHandle;
+    }
+    BM_BindlessWriteDescriptors(uiFrame % g_bindlessFramesInFlight, numBound, nullptr,
+                                g_bindlessWriteValues);
+    numWrites += numBound;
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  *usPerFrame =
+    std::chrono::duration<double, std::micro>(elapsed).count() / g_bindlessNumFrames;
+  return (double)numWrites / g_bindlessNumFrames;
+}
+
+double BM_BindlessSlotTableWritesPerFrame(uint32 numChurnPerFrame, double* usPerFrame)
+{
+  MirroredSlotTable<g_bindlessFramesInFlight> table;
+  table.Init(g_bindlessArraySize, g_bindlessFallbackHandle);
+  for (uint32 i = 0; i < g_bindlessNumResident; ++i)
+  {
+    g_bindlessResident[i] = i;
+    g_bindlessResidentIndices[i] = table.Alloc(i);
+  }
+  uint32 nextHandle = g_bindlessNumResident;
+  uint32 churnRandom = 0;
+  uint64 numWrites = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32 uiFrame = 0; uiFrame < g_bindlessNumFrames; ++uiFrame)
+  {
+    const uint32 frameInFlight = uiFrame % g_bindlessFramesInFlight;
+    table.BeginFrame(frameInFlight);
+    for (uint32 uiChurn = 0; uiChurn < numChurnPerFrame; ++uiChurn)
+    {
+      const uint32 resident = BM_BindlessNextChurn(&churnRandom);
+      table.Free(g_bindlessResidentIndices[resident]);
+      g_bindlessResident[resident] = nextHandle;
+      g_bindlessResidentIndices[resident] = table.Alloc(nextHandle);
+      ++nextHandle;
+    }
+
+    const uint32 numDirty = table.Flush(g_bindlessWriteSlots, g_bindlessWriteValues);
+    BM_BindlessWriteDescriptors(frameInFlight, numDirty, g_bindlessWriteSlots,
+                                g_bindlessWriteValues);
+    numWrites += numDirty;
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  *usPerFrame =
+    std::chrono::duration<double, std::micro>(elapsed).count() / g_bindlessNumFrames;
+  return (double)numWrites / g_bindlessNumFrames;
+}
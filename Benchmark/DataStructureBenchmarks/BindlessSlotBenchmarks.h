@@ -0,0 +1,13 @@
+#include "CoreDefines.h"
+
+// Bindless descriptor update benchmarks
+// Simulates frames of a 1024 entry bindless array with 500 resident textures and two
+// frames in flight, where numChurnPerFrame textures get unbound and a new one bound
+// each frame. Rebuild is the old scheme that refills the whole array every frame, slot
+// table keeps each texture's index and only writes the entries that changed. Each
+// returns the average number of descriptor writes per frame, and the CPU time per frame
+// in usPerFrame.
+void BM_bindless_Startup();
+void BM_bindless_Shutdown();
+double BM_BindlessRebuildWritesPerFrame(uint32 numChurnPerFrame, double* usPerFrame);
+double BM_BindlessSlotTableWritesPerFrame(uint32 numChurnPerFrame, double* usPerFrame);
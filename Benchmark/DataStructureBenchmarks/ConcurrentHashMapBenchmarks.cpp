@@ -0,0 +1,154 @@
+#include "ConcurrentHashMapBenchmarks.h"
+#include "DataStructures/ConcurrentHashMap.h"
+#include "DataStructures/HashMap.h"
+#include "Platform/PlatformGameAPI.h"
+#include "Platform/WorkerThreadPool.h"
+
+using namespace Tk;
+using namespace Platform;
+using namespace Core;
+
+const uint32 g_chmMaxThreads = 8;
+const uint32 g_chmNumKeys = 1 << 16;
+const uint32 g_chmNumOps = 8'000'000;
+
+static ConcurrentHashMapU32* g_chm = nullptr;
+static HashMapU32* g_lockedHM = nullptr;
+static SpinLock g_lockedHMLock;
+
+struct alignas(CACHE_LINE) BM_CHMThreadResult
+{
+  uint64 m_sum;
+};
+static BM_CHMThreadResult g_chmResults[g_chmMaxThreads] = {};
+
+void BM_chm_Startup()
+{
+  ThreadPool::Startup(g_chmMaxThreads - 1);
+
+  g_chm = new ConcurrentHashMapU32();
+  g_chm->Reserve(g_chmNumKeys);
+  g_lockedHM = new HashMapU32();
+  g_lockedHM->Reserve(g_chmNumKeys);
+  for (uint32 i = 0; i < g_chmNumKeys; ++i)
+  {
+    g_chm->Insert(i, i);
+    g_lockedHM->Insert(i, i);
+  }
+}
+
+void BM_chm_Shutdown()
+{
+  ThreadPool::Shutdown();
+
+  delete g_chm;
+  g_chm = nullptr;
+  delete g_lockedHM;
+  g_lockedHM = nullptr;
+}
+
+// Cheap per-thread key sequence so the benchmark measures the map, not rand()
+static uint32 BM_CHMNextKey(uint32& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state & (g_chmNumKeys - 1);
+}
+
+#define BM_CHM_THREAD_FUNC(name)                                                         \
+  uint64 name(uint32 threadIndex, uint32 numOps, uint32 writeEvery)
+typedef BM_CHM_THREAD_FUNC(BM_CHMThreadFunc);
+
+static BM_CHM_THREAD_FUNC(BM_CHMMixedOps)
+{
+  uint32 state = 0x9E37'79B9u * (threadIndex + 1);
+  uint64 sum = 0;
+  uint32 opsUntilWrite = 0;
+  for (uint32 op = 0; op < numOps; ++op)
+  {
+    const uint32 key = BM_CHMNextKey(state);
+    if (opsUntilWrite-- == 0)
+    {
+      g_chm->Insert(key, op);
+      opsUntilWrite = writeEvery - 1;
+    }
+    else
+    {
+      uint32 value = 0;
+      g_chm->Find(key, &value);
+      sum += value;
+    }
+  }
+  return sum;
+}
+
+static BM_CHM_THREAD_FUNC(BM_LockedHMMixedOps)
+{
+  uint32 state = 0x9E37'79B9u * (threadIndex + 1);
+  uint64 sum = 0;
+  uint32 opsUntilWrite = 0;
+  for (uint32 op = 0; op < numOps; ++op)
+  {
+    const uint32 key = BM_CHMNextKey(state);
+    g_lockedHMLock.Lock();
+    if (opsUntilWrite-- == 0)
+    {
+      g_lockedHM->Insert(key, op);
+      opsUntilWrite = writeEvery - 1;
+    }
+    else
+    {
+      sum += g_lockedHM->DataAtIndex(g_lockedHM->FindIndex(key));
+    }
+    g_lockedHMLock.Unlock();
+  }
+  return sum;
+}
+
+// Splits g_chmNumOps across numThreads jobs, the calling thread runs the first one
+static uint64 BM_CHMRunOnThreads(uint32 numThreads, uint32 writeEvery,
+                                 BM_CHMThreadFunc* ThreadFunc)
+{
+  TINKER_ASSERT(numThreads >= 1 && numThreads <= g_chmMaxThreads);
+  const uint32 opsPerThread = g_chmNumOps / numThreads;
+
+  WorkerJob* jobs[g_chmMaxThreads] = {};
+  for (uint32 i = 0; i < numThreads; ++i)
+  {
+    jobs[i] = CreateNewThreadJob(
+      [=]() { g_chmResults[i].m_sum = ThreadFunc(i, opsPerThread, writeEvery); });
+  }
+
+  for (uint32 i = 1; i < numThreads; ++i)
+  {
+    ThreadPool::EnqueueSingleJob(jobs[i]);
+  }
+
+  (*jobs[0])();
+  jobs[0]->m_done = 1;
+
+  uint64 sum = 0;
+  for (uint32 i = 0; i < numThreads; ++i)
+  {
+    WaitOnJob(jobs[i]);
+    sum += g_chmResults[i].m_sum;
+    FreeJob(jobs[i]);
+  }
+  return sum;
+}
+
+uint64 BM_CHMReadMostly_U32(uint32 numThreads)
+{
+  return BM_CHMRunOnThreads(numThreads, 100, BM_CHMMixedOps);
+}
+
+uint64 BM_CHMWriteHeavy_U32(uint32 numThreads)
+{
+  return BM_CHMRunOnThreads(numThreads, 4, BM_CHMMixedOps);
+}
+
+uint64 BM_LockedHMReadMostly_U32(uint32 numThreads)
+{
+  return BM_CHMRunOnThreads(numThreads, 100, BM_LockedHMMixedOps);
+}
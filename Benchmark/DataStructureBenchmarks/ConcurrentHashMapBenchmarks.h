@@ -0,0 +1,10 @@
+#include "CoreDefines.h"
+
+// Concurrent hashmap benchmarks
+// Same total number of operations for every thread count, so the times show how reads and
+// writes scale from 1 to N threads
+void BM_chm_Startup();
+void BM_chm_Shutdown();
+uint64 BM_CHMReadMostly_U32(uint32 numThreads); // 1 write per 100 ops
+uint64 BM_CHMWriteHeavy_U32(uint32 numThreads); // 1 write per 4 ops
+uint64 BM_LockedHMReadMostly_U32(uint32 numThreads); // HashMap behind one lock
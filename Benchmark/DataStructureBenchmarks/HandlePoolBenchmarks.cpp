@@ -0,0 +1,161 @@
+#include "HandlePoolBenchmarks.h"
+#include "Allocators.h"
+#include "DataStructures/HandlePool.h"
+#include <stdlib.h>
+
+using namespace Tk;
+using namespace Core;
+
+const uint32 g_hpNumEntities = 100'000;
+const uint32 g_hpNumIters = 64;
+
+struct BM_HPEntity
+{
+  float m_pos[3];
+  float m_vel[3];
+  uint32 m_flags;
+};
+
+enum
+{
+  eBM_HPEntityActive = 0x1,
+};
+
+// Random destroy order, shared by every benchmark
+static uint32* g_hpDestroyOrder = nullptr;
+static uint32* g_hpHandles = nullptr;
+
+static HandlePool<BM_HPEntity>* g_hpIterPool = nullptr;
+static BM_HPEntity* g_hpIterSparse = nullptr;
+
+static BM_HPEntity BM_HPMakeEntity(uint32 i)
+{
+  BM_HPEntity entity = {};
+  entity.m_vel[0] = (float)(i & 7);
+  entity.m_vel[1] = 1.0f;
+  entity.m_vel[2] = (float)(i & 3);
+  entity.m_flags = eBM_HPEntityActive;
+  return entity;
+}
+
+void BM_hp_Startup()
+{
+  g_hpDestroyOrder = new uint32[g_hpNumEntities];
+  g_hpHandles = new uint32[g_hpNumEntities];
+  for (uint32 i = 0; i < g_hpNumEntities; ++i)
+  {
+    g_hpDestroyOrder[i] = i;
+  }
+  for (uint32 i = g_hpNumEntities - 1; i > 0; --i)
+  {
+    const uint32 j = (uint32)rand() % (i + 1);
+    const uint32 tmp = g_hpDestroyOrder[i];
+    g_hpDestroyOrder[i] = g_hpDestroyOrder[j];
+    g_hpDestroyOrder[j] = tmp;
+  }
+
+  // Same live set in both containers: every entity created, then half destroyed
+  g_hpIterPool = new HandlePool<BM_HPEntity>();
+  g_hpIterPool->Init(g_hpNumEntities);
+  g_hpIterSparse = new BM_HPEntity[g_hpNumEntities];
+  for (uint32 i = 0; i < g_hpNumEntities; ++i)
+  {
+    g_hpHandles[i] = g_hpIterPool->Create(BM_HPMakeEntity(i));
+    g_hpIterSparse[i] = BM_HPMakeEntity(i);
+  }
+  for (uint32 i = 0; i < g_hpNumEntities / 2; ++i)
+  {
+    const uint32 entity = g_hpDestroyOrder[i];
+    g_hpIterPool->Destroy(g_hpHandles[entity]);
+    g_hpIterSparse[entity].m_flags &= ~eBM_HPEntityActive;
+  }
+}
+
+void BM_hp_Shutdown()
+{
+  delete[] g_hpDestroyOrder;
+  g_hpDestroyOrder = nullptr;
+  delete[] g_hpHandles;
+  g_hpHandles = nullptr;
+  delete g_hpIterPool;
+  g_hpIterPool = nullptr;
+  delete[] g_hpIterSparse;
+  g_hpIterSparse = nullptr;
+}
+
+uint64 BM_HandlePoolCreateDestroy100K()
+{
+  uint64 sum = 0;
+  HandlePool<BM_HPEntity> pool;
+  pool.Init(g_hpNumEntities);
+  for (uint32 iter = 0; iter < g_hpNumIters; ++iter)
+  {
+    for (uint32 i = 0; i < g_hpNumEntities; ++i)
+    {
+      g_hpHandles[i] = pool.Create(BM_HPMakeEntity(i));
+    }
+    for (uint32 i = 0; i < g_hpNumEntities; ++i)
+    {
+      pool.Destroy(g_hpHandles[g_hpDestroyOrder[i]]);
+    }
+    sum += g_hpHandles[iter];
+  }
+  return sum;
+}
+
+uint64 BM_PoolAllocCreateDestroy100K()
+{
+  uint64 sum = 0;
+  PoolAllocator<BM_HPEntity> pool;
+  pool.Init(g_hpNumEntities, alignof(BM_HPEntity));
+  for (uint32 iter = 0; iter < g_hpNumIters; ++iter)
+  {
+    for (uint32 i = 0; i < g_hpNumEntities; ++i)
+    {
+      g_hpHandles[i] = pool.Alloc();
+      *pool.PtrFromHandle(g_hpHandles[i]) = BM_HPMakeEntity(i);
+    }
+    for (uint32 i = 0; i < g_hpNumEntities; ++i)
+    {
+      pool.Dealloc(g_hpHandles[g_hpDestroyOrder[i]]);
+    }
+    sum += g_hpHandles[iter];
+  }
+  return sum;
+}
+
+uint64 BM_HandlePoolIterate100K()
+{
+  BM_HPEntity* entities = g_hpIterPool->Data();
+  const uint32 numEntities = g_hpIterPool->Size();
+  for (uint32 iter = 0; iter < g_hpNumIters; ++iter)
+  {
+    for (uint32 i = 0; i < numEntities; ++i)
+    {
+      BM_HPEntity& entity = entities[i];
+      entity.m_pos[0] += entity.m_vel[0];
+      entity.m_pos[1] += entity.m_vel[1];
+      entity.m_pos[2] += entity.m_vel[2];
+    }
+  }
+  return (uint64)entities[0].m_pos[1];
+}
+
+uint64 BM_SparseArrayIterate100K()
+{
+  BM_HPEntity* entities = g_hpIterSparse;
+  for (uint32 iter = 0; iter < g_hpNumIters; ++iter)
+  {
+    for (uint32 i = 0; i < g_hpNumEntities; ++i)
+    {
+      BM_HPEntity& entity = entities[i];
+      if (entity.m_flags & eBM_HPEntityActive)
+      {
+        entity.m_pos[0] += entity.m_vel[0];
+        entity.m_pos[1] += entity.m_vel[1];
+        entity.m_pos[2] += entity.m_vel[2];
+      }
+    }
+  }
+  return (uint64)entities[g_hpDestroyOrder[g_hpNumEntities - 1]].m_pos[1];
+}
@@ -0,0 +1,11 @@
+#include "CoreDefines.h"
+
+// Handle pool benchmarks, 100k entities
+// The iterate benchmarks run with half of the entities destroyed in random order, so the
+// sparse array has holes everywhere and the handle pool is packed
+void BM_hp_Startup();
+void BM_hp_Shutdown();
+uint64 BM_HandlePoolCreateDestroy100K();
+uint64 BM_PoolAllocCreateDestroy100K(); // free list, no generations
+uint64 BM_HandlePoolIterate100K();
+uint64 BM_SparseArrayIterate100K(); // active flag per slot, like the old Scene
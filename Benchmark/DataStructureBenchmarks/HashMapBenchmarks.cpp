@@ -133,3 +133,112 @@ uint64 BM_StdHMIns1M_fScalar_U64()
   // return some random value out of the second map
   return map_std2[keys[256]];
 }
+
+// Lookup benchmarks - the maps are filled once, outside of the timed block
+static HashMapU32* g_lookupMap = nullptr;
+static std::unordered_map<uint32, uint32>* g_lookupMapStd = nullptr;
+uint32 missKeys[g_numEles] = {};
+
+void BM_hmLookup_Startup()
+{
+  BM_hm_Startup();
+
+  // Distinct keys so that every miss key is guaranteed to not be in the maps
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    keys[i] = i * 2;
+  }
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    missKeys[i] = keys[rand() % g_numEles] + 1;
+  }
+
+  g_lookupMap = new HashMapU32();
+  g_lookupMapStd = new std::unordered_map<uint32, uint32>();
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    g_lookupMap->Insert(keys[i], vals[i]);
+    (*g_lookupMapStd)[keys[i]] = vals[i];
+  }
+}
+
+void BM_hmLookup_Shutdown()
+{
+  delete g_lookupMap;
+  g_lookupMap = nullptr;
+  delete g_lookupMapStd;
+  g_lookupMapStd = nullptr;
+}
+
+uint64 BM_HMFindHit1M_U32()
+{
+  uint64 sum = 0;
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    uint32 key = keys[(i * 7919) % g_numEles];
+    sum += g_lookupMap->DataAtIndex(g_lookupMap->FindIndex(key));
+  }
+  return sum;
+}
+
+uint64 BM_StdHMFindHit1M_U32()
+{
+  uint64 sum = 0;
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    uint32 key = keys[(i * 7919) % g_numEles];
+    sum += g_lookupMapStd->find(key)->second;
+  }
+  return sum;
+}
+
+uint64 BM_HMFindMiss1M_U32()
+{
+  uint64 numFound = 0;
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    numFound += g_lookupMap->FindIndex(missKeys[i]) != HashMapBase::eInvalidIndex;
+  }
+  return numFound;
+}
+
+uint64 BM_StdHMFindMiss1M_U32()
+{
+  uint64 numFound = 0;
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    numFound += g_lookupMapStd->find(missKeys[i]) != g_lookupMapStd->end();
+  }
+  return numFound;
+}
+
+// Keep a small live set while cycling through every key, lots of inserts and erases
+const uint32 g_numLiveEles = 4096;
+
+uint64 BM_HMEraseHeavy1M_U32()
+{
+  HashMapU32 map;
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    map.Insert(keys[i], vals[i]);
+    if (i >= g_numLiveEles)
+    {
+      map.Remove(keys[i - g_numLiveEles]);
+    }
+  }
+  return map.Size();
+}
+
+uint64 BM_StdHMEraseHeavy1M_U32()
+{
+  std::unordered_map<uint32, uint32> map_std;
+  for (uint32 i = 0; i < g_numEles; ++i)
+  {
+    map_std[keys[i]] = vals[i];
+    if (i >= g_numLiveEles)
+    {
+      map_std.erase(keys[i - g_numLiveEles]);
+    }
+  }
+  return map_std.size();
+}
@@ -7,3 +7,12 @@ uint32 BM_HMIns1M_fScalar_U32();
 uint64 BM_HMIns1M_fScalar_U64();
 uint32 BM_StdHMIns1M_fScalar_U32();
 uint64 BM_StdHMIns1M_fScalar_U64();
+
+void BM_hmLookup_Startup();
+void BM_hmLookup_Shutdown();
+uint64 BM_HMFindHit1M_U32();
+uint64 BM_StdHMFindHit1M_U32();
+uint64 BM_HMFindMiss1M_U32();
+uint64 BM_StdHMFindMiss1M_U32();
+uint64 BM_HMEraseHeavy1M_U32();
+uint64 BM_StdHMEraseHeavy1M_U32();
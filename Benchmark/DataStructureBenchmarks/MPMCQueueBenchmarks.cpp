@@ -0,0 +1,259 @@
+#include "MPMCQueueBenchmarks.h"
+#include "DataStructures/MPMCQueue.h"
+#include "Platform/WorkerThreadPool.h"
+#include "Sorting.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace Tk;
+using namespace Platform;
+using namespace Core;
+
+const uint32 g_mpmcMaxThreads = 8;
+const uint32 g_mpmcNumItems = 2'000'000;
+const uint32 g_mpmcCapacity = 1024;
+const uint32 g_mpmcBatchSize = 16;
+const uint32 g_mpmcSampleEvery = 64; // items that carry their enqueue time
+const uint32 g_mpmcMaxSamples = g_mpmcNumItems / g_mpmcSampleEvery + g_mpmcMaxThreads;
+
+namespace BM_MPMCMode
+{
+  enum : uint32
+  {
+    eSingle = 0,
+    eBatch,
+    eLocked,
+  };
+}
+
+// Items are enqueue times in ns, or 0 for items that aren't sampled
+static MPMCQueue<uint64>* g_mpmcQueue = nullptr;
+static std::deque<uint64>* g_lockedDeque = nullptr;
+static std::mutex g_lockedDequeMutex;
+
+struct alignas(CACHE_LINE) BM_MPMCConsumerSamples
+{
+  uint32 m_numSamples;
+};
+static BM_MPMCConsumerSamples g_mpmcNumSamples[g_mpmcMaxThreads] = {};
+static uint32 g_mpmcSamplesNs[g_mpmcMaxThreads][g_mpmcMaxSamples] = {};
+static uint32 g_mpmcAllSamplesNs[g_mpmcMaxThreads * g_mpmcMaxSamples] = {};
+
+void BM_mpmc_Startup()
+{
+  ThreadPool::Startup(g_mpmcMaxThreads - 1);
+
+  g_mpmcQueue = new MPMCQueue<uint64>();
+  g_mpmcQueue->Init(g_mpmcCapacity);
+  g_lockedDeque = new std::deque<uint64>();
+}
+
+void BM_mpmc_Shutdown()
+{
+  ThreadPool::Shutdown();
+
+  delete g_mpmcQueue;
+  g_mpmcQueue = nullptr;
+  delete g_lockedDeque;
+  g_lockedDeque = nullptr;
+}
+
+static uint64 BM_MPMCNowNs()
+{
+  return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+// Same bound as the lock free queue, so producers block on a full deque the same way
+static uint32 BM_LockedDequeEnqueue(const uint64* items, uint32 numItems)
+{
+  std::lock_guard<std::mutex> lock(g_lockedDequeMutex);
+  const uint32 numToEnqueue =
+    Min(numItems, g_mpmcCapacity - (uint32)g_lockedDeque->size());
+  for (uint32 i = 0; i < numToEnqueue; ++i)
+  {
+    g_lockedDeque->push_back(items[i]);
+  }
+  return numToEnqueue;
+}
+
+static uint32 BM_LockedDequeDequeue(uint64* items, uint32 maxItems)
+{
+  std::lock_guard<std::mutex> lock(g_lockedDequeMutex);
+  const uint32 numToDequeue = Min(maxItems, (uint32)g_lockedDeque->size());
+  for (uint32 i = 0; i < numToDequeue; ++i)
+  {
+    items[i] = g_lockedDeque->front();
+    g_lockedDeque->pop_front();
+  }
+  return numToDequeue;
+}
+
+static void BM_MPMCProduce(uint32 mode, uint32 numItems)
+{
+  const uint32 maxBatch = mode == BM_MPMCMode::eBatch ? g_mpmcBatchSize : 1;
+  uint64 items[g_mpmcBatchSize];
+  uint32 next = 0;
+  while (next < numItems)
+  {
+    const uint32 batchSize = Min(maxBatch, numItems - next);
+    for (uint32 i = 0; i < batchSize; ++i)
+    {
+      items[i] = (next + i) % g_mpmcSampleEvery ? 0 : BM_MPMCNowNs();
+    }
+
+    uint32 numEnqueued = 0;
+    switch (mode)
+    {
+      case BM_MPMCMode::eSingle:
+      {
+        numEnqueued = g_mpmcQueue->TryEnqueue(items[0]) ? 1 : 0;
+        break;
+      }
+      case BM_MPMCMode::eBatch:
+      {
+        numEnqueued = g_mpmcQueue->TryEnqueueBatch(items, batchSize);
+        break;
+      }
+      case BM_MPMCMode::eLocked:
+      {
+        numEnqueued = BM_LockedDequeEnqueue(items, batchSize);
+        break;
+      }
+    }
+    next += numEnqueued;
+    if (!numEnqueued)
+    {
+      // Full, let a consumer have the core
+      std::this_thread::yield();
+    }
+  }
+}
+
+// Takes exactly numItems, so consumers stop on their own once everything is through
+static void BM_MPMCConsume(uint32 mode, uint32 consumerIndex, uint32 numItems)
+{
+  const uint32 maxBatch = mode == BM_MPMCMode::eBatch ? g_mpmcBatchSize : 1;
+  uint64 items[g_mpmcBatchSize];
+  uint32* samples = g_mpmcSamplesNs[consumerIndex];
+  uint32 numSamples = 0;
+  uint32 numTaken = 0;
+  while (numTaken < numItems)
+  {
+    const uint32 batchSize = Min(maxBatch, numItems - numTaken);
+    uint32 numDequeued = 0;
+    switch (mode)
+    {
+      case BM_MPMCMode::eSingle:
+      {
+        numDequeued = g_mpmcQueue->TryDequeue(&items[0]) ? 1 : 0;
+        break;
+      }
+      case BM_MPMCMode::eBatch:
+      {
+        numDequeued = g_mpmcQueue->TryDequeueBatch(items, batchSize);
+        break;
+      }
+      case BM_MPMCMode::eLocked:
+      {
+        numDequeued = BM_LockedDequeDequeue(items, batchSize);
+        break;
+      }
+    }
+    if (!numDequeued)
+    {
+      // Empty, let a producer have the core
+      std::this_thread::yield();
+      continue;
+    }
+
+    uint64 now = 0;
+    for (uint32 i = 0; i < numDequeued; ++i)
+    {
+      if (items[i] && numSamples < g_mpmcMaxSamples)
+      {
+        now = now ? now : BM_MPMCNowNs();
+        samples[numSamples++] = (uint32)Min(now - items[i], (uint64)0xFFFFFFFF);
+      }
+    }
+    numTaken += numDequeued;
+  }
+  g_mpmcNumSamples[consumerIndex].m_numSamples = numSamples;
+}
+
+// Producers and consumers each get a job, the calling thread runs the first producer.
+// Every job has to be running at once, so there are enough workers for all of them.
+static double BM_MPMCRun(uint32 mode, uint32 numProducers, uint32 numConsumers,
+                         double* p99LatencyUs)
+{
+  TINKER_ASSERT(numProducers >= 1 && numConsumers >= 1);
+  TINKER_ASSERT(numProducers + numConsumers <= g_mpmcMaxThreads);
+  const uint32 numItems = g_mpmcNumItems - g_mpmcNumItems % (numProducers * numConsumers);
+
+  WorkerJob* jobs[g_mpmcMaxThreads] = {};
+  for (uint32 i = 0; i < numProducers; ++i)
+  {
+    jobs[i] =
+      CreateNewThreadJob([=]() { BM_MPMCProduce(mode, numItems / numProducers); });
+  }
+  for (uint32 i = 0; i < numConsumers; ++i)
+  {
+    jobs[numProducers + i] =
+      CreateNewThreadJob([=]() { BM_MPMCConsume(mode, i, numItems / numConsumers); });
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32 i = 1; i < numProducers + numConsumers; ++i)
+  {
+    ThreadPool::EnqueueSingleJob(jobs[i]);
+  }
+
+  (*jobs[0])();
+  jobs[0]->m_done = 1;
+
+  for (uint32 i = 0; i < numProducers + numConsumers; ++i)
+  {
+    WaitOnJob(jobs[i]);
+    FreeJob(jobs[i]);
+  }
+  const double seconds =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  uint32 numSamples = 0;
+  for (uint32 i = 0; i < numConsumers; ++i)
+  {
+    for (uint32 uiSample = 0; uiSample < g_mpmcNumSamples[i].m_numSamples; ++uiSample)
+    {
+      g_mpmcAllSamplesNs[numSamples++] = g_mpmcSamplesNs[i][uiSample];
+    }
+  }
+  *p99LatencyUs = 0.0;
+  if (numSamples)
+  {
+    MergeSort(g_mpmcAllSamplesNs, numSamples, CompareLessThan_uint32);
+    *p99LatencyUs = g_mpmcAllSamplesNs[numSamples * 99 / 100] / 1000.0;
+  }
+
+  return numItems / seconds / 1'000'000.0;
+}
+
+double BM_MPMCQueueMops(uint32 numProducers, uint32 numConsumers, double* p99LatencyUs)
+{
+  return BM_MPMCRun(BM_MPMCMode::eSingle, numProducers, numConsumers, p99LatencyUs);
+}
+
+double BM_MPMCQueueBatchMops(uint32 numProducers, uint32 numConsumers,
+                             double* p99LatencyUs)
+{
+  return BM_MPMCRun(BM_MPMCMode::eBatch, numProducers, numConsumers, p99LatencyUs);
+}
+
+double BM_LockedDequeMops(uint32 numProducers, uint32 numConsumers, double* p99LatencyUs)
+{
+  return BM_MPMCRun(BM_MPMCMode::eLocked, numProducers, numConsumers, p99LatencyUs);
+}
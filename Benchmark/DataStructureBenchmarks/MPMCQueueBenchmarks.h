@@ -0,0 +1,14 @@
+#include "CoreDefines.h"
+
+// MPMC queue benchmarks
+// Producers push the same total number of items through a small queue to consumers,
+// spread across however many of each. Each returns millions of items per second, and
+// the 99th percentile time from enqueue to dequeue of a sample of the items in
+// *p99LatencyUs.
+void BM_mpmc_Startup();
+void BM_mpmc_Shutdown();
+double BM_MPMCQueueMops(uint32 numProducers, uint32 numConsumers, double* p99LatencyUs);
+double BM_MPMCQueueBatchMops(uint32 numProducers, uint32 numConsumers,
+                             double* p99LatencyUs); // 16 items per call
+double BM_LockedDequeMops(uint32 numProducers, uint32 numConsumers,
+                          double* p99LatencyUs); // std::deque behind a std::mutex
@@ -0,0 +1,131 @@
+#include "SoAVectorBenchmarks.h"
+#include "DataStructures/SoAVector.h"
+#include <xmmintrin.h>
+
+using namespace Tk;
+using namespace Core;
+
+const uint32 g_soaNumEntities = 1'000'000;
+const uint32 g_soaNumIters = 16;
+const float g_soaDeltaTime = 1.0f / 60.0f;
+
+struct BM_SoATransform
+{
+  float m_matrix[16];
+};
+
+struct BM_SoAEntity
+{
+  float m_pos[3];
+  float m_vel[3];
+  BM_SoATransform m_transform;
+  uint32 m_assetID;
+};
+
+enum : uint32
+{
+  eBM_SoAPosX,
+  eBM_SoAPosY,
+  eBM_SoAPosZ,
+  eBM_SoAVelX,
+  eBM_SoAVelY,
+  eBM_SoAVelZ,
+  eBM_SoATransform,
+  eBM_SoAAssetID,
+};
+
+typedef SoAVector<float, float, float, float, float, float, BM_SoATransform, uint32>
+  BM_SoAEntities;
+
+static BM_SoAEntity* g_soaAoS = nullptr;
+static BM_SoAEntities* g_soaEntities = nullptr;
+
+void BM_soa_Startup()
+{
+  g_soaAoS = new BM_SoAEntity[g_soaNumEntities];
+  g_soaEntities = new BM_SoAEntities();
+  g_soaEntities->Reserve(g_soaNumEntities);
+  for (uint32 i = 0; i < g_soaNumEntities; ++i)
+  {
+    BM_SoAEntity entity = {};
+    entity.m_vel[0] = (float)(i & 7);
+    entity.m_vel[1] = 1.0f;
+    entity.m_vel[2] = (float)(i & 3);
+    entity.m_assetID = i & 15;
+    g_soaAoS[i] = entity;
+    g_soaEntities->PushBack(entity.m_pos[0], entity.m_pos[1], entity.m_pos[2],
+                            entity.m_vel[0], entity.m_vel[1], entity.m_vel[2],
+                            entity.m_transform, entity.m_assetID);
+  }
+}
+
+void BM_soa_Shutdown()
+{
+  delete[] g_soaAoS;
+  g_soaAoS = nullptr;
+  delete g_soaEntities;
+  g_soaEntities = nullptr;
+}
+
+uint64 BM_AoSIntegrate1M()
+{
+  BM_SoAEntity* entities = g_soaAoS;
+  for (uint32 iter = 0; iter < g_soaNumIters; ++iter)
+  {
+    for (uint32 i = 0; i < g_soaNumEntities; ++i)
+    {
+      BM_SoAEntity& entity = entities[i];
+      entity.m_pos[0] += entity.m_vel[0] * g_soaDeltaTime;
+      entity.m_pos[1] += entity.m_vel[1] * g_soaDeltaTime;
+      entity.m_pos[2] += entity.m_vel[2] * g_soaDeltaTime;
+    }
+  }
+  return (uint64)entities[0].m_pos[1];
+}
+
+uint64 BM_SoAVectorIntegrate1M()
+{
+  SoAColumn<float> posX = g_soaEntities->Column<eBM_SoAPosX>();
+  SoAColumn<float> posY = g_soaEntities->Column<eBM_SoAPosY>();
+  SoAColumn<float> posZ = g_soaEntities->Column<eBM_SoAPosZ>();
+  const SoAColumn<float> velX = g_soaEntities->Column<eBM_SoAVelX>();
+  const SoAColumn<float> velY = g_soaEntities->Column<eBM_SoAVelY>();
+  const SoAColumn<float> velZ = g_soaEntities->Column<eBM_SoAVelZ>();
+  const uint32 numEntities = g_soaEntities->Size();
+  for (uint32 iter = 0; iter < g_soaNumIters; ++iter)
+  {
+    for (uint32 i = 0; i < numEntities; ++i)
+    {
+      posX[i] += velX[i] * g_soaDeltaTime;
+      posY[i] += velY[i] * g_soaDeltaTime;
+      posZ[i] += velZ[i] * g_soaDeltaTime;
+    }
+  }
+  return (uint64)posY[0];
+}
+
+uint64 BM_SoAVectorIntegrate1M_SSE()
+{
+  float* posX = g_soaEntities->Column<eBM_SoAPosX>().Data();
+  float* posY = g_soaEntities->Column<eBM_SoAPosY>().Data();
+  float* posZ = g_soaEntities->Column<eBM_SoAPosZ>().Data();
+  const float* velX = g_soaEntities->Column<eBM_SoAVelX>().Data();
+  const float* velY = g_soaEntities->Column<eBM_SoAVelY>().Data();
+  const float* velZ = g_soaEntities->Column<eBM_SoAVelZ>().Data();
+  const uint32 numEntities = g_soaEntities->Size();
+  const __m128 deltaTime = _mm_set1_ps(g_soaDeltaTime);
+  for (uint32 iter = 0; iter < g_soaNumIters; ++iter)
+  {
+    // Columns are cache line aligned and padded, so no scalar tail loop
+    for (uint32 i = 0; i < numEntities; i += 4)
+    {
+      _mm_store_ps(&posX[i], _mm_add_ps(_mm_load_ps(&posX[i]),
+                                        _mm_mul_ps(_mm_load_ps(&velX[i]), deltaTime)));
+      _mm_store_ps(&posY[i], _mm_add_ps(_mm_load_ps(&posY[i]),
+                                        _mm_mul_ps(_mm_load_ps(&velY[i]), deltaTime)));
+      _mm_store_ps(&posZ[i], _mm_add_ps(_mm_load_ps(&posZ[i]),
+                                        _mm_mul_ps(_mm_load_ps(&velZ[i]), deltaTime)));
+    }
+  }
+  return (uint64)posY[0];
+}
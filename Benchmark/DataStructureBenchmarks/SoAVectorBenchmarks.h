@@ -0,0 +1,10 @@
+#include "CoreDefines.h"
+
+// SoA vector benchmarks, 1M entities
+// Moves every entity's position by its velocity. The entities also carry a transform and
+// an asset ID that the loop doesn't need, which AoS drags through the cache anyway.
+void BM_soa_Startup();
+void BM_soa_Shutdown();
+uint64 BM_AoSIntegrate1M();
+uint64 BM_SoAVectorIntegrate1M();
+uint64 BM_SoAVectorIntegrate1M_SSE(); // whole vectors of 4 past Size() into the padding
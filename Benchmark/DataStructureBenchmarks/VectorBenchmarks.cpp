@@ -0,0 +1,110 @@
+#include "VectorBenchmarks.h"
+#include "DataStructures/Vector.h"
+#include <stdlib.h>
+#include <vector>
+
+using namespace Tk;
+using namespace Core;
+
+const uint32 g_numVecEles = 1'000'000;
+const uint32 g_numVecIters = 64;
+uint32 vecVals[g_numVecEles] = {};
+
+// Pre-filled containers for the iterate benchmarks
+static Vector<uint32>* g_iterVec = nullptr;
+static std::vector<uint32>* g_iterStdVec = nullptr;
+
+void BM_vec_Startup()
+{
+  for (uint32 i = 0; i < g_numVecEles; ++i)
+  {
+    vecVals[i] = rand();
+  }
+
+  g_iterVec = new Vector<uint32>();
+  g_iterVec->AppendN(&vecVals[0], g_numVecEles);
+
+  g_iterStdVec = new std::vector<uint32>(&vecVals[0], &vecVals[0] + g_numVecEles);
+}
+
+void BM_vec_Shutdown()
+{
+  delete g_iterVec;
+  g_iterVec = nullptr;
+  delete g_iterStdVec;
+  g_iterStdVec = nullptr;
+}
+
+uint64 BM_VecPushBack1M_U32()
+{
+  // push one element at a time into a fresh vector, no reserve
+  uint64 sum = 0;
+  for (uint32 iter = 0; iter < g_numVecIters; ++iter)
+  {
+    Vector<uint32> vec;
+    for (uint32 i = 0; i < g_numVecEles; ++i)
+    {
+      vec.PushBackRaw(vecVals[i]);
+    }
+    sum += vec[iter];
+  }
+  return sum;
+}
+
+uint64 BM_StdVecPushBack1M_U32()
+{
+  uint64 sum = 0;
+  for (uint32 iter = 0; iter < g_numVecIters; ++iter)
+  {
+    std::vector<uint32> vec;
+    for (uint32 i = 0; i < g_numVecEles; ++i)
+    {
+      vec.push_back(vecVals[i]);
+    }
+    sum += vec[iter];
+  }
+  return sum;
+}
+
+uint64 BM_VecAppendN1M_U32()
+{
+  // same amount of data as the push back benchmark, appended in chunks
+  const uint32 chunkSize = 256;
+  uint64 sum = 0;
+  for (uint32 iter = 0; iter < g_numVecIters; ++iter)
+  {
+    Vector<uint32> vec;
+    for (uint32 i = 0; i < g_numVecEles; i += chunkSize)
+    {
+      vec.AppendN(&vecVals[i], Min(chunkSize, g_numVecEles - i));
+    }
+    sum += vec[iter];
+  }
+  return sum;
+}
+
+uint64 BM_VecIterate1M_U32()
+{
+  uint64 sum = 0;
+  for (uint32 iter = 0; iter < g_numVecIters; ++iter)
+  {
+    for (uint32 val : *g_iterVec)
+    {
+      sum += val;
+    }
+  }
+  return sum;
+}
+
+uint64 BM_StdVecIterate1M_U32()
+{
+  uint64 sum = 0;
+  for (uint32 iter = 0; iter < g_numVecIters; ++iter)
+  {
+    for (uint32 val : *g_iterStdVec)
+    {
+      sum += val;
+    }
+  }
+  return sum;
+}
@@ -0,0 +1,10 @@
+#include "CoreDefines.h"
+
+// Vector benchmarks
+void BM_vec_Startup();
+void BM_vec_Shutdown();
+uint64 BM_VecPushBack1M_U32();
+uint64 BM_StdVecPushBack1M_U32();
+uint64 BM_VecAppendN1M_U32();
+uint64 BM_VecIterate1M_U32();
+uint64 BM_StdVecIterate1M_U32();
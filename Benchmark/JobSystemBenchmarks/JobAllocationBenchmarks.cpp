@@ -0,0 +1,58 @@
+#include "JobAllocationBenchmarks.h"
+#include "Platform/WorkerThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+
+using namespace Tk;
+using namespace Platform;
+
+const uint32 g_jobsubNumJobs = 100'000;
+
+static WorkerJob** g_jobsubJobs = nullptr;
+static std::atomic<uint32> g_jobsubNumRun = 0;
+
+void BM_jobsub_Startup(uint32 numWorkers)
+{
+  ThreadPool::Startup(numWorkers);
+  g_jobsubJobs = (WorkerJob**)Core::CoreMallocAligned(
+    g_jobsubNumJobs * sizeof(WorkerJob*), CACHE_LINE);
+}
+
+void BM_jobsub_Shutdown()
+{
+  ThreadPool::Shutdown();
+  Core::CoreFreeAligned(g_jobsubJobs);
+  g_jobsubJobs = nullptr;
+}
+
+template <typename Func>
+static double BM_JobsSubmitMs(Func func)
+{
+  const auto start = std::chrono::steady_clock::now();
+  JobCounter counter;
+  for (uint32 i = 0; i < g_jobsubNumJobs; ++i)
+  {
+    g_jobsubJobs[i] = CreateNewThreadJob(func);
+    LaunchJob(g_jobsubJobs[i], &counter, nullptr);
+  }
+  WaitOnJobCounter(&counter, false);
+  for (uint32 i = 0; i < g_jobsubNumJobs; ++i)
+  {
+    FreeJob(g_jobsubJobs[i]);
+  }
+  const std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+double BM_JobsSubmitHeapMs()
+{
+  uint8 padding[InlineJob::eMaxFuncSize] = {};
+  return BM_JobsSubmitMs([padding]() { g_jobsubNumRun.fetch_add(1 + padding[0]); });
+}
+
+double BM_JobsSubmitPooledMs()
+{
+  return BM_JobsSubmitMs([]() { g_jobsubNumRun.fetch_add(1); });
+}
@@ -0,0 +1,9 @@
+#include "CoreDefines.h"
+
+// Job creation cost
+// The main thread creates, launches, waits on and frees 100k tiny jobs. Each returns
+// the total in ms.
+void BM_jobsub_Startup(uint32 numWorkers);
+void BM_jobsub_Shutdown();
+double BM_JobsSubmitHeapMs(); // captures too big to store in place, one alloc per job
+double BM_JobsSubmitPooledMs(); // stored in place, recycled from the job pool
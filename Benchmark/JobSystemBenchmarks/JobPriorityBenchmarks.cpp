@@ -0,0 +1,111 @@
+#include "JobPriorityBenchmarks.h"
+#include "Platform/WorkerThreadPool.h"
+#include "Sorting.h"
+
+#include <atomic>
+#include <chrono>
+#include <emmintrin.h>
+
+using namespace Tk;
+using namespace Platform;
+using namespace Core;
+
+const uint32 g_jobprioNumFrames = 500;
+const uint32 g_jobprioFrameJobUs = 20;
+const uint32 g_jobprioFrameJobsPerWorker = 4;
+const uint32 g_jobprioBackgroundJobUs = 2000;
+const uint32 g_jobprioBackgroundJobsPerWorker = 2; // kept queued
+const uint32 g_jobprioNoBackground = JobPriority::eCount;
+
+static uint32 g_jobprioNumWorkers = 0;
+static uint32 g_jobprioLatenciesUs[g_jobprioNumFrames] = {};
+
+static void BM_JobPrioBusyWait(uint32 durationUs)
+{
+  const auto end =
+    std::chrono::steady_clock::now() + std::chrono::microseconds(durationUs);
+  while (std::chrono::steady_clock::now() < end)
+  {
+    _mm_pause();
+  }
+}
+
+void BM_jobprio_Startup(uint32 numWorkers)
+{
+  g_jobprioNumWorkers = numWorkers;
+  ThreadPool::Startup(numWorkers);
+}
+
+void BM_jobprio_Shutdown()
+{
+  ThreadPool::Shutdown();
+}
+
+static double BM_FrameJobsP99Ms(uint32 framePriority, uint32 backgroundPriority)
+{
+  const uint32 numFrameJobs = g_jobprioFrameJobsPerWorker * g_jobprioNumWorkers;
+  const uint32 numBackgroundQueued =
+    g_jobprioBackgroundJobsPerWorker * g_jobprioNumWorkers;
+
+  std::atomic<uint32> numBackgroundInFlight = 0;
+  JobCounter backgroundCounter;
+  WorkerJobList backgroundJobs;
+  WorkerJobList frameJobs;
+  frameJobs.Init(numFrameJobs);
+
+  for (uint32 uiFrame = 0; uiFrame < g_jobprioNumFrames; ++uiFrame)
+  {
+    // Top the background load back up, it never runs dry
+    while (backgroundPriority != g_jobprioNoBackground
+           && numBackgroundInFlight.load(std::memory_order_relaxed) < numBackgroundQueued)
+    {
+      WorkerJob* job = CreateNewThreadJob(
+        [&numBackgroundInFlight]()
+        {
+          BM_JobPrioBusyWait(g_jobprioBackgroundJobUs);
+          numBackgroundInFlight.fetch_sub(1, std::memory_order_relaxed);
+        });
+      job->m_priority = backgroundPriority;
+      numBackgroundInFlight.fetch_add(1, std::memory_order_relaxed);
+      backgroundJobs.Add(job);
+      LaunchJob(job, &backgroundCounter, nullptr);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    JobCounter frameCounter;
+    for (uint32 i = 0; i < numFrameJobs; ++i)
+    {
+      frameJobs.m_jobs[i] =
+        CreateNewThreadJob([]() { BM_JobPrioBusyWait(g_jobprioFrameJobUs); });
+      frameJobs.m_jobs[i]->m_priority = framePriority;
+      LaunchJob(frameJobs.m_jobs[i], &frameCounter, nullptr);
+    }
+    WaitOnJobCounter(&frameCounter, false);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+    g_jobprioLatenciesUs[uiFrame] = (uint32)elapsed.count();
+    frameJobs.FreeList();
+    frameJobs.Init(numFrameJobs);
+  }
+
+  WaitOnJobCounter(&backgroundCounter, true);
+  backgroundJobs.FreeList();
+
+  MergeSort(g_jobprioLatenciesUs, g_jobprioNumFrames, CompareLessThan_uint32);
+  return g_jobprioLatenciesUs[g_jobprioNumFrames * 99 / 100] / 1000.0;
+}
+
+double BM_FrameJobsNoLoadP99Ms()
+{
+  return BM_FrameJobsP99Ms(JobPriority::eFrameCritical, g_jobprioNoBackground);
+}
+
+double BM_FrameJobsSamePriorityP99Ms()
+{
+  return BM_FrameJobsP99Ms(JobPriority::eNormal, JobPriority::eNormal);
+}
+
+double BM_FrameJobsPriorityLanesP99Ms()
+{
+  return BM_FrameJobsP99Ms(JobPriority::eFrameCritical, JobPriority::eBackground);
+}
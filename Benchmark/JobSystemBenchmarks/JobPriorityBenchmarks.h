@@ -0,0 +1,11 @@
+#include "CoreDefines.h"
+
+// Frame job latency under background load
+// Each frame the main thread submits a batch of short jobs and times how long until
+// they're all done, while 2 ms background jobs are kept queued for every worker. Each
+// returns the 99th percentile over all frames in ms.
+void BM_jobprio_Startup(uint32 numWorkers);
+void BM_jobprio_Shutdown();
+double BM_FrameJobsNoLoadP99Ms(); // nothing else running
+double BM_FrameJobsSamePriorityP99Ms(); // background jobs queued alongside frame jobs
+double BM_FrameJobsPriorityLanesP99Ms(); // background jobs on the background lane
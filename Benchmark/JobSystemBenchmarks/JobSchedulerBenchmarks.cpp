@@ -0,0 +1,161 @@
+#include "JobSchedulerBenchmarks.h"
+#include "DataStructures/RingBuffer.h"
+#include "Mem.h"
+#include "Platform/WorkerThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <emmintrin.h>
+#include <thread>
+
+using namespace Tk;
+using namespace Platform;
+using namespace Core;
+
+const uint32 g_jobsMaxWorkers = 16;
+const uint32 g_jobsNumJobs = 2048;
+const uint32 g_jobsShortUs = 1;
+const uint32 g_jobsLongUs = 10'000;
+const uint32 g_jobsLongEvery = 64; // on average
+
+static uint32 g_jobsNumWorkers = 0;
+static uint32 g_jobsDurationsUs[g_jobsNumJobs] = {};
+static WorkerJob* g_jobs[g_jobsNumJobs] = {};
+
+static void BM_JobsBusyWait(uint32 durationUs)
+{
+  const auto end =
+    std::chrono::steady_clock::now() + std::chrono::microseconds(durationUs);
+  while (std::chrono::steady_clock::now() < end)
+  {
+    _mm_pause();
+  }
+}
+
+void BM_jobs_Startup(uint32 numWorkers)
+{
+  TINKER_ASSERT(numWorkers >= 1 && numWorkers <= g_jobsMaxWorkers);
+  g_jobsNumWorkers = numWorkers;
+  ThreadPool::Startup(numWorkers);
+
+  // Long jobs land at random positions, same sequence every run, so under round robin
+  // some workers get several of them and others none
+  uint32 state = 1234;
+  for (uint32 i = 0; i < g_jobsNumJobs; ++i)
+  {
+    state = state * 1664525 + 1013904223;
+    const bool isLong = (state >> 8) % g_jobsLongEvery == 0;
+    g_jobsDurationsUs[i] = isLong ? g_jobsLongUs : g_jobsShortUs;
+  }
+
+  for (uint32 i = 0; i < g_jobsNumJobs; ++i)
+  {
+    const uint32 durationUs = g_jobsDurationsUs[i];
+    g_jobs[i] = CreateNewThreadJob([=]() { BM_JobsBusyWait(durationUs); });
+  }
+}
+
+void BM_jobs_Shutdown()
+{
+  ThreadPool::Shutdown();
+
+  for (uint32 i = 0; i < g_jobsNumJobs; ++i)
+  {
+    FreeJob(g_jobs[i]);
+    g_jobs[i] = nullptr;
+  }
+}
+
+double BM_JobsIdealMakespanMs()
+{
+  uint64 totalUs = 0;
+  uint32 longestUs = 0;
+  for (uint32 i = 0; i < g_jobsNumJobs; ++i)
+  {
+    totalUs += g_jobsDurationsUs[i];
+    longestUs = Max(longestUs, g_jobsDurationsUs[i]);
+  }
+  return Max((double)totalUs / g_jobsNumWorkers, (double)longestUs) / 1000.0;
+}
+
+static void BM_JobsResetAll()
+{
+  for (uint32 i = 0; i < g_jobsNumJobs; ++i)
+  {
+    g_jobs[i]->m_done = 0;
+  }
+}
+
+static double BM_JobsWaitAllMs(std::chrono::steady_clock::time_point start)
+{
+  for (uint32 i = 0; i < g_jobsNumJobs; ++i)
+  {
+    WaitOnJob(g_jobs[i]);
+  }
+  const std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+// What ThreadPool::EnqueueSingleJob used to do: jobs go round robin into per worker
+// single producer rings and a worker only ever runs its own
+struct BM_RoundRobinWorker
+{
+  alignas(CACHE_LINE) RingBuffer<WorkerJob*> m_jobs;
+  std::thread m_thread;
+};
+
+double BM_JobsMixedRoundRobinMs()
+{
+  BM_RoundRobinWorker workers[g_jobsMaxWorkers];
+  std::atomic<uint32> terminate = 0;
+  for (uint32 i = 0; i < g_jobsNumWorkers; ++i)
+  {
+    workers[i].m_jobs.Init(g_jobsNumJobs);
+    RingBuffer<WorkerJob*>* jobs = &workers[i].m_jobs;
+    workers[i].m_thread = std::thread(
+      [jobs, &terminate]()
+      {
+        while (!terminate.load(std::memory_order_relaxed))
+        {
+          if (jobs->Size())
+          {
+            WorkerJob* job;
+            jobs->Dequeue(&job);
+            (*job)();
+            job->m_done = 1;
+          }
+          else
+          {
+            std::this_thread::yield();
+          }
+        }
+      });
+  }
+
+  BM_JobsResetAll();
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32 i = 0; i < g_jobsNumJobs; ++i)
+  {
+    workers[i % g_jobsNumWorkers].m_jobs.Enqueue(g_jobs[i]);
+  }
+  const double makespanMs = BM_JobsWaitAllMs(start);
+
+  terminate = 1;
+  for (uint32 i = 0; i < g_jobsNumWorkers; ++i)
+  {
+    workers[i].m_thread.join();
+  }
+  return makespanMs;
+}
+
+double BM_JobsMixedWorkStealingMs()
+{
+  BM_JobsResetAll();
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32 i = 0; i < g_jobsNumJobs; ++i)
+  {
+    ThreadPool::EnqueueSingleJob(g_jobs[i]);
+  }
+  return BM_JobsWaitAllMs(start);
+}
@@ -0,0 +1,10 @@
+#include "CoreDefines.h"
+
+// Job scheduler load imbalance benchmarks
+// The main thread submits a batch of mostly 1 us jobs with a few 10 ms ones mixed in
+// and waits for all of them. Each returns the makespan in ms.
+void BM_jobs_Startup(uint32 numWorkers);
+void BM_jobs_Shutdown();
+double BM_JobsIdealMakespanMs(); // total work / workers, or the longest job
+double BM_JobsMixedRoundRobinMs(); // the old round robin pool with per worker rings
+double BM_JobsMixedWorkStealingMs(); // ThreadPool
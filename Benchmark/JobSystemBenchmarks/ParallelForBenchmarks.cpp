@@ -0,0 +1,114 @@
+#include "ParallelForBenchmarks.h"
+#include "Mem.h"
+#include "Platform/ParallelFor.h"
+#include "Platform/WorkerThreadPool.h"
+
+#include <chrono>
+#include <math.h>
+
+using namespace Tk;
+using namespace Platform;
+using namespace Core;
+
+const uint32 g_pforNumElements = 1024 * 1024 * 4;
+const uint32 g_pforNumIterations = 16; // of the transform, per element
+
+static float* g_pforSrc = nullptr;
+static float* g_pforDst = nullptr;
+static volatile float g_pforSink = 0.0f;
+
+void BM_pfor_Startup(uint32 numThreads)
+{
+  // The calling thread helps, so it's one worker short
+  if (numThreads > 1)
+  {
+    ThreadPool::Startup(numThreads - 1);
+  }
+
+  g_pforSrc = (float*)CoreMallocAligned(g_pforNumElements * sizeof(float), CACHE_LINE);
+  g_pforDst = (float*)CoreMallocAligned(g_pforNumElements * sizeof(float), CACHE_LINE);
+  for (uint32 i = 0; i < g_pforNumElements; ++i)
+  {
+    g_pforSrc[i] = (float)(i % 1000) * 0.001f;
+  }
+}
+
+void BM_pfor_Shutdown()
+{
+  if (ThreadPool::NumWorkerThreads())
+  {
+    ThreadPool::Shutdown();
+  }
+
+  CoreFreeAligned(g_pforSrc);
+  CoreFreeAligned(g_pforDst);
+  g_pforSrc = nullptr;
+  g_pforDst = nullptr;
+}
+
+static float BM_PForTransformOne(float x)
+{
+  float y = x;
+  for (uint32 i = 0; i < g_pforNumIterations; ++i)
+  {
+    y = sqrtf(y * y + x) * 0.5f + sinf(y);
+  }
+  return y;
+}
+
+template <typename Func>
+static double BM_PForTimeMs(Func func)
+{
+  const auto start = std::chrono::steady_clock::now();
+  func();
+  const std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+double BM_SerialTransformMs()
+{
+  return BM_PForTimeMs(
+    []()
+    {
+      for (uint32 i = 0; i < g_pforNumElements; ++i)
+      {
+        g_pforDst[i] = BM_PForTransformOne(g_pforSrc[i]);
+      }
+    });
+}
+
+double BM_ParallelForTransformMs()
+{
+  return BM_PForTimeMs(
+    []()
+    {
+      ParallelFor(0, g_pforNumElements, 0,
+                  [](uint32 i) { g_pforDst[i] = BM_PForTransformOne(g_pforSrc[i]); });
+    });
+}
+
+double BM_SerialSumMs()
+{
+  return BM_PForTimeMs(
+    []()
+    {
+      float sum = 0.0f;
+      for (uint32 i = 0; i < g_pforNumElements; ++i)
+      {
+        sum += g_pforSrc[i];
+      }
+      g_pforSink = sum;
+    });
+}
+
+double BM_ParallelReduceSumMs()
+{
+  return BM_PForTimeMs(
+    []()
+    {
+      g_pforSink = ParallelReduce(
+        0, g_pforNumElements, 0, 0.0f, [](uint32 i) { return g_pforSrc[i]; },
+        [](float a, float b) { return a + b; });
+    });
+}
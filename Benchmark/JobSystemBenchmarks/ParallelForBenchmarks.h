@@ -0,0 +1,10 @@
+#include "CoreDefines.h"
+
+// ParallelFor / ParallelReduce scaling benchmarks
+// Same work on 1 to N threads, the calling thread counts as one. Each returns ms.
+void BM_pfor_Startup(uint32 numThreads);
+void BM_pfor_Shutdown();
+double BM_SerialTransformMs();
+double BM_ParallelForTransformMs(); // per element math, a few hundred cycles each
+double BM_SerialSumMs();
+double BM_ParallelReduceSumMs(); // memory bound
@@ -1,6 +1,6 @@
 #include "VectorTypeBenchmarks.h"
 #include "Platform/PlatformGameAPI.h"
-#include "Platform/Win32WorkerThreadPool.h"
+#include "Platform/WorkerThreadPool.h"
 #include <emmintrin.h>
 
 using namespace Tk;
@@ -64,10 +64,13 @@ void BM_m2MulV2_iScalar()
 void BM_m2MulV2_iVectorized()
 {
   alignas(16) v2i v = { 4, 5 };
+  alignas(16) v2i result;
   for (uint32 i = 0; i < 10'000'000; ++i)
   {
     m2i m = { (int32)i, (int32)i + 1, (int32)i + 2, (int32)i + 3 };
-    VectorOps::Mul_SIMD(&v, &m, &v);
+    // The out param is RESTRICT, so it can't alias the input
+    VectorOps::Mul_SIMD(&v, &m, &result);
+    v = result;
   }
 }
 
@@ -129,7 +132,7 @@ void BM_m2MulV2_fScalar_MT_Shutdown()
   BM_v2_Shutdown();
   for (uint32 i = 0; i < numJobs; ++i)
   {
-    Tk::Platform::FreeAlignedRaw(jobs[i]);
+    FreeJob(jobs[i]);
   }
 }
 
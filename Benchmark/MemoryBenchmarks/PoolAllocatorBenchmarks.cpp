@@ -0,0 +1,127 @@
+#include "PoolAllocatorBenchmarks.h"
+#include "Allocators.h"
+#include "Mem.h"
+#include "Platform/PlatformGameAPI.h"
+#include "Platform/WorkerThreadPool.h"
+
+using namespace Tk;
+using namespace Platform;
+using namespace Core;
+
+const uint32 g_poolMaxThreads = 8;
+const uint32 g_poolNumAllocs = 8'000'000;
+const uint32 g_poolWindowSize = 512; // live elements per thread
+
+struct BM_PoolEle
+{
+  uint64 m_data[4];
+};
+
+static PoolAllocator<BM_PoolEle>* g_pool = nullptr;
+
+struct alignas(CACHE_LINE) BM_PoolThreadResult
+{
+  uint64 m_sum;
+};
+static BM_PoolThreadResult g_poolResults[g_poolMaxThreads] = {};
+
+void BM_pool_Startup()
+{
+  ThreadPool::Startup(g_poolMaxThreads - 1);
+
+  // Sized for one thread, so multithreaded runs also measure growing the pool
+  g_pool = new PoolAllocator<BM_PoolEle>();
+  g_pool->Init(g_poolWindowSize, alignof(BM_PoolEle));
+}
+
+void BM_pool_Shutdown()
+{
+  ThreadPool::Shutdown();
+
+  delete g_pool;
+  g_pool = nullptr;
+}
+
+#define BM_POOL_THREAD_FUNC(name) uint64 name(uint32 numAllocs)
+typedef BM_POOL_THREAD_FUNC(BM_PoolThreadFunc);
+
+static BM_POOL_THREAD_FUNC(BM_PoolChurnOneThread)
+{
+  uint32 window[g_poolWindowSize];
+  uint64 sum = 0;
+  for (uint32 i = 0; i < numAllocs; i += g_poolWindowSize)
+  {
+    for (uint32 j = 0; j < g_poolWindowSize; ++j)
+    {
+      window[j] = g_pool->Alloc();
+      g_pool->PtrFromHandle(window[j])->m_data[0] = j;
+    }
+    for (uint32 j = 0; j < g_poolWindowSize; ++j)
+    {
+      sum += g_pool->PtrFromHandle(window[j])->m_data[0];
+      g_pool->Dealloc(window[j]);
+    }
+  }
+  return sum;
+}
+
+static BM_POOL_THREAD_FUNC(BM_MallocChurnOneThread)
+{
+  BM_PoolEle* window[g_poolWindowSize];
+  uint64 sum = 0;
+  for (uint32 i = 0; i < numAllocs; i += g_poolWindowSize)
+  {
+    for (uint32 j = 0; j < g_poolWindowSize; ++j)
+    {
+      window[j] = (BM_PoolEle*)CoreMallocAligned(sizeof(BM_PoolEle), alignof(BM_PoolEle));
+      window[j]->m_data[0] = j;
+    }
+    for (uint32 j = 0; j < g_poolWindowSize; ++j)
+    {
+      sum += window[j]->m_data[0];
+      CoreFreeAligned(window[j]);
+    }
+  }
+  return sum;
+}
+
+// Splits g_poolNumAllocs across numThreads jobs, the calling thread runs the first one
+static uint64 BM_PoolRunOnThreads(uint32 numThreads, BM_PoolThreadFunc* ThreadFunc)
+{
+  TINKER_ASSERT(numThreads >= 1 && numThreads <= g_poolMaxThreads);
+  const uint32 allocsPerThread = g_poolNumAllocs / numThreads;
+
+  WorkerJob* jobs[g_poolMaxThreads] = {};
+  for (uint32 i = 0; i < numThreads; ++i)
+  {
+    jobs[i] =
+      CreateNewThreadJob([=]() { g_poolResults[i].m_sum = ThreadFunc(allocsPerThread); });
+  }
+
+  for (uint32 i = 1; i < numThreads; ++i)
+  {
+    ThreadPool::EnqueueSingleJob(jobs[i]);
+  }
+
+  (*jobs[0])();
+  jobs[0]->m_done = 1;
+
+  uint64 sum = 0;
+  for (uint32 i = 0; i < numThreads; ++i)
+  {
+    WaitOnJob(jobs[i]);
+    sum += g_poolResults[i].m_sum;
+    FreeJob(jobs[i]);
+  }
+  return sum;
+}
+
+uint64 BM_PoolAllocChurn(uint32 numThreads)
+{
+  return BM_PoolRunOnThreads(numThreads, BM_PoolChurnOneThread);
+}
+
+uint64 BM_MallocChurn(uint32 numThreads)
+{
+  return BM_PoolRunOnThreads(numThreads, BM_MallocChurnOneThread);
+}
@@ -0,0 +1,9 @@
+#include "CoreDefines.h"
+
+// Pool allocator benchmarks
+// Every thread allocates a window of elements and frees them in batches, the same total
+// number of allocs for every thread count
+void BM_pool_Startup();
+void BM_pool_Shutdown();
+uint64 BM_PoolAllocChurn(uint32 numThreads);
+uint64 BM_MallocChurn(uint32 numThreads); // CoreMallocAligned/CoreFreeAligned
@@ -0,0 +1,200 @@
+#include "TLSFHeapBenchmarks.h"
+#include "Mem.h"
+#include "TLSFHeap.h"
+#include "Platform/WorkerThreadPool.h"
+
+#include <stdlib.h>
+
+using namespace Tk;
+using namespace Platform;
+using namespace Core;
+
+const uint32 g_tlsfMaxThreads = 8;
+const uint32 g_tlsfNumAllocs = 4'000'000;
+const uint32 g_tlsfWindowSize = 512; // live allocations per thread
+const uint32 g_tlsfNumSizes = 4096;
+const size_t g_tlsfPoolSize = 1024 * 1024 * 4;
+
+static uint32 g_tlsfSizes[g_tlsfNumSizes] = {};
+static TLSFHeap* g_tlsfSharedHeap = nullptr;
+static TLSFHeap* g_tlsfThreadHeaps = nullptr;
+
+struct alignas(CACHE_LINE) BM_TLSFThreadResult
+{
+  uint64 m_sum;
+};
+static BM_TLSFThreadResult g_tlsfResults[g_tlsfMaxThreads] = {};
+
+void BM_tlsf_Startup()
+{
+  ThreadPool::Startup(g_tlsfMaxThreads - 1);
+
+  // Mostly small sizes with a long tail, same sequence every run
+  uint32 state = 1234;
+  for (uint32 i = 0; i < g_tlsfNumSizes; ++i)
+  {
+    state = state * 1664525 + 1013904223;
+    const uint32 rand = state >> 8;
+    g_tlsfSizes[i] = (rand & 7) ? 16 + rand % 240 : 16 + rand % 2032;
+  }
+
+  g_tlsfSharedHeap = new TLSFHeap();
+  g_tlsfSharedHeap->Init(g_tlsfPoolSize, g_tlsfPoolSize, true);
+  g_tlsfThreadHeaps = new TLSFHeap[g_tlsfMaxThreads];
+  for (uint32 i = 0; i < g_tlsfMaxThreads; ++i)
+  {
+    g_tlsfThreadHeaps[i].Init(g_tlsfPoolSize, g_tlsfPoolSize, false);
+  }
+}
+
+void BM_tlsf_Shutdown()
+{
+  ThreadPool::Shutdown();
+
+  g_tlsfSharedHeap->Shutdown();
+  delete g_tlsfSharedHeap;
+  g_tlsfSharedHeap = nullptr;
+  for (uint32 i = 0; i < g_tlsfMaxThreads; ++i)
+  {
+    g_tlsfThreadHeaps[i].Shutdown();
+  }
+  delete[] g_tlsfThreadHeaps;
+  g_tlsfThreadHeaps = nullptr;
+}
+
+// Heaps the churn runs against, constructed on the thread that uses them
+struct BM_TLSFSharedHeap
+{
+  explicit BM_TLSFSharedHeap(uint32) {}
+
+  void* Alloc(size_t size)
+  {
+    return g_tlsfSharedHeap->Alloc(size);
+  }
+
+  void Free(void* ptr)
+  {
+    g_tlsfSharedHeap->Free(ptr);
+  }
+};
+
+struct BM_TLSFPerThreadHeap
+{
+  TLSFHeap* m_heap;
+
+  explicit BM_TLSFPerThreadHeap(uint32 threadIndex)
+    : m_heap(&g_tlsfThreadHeaps[threadIndex])
+  {
+  }
+
+  void* Alloc(size_t size)
+  {
+    return m_heap->Alloc(size);
+  }
+
+  void Free(void* ptr)
+  {
+    m_heap->Free(ptr);
+  }
+};
+
+struct BM_CRTHeap
+{
+  explicit BM_CRTHeap(uint32) {}
+
+  void* Alloc(size_t size)
+  {
+    return malloc(size);
+  }
+
+  void Free(void* ptr)
+  {
+    free(ptr);
+  }
+};
+
+// Frees every other allocation in the window and refills it, so the heap sees
+// interleaved holes of different sizes rather than a stack
+template <typename Heap>
+static uint64 BM_TLSFChurnOneThread(uint32 threadIndex, uint32 numAllocs)
+{
+  Heap heap(threadIndex);
+  uint64* window[g_tlsfWindowSize];
+  uint32 sizeIndex = threadIndex * 997;
+  for (uint32 j = 0; j < g_tlsfWindowSize; ++j)
+  {
+    window[j] = (uint64*)heap.Alloc(g_tlsfSizes[sizeIndex++ % g_tlsfNumSizes]);
+    *window[j] = j;
+  }
+
+  uint64 sum = 0;
+  for (uint32 i = g_tlsfWindowSize; i < numAllocs; i += g_tlsfWindowSize / 2)
+  {
+    const uint32 parity = (i / (g_tlsfWindowSize / 2)) & 1;
+    for (uint32 j = parity; j < g_tlsfWindowSize; j += 2)
+    {
+      sum += *window[j];
+      heap.Free(window[j]);
+    }
+    for (uint32 j = parity; j < g_tlsfWindowSize; j += 2)
+    {
+      window[j] = (uint64*)heap.Alloc(g_tlsfSizes[sizeIndex++ % g_tlsfNumSizes]);
+      *window[j] = j;
+    }
+  }
+
+  for (uint32 j = 0; j < g_tlsfWindowSize; ++j)
+  {
+    sum += *window[j];
+    heap.Free(window[j]);
+  }
+  return sum;
+}
+
+// Splits g_tlsfNumAllocs across numThreads jobs, the calling thread runs the first one
+template <typename Heap>
+static uint64 BM_TLSFRunOnThreads(uint32 numThreads)
+{
+  TINKER_ASSERT(numThreads >= 1 && numThreads <= g_tlsfMaxThreads);
+  const uint32 allocsPerThread = g_tlsfNumAllocs / numThreads;
+
+  WorkerJob* jobs[g_tlsfMaxThreads] = {};
+  for (uint32 i = 0; i < numThreads; ++i)
+  {
+    jobs[i] = CreateNewThreadJob([=]() {
+      g_tlsfResults[i].m_sum = BM_TLSFChurnOneThread<Heap>(i, allocsPerThread);
+    });
+  }
+
+  for (uint32 i = 1; i < numThreads; ++i)
+  {
+    ThreadPool::EnqueueSingleJob(jobs[i]);
+  }
+
+  (*jobs[0])();
+  jobs[0]->m_done = 1;
+
+  uint64 sum = 0;
+  for (uint32 i = 0; i < numThreads; ++i)
+  {
+    WaitOnJob(jobs[i]);
+    sum += g_tlsfResults[i].m_sum;
+    FreeJob(jobs[i]);
+  }
+  return sum;
+}
+
+uint64 BM_TLSFSharedChurn(uint32 numThreads)
+{
+  return BM_TLSFRunOnThreads<BM_TLSFSharedHeap>(numThreads);
+}
+
+uint64 BM_TLSFPerThreadChurn(uint32 numThreads)
+{
+  return BM_TLSFRunOnThreads<BM_TLSFPerThreadHeap>(numThreads);
+}
+
+uint64 BM_CRTMallocChurn(uint32 numThreads)
+{
+  return BM_TLSFRunOnThreads<BM_CRTHeap>(numThreads);
+}
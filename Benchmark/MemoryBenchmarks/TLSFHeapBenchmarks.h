@@ -0,0 +1,10 @@
+#include "CoreDefines.h"
+
+// TLSF heap benchmarks
+// Every thread churns a window of mixed size allocations, 16 bytes to 2 KB, the same
+// total number of allocs for every thread count
+void BM_tlsf_Startup();
+void BM_tlsf_Shutdown();
+uint64 BM_TLSFSharedChurn(uint32 numThreads); // one locked heap for all threads
+uint64 BM_TLSFPerThreadChurn(uint32 numThreads); // one unlocked heap per thread
+uint64 BM_CRTMallocChurn(uint32 numThreads); // malloc/free
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "CoreDefines.h"
+#include <chrono>
 #include <iostream>
-#include <windows.h>
 
 #define NUM_SAMPLES 10
 #define SEC_2_MSEC 1000.0
@@ -29,15 +29,13 @@
   {                                                                                      \
     std::cout << str << ":\n";                                                           \
     float timeSamples[NUM_SAMPLES] = {};                                                 \
-    LARGE_INTEGER start = {}, end = {}, freq = {};                                       \
-    QueryPerformanceFrequency(&freq);                                                    \
     for (uint32 i = 0; i < NUM_SAMPLES; ++i)                                             \
     {                                                                                    \
-      QueryPerformanceCounter(&start);                                                   \
+      auto start = std::chrono::steady_clock::now();                                     \
       func();                                                                            \
-      QueryPerformanceCounter(&end);                                                     \
+      auto end = std::chrono::steady_clock::now();                                       \
       timeSamples[i] =                                                                   \
-        (float)(end.QuadPart - start.QuadPart) / ((float)freq.QuadPart * SEC_2_MSEC);    \
+        (float)(std::chrono::duration<double>(end - start).count() * SEC_2_MSEC);        \
     }                                                                                    \
     TINKER_PRINT_STATS(timeSamples);                                                     \
   }
@@ -46,16 +44,14 @@
   {                                                                                      \
     std::cout << str << ":\n";                                                           \
     float timeSamples[NUM_SAMPLES] = {};                                                 \
-    LARGE_INTEGER start = {}, end = {}, freq = {};                                       \
-    QueryPerformanceFrequency(&freq);                                                    \
-    freq.QuadPart = freq.QuadPart / (LONGLONG)SEC_2_MSEC;                                \
     funcSU();                                                                            \
     for (uint32 i = 0; i < NUM_SAMPLES; ++i)                                             \
     {                                                                                    \
-      QueryPerformanceCounter(&start);                                                   \
+      auto start = std::chrono::steady_clock::now();                                     \
       func();                                                                            \
-      QueryPerformanceCounter(&end);                                                     \
-      timeSamples[i] = (float)(end.QuadPart - start.QuadPart) / ((float)freq.QuadPart);  \
+      auto end = std::chrono::steady_clock::now();                                       \
+      timeSamples[i] =                                                                   \
+        (float)(std::chrono::duration<double>(end - start).count() * SEC_2_MSEC);        \
     }                                                                                    \
     funcSD();                                                                            \
     TINKER_PRINT_STATS(timeSamples);                                                     \
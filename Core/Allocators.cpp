@@ -0,0 +1,590 @@
+#include "Allocators.h"
+#include "Platform/PlatformGameAPI.h"
+#include <new>
+#include <string.h>
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Threads get a cache, the same one in every pool, in the order they first touch any
+    // pool. A thread that exits hands its cache back to every pool that is still alive
+    // and frees its index up for the next thread. Only once eSharedThreadCache threads
+    // are alive at the same time do new threads go through the shared cache.
+    static SpinLock g_ThreadCacheLock; // guards everything below
+    static PoolAllocatorBase* g_FirstPool = nullptr;
+    static uint32 g_FreeThreadCacheIndices[PoolAllocatorBase::eSharedThreadCache];
+    static uint32 g_NumFreeThreadCacheIndices = 0;
+    static uint32 g_NextThreadCacheIndex = 0;
+
+    struct ThreadCacheOwner
+    {
+      uint32 m_index = TINKER_INVALID_HANDLE;
+
+      ~ThreadCacheOwner()
+      {
+        if (m_index == TINKER_INVALID_HANDLE
+            || m_index == PoolAllocatorBase::eSharedThreadCache)
+        {
+          return;
+        }
+
+        g_ThreadCacheLock.Lock();
+        for (PoolAllocatorBase* pool = g_FirstPool; pool; pool = pool->m_nextPool)
+        {
+          pool->FlushThreadCache(m_index);
+        }
+        g_FreeThreadCacheIndices[g_NumFreeThreadCacheIndices++] = m_index;
+        g_ThreadCacheLock.Unlock();
+      }
+    };
+    static thread_local ThreadCacheOwner t_ThreadCache;
+
+    static uint32 GetThreadCacheIndex()
+    {
+      uint32 index = t_ThreadCache.m_index;
+      if (index == TINKER_INVALID_HANDLE)
+      {
+        g_ThreadCacheLock.Lock();
+        if (g_NumFreeThreadCacheIndices > 0)
+        {
+          index = g_FreeThreadCacheIndices[--g_NumFreeThreadCacheIndices];
+        }
+        else if (g_NextThreadCacheIndex < PoolAllocatorBase::eSharedThreadCache)
+        {
+          index = g_NextThreadCacheIndex++;
+        }
+        else
+        {
+          index = PoolAllocatorBase::eSharedThreadCache;
+        }
+        g_ThreadCacheLock.Unlock();
+        t_ThreadCache.m_index = index;
+      }
+      return index;
+    }
+
+    TINKER_API void LinearAllocator::ExplicitFree()
+    {
+      if (m_ownedMemPtr)
+      {
+        if (m_isReserved)
+        {
+          Platform::ReleaseAddressSpace(m_ownedMemPtr, Capacity());
+        }
+        else
+        {
+          Tk::Core::CoreFreeAligned(m_ownedMemPtr);
+        }
+        m_ownedMemPtr = nullptr;
+      }
+      m_nextAllocOffset.store(0, std::memory_order_relaxed);
+      m_capacity.store(0, std::memory_order_relaxed);
+      m_committed.store(0, std::memory_order_relaxed);
+      m_highWaterMark.store(0, std::memory_order_relaxed);
+      m_numAllocs.store(0, std::memory_order_relaxed);
+      m_isReserved = false;
+    }
+
+    TINKER_API void LinearAllocator::InitReserved(size_t maxCapacity,
+                                                  uint32 virtualMemFlags)
+    {
+      TINKER_ASSERT(!m_ownedMemPtr);
+      TINKER_ASSERT(maxCapacity > 0);
+      static_assert(ReservedArenaCommitGranularity % Platform::VirtualMemPageSize == 0);
+
+      const size_t capacity = RoundValueToPow2(maxCapacity, ReservedArenaCommitGranularity);
+      m_ownedMemPtr = (uint8*)Platform::ReserveAddressSpace(capacity, virtualMemFlags);
+      TINKER_ASSERT(m_ownedMemPtr);
+      m_capacity.store(capacity, std::memory_order_relaxed);
+      m_committed.store(0, std::memory_order_relaxed);
+      m_nextAllocOffset.store(0, std::memory_order_relaxed);
+      m_isReserved = true;
+    }
+
+    TINKER_API bool LinearAllocator::CommitUpTo(size_t offset)
+    {
+      // Only reserved arenas have less committed than their capacity
+      TINKER_ASSERT(m_isReserved);
+      TINKER_ASSERT(offset <= Capacity());
+
+      const size_t committed = m_committed.load(std::memory_order_relaxed);
+      const size_t step = Min(Max(committed, ReservedArenaCommitGranularity),
+                              ReservedArenaMaxCommitStep);
+      size_t newCommitted = Max(offset, committed + step);
+      newCommitted = RoundValueToPow2(newCommitted, ReservedArenaCommitGranularity);
+      newCommitted = Min(newCommitted, Capacity());
+      if (!Platform::CommitPages(m_ownedMemPtr + committed, newCommitted - committed))
+      {
+        return false;
+      }
+      m_committed.store(newCommitted, std::memory_order_relaxed);
+      return true;
+    }
+
+    TINKER_API void LinearAllocator::DecommitUnused()
+    {
+      if (!m_isReserved)
+      {
+        return;
+      }
+
+      const size_t committed = m_committed.load(std::memory_order_relaxed);
+      const size_t inUse = RoundValueToPow2(Size(), ReservedArenaCommitGranularity);
+      if (inUse < committed)
+      {
+        Platform::DecommitPages(m_ownedMemPtr + inUse, committed - inUse);
+        m_committed.store(inUse, std::memory_order_relaxed);
+      }
+    }
+
+    TINKER_API void ChainedLinearAllocator::Init(size_t blockSize, uint32 alignment)
+    {
+      TINKER_ASSERT(!m_firstBlock);
+      TINKER_ASSERT(blockSize > 0);
+      TINKER_ASSERT(ISPOW2(alignment));
+
+      m_blockSize = blockSize;
+      m_blockAlignment = Max(alignment, (uint32)alignof(Block));
+      m_firstBlock = AllocBlock(blockSize);
+      m_currentBlock = m_firstBlock;
+      m_usedInPrevBlocks = 0;
+      m_used.store(0, std::memory_order_relaxed);
+      m_highWaterMark.store(0, std::memory_order_relaxed);
+      m_numAllocs.store(0, std::memory_order_relaxed);
+    }
+
+    TINKER_API void ChainedLinearAllocator::ExplicitFree()
+    {
+      Block* block = m_firstBlock;
+      while (block)
+      {
+        Block* next = block->m_next;
+        CoreFreeAligned(block);
+        block = next;
+      }
+      m_firstBlock = nullptr;
+      m_currentBlock = nullptr;
+      m_usedInPrevBlocks = 0;
+      m_used.store(0, std::memory_order_relaxed);
+      m_reserved.store(0, std::memory_order_relaxed);
+      m_numBlocks.store(0, std::memory_order_relaxed);
+      m_highWaterMark.store(0, std::memory_order_relaxed);
+      m_numAllocs.store(0, std::memory_order_relaxed);
+    }
+
+    TINKER_API void ChainedLinearAllocator::FreeUnusedBlocks()
+    {
+      if (!m_currentBlock)
+      {
+        return;
+      }
+
+      Block* block = m_currentBlock->m_next;
+      while (block)
+      {
+        Block* next = block->m_next;
+        m_reserved.store(m_reserved.load(std::memory_order_relaxed) - block->m_capacity,
+                         std::memory_order_relaxed);
+        m_numBlocks.store(m_numBlocks.load(std::memory_order_relaxed) - 1,
+                          std::memory_order_relaxed);
+        CoreFreeAligned(block);
+        block = next;
+      }
+      m_currentBlock->m_next = nullptr;
+    }
+
+    ChainedLinearAllocator::Block* ChainedLinearAllocator::AllocBlock(size_t capacity)
+    {
+      // Block header is padded so that the data starts at the block alignment
+      const size_t headerSize =
+        (sizeof(Block) + m_blockAlignment - 1) & ~(size_t)(m_blockAlignment - 1);
+      Block* block =
+        (Block*)CoreMallocAligned(headerSize + capacity, m_blockAlignment);
+      block->m_next = nullptr;
+      block->m_data = (uint8*)block + headerSize;
+      block->m_capacity = capacity;
+      block->m_used = 0;
+      m_reserved.store(m_reserved.load(std::memory_order_relaxed) + block->m_capacity,
+                       std::memory_order_relaxed);
+      m_numBlocks.store(m_numBlocks.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+      return block;
+    }
+
+    TINKER_API uint8* ChainedLinearAllocator::AllocFromNextBlock(size_t size,
+                                                                 uint32 alignment)
+    {
+      // Worst case padding, so whichever block this lands in is sure to fit it
+      const size_t worstCaseSize = size + alignment - 1;
+
+      Block* next = m_currentBlock->m_next;
+      if (!next || next->m_capacity < worstCaseSize)
+      {
+        // Blocks that are too small stay further down the chain for later
+        Block* newBlock = AllocBlock(Max(m_blockSize, worstCaseSize));
+        newBlock->m_next = next;
+        m_currentBlock->m_next = newBlock;
+        next = newBlock;
+      }
+
+      m_usedInPrevBlocks += m_currentBlock->m_used;
+      m_currentBlock = next;
+      m_currentBlock->m_used = 0;
+      return Alloc(size, alignment);
+    }
+
+    // Freed when the thread exits if nobody called ShutdownThreadScratch()
+    static thread_local ChainedLinearAllocator t_threadScratch;
+
+    TINKER_API void InitThreadScratch(size_t blockSize)
+    {
+      if (t_threadScratch.m_isRegistered)
+      {
+        Utility::UnregisterAllocator(&t_threadScratch);
+        t_threadScratch.m_isRegistered = false;
+      }
+      t_threadScratch.ExplicitFree();
+      t_threadScratch.Init(blockSize, CACHE_LINE);
+      Utility::RegisterAllocator(t_threadScratch, "Thread scratch");
+    }
+
+    TINKER_API void ShutdownThreadScratch()
+    {
+      Utility::UnregisterAllocator(&t_threadScratch);
+      t_threadScratch.m_isRegistered = false;
+      t_threadScratch.ExplicitFree();
+    }
+
+    TINKER_API ChainedLinearAllocator& GetThreadScratch()
+    {
+      if (!t_threadScratch.m_firstBlock)
+      {
+        t_threadScratch.Init(ThreadScratchDefaultBlockSize, CACHE_LINE);
+      }
+      return t_threadScratch;
+    }
+
+    TINKER_API PoolAllocatorBase::~PoolAllocatorBase()
+    {
+      // Unregister first, stats can be read from another thread until then
+      if (m_isRegistered)
+      {
+        Utility::UnregisterAllocator(this);
+      }
+      ExplicitFree();
+    }
+
+    TINKER_API void PoolAllocatorBase::Init(uint32 elementsPerPage, uint32 eleSize,
+                                            uint32 eleAlignment)
+    {
+      TINKER_ASSERT(!m_pages);
+      // Only call Init() if you did not provide the number of elements as a template at
+      // compile-time.
+
+      TINKER_ASSERT(elementsPerPage > 0 && elementsPerPage <= eMaxElementsPerPage);
+      TINKER_ASSERT(ISPOW2(eleAlignment));
+
+      uint32 pageSize = eMinElementsPerPage;
+      while (pageSize < elementsPerPage)
+      {
+        pageSize <<= 1;
+      }
+      m_pageShift = CountTrailingZeros32(pageSize);
+      m_pageMask = pageSize - 1;
+
+      // Keeps the element stride a multiple of the alignment
+      m_elementSize = (eleSize + eleAlignment - 1) & ~(eleAlignment - 1);
+      m_elementAlignment = eleAlignment;
+
+      m_pages = (uint8**)CoreMallocAligned(eMaxPages * sizeof(uint8*), alignof(uint8*));
+      memset(m_pages, 0, eMaxPages * sizeof(uint8*));
+      m_batchLinks = (std::atomic<uint32>**)CoreMallocAligned(
+        eMaxPages * sizeof(std::atomic<uint32>*), alignof(std::atomic<uint32>*));
+      memset(m_batchLinks, 0, eMaxPages * sizeof(std::atomic<uint32>*));
+      m_caches = (ThreadCache*)CoreMallocAligned(eMaxThreadCaches * sizeof(ThreadCache),
+                                                 alignof(ThreadCache));
+      for (uint32 i = 0; i < eMaxThreadCaches; ++i)
+      {
+        ThreadCache* cache = new (&m_caches[i]) ThreadCache();
+        cache->m_count.store(0, std::memory_order_relaxed);
+        cache->m_numAllocated.store(0, std::memory_order_relaxed);
+      }
+      m_freeBatches.store(TINKER_INVALID_HANDLE, std::memory_order_relaxed);
+      m_numPages.store(0, std::memory_order_relaxed);
+
+      // First page up front, so a pool sized for its common case never grows
+      m_growLock.Lock();
+      PushBatch(Grow());
+      m_growLock.Unlock();
+
+      // So that exiting threads hand their caches back
+      g_ThreadCacheLock.Lock();
+      m_prevPool = nullptr;
+      m_nextPool = g_FirstPool;
+      if (g_FirstPool)
+      {
+        g_FirstPool->m_prevPool = this;
+      }
+      g_FirstPool = this;
+      g_ThreadCacheLock.Unlock();
+    }
+
+    TINKER_API void PoolAllocatorBase::ExplicitFree()
+    {
+      if (m_pages)
+      {
+        // No exiting thread can be flushing its cache into this pool after this
+        g_ThreadCacheLock.Lock();
+        if (m_prevPool)
+        {
+          m_prevPool->m_nextPool = m_nextPool;
+        }
+        else
+        {
+          g_FirstPool = m_nextPool;
+        }
+        if (m_nextPool)
+        {
+          m_nextPool->m_prevPool = m_prevPool;
+        }
+        m_prevPool = nullptr;
+        m_nextPool = nullptr;
+        g_ThreadCacheLock.Unlock();
+
+        const uint32 numPages = m_numPages.load(std::memory_order_relaxed);
+        for (uint32 i = 0; i < numPages; ++i)
+        {
+          CoreFreeAligned(m_pages[i]);
+          CoreFreeAligned(m_batchLinks[i]);
+        }
+        CoreFreeAligned(m_pages);
+        m_pages = nullptr;
+        CoreFreeAligned(m_batchLinks);
+        m_batchLinks = nullptr;
+
+        for (uint32 i = 0; i < eMaxThreadCaches; ++i)
+        {
+          m_caches[i].~ThreadCache();
+        }
+        CoreFreeAligned(m_caches);
+        m_caches = nullptr;
+
+        m_numPages.store(0, std::memory_order_relaxed);
+        m_freeBatches.store(TINKER_INVALID_HANDLE, std::memory_order_relaxed);
+      }
+    }
+
+    // Treiber stack. The tag in the top 32 bits changes on every push and pop so that a
+    // batch popped and pushed back in between doesn't fool the compare exchange.
+    uint32 PoolAllocatorBase::PopBatch()
+    {
+      uint64 head = m_freeBatches.load(std::memory_order_acquire);
+      while ((uint32)head != TINKER_INVALID_HANDLE)
+      {
+        // May read the link of a batch that another thread already popped and pushed
+        // again. The exchange below fails in that case, since the tag will have changed.
+        const uint32 next = NextBatch((uint32)head).load(std::memory_order_relaxed);
+        const uint64 newHead = (uint64)next | (((head >> 32) + 1) << 32);
+        if (m_freeBatches.compare_exchange_weak(head, newHead, std::memory_order_acquire,
+                                                std::memory_order_acquire))
+        {
+          return (uint32)head;
+        }
+      }
+      return TINKER_INVALID_HANDLE;
+    }
+
+    void PoolAllocatorBase::PushBatch(uint32 firstEle)
+    {
+      uint64 head = m_freeBatches.load(std::memory_order_relaxed);
+      std::atomic<uint32>& nextBatch = NextBatch(firstEle);
+      uint64 newHead;
+      do
+      {
+        nextBatch.store((uint32)head, std::memory_order_relaxed);
+        newHead = (uint64)firstEle | (((head >> 32) + 1) << 32);
+      } while (!m_freeBatches.compare_exchange_weak(head, newHead,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed));
+    }
+
+    // Adds a page, pushes all of it but the first batch to the shared free list and
+    // returns that first batch. Caller holds m_growLock.
+    uint32 PoolAllocatorBase::Grow()
+    {
+      const uint32 pageIndex = m_numPages.load(std::memory_order_relaxed);
+      if (pageIndex == eMaxPages)
+      {
+        TINKER_ASSERT(0);
+        return TINKER_INVALID_HANDLE;
+      }
+
+      const uint32 pageSize = m_pageMask + 1;
+      m_pages[pageIndex] =
+        (uint8*)CoreMallocAligned((size_t)pageSize * m_elementSize, m_elementAlignment);
+      std::atomic<uint32>* links = (std::atomic<uint32>*)CoreMallocAligned(
+        pageSize * sizeof(std::atomic<uint32>), alignof(std::atomic<uint32>));
+      for (uint32 i = 0; i < pageSize; ++i)
+      {
+        new (&links[i]) std::atomic<uint32>(TINKER_INVALID_HANDLE);
+      }
+      m_batchLinks[pageIndex] = links;
+      m_numPages.store(pageIndex + 1, std::memory_order_release);
+
+      const uint32 firstHandle = pageIndex << m_pageShift;
+      for (uint32 batch = 0; batch < pageSize; batch += eBatchSize)
+      {
+        const uint32 batchStart = firstHandle + batch;
+        for (uint32 i = 0; i < eBatchSize - 1; ++i)
+        {
+          NextFreeEle(batchStart + i) = batchStart + i + 1;
+        }
+        NextFreeEle(batchStart + eBatchSize - 1) = TINKER_INVALID_HANDLE;
+
+        if (batch > 0)
+        {
+          PushBatch(batchStart);
+        }
+      }
+      return firstHandle;
+    }
+
+    // Returns the new number of elements in the cache, 0 if the pool is out of pages
+    uint32 PoolAllocatorBase::Refill(ThreadCache& cache)
+    {
+      uint32 ele = PopBatch();
+      if (ele == TINKER_INVALID_HANDLE)
+      {
+        m_growLock.Lock();
+        // Someone else may have grown the pool while this thread waited
+        ele = PopBatch();
+        if (ele == TINKER_INVALID_HANDLE)
+        {
+          ele = Grow();
+        }
+        m_growLock.Unlock();
+      }
+
+      uint32 count = 0;
+      while (ele != TINKER_INVALID_HANDLE)
+      {
+        cache.m_free[count++] = ele;
+        ele = NextFreeEle(ele);
+      }
+      return count;
+    }
+
+    TINKER_API uint32 PoolAllocatorBase::Alloc()
+    {
+      TINKER_ASSERT(m_pages);
+      const uint32 cacheIndex = GetThreadCacheIndex();
+      ThreadCache& cache = m_caches[cacheIndex];
+      if (cacheIndex == eSharedThreadCache)
+      {
+        m_sharedCacheLock.Lock();
+      }
+
+      // Plain loads and stores, only this thread writes to the cache
+      uint32 count = cache.m_count.load(std::memory_order_relaxed);
+      if (count == 0)
+      {
+        count = Refill(cache);
+      }
+
+      uint32 handle = TINKER_INVALID_HANDLE;
+      if (count > 0)
+      {
+        handle = cache.m_free[--count];
+        const int32 numAllocated = cache.m_numAllocated.load(std::memory_order_relaxed);
+        cache.m_numAllocated.store(numAllocated + 1, std::memory_order_relaxed);
+      }
+      cache.m_count.store(count, std::memory_order_relaxed);
+
+      if (cacheIndex == eSharedThreadCache)
+      {
+        m_sharedCacheLock.Unlock();
+      }
+      return handle;
+    }
+
+    TINKER_API void PoolAllocatorBase::Dealloc(uint32 handle)
+    {
+      TINKER_ASSERT((handle >> m_pageShift) < m_numPages.load(std::memory_order_relaxed));
+      const uint32 cacheIndex = GetThreadCacheIndex();
+      ThreadCache& cache = m_caches[cacheIndex];
+      if (cacheIndex == eSharedThreadCache)
+      {
+        m_sharedCacheLock.Lock();
+      }
+
+      uint32 count = cache.m_count.load(std::memory_order_relaxed);
+      if (count == eCacheSize)
+      {
+        // Hand the oldest half back as one batch, keep the recently freed ones
+        for (uint32 i = 0; i < eBatchSize - 1; ++i)
+        {
+          NextFreeEle(cache.m_free[i]) = cache.m_free[i + 1];
+        }
+        NextFreeEle(cache.m_free[eBatchSize - 1]) = TINKER_INVALID_HANDLE;
+        PushBatch(cache.m_free[0]);
+
+        memmove(&cache.m_free[0], &cache.m_free[eBatchSize],
+                (eCacheSize - eBatchSize) * sizeof(uint32));
+        count -= eBatchSize;
+      }
+
+      cache.m_free[count++] = handle;
+      cache.m_count.store(count, std::memory_order_relaxed);
+      const int32 numAllocated = cache.m_numAllocated.load(std::memory_order_relaxed);
+      cache.m_numAllocated.store(numAllocated - 1, std::memory_order_relaxed);
+
+      if (cacheIndex == eSharedThreadCache)
+      {
+        m_sharedCacheLock.Unlock();
+      }
+    }
+
+    // Called by the thread that owned the cache as it exits, with g_ThreadCacheLock held.
+    // The alloc count stays with the cache, for whichever thread gets it next.
+    void PoolAllocatorBase::FlushThreadCache(uint32 cacheIndex)
+    {
+      ThreadCache& cache = m_caches[cacheIndex];
+      const uint32 count = cache.m_count.load(std::memory_order_relaxed);
+      for (uint32 start = 0; start < count; start += eBatchSize)
+      {
+        // The last batch can be short, Refill() takes whatever is linked
+        const uint32 end = Min(start + eBatchSize, count);
+        for (uint32 i = start; i < end - 1; ++i)
+        {
+          NextFreeEle(cache.m_free[i]) = cache.m_free[i + 1];
+        }
+        NextFreeEle(cache.m_free[end - 1]) = TINKER_INVALID_HANDLE;
+        PushBatch(cache.m_free[start]);
+      }
+      cache.m_count.store(0, std::memory_order_relaxed);
+    }
+
+    TINKER_API PoolAllocatorStats PoolAllocatorBase::GetStats() const
+    {
+      PoolAllocatorStats stats = {};
+      if (!m_pages)
+      {
+        return stats;
+      }
+
+      stats.m_numPages = m_numPages.load(std::memory_order_acquire);
+      stats.m_capacity = stats.m_numPages << m_pageShift;
+
+      int64 numAllocated = 0;
+      for (uint32 i = 0; i < eMaxThreadCaches; ++i)
+      {
+        const ThreadCache& cache = m_caches[i];
+        numAllocated += cache.m_numAllocated.load(std::memory_order_relaxed);
+        stats.m_numCachedFree += cache.m_count.load(std::memory_order_relaxed);
+      }
+      stats.m_numAllocated = (uint32)Max(numAllocated, (int64)0);
+      return stats;
+    }
+  } //namespace Core
+} //namespace Tk
@@ -2,58 +2,95 @@
 
 #include "CoreDefines.h"
 #include "Mem.h"
+#include "SpinLock.h"
+#include "Utility/AllocatorRegistry.h"
+#include <atomic>
 
 namespace Tk
 {
   namespace Core
   {
+    // High water mark is the most memory an allocator has had in use at once since Init()
+    struct ArenaStats
+    {
+      size_t m_numBlocks;
+      size_t m_reserved;
+      size_t m_used;
+      size_t m_highWaterMark;
+      size_t m_numAllocs; // since Init()
+    };
+
+    // Reserved arenas commit at least as much again as they already have each time they
+    // grow, up to the max step, so filling one makes few calls into the OS
+    const size_t ReservedArenaCommitGranularity = 1024 * 64;
+    const size_t ReservedArenaMaxCommitStep = 1024 * 1024 * 16;
+
+    // Arenas are only used by one thread at a time. The fields that GetStats() reads are
+    // atomic so that the allocator registry can read them from any thread, but only the
+    // owning thread writes them, with plain relaxed loads and stores.
     struct LinearAllocator
     {
       uint8* m_ownedMemPtr = nullptr;
-      size_t m_capacity = 0;
-      size_t m_nextAllocOffset = 0;
+      std::atomic<size_t> m_capacity = 0;
+      std::atomic<size_t> m_nextAllocOffset = 0;
+      std::atomic<size_t> m_highWaterMark = 0;
+      std::atomic<size_t> m_committed = 0; // same as m_capacity unless reserved
+      std::atomic<size_t> m_numAllocs = 0;
+      bool m_isReserved = false;
+      bool m_isRegistered = false;
+
+      // Everything allocated after taking a marker is freed by rewinding to it
+      typedef size_t Marker;
 
       LinearAllocator() {}
 
       ~LinearAllocator()
       {
-        ExplicitFree();
-      }
-
-      void ExplicitFree()
-      {
-        if (m_ownedMemPtr)
+        // Unregister first, stats can be read from another thread until then
+        if (m_isRegistered)
         {
-          Tk::Core::CoreFreeAligned(m_ownedMemPtr);
-          m_ownedMemPtr = nullptr;
+          Utility::UnregisterAllocator(this);
         }
-        m_nextAllocOffset = 0;
-        m_capacity = 0;
+        ExplicitFree();
       }
 
+      TINKER_API void ExplicitFree();
+
       void Init(size_t capacity, uint32 alignment)
       {
         TINKER_ASSERT(capacity > 0);
         TINKER_ASSERT(alignment > 0);
-        m_capacity = capacity;
-        m_ownedMemPtr = (uint8*)Tk::Core::CoreMallocAligned(m_capacity, alignment);
-        m_nextAllocOffset = 0;
+        m_capacity.store(capacity, std::memory_order_relaxed);
+        m_committed.store(capacity, std::memory_order_relaxed);
+        m_ownedMemPtr = (uint8*)Tk::Core::CoreMallocAligned(capacity, alignment);
+        m_nextAllocOffset.store(0, std::memory_order_relaxed);
       }
 
       void Init(void* existingBuffer, uint32 existingBufferSize)
       {
         TINKER_ASSERT(existingBuffer);
         TINKER_ASSERT(existingBufferSize > 0);
-        m_capacity = existingBufferSize;
+        m_capacity.store(existingBufferSize, std::memory_order_relaxed);
+        m_committed.store(existingBufferSize, std::memory_order_relaxed);
         m_ownedMemPtr = (uint8*)existingBuffer;
-        m_nextAllocOffset = 0;
+        m_nextAllocOffset.store(0, std::memory_order_relaxed);
       }
 
+      // Reserves address space for maxCapacity bytes and only commits it as allocations
+      // reach it, so the capacity can be sized for the worst case. The memory stays
+      // contiguous and page aligned. Flags are Platform::VirtualMemFlags.
+      TINKER_API void InitReserved(size_t maxCapacity, uint32 virtualMemFlags);
+      // Gives back committed pages past the current offset, e.g. after rewinding from a
+      // one-off spike
+      TINKER_API void DecommitUnused();
+      TINKER_API bool CommitUpTo(size_t offset);
+
       uint8* Alloc(size_t size, uint32 alignment)
       {
         TINKER_ASSERT(ISPOW2(alignment));
 
-        size_t memPtrAsNum = (size_t)((uint8*)m_ownedMemPtr + m_nextAllocOffset);
+        const size_t nextAllocOffset = m_nextAllocOffset.load(std::memory_order_relaxed);
+        size_t memPtrAsNum = (size_t)((uint8*)m_ownedMemPtr + nextAllocOffset);
 
         // If the current memory pointer is not aligned, add the alignment as offset
         size_t alignmentBits = LOG2(alignment);
@@ -65,20 +102,43 @@ namespace Tk
 
         // Check that there is room for this size allocation
         size_t allocSize = size + (alignedPtrAsNum - memPtrAsNum);
-        if (allocSize > m_capacity - m_nextAllocOffset)
+        if (allocSize > m_capacity.load(std::memory_order_relaxed) - nextAllocOffset)
         {
           return nullptr; // fail, no assert
         }
+        const size_t allocEnd = nextAllocOffset + allocSize;
+        if (allocEnd > m_committed.load(std::memory_order_relaxed) &&
+            !CommitUpTo(allocEnd))
+        {
+          return nullptr;
+        }
 
         // Return new pointer
         uint8* newAllocPtr = (uint8*)alignedPtrAsNum;
-        m_nextAllocOffset += allocSize;
+        m_nextAllocOffset.store(allocEnd, std::memory_order_relaxed);
+        if (allocEnd > m_highWaterMark.load(std::memory_order_relaxed))
+        {
+          m_highWaterMark.store(allocEnd, std::memory_order_relaxed);
+        }
+        m_numAllocs.store(m_numAllocs.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
         return newAllocPtr;
       }
 
       void ResetState()
       {
-        m_nextAllocOffset = 0;
+        m_nextAllocOffset.store(0, std::memory_order_relaxed);
+      }
+
+      Marker GetMarker() const
+      {
+        return m_nextAllocOffset.load(std::memory_order_relaxed);
+      }
+
+      void RewindTo(Marker marker)
+      {
+        TINKER_ASSERT(marker <= m_nextAllocOffset.load(std::memory_order_relaxed));
+        m_nextAllocOffset.store(marker, std::memory_order_relaxed);
       }
 
       void* Data() const
@@ -88,128 +148,397 @@ namespace Tk
 
       size_t Capacity() const
       {
-        return m_capacity;
+        return m_capacity.load(std::memory_order_relaxed);
       }
 
       size_t Size() const
       {
-        return m_nextAllocOffset;
+        return m_nextAllocOffset.load(std::memory_order_relaxed);
+      }
+
+      // Safe from any thread while the arena is registered
+      ArenaStats GetStats() const
+      {
+        ArenaStats stats = {};
+        stats.m_numBlocks = Capacity() ? 1 : 0;
+        // Capacity() has the reserved address space
+        stats.m_reserved = m_committed.load(std::memory_order_relaxed);
+        stats.m_used = m_nextAllocOffset.load(std::memory_order_relaxed);
+        stats.m_highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+        stats.m_numAllocs = m_numAllocs.load(std::memory_order_relaxed);
+        return stats;
       }
     };
 
-    template <typename T>
-    struct pool_element
+    // Linear allocator that grows instead of failing. Memory comes in blocks that are
+    // chained together, allocations that don't fit in the current block move on to the
+    // next one, and allocations bigger than the block size get a block of their own.
+    // Rewinding keeps the blocks after the marker around for reuse, so an arena that is
+    // reset every frame stops allocating once it has seen its biggest frame. Memory is
+    // not contiguous across blocks, so there is no Data() like LinearAllocator. Like
+    // LinearAllocator, the fields GetStats() reads are atomic and written only by the
+    // owning thread. The blocks are not, so stats never look at them.
+    struct ChainedLinearAllocator
     {
-      union
+      struct Block
       {
-        struct
-        {
-          T m_data;
-        };
+        Block* m_next;
+        uint8* m_data; // follows the header, at the allocator's alignment
+        size_t m_capacity;
+        size_t m_used;
+      };
 
-        struct
-        {
-          uint32 m_nextFreeEleIdx;
-        };
+      struct Marker
+      {
+        Block* m_block;
+        size_t m_used;
+        size_t m_usedInPrevBlocks;
       };
-    };
 
-    template <typename T, uint32 NumElements = 0, uint32 Alignment = 1>
-    struct PoolAllocator
-    {
-      uint32 m_numAllocdElements = 0;
-      uint32 m_maxPoolElements = 0;
-      uint32 m_freeListHead = 0;
+      Block* m_firstBlock = nullptr;
+      Block* m_currentBlock = nullptr;
+      size_t m_blockSize = 0;
+      size_t m_usedInPrevBlocks = 0; // bytes used in the blocks before m_currentBlock
+      std::atomic<size_t> m_used = 0; // m_usedInPrevBlocks + m_currentBlock->m_used
+      std::atomic<size_t> m_reserved = 0;
+      std::atomic<size_t> m_numBlocks = 0;
+      std::atomic<size_t> m_highWaterMark = 0;
+      std::atomic<size_t> m_numAllocs = 0;
+      uint32 m_blockAlignment = 0;
+      bool m_isRegistered = false;
+
+      ChainedLinearAllocator() {}
+
+      ~ChainedLinearAllocator()
+      {
+        // Unregister first, stats can be read from another thread until then
+        if (m_isRegistered)
+        {
+          Utility::UnregisterAllocator(this);
+        }
+        ExplicitFree();
+      }
 
-      template <typename U>
-      using PoolElement = struct pool_element<U>;
-      PoolElement<T>* m_pool = nullptr;
-      uint32 m_elementSizeInBytes = sizeof(PoolElement<T>);
+      ChainedLinearAllocator(const ChainedLinearAllocator& other) = delete;
+      ChainedLinearAllocator& operator=(const ChainedLinearAllocator& other) = delete;
 
-      PoolAllocator()
+      TINKER_API void Init(size_t blockSize, uint32 alignment);
+      TINKER_API void ExplicitFree();
+      // Frees the blocks past the current one, e.g. after a one-off spike
+      TINKER_API void FreeUnusedBlocks();
+
+      uint8* Alloc(size_t size, uint32 alignment)
       {
-        TINKER_ASSERT(ISPOW2(Alignment));
-        if (NumElements > 0)
+        TINKER_ASSERT(ISPOW2(alignment));
+        TINKER_ASSERT(m_currentBlock);
+
+        Block* block = m_currentBlock;
+        const size_t memPtrAsNum = (size_t)(block->m_data + block->m_used);
+        const size_t alignedPtrAsNum =
+          (memPtrAsNum + alignment - 1) & ~(size_t)(alignment - 1);
+        const size_t allocEnd = block->m_used + (alignedPtrAsNum - memPtrAsNum) + size;
+        if (allocEnd > block->m_capacity)
         {
-          Init(NumElements, Alignment);
+          return AllocFromNextBlock(size, alignment);
         }
-        else
+
+        block->m_used = allocEnd;
+        const size_t used = m_usedInPrevBlocks + allocEnd;
+        m_used.store(used, std::memory_order_relaxed);
+        if (used > m_highWaterMark.load(std::memory_order_relaxed))
         {
-          // User must specify alloc'd memory with Init()
+          m_highWaterMark.store(used, std::memory_order_relaxed);
         }
+        m_numAllocs.store(m_numAllocs.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+        return (uint8*)alignedPtrAsNum;
       }
 
-      ~PoolAllocator()
+      Marker GetMarker() const
       {
-        ExplicitFree();
+        TINKER_ASSERT(m_currentBlock);
+        return { m_currentBlock, m_currentBlock->m_used, m_usedInPrevBlocks };
       }
 
-      void ExplicitFree()
+      void RewindTo(const Marker& marker)
       {
-        if (m_pool)
+        m_currentBlock = marker.m_block;
+        m_currentBlock->m_used = marker.m_used;
+        m_usedInPrevBlocks = marker.m_usedInPrevBlocks;
+        m_used.store(marker.m_usedInPrevBlocks + marker.m_used, std::memory_order_relaxed);
+      }
+
+      void ResetState()
+      {
+        if (m_firstBlock)
         {
-          Tk::Core::CoreFreeAligned(m_pool);
-          m_pool = nullptr;
-          m_freeListHead = 0;
-          m_maxPoolElements = 0;
+          RewindTo({ m_firstBlock, 0, 0 });
         }
       }
 
-      inline T* PtrFromHandle(uint32 handle)
+      size_t Size() const
       {
-        return &m_pool[handle].m_data;
+        return m_used.load(std::memory_order_relaxed);
       }
 
-      void Init(uint32 maxPoolElements, size_t alignment)
+      // Safe from any thread while the arena is registered
+      ArenaStats GetStats() const
       {
-        TINKER_ASSERT(m_maxPoolElements == 0);
-        // Only call Init() if you did not provide the number of elements as a template at
-        // compile-time.
+        ArenaStats stats = {};
+        stats.m_numBlocks = m_numBlocks.load(std::memory_order_relaxed);
+        stats.m_reserved = m_reserved.load(std::memory_order_relaxed);
+        stats.m_used = Size();
+        stats.m_highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+        stats.m_numAllocs = m_numAllocs.load(std::memory_order_relaxed);
+        return stats;
+      }
+
+    private:
+      TINKER_API uint8* AllocFromNextBlock(size_t size, uint32 alignment);
+      Block* AllocBlock(size_t capacity);
+    };
+
+    // Rewinds an arena to where it was when the scope was entered
+    template <typename Arena>
+    struct ScopedArenaMarker
+    {
+      Arena& m_arena;
+      typename Arena::Marker m_marker;
 
-        TINKER_ASSERT(maxPoolElements > 0 && maxPoolElements < TINKER_INVALID_HANDLE);
-        m_maxPoolElements = maxPoolElements;
+      explicit ScopedArenaMarker(Arena& arena)
+        : m_arena(arena), m_marker(arena.GetMarker())
+      {
+      }
+
+      ~ScopedArenaMarker()
+      {
+        m_arena.RewindTo(m_marker);
+      }
+
+      ScopedArenaMarker(const ScopedArenaMarker& other) = delete;
+      ScopedArenaMarker& operator=(const ScopedArenaMarker& other) = delete;
+    };
+
+    // One arena per frame in flight for transient per-frame data. BeginFrame() frees
+    // everything that was allocated the last time that frame index was in use, so only
+    // call it once the GPU fence for that frame has signaled.
+    template <uint32 NumFrames>
+    struct FrameArena
+    {
+      ChainedLinearAllocator m_arenas[NumFrames];
+      uint32 m_currentFrame = 0;
 
-        m_pool = (PoolElement<T>*)Tk::Core::CoreMallocAligned(
-          m_maxPoolElements * m_elementSizeInBytes, alignment);
+      void Init(size_t blockSize, uint32 alignment)
+      {
+        for (uint32 i = 0; i < NumFrames; ++i)
+        {
+          m_arenas[i].Init(blockSize, alignment);
+        }
+        m_currentFrame = 0;
+      }
 
-        // Init free list
-        for (uint32 uiEle = 0; uiEle < m_maxPoolElements - 1; ++uiEle)
+      void ExplicitFree()
+      {
+        for (uint32 i = 0; i < NumFrames; ++i)
         {
-          m_pool[uiEle].m_nextFreeEleIdx = uiEle + 1; // point to next element
+          m_arenas[i].ExplicitFree();
         }
-        m_pool[m_maxPoolElements - 1].m_nextFreeEleIdx = TINKER_INVALID_HANDLE;
       }
 
-      uint32 Alloc()
+      void BeginFrame(uint32 frameIndex)
+      {
+        TINKER_ASSERT(frameIndex < NumFrames);
+        m_currentFrame = frameIndex;
+        m_arenas[frameIndex].ResetState();
+      }
+
+      uint8* Alloc(size_t size, uint32 alignment)
+      {
+        return m_arenas[m_currentFrame].Alloc(size, alignment);
+      }
+
+      ChainedLinearAllocator& Current()
+      {
+        return m_arenas[m_currentFrame];
+      }
+
+      ArenaStats GetStats(uint32 frameIndex) const
+      {
+        TINKER_ASSERT(frameIndex < NumFrames);
+        return m_arenas[frameIndex].GetStats();
+      }
+    };
+
+    // Per-thread scratch arena for temporaries that don't outlive the current job. The
+    // thread pool rewinds it after every job and the platform layer rewinds the main
+    // thread's after every frame, so nothing needs a lock or a free. Don't hand out
+    // pointers into it that outlive the job. Threads that weren't set up with
+    // InitThreadScratch() get a default sized arena the first time they ask for one.
+    // Only arenas set up with InitThreadScratch() show up in the allocator registry.
+    const size_t ThreadScratchDefaultBlockSize = 1024 * 1024;
+
+    TINKER_API void InitThreadScratch(size_t blockSize);
+    TINKER_API void ShutdownThreadScratch();
+    TINKER_API ChainedLinearAllocator& GetThreadScratch();
+
+    // Frees whatever was allocated from this thread's scratch arena inside the scope
+    typedef ScopedArenaMarker<ChainedLinearAllocator> ScopedThreadScratch;
+
+    template <typename T>
+    struct pool_element
+    {
+      union
       {
-        if (m_freeListHead == TINKER_INVALID_HANDLE)
+        struct
         {
-          // Pool is full - resize?
-          TINKER_ASSERT(0);
-          return TINKER_INVALID_HANDLE;
+          T m_data;
+        };
+
+        // While the element is free, next element in the same batch. Only read by the
+        // thread that owns the batch.
+        uint32 m_nextFreeEleIdx;
+      };
+    };
+
+    struct PoolAllocatorStats
+    {
+      uint32 m_numPages;
+      uint32 m_capacity;
+      uint32 m_numAllocated;
+      uint32 m_numCachedFree; // free elements sitting in per-thread caches
+    };
+
+    struct ThreadCacheOwner;
+
+    // Type-erased base class - avoid template compilation overhead
+    // Elements are handed out as uint32 handles. Memory comes in pages that are never
+    // moved or freed until the pool is, so the pool grows without invalidating pointers.
+    // Alloc() and Dealloc() are safe from any thread. Each thread works out of its own
+    // small cache of free elements, without locking, and only touches the shared free
+    // list, a lock-free stack of batches, when its cache runs empty or full, or when the
+    // thread exits. Threads past the first eMaxThreadCaches - 1 that are alive at once
+    // share the last cache behind a lock.
+    struct PoolAllocatorBase
+    {
+      enum : uint32
+      {
+        eMaxPages = 1024,
+        eMinElementsPerPage = 64,
+        eMaxElementsPerPage = 1u << 20,
+        eMaxThreadCaches = 64,
+        eSharedThreadCache = eMaxThreadCaches - 1,
+        eBatchSize = 16, // elements moved between a thread cache and the shared list
+        eCacheSize = eBatchSize * 2,
+      };
+
+      TINKER_API ~PoolAllocatorBase();
+
+      TINKER_API uint32 Alloc();
+      TINKER_API void Dealloc(uint32 handle);
+      TINKER_API void ExplicitFree();
+      // Counts are read without stopping other threads, so they are approximate while
+      // other threads are allocating
+      TINKER_API PoolAllocatorStats GetStats() const;
+
+      uint32 ElementSize() const
+      {
+        return m_elementSize;
+      }
+
+      bool m_isRegistered = false;
+
+    protected:
+      // Only written by the owning thread. The counts are atomic so that GetStats() can
+      // read them from any thread.
+      struct alignas(CACHE_LINE) ThreadCache
+      {
+        std::atomic<uint32> m_count;
+        std::atomic<int32> m_numAllocated; // allocs minus deallocs, can go negative
+        uint32 m_free[eCacheSize];
+      };
+
+      uint8** m_pages = nullptr; // eMaxPages entries
+      // Next batch on the shared free list, one entry per element of each page but only
+      // used for the first element of a batch. Kept out of the elements since PopBatch()
+      // can read the link of a batch that another thread has already popped and is
+      // writing to.
+      std::atomic<uint32>** m_batchLinks = nullptr; // eMaxPages entries
+      ThreadCache* m_caches = nullptr;
+      std::atomic<uint64> m_freeBatches = TINKER_INVALID_HANDLE; // index | (tag << 32)
+      std::atomic<uint32> m_numPages = 0;
+      uint32 m_elementSize = 0;
+      uint32 m_elementAlignment = 0;
+      uint32 m_pageShift = 0;
+      uint32 m_pageMask = 0;
+      SpinLock m_growLock;
+      SpinLock m_sharedCacheLock;
+      // Every initialized pool, for exiting threads to flush their caches into
+      PoolAllocatorBase* m_prevPool = nullptr;
+      PoolAllocatorBase* m_nextPool = nullptr;
+
+      uint8* PtrFromHandleRaw(uint32 handle) const
+      {
+        TINKER_ASSERT((handle >> m_pageShift)
+                      < m_numPages.load(std::memory_order_relaxed));
+        return m_pages[handle >> m_pageShift] + (handle & m_pageMask) * m_elementSize;
+      }
+
+      TINKER_API void Init(uint32 elementsPerPage, uint32 eleSize, uint32 eleAlignment);
+
+    private:
+      friend struct ThreadCacheOwner;
+
+      uint32& NextFreeEle(uint32 handle) const
+      {
+        return *(uint32*)PtrFromHandleRaw(handle);
+      }
+
+      std::atomic<uint32>& NextBatch(uint32 handle) const
+      {
+        return m_batchLinks[handle >> m_pageShift][handle & m_pageMask];
+      }
+
+      uint32 PopBatch();
+      void PushBatch(uint32 firstEle);
+      uint32 Grow();
+      uint32 Refill(ThreadCache& cache);
+      void FlushThreadCache(uint32 cacheIndex);
+    };
+
+    // elementsPerPage is the size of each page, so a pool that is sized for its common
+    // case never grows
+    template <typename T, uint32 NumElements = 0, uint32 Alignment = 1>
+    struct PoolAllocator : public PoolAllocatorBase
+    {
+      template <typename U>
+      using PoolElement = struct pool_element<U>;
+
+      PoolAllocator()
+        : PoolAllocatorBase()
+      {
+        TINKER_ASSERT(ISPOW2(Alignment));
+        if (NumElements > 0)
+        {
+          Init(NumElements, Alignment);
         }
         else
         {
-          uint32 newEle = m_freeListHead;
-          m_freeListHead = m_pool[m_freeListHead].m_nextFreeEleIdx;
-          ++m_numAllocdElements;
+          // User must specify alloc'd memory with Init()
+        }
+      }
 
-          if (m_numAllocdElements == m_maxPoolElements)
-          {
-            m_freeListHead = TINKER_INVALID_HANDLE;
-          }
+      PoolAllocator(const PoolAllocator& other) = delete;
+      PoolAllocator& operator=(const PoolAllocator& other) = delete;
 
-          return newEle;
-        }
+      inline T* PtrFromHandle(uint32 handle) const
+      {
+        return &((PoolElement<T>*)PtrFromHandleRaw(handle))->m_data;
       }
 
-      void Dealloc(uint32 handle)
+      void Init(uint32 elementsPerPage, size_t alignment)
       {
-        TINKER_ASSERT(m_numAllocdElements > 0);
-        TINKER_ASSERT(handle < m_maxPoolElements);
-        m_pool[handle].m_nextFreeEleIdx = m_freeListHead;
-        m_freeListHead = handle;
-        --m_numAllocdElements;
+        PoolAllocatorBase::Init(elementsPerPage, sizeof(PoolElement<T>),
+                                Max((uint32)alignment, (uint32)alignof(PoolElement<T>)));
       }
     };
   } //namespace Core
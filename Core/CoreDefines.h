@@ -6,6 +6,10 @@
 #include <math.h>
 #include <stdint.h>
 
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
 #ifdef ASSERTS_ENABLE
   #include <assert.h>
   #define TINKER_ASSERT(cond) assert((cond))
@@ -65,6 +69,51 @@ T LOG2(T x)
   return i - 1;
 }
 
+// Bit scans - undefined for x == 0
+inline uint32 CountTrailingZeros32(uint32 x)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, x);
+  return (uint32)index;
+#else
+  return (uint32)__builtin_ctz(x);
+#endif
+}
+
+inline uint32 CountTrailingZeros64(uint64 x)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return (uint32)index;
+#else
+  return (uint32)__builtin_ctzll(x);
+#endif
+}
+
+inline uint32 CountLeadingZeros32(uint32 x)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse(&index, x);
+  return 31 - (uint32)index;
+#else
+  return (uint32)__builtin_clz(x);
+#endif
+}
+
+inline uint32 CountLeadingZeros64(uint64 x)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse64(&index, x);
+  return 63 - (uint32)index;
+#else
+  return (uint32)__builtin_clzll(x);
+#endif
+}
+
 inline uint32 POW2(uint32 x)
 {
   return 1 << LOG2(x);
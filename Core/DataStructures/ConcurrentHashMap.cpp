@@ -0,0 +1,188 @@
+#include "ConcurrentHashMap.h"
+#include "DataStructures/Vector.h"
+#include "Mem.h"
+
+namespace Tk
+{
+  namespace Core
+  {
+    namespace Epoch
+    {
+      // 0 means the thread is not in a read section, so the global epoch starts at 1
+      struct alignas(CACHE_LINE) ThreadRecord
+      {
+        std::atomic<uint64> m_epoch = 0;
+        std::atomic<uint32> m_inUse = 0;
+      };
+
+      struct RetiredPtr
+      {
+        void* m_ptr;
+        uint64 m_epoch;
+      };
+
+      static ThreadRecord g_ThreadRecords[eMaxThreads];
+      alignas(CACHE_LINE) static std::atomic<uint64> g_GlobalEpoch = 1;
+      // Threads that didn't get a record of their own, while they are in a read section.
+      // The epoch doesn't advance while any of them is reading.
+      alignas(CACHE_LINE) static std::atomic<uint32> g_NumOverflowReaders = 0;
+      // Stands in for a record for threads that found them all taken. Never read.
+      static ThreadRecord g_OverflowRecord;
+
+      static SpinLock g_RetiredLock;
+      static Vector<RetiredPtr> g_Retired;
+
+      // Hands the record back when the thread exits
+      struct ThreadRecordOwner
+      {
+        ThreadRecord* m_record = nullptr;
+
+        ~ThreadRecordOwner()
+        {
+          if (m_record)
+          {
+            m_record->m_inUse.store(0, std::memory_order_release);
+          }
+        }
+      };
+
+      static thread_local ThreadRecordOwner t_RecordOwner;
+
+      // Trivial thread locals so the fast path doesn't go through a TLS init guard
+      static thread_local ThreadRecord* t_Record = nullptr;
+      static thread_local uint32 t_ReadDepth = 0;
+
+      static ThreadRecord* GetThreadRecord()
+      {
+        ThreadRecord* record = t_Record;
+        if (!record)
+        {
+          for (uint32 i = 0; i < eMaxThreads; ++i)
+          {
+            uint32 expected = 0;
+            if (g_ThreadRecords[i].m_inUse.compare_exchange_strong(expected, 1))
+            {
+              record = &g_ThreadRecords[i];
+              t_RecordOwner.m_record = record;
+              break;
+            }
+          }
+          if (!record)
+          {
+            record = &g_OverflowRecord;
+          }
+          t_Record = record;
+        }
+        return record;
+      }
+
+      TINKER_API void EnterRead()
+      {
+        if (t_ReadDepth++ == 0)
+        {
+          ThreadRecord* record = GetThreadRecord();
+          if (record != &g_OverflowRecord)
+          {
+            record->m_epoch.store(g_GlobalEpoch.load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+          }
+          else
+          {
+            g_NumOverflowReaders.fetch_add(1, std::memory_order_relaxed);
+          }
+          // Pairs with the fence in TryAdvance(). Either that sees this thread reading,
+          // or this thread sees every table swap from before the epoch advanced. Without
+          // it, the loads in the read section could be ordered before the store above.
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+      }
+
+      TINKER_API void ExitRead()
+      {
+        TINKER_ASSERT(t_ReadDepth > 0);
+        if (--t_ReadDepth == 0)
+        {
+          ThreadRecord* record = t_Record;
+          if (record != &g_OverflowRecord)
+          {
+            record->m_epoch.store(0, std::memory_order_release);
+          }
+          else
+          {
+            g_NumOverflowReaders.fetch_sub(1, std::memory_order_release);
+          }
+        }
+      }
+
+      // The global epoch can only move forward once every thread in a read section has
+      // seen the current one
+      static bool TryAdvance()
+      {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (g_NumOverflowReaders.load(std::memory_order_acquire) > 0)
+        {
+          return false;
+        }
+        uint64 epoch = g_GlobalEpoch.load(std::memory_order_relaxed);
+        for (uint32 i = 0; i < eMaxThreads; ++i)
+        {
+          const uint64 threadEpoch =
+            g_ThreadRecords[i].m_epoch.load(std::memory_order_acquire);
+          if (threadEpoch != 0 && threadEpoch != epoch)
+          {
+            return false;
+          }
+        }
+        g_GlobalEpoch.compare_exchange_strong(epoch, epoch + 1);
+        return true;
+      }
+
+      TINKER_API void Retire(void* ptr)
+      {
+        g_RetiredLock.Lock();
+        RetiredPtr retired = { ptr, g_GlobalEpoch.load(std::memory_order_relaxed) };
+        g_Retired.PushBackRaw(retired);
+        g_RetiredLock.Unlock();
+
+        Collect();
+      }
+
+      TINKER_API void Collect()
+      {
+        g_RetiredLock.Lock();
+
+        if (g_Retired.Size() > 0)
+        {
+          // Anything retired two epochs ago can't be seen by any reader anymore
+          TryAdvance();
+          TryAdvance();
+          const uint64 epoch = g_GlobalEpoch.load(std::memory_order_relaxed);
+
+          uint32 i = 0;
+          while (i < g_Retired.Size())
+          {
+            if (g_Retired[i].m_epoch + 2 <= epoch)
+            {
+              CoreFreeAligned(g_Retired[i].m_ptr);
+              g_Retired.SwapRemove(i);
+            }
+            else
+            {
+              ++i;
+            }
+          }
+        }
+
+        g_RetiredLock.Unlock();
+      }
+
+      TINKER_API uint32 NumPendingRetired()
+      {
+        g_RetiredLock.Lock();
+        const uint32 numRetired = g_Retired.Size();
+        g_RetiredLock.Unlock();
+        return numRetired;
+      }
+    } //namespace Epoch
+  } //namespace Core
+} //namespace Tk
@@ -0,0 +1,428 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "Mem.h"
+#include "SpinLock.h"
+#include "DataStructures/HashMap.h"
+#include <atomic>
+#include <emmintrin.h>
+#include <string.h>
+#include <type_traits>
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Epoch based reclamation for memory that lock-free readers may still be looking at.
+    // Readers bracket their accesses with EnterRead()/ExitRead(). Retired memory is only
+    // freed once every thread that was reading when it was retired has left its read
+    // section, which takes two advances of the global epoch.
+    namespace Epoch
+    {
+      enum : uint32
+      {
+        // Threads that get a record of their own. Past that, threads share a count of
+        // readers, which is slower and holds up reclamation while any of them reads.
+        eMaxThreads = 64,
+      };
+
+      // Can be nested
+      TINKER_API void EnterRead();
+      TINKER_API void ExitRead();
+
+      // Memory must have come from CoreMallocAligned
+      TINKER_API void Retire(void* ptr);
+
+      // Frees whatever is safe to free. Called on every Retire(), can also be called
+      // periodically, e.g. once per frame.
+      TINKER_API void Collect();
+
+      TINKER_API uint32 NumPendingRetired();
+
+      struct ScopedRead
+      {
+        ScopedRead()
+        {
+          EnterRead();
+        }
+
+        ~ScopedRead()
+        {
+          ExitRead();
+        }
+      };
+    } //namespace Epoch
+
+    // Hashmap that any number of threads can read while other threads write, e.g. name
+    // to handle lookups from asset loading jobs or parallel command recording.
+    // - Find() never takes a lock. Values are read through a per-slot sequence counter
+    //   and retried if a writer was updating the slot at the same time.
+    // - Writers lock one of NumShards shards, picked by the top bits of the hash, so
+    //   writes to different shards don't contend.
+    // - When a shard grows, its new table is built off to the side and swapped in. The
+    //   old table is retired through Epoch so in-flight readers can finish with it.
+    // Meant for read-mostly data. Removed keys leave a tombstone until the next rehash.
+    template <typename tKey, typename tVal, uint32 HashFunc(tKey), uint32 NumShards = 16>
+    struct ConcurrentHashMap
+    {
+    private:
+      static_assert(std::is_trivially_copyable_v<tKey>);
+      static_assert(std::is_trivially_copyable_v<tVal>);
+      static_assert(NumShards > 1 && (NumShards & (NumShards - 1)) == 0);
+
+      enum : uint32
+      {
+        eMinSlotsPerShard = 16,
+      };
+
+      struct Slot
+      {
+        // 0 until the key is published, odd while a writer is changing the value
+        std::atomic<uint32> m_seq;
+        std::atomic<uint32> m_live; // 0 for a tombstone
+        tKey m_key; // never changes once published
+        tVal m_value;
+      };
+
+      struct Table
+      {
+        uint32 m_numSlots;
+        uint32 m_numUsed; // live + tombstones, only touched by writers
+        Slot* Slots()
+        {
+          return (Slot*)((uint8*)this + SlotsOffset());
+        }
+      };
+
+      struct alignas(CACHE_LINE) Shard
+      {
+        std::atomic<Table*> m_table = nullptr;
+        std::atomic<uint32> m_numEntries = 0;
+        SpinLock m_lock;
+      };
+
+      Shard m_shards[NumShards];
+
+      static constexpr uint32 SlotsOffset()
+      {
+        return (uint32)((sizeof(Table) + alignof(Slot) - 1) & ~(alignof(Slot) - 1));
+      }
+
+      static constexpr uint32 ShardShift()
+      {
+        uint32 shift = 32;
+        for (uint32 n = NumShards; n > 1; n >>= 1)
+        {
+          --shift;
+        }
+        return shift;
+      }
+
+      // Max load factor of 3/4, tombstones included
+      static uint32 GrowthLimit(uint32 numSlots)
+      {
+        return numSlots - numSlots / 4;
+      }
+
+      static Table* AllocTable(uint32 numSlots)
+      {
+        const size_t numBytes = SlotsOffset() + (size_t)numSlots * sizeof(Slot);
+        const uint32 alignment = Max((uint32)alignof(Slot), (uint32)CACHE_LINE);
+        Table* table = (Table*)CoreMallocAligned(numBytes, alignment);
+        memset(table, 0, numBytes);
+        table->m_numSlots = numSlots;
+        table->m_numUsed = 0;
+        return table;
+      }
+
+      // Returns the slot holding the key, or the empty slot that ends its probe chain.
+      // Writers only, a reader could see the empty slot get filled with a different key.
+      static Slot* Probe(Table* table, const tKey& key, uint32 hash)
+      {
+        const uint32 mask = table->m_numSlots - 1;
+        Slot* slots = table->Slots();
+        uint32 index = hash & mask;
+        while (1)
+        {
+          Slot* slot = &slots[index];
+          if (slot->m_seq.load(std::memory_order_acquire) == 0 || slot->m_key == key)
+          {
+            return slot;
+          }
+          index = (index + 1) & mask;
+        }
+      }
+
+      // Values can be read while a writer changes them, and the sequence counter throws
+      // those reads away. They still go through relaxed atomics, a word at a time, so
+      // that the overlap isn't a data race.
+      using ValueWord = std::conditional_t<
+        sizeof(tVal) % 8 == 0 && alignof(tVal) >= 8, uint64,
+        std::conditional_t<sizeof(tVal) % 4 == 0 && alignof(tVal) >= 4, uint32, uint8>>;
+
+      static tVal LoadSlotValue(Slot* slot)
+      {
+        ValueWord words[sizeof(tVal) / sizeof(ValueWord)];
+        ValueWord* src = (ValueWord*)&slot->m_value;
+        for (uint32 i = 0; i < ARRAYCOUNT(words); ++i)
+        {
+          words[i] = std::atomic_ref<ValueWord>(src[i]).load(std::memory_order_relaxed);
+        }
+        tVal value;
+        memcpy(&value, words, sizeof(tVal));
+        return value;
+      }
+
+      static void StoreSlotValue(Slot* slot, const tVal& value)
+      {
+        ValueWord words[sizeof(tVal) / sizeof(ValueWord)];
+        memcpy(words, &value, sizeof(tVal));
+        ValueWord* dst = (ValueWord*)&slot->m_value;
+        for (uint32 i = 0; i < ARRAYCOUNT(words); ++i)
+        {
+          std::atomic_ref<ValueWord>(dst[i]).store(words[i], std::memory_order_relaxed);
+        }
+      }
+
+      // Writer side of the sequence counter. Shard lock must be held.
+      static void WriteSlotValue(Slot* slot, const tVal& value, uint32 live)
+      {
+        const uint32 seq = slot->m_seq.load(std::memory_order_relaxed);
+        slot->m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        StoreSlotValue(slot, value);
+        slot->m_live.store(live, std::memory_order_relaxed);
+        slot->m_seq.store(seq + 2, std::memory_order_release);
+      }
+
+      // Shard lock must be held
+      void RehashShard(Shard& shard, uint32 newNumSlots)
+      {
+        Table* oldTable = shard.m_table.load(std::memory_order_relaxed);
+        Table* newTable = AllocTable(newNumSlots);
+
+        if (oldTable)
+        {
+          Slot* oldSlots = oldTable->Slots();
+          for (uint32 i = 0; i < oldTable->m_numSlots; ++i)
+          {
+            Slot& oldSlot = oldSlots[i];
+            if (oldSlot.m_seq.load(std::memory_order_relaxed)
+                && oldSlot.m_live.load(std::memory_order_relaxed))
+            {
+              Slot* slot = Probe(newTable, oldSlot.m_key, HashFunc(oldSlot.m_key));
+              slot->m_key = oldSlot.m_key;
+              slot->m_value = oldSlot.m_value;
+              slot->m_live.store(1, std::memory_order_relaxed);
+              slot->m_seq.store(2, std::memory_order_relaxed);
+              ++newTable->m_numUsed;
+            }
+          }
+        }
+
+        // Publishes all of the slot writes above too
+        shard.m_table.store(newTable, std::memory_order_release);
+
+        if (oldTable)
+        {
+          Epoch::Retire(oldTable);
+        }
+      }
+
+      static uint32 NumSlotsForNumEles(uint32 numEles)
+      {
+        uint32 numSlots = eMinSlotsPerShard;
+        while (GrowthLimit(numSlots) < numEles)
+        {
+          numSlots *= 2;
+        }
+        return numSlots;
+      }
+
+    public:
+      ConcurrentHashMap() {}
+
+      ConcurrentHashMap(const ConcurrentHashMap& other) = delete;
+      ConcurrentHashMap& operator=(const ConcurrentHashMap& other) = delete;
+
+      // No other thread may be using the map anymore
+      ~ConcurrentHashMap()
+      {
+        for (uint32 i = 0; i < NumShards; ++i)
+        {
+          Table* table = m_shards[i].m_table.load(std::memory_order_relaxed);
+          if (table)
+          {
+            CoreFreeAligned(table);
+          }
+        }
+        Epoch::Collect();
+      }
+
+      // Make room for numEles entries, assuming they are spread evenly across the shards
+      void Reserve(uint32 numEles)
+      {
+        const uint32 numSlots = NumSlotsForNumEles((numEles + NumShards - 1) / NumShards);
+        for (uint32 i = 0; i < NumShards; ++i)
+        {
+          Shard& shard = m_shards[i];
+          shard.m_lock.Lock();
+          Table* table = shard.m_table.load(std::memory_order_relaxed);
+          if (!table || table->m_numSlots < numSlots)
+          {
+            RehashShard(shard, numSlots);
+          }
+          shard.m_lock.Unlock();
+        }
+      }
+
+      // Number of entries. Only a snapshot if other threads are writing.
+      uint32 Size() const
+      {
+        uint32 size = 0;
+        for (uint32 i = 0; i < NumShards; ++i)
+        {
+          size += m_shards[i].m_numEntries.load(std::memory_order_relaxed);
+        }
+        return size;
+      }
+
+      // Lock-free. Copies the value out since the slot can change right after.
+      bool Find(tKey key, tVal* outValue) const
+      {
+        const uint32 hash = HashFunc(key);
+        const Shard& shard = m_shards[hash >> ShardShift()];
+
+        bool found = false;
+        Epoch::EnterRead();
+
+        Table* table = shard.m_table.load(std::memory_order_acquire);
+        if (table)
+        {
+          const uint32 mask = table->m_numSlots - 1;
+          Slot* slots = table->Slots();
+          uint32 index = hash & mask;
+          while (1)
+          {
+            Slot* slot = &slots[index];
+            uint32 seq = slot->m_seq.load(std::memory_order_acquire);
+            if (seq == 0)
+            {
+              // End of the probe chain
+              break;
+            }
+
+            if (slot->m_key == key)
+            {
+              while (1)
+              {
+                if (seq & 1)
+                {
+                  _mm_pause();
+                  seq = slot->m_seq.load(std::memory_order_acquire);
+                  continue;
+                }
+
+                const uint32 live = slot->m_live.load(std::memory_order_relaxed);
+                const tVal value = LoadSlotValue(slot);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const uint32 seqAfter = slot->m_seq.load(std::memory_order_relaxed);
+                if (seqAfter == seq)
+                {
+                  found = live != 0;
+                  if (found && outValue)
+                  {
+                    *outValue = value;
+                  }
+                  break;
+                }
+                seq = seqAfter;
+              }
+              break;
+            }
+
+            index = (index + 1) & mask;
+          }
+        }
+
+        Epoch::ExitRead();
+        return found;
+      }
+
+      bool Contains(tKey key) const
+      {
+        return Find(key, nullptr);
+      }
+
+      // Overwrites the value if the key is already present
+      void Insert(tKey key, tVal value)
+      {
+        const uint32 hash = HashFunc(key);
+        Shard& shard = m_shards[hash >> ShardShift()];
+        shard.m_lock.Lock();
+
+        Table* table = shard.m_table.load(std::memory_order_relaxed);
+        Slot* slot = table ? Probe(table, key, hash) : nullptr;
+        if (!slot || (slot->m_seq.load(std::memory_order_relaxed) == 0
+                      && table->m_numUsed + 1 > GrowthLimit(table->m_numSlots)))
+        {
+          // Size for the live entries only, tombstones are dropped by the rehash
+          const uint32 numEntries = shard.m_numEntries.load(std::memory_order_relaxed);
+          RehashShard(shard, NumSlotsForNumEles(numEntries * 2 + 1));
+          table = shard.m_table.load(std::memory_order_relaxed);
+          slot = Probe(table, key, hash);
+        }
+
+        if (slot->m_seq.load(std::memory_order_relaxed) == 0)
+        {
+          // Readers don't look at anything in the slot until the sequence is published
+          slot->m_key = key;
+          slot->m_value = value;
+          slot->m_live.store(1, std::memory_order_relaxed);
+          slot->m_seq.store(2, std::memory_order_release);
+          ++table->m_numUsed;
+          shard.m_numEntries.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+          if (!slot->m_live.load(std::memory_order_relaxed))
+          {
+            shard.m_numEntries.fetch_add(1, std::memory_order_relaxed);
+          }
+          WriteSlotValue(slot, value, 1);
+        }
+
+        shard.m_lock.Unlock();
+      }
+
+      // Returns false if the key wasn't in the map
+      bool Remove(tKey key)
+      {
+        const uint32 hash = HashFunc(key);
+        Shard& shard = m_shards[hash >> ShardShift()];
+        shard.m_lock.Lock();
+
+        bool removed = false;
+        Table* table = shard.m_table.load(std::memory_order_relaxed);
+        if (table)
+        {
+          Slot* slot = Probe(table, key, hash);
+          if (slot->m_seq.load(std::memory_order_relaxed) != 0
+              && slot->m_live.load(std::memory_order_relaxed))
+          {
+            WriteSlotValue(slot, slot->m_value, 0);
+            shard.m_numEntries.fetch_sub(1, std::memory_order_relaxed);
+            removed = true;
+          }
+        }
+
+        shard.m_lock.Unlock();
+        return removed;
+      }
+    };
+
+    // Common concurrent hashmap specializations
+    typedef ConcurrentHashMap<uint32, uint32, MapHashFn32> ConcurrentHashMapU32;
+    typedef ConcurrentHashMap<uint64, uint64, MapHashFn64> ConcurrentHashMapU64;
+  } //namespace Core
+} //namespace Tk
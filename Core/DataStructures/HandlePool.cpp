@@ -0,0 +1,95 @@
+#include "HandlePool.h"
+#include "Mem.h"
+
+namespace Tk
+{
+  namespace Core
+  {
+    TINKER_API HandlePoolBase::~HandlePoolBase()
+    {
+      FreeData();
+    }
+
+    TINKER_API void HandlePoolBase::Init(uint32 maxEles, uint32 eleSize,
+                                         uint32 eleAlignment)
+    {
+      TINKER_ASSERT(m_capacity == 0);
+      TINKER_ASSERT(maxEles > 0 && maxEles <= eMaxElements);
+
+      m_dense = (uint8*)CoreMallocAligned((size_t)maxEles * eleSize, eleAlignment);
+      m_sparse =
+        (SparseSlot*)CoreMallocAligned(maxEles * sizeof(SparseSlot), alignof(SparseSlot));
+      m_denseToSparse =
+        (uint32*)CoreMallocAligned(maxEles * sizeof(uint32), alignof(uint32));
+      m_capacity = maxEles;
+      m_size = 0;
+
+      for (uint32 i = 0; i < maxEles; ++i)
+      {
+        m_sparse[i].m_denseIndexOrNextFree = i + 1;
+        m_sparse[i].m_generation = 0;
+      }
+      m_sparse[maxEles - 1].m_denseIndexOrNextFree = eInvalidHandle;
+      m_freeListHead = 0;
+    }
+
+    TINKER_API void HandlePoolBase::FreeData()
+    {
+      if (m_dense)
+      {
+        CoreFreeAligned(m_dense);
+        CoreFreeAligned(m_sparse);
+        CoreFreeAligned(m_denseToSparse);
+      }
+      m_dense = nullptr;
+      m_sparse = nullptr;
+      m_denseToSparse = nullptr;
+      m_size = 0;
+      m_capacity = 0;
+      m_freeListHead = eInvalidHandle;
+    }
+
+    TINKER_API uint32 HandlePoolBase::AllocSlot()
+    {
+      if (m_freeListHead == eInvalidHandle)
+      {
+        // Pool is full
+        TINKER_ASSERT(0);
+        return eInvalidHandle;
+      }
+
+      const uint32 index = m_freeListHead;
+      SparseSlot& slot = m_sparse[index];
+      m_freeListHead = slot.m_denseIndexOrNextFree;
+
+      const uint32 denseIndex = m_size++;
+      slot.m_denseIndexOrNextFree = denseIndex;
+      m_denseToSparse[denseIndex] = index;
+      return (slot.m_generation << eIndexBits) | index;
+    }
+
+    TINKER_API uint32 HandlePoolBase::FreeSlot(uint32 handle)
+    {
+      const uint32 denseIndex = DenseIndexFromHandle(handle);
+      if (denseIndex == eInvalidHandle)
+      {
+        // Destroying something twice, or a handle from somewhere else
+        TINKER_ASSERT(0);
+        return eInvalidHandle;
+      }
+
+      // The last element gets moved into the freed dense spot
+      const uint32 lastDenseIndex = --m_size;
+      const uint32 lastIndex = m_denseToSparse[lastDenseIndex];
+      m_denseToSparse[denseIndex] = lastIndex;
+      m_sparse[lastIndex].m_denseIndexOrNextFree = denseIndex;
+
+      const uint32 index = IndexFromHandle(handle);
+      SparseSlot& slot = m_sparse[index];
+      slot.m_generation = (slot.m_generation + 1) & eGenerationMask;
+      slot.m_denseIndexOrNextFree = m_freeListHead;
+      m_freeListHead = index;
+      return denseIndex;
+    }
+  } //namespace Core
+} //namespace Tk
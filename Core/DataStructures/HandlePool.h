@@ -0,0 +1,220 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Sparse set with generational handles. A handle packs a slot index with that slot's
+    // generation, which is bumped every time the slot is freed, so a handle to a
+    // destroyed element never resolves to whatever was created in its slot afterwards.
+    // Live elements are packed densely in creation order (modulo swap-removes) for
+    // iteration. Destroying an element moves the last one into its place, so element
+    // pointers are only good until the next Destroy(), handles stay good until their own
+    // element is destroyed.
+    // Type-erased base class - avoid template compilation overhead
+    struct HandlePoolBase
+    {
+      enum : uint32
+      {
+        eIndexBits = 20,
+        eIndexMask = (1u << eIndexBits) - 1,
+        eGenerationMask = (1u << (32 - eIndexBits)) - 1,
+        // Leaves index eIndexMask unused, so TINKER_INVALID_HANDLE never resolves
+        eMaxElements = eIndexMask,
+        eInvalidHandle = TINKER_INVALID_HANDLE,
+      };
+
+      static uint32 IndexFromHandle(uint32 handle)
+      {
+        return handle & eIndexMask;
+      }
+
+      static uint32 GenerationFromHandle(uint32 handle)
+      {
+        return handle >> eIndexBits;
+      }
+
+      TINKER_API ~HandlePoolBase();
+
+      uint32 Size() const
+      {
+        return m_size;
+      }
+
+      uint32 Capacity() const
+      {
+        return m_capacity;
+      }
+
+      bool IsValid(uint32 handle) const
+      {
+        return DenseIndexFromHandle(handle) != eInvalidHandle;
+      }
+
+      // For going from dense iteration back to the element's handle
+      uint32 HandleAtDenseIndex(uint32 denseIndex) const
+      {
+        TINKER_ASSERT(denseIndex < m_size);
+        const uint32 index = m_denseToSparse[denseIndex];
+        return (m_sparse[index].m_generation << eIndexBits) | index;
+      }
+
+    protected:
+      struct SparseSlot
+      {
+        uint32 m_denseIndexOrNextFree;
+        uint32 m_generation;
+      };
+
+      uint8* m_dense;
+      SparseSlot* m_sparse;
+      uint32* m_denseToSparse;
+      uint32 m_size;
+      uint32 m_capacity;
+      uint32 m_freeListHead;
+
+      // eInvalidHandle for stale or garbage handles
+      uint32 DenseIndexFromHandle(uint32 handle) const
+      {
+        const uint32 index = IndexFromHandle(handle);
+        if (index >= m_capacity)
+        {
+          return eInvalidHandle;
+        }
+
+        const SparseSlot& slot = m_sparse[index];
+        if (slot.m_generation != GenerationFromHandle(handle)
+            || slot.m_denseIndexOrNextFree >= m_size
+            || m_denseToSparse[slot.m_denseIndexOrNextFree] != index)
+        {
+          return eInvalidHandle;
+        }
+        return slot.m_denseIndexOrNextFree;
+      }
+
+      TINKER_API void Init(uint32 maxEles, uint32 eleSize, uint32 eleAlignment);
+      TINKER_API void FreeData();
+      // Claims a slot for a new element at dense index Size() - 1, which the caller
+      // constructs. Returns eInvalidHandle when the pool is full.
+      TINKER_API uint32 AllocSlot();
+      // Frees the handle's slot and returns the dense index it occupied. The caller then
+      // moves the element at dense index Size() (the old last element) into that spot.
+      TINKER_API uint32 FreeSlot(uint32 handle);
+    };
+
+    template <typename T>
+    struct HandlePool : public HandlePoolBase
+    {
+    private:
+      T* Dense() const
+      {
+        return (T*)m_dense;
+      }
+
+    public:
+      HandlePool()
+        : HandlePoolBase()
+      {
+        m_dense = nullptr;
+        m_sparse = nullptr;
+        m_denseToSparse = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+        m_freeListHead = eInvalidHandle;
+      }
+
+      HandlePool(const HandlePool& other) = delete;
+      HandlePool& operator=(const HandlePool& other) = delete;
+
+      ~HandlePool()
+      {
+        ExplicitFree();
+      }
+
+      void Init(uint32 maxEles)
+      {
+        HandlePoolBase::Init(maxEles, sizeof(T), alignof(T));
+      }
+
+      void ExplicitFree()
+      {
+        Clear();
+        FreeData();
+      }
+
+      // Destroys every element, outstanding handles all become stale
+      void Clear()
+      {
+        while (m_size > 0)
+        {
+          Destroy(HandleAtDenseIndex(m_size - 1));
+        }
+      }
+
+      template <typename... Args>
+      uint32 Create(Args&&... args)
+      {
+        const uint32 handle = AllocSlot();
+        if (handle != eInvalidHandle)
+        {
+          new (&Dense()[m_size - 1]) T(std::forward<Args>(args)...);
+        }
+        return handle;
+      }
+
+      void Destroy(uint32 handle)
+      {
+        const uint32 denseIndex = FreeSlot(handle);
+        if (denseIndex == eInvalidHandle)
+        {
+          return;
+        }
+
+        T* dense = Dense();
+        if (denseIndex != m_size)
+        {
+          dense[denseIndex] = std::move(dense[m_size]);
+        }
+        dense[m_size].~T();
+      }
+
+      // Returns nullptr for a handle whose element has been destroyed
+      T* PtrFromHandle(uint32 handle) const
+      {
+        const uint32 denseIndex = DenseIndexFromHandle(handle);
+        TINKER_ASSERT(denseIndex != eInvalidHandle);
+        return denseIndex == eInvalidHandle ? nullptr : &Dense()[denseIndex];
+      }
+
+      // Same, but for handles that are allowed to be stale
+      T* TryPtrFromHandle(uint32 handle) const
+      {
+        const uint32 denseIndex = DenseIndexFromHandle(handle);
+        return denseIndex == eInvalidHandle ? nullptr : &Dense()[denseIndex];
+      }
+
+      // Dense iteration over live elements, indices are 0 to Size() - 1
+      T* Data() const
+      {
+        return Dense();
+      }
+
+      T& operator[](uint32 denseIndex)
+      {
+        TINKER_ASSERT(denseIndex < m_size);
+        return Dense()[denseIndex];
+      }
+
+      const T& operator[](uint32 denseIndex) const
+      {
+        TINKER_ASSERT(denseIndex < m_size);
+        return Dense()[denseIndex];
+      }
+    };
+  } //namespace Core
+} //namespace Tk
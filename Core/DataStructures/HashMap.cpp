@@ -8,141 +8,79 @@ namespace Tk
   {
     TINKER_API HashMapBase::~HashMapBase()
     {
-      CoreFree(m_data);
+      FreeTables(m_data);
       m_data = nullptr;
+      m_ctrl = nullptr;
       m_size = 0;
+      m_numEntries = 0;
+      m_growthLeft = 0;
     }
 
-    TINKER_API void HashMapBase::Reserve(uint32 numEles, uint32 dataPairSize)
+    TINKER_API uint8* HashMapBase::AllocTables(uint32 numSlots, uint32 pairSize,
+                                               uint32 pairAlignment)
     {
-      if (numEles > m_size)
-      {
-        const size_t BytesToAllocate = (size_t)numEles * (size_t)dataPairSize;
-        TINKER_ASSERT(BytesToAllocate <= (size_t)MAX_UINT32);
-        void* newData = CoreMalloc(BytesToAllocate);
-
-        if (m_data && m_size > 0)
-        {
-          memcpy(newData, m_data, m_size * dataPairSize);
-          CoreFree(m_data); // free old data
-        }
-
-        m_data = (uint8*)newData;
-
-        // Init all other elements to invalid
-        uint32 numRemainingEles = numEles - m_size;
-        memset(m_data + m_size * dataPairSize, 0xFF, numRemainingEles * dataPairSize);
-
-        m_size = numEles;
-      }
-    }
-
-    TINKER_API void HashMapBase::Clear(size_t dataPairSize)
-    {
-      memset(m_data, eInvalidDataByte, m_size * dataPairSize);
+      TINKER_ASSERT(ISPOW2(numSlots) && numSlots >= HashMapGroup::eWidth);
+      TINKER_ASSERT(numSlots >= m_numEntries);
+
+      // Pairs first so they keep their alignment, then the control bytes
+      const size_t pairBytes = (size_t)numSlots * (size_t)pairSize;
+      const size_t ctrlBytes = (size_t)numSlots + HashMapGroup::eWidth;
+      uint8* newData = (uint8*)CoreMallocAligned(pairBytes + ctrlBytes,
+                                                 Max(pairAlignment, (uint32)CACHE_LINE));
+
+      uint8* oldData = m_data;
+      m_data = newData;
+      m_ctrl = newData + pairBytes;
+      m_size = numSlots;
+      m_growthLeft = GrowthLimit(numSlots);
+      memset(m_ctrl, HashMapCtrl::eEmpty, ctrlBytes);
+
+      return oldData;
     }
 
-    TINKER_API void HashMapBase::ClearEntry(uint32 dataIndex, size_t dataPairSize,
-                                            size_t dataValueOffset)
+    TINKER_API void HashMapBase::FreeTables(uint8* data)
     {
-      const size_t keySize = dataValueOffset;
-      memset(KeyAtIndex(dataIndex, dataPairSize), eInvalidDataByte, keySize);
-
-      const size_t dataSize = dataPairSize - dataValueOffset;
-      memset(DataAtIndex(dataIndex, dataPairSize, dataValueOffset), eInvalidDataByte,
-             dataSize);
-    }
-
-    TINKER_API uint32 HashMapBase::FindIndex(uint32 index, void* key, size_t dataPairSize,
-                                             bool CompareKeysFunc(const void*,
-                                                                  const void*),
-                                             const void* m_InvalidKey) const
-    {
-      if (CompareKeysFunc(key, m_InvalidKey))
+      if (data)
       {
-        return eInvalidIndex;
+        CoreFreeAligned(data);
       }
-
-      uint32 currIndex = index;
-      do
-      {
-        void* dataKey = m_data + currIndex * dataPairSize;
-        if (CompareKeysFunc(dataKey, key))
-        {
-          return currIndex;
-        }
-
-        currIndex = ProbeFunc(currIndex);
-      } while (currIndex != index);
-
-      return eInvalidIndex;
     }
 
-    TINKER_API void* HashMapBase::DataAtIndex(uint32 index, size_t dataPairSize,
-                                              size_t dataValueOffset) const
+    TINKER_API void HashMapBase::Clear()
     {
-      TINKER_ASSERT(index < m_size);
-      return m_data + index * dataPairSize + dataValueOffset;
-    }
-
-    TINKER_API void* HashMapBase::KeyAtIndex(uint32 index, size_t dataPairSize) const
-    {
-      TINKER_ASSERT(index < m_size);
-      return m_data + index * dataPairSize;
-    }
-
-    TINKER_API uint32 HashMapBase::Insert(uint32 index, void* key, void* value,
-                                          bool CompareKeysFunc(const void*, const void*),
-                                          size_t dataPairSize, size_t dataValueOffset,
-                                          size_t dataValueSize, const void* m_InvalidKey)
-    {
-      if (CompareKeysFunc(key, m_InvalidKey))
+      if (m_ctrl)
       {
-        return eInvalidIndex;
+        memset(m_ctrl, HashMapCtrl::eEmpty, m_size + HashMapGroup::eWidth);
       }
-
-      uint32 currIndex = index;
-      do
-      {
-        void* keyToInsertAt = m_data + currIndex * dataPairSize;
-
-        // check if key is marked as invalid (unused) or matches the input key
-        if (CompareKeysFunc(keyToInsertAt, m_InvalidKey)
-            || CompareKeysFunc(keyToInsertAt, key))
-        {
-          // found a slot
-          memcpy(
-            keyToInsertAt, key,
-            dataValueOffset); // write key - assumes that offset is the same as key size
-          memcpy((uint8*)keyToInsertAt + dataValueOffset, value,
-                 dataValueSize); // write value
-          return currIndex;
-        }
-        else
-        {
-          currIndex = ProbeFunc(currIndex);
-        }
-      } while (currIndex != index);
-
-      return eInvalidIndex;
+      m_numEntries = 0;
+      m_growthLeft = m_size ? GrowthLimit(m_size) : 0;
     }
 
-    TINKER_API void HashMapBase::Remove(uint32 index, void* key,
-                                        bool CompareKeysFunc(const void*, const void*),
-                                        size_t dataPairSize, size_t dataValueOffset,
-                                        size_t dataValueSize, const void* m_InvalidKey)
+    TINKER_API void HashMapBase::EraseAtIndex(uint32 index)
     {
-      uint32 dataIndex =
-        FindIndex(index, key, dataPairSize, CompareKeysFunc, m_InvalidKey);
-      if (dataIndex == eInvalidIndex)
+      TINKER_ASSERT(IsSlotOccupied(index));
+      --m_numEntries;
+
+      // If this slot was never part of a full group-width window, no probe sequence can
+      // have skipped past it, so it can go straight back to empty. Otherwise leave a
+      // tombstone so lookups of colliding keys keep probing.
+      const uint32 indexBefore = (index - HashMapGroup::eWidth) & (m_size - 1);
+      const uint32 emptyAfter = HashMapGroup(m_ctrl + index).MatchEmpty();
+      const uint32 emptyBefore = HashMapGroup(m_ctrl + indexBefore).MatchEmpty();
+      const bool wasNeverFull =
+        emptyBefore
+        && emptyAfter
+        && (CountTrailingZeros32(emptyAfter) + (CountLeadingZeros32(emptyBefore) - 16))
+             < HashMapGroup::eWidth;
+
+      if (wasNeverFull)
       {
-        // TODO: should this code path error or not?
-        TINKER_ASSERT(0);
+        SetCtrl(index, HashMapCtrl::eEmpty);
+        ++m_growthLeft;
       }
       else
       {
-        void* data = DataAtIndex(dataIndex, dataPairSize, dataValueOffset);
-        ClearEntry(dataIndex, dataPairSize, dataValueOffset);
+        SetCtrl(index, HashMapCtrl::eDeleted);
       }
     }
   } //namespace Core
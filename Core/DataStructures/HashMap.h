@@ -2,12 +2,13 @@
 
 #include "CoreDefines.h"
 #include "Mem.h"
+#include <string.h>
+#include <type_traits>
 
-template <typename tKey>
-bool CompareKeys(const void* A, const void* B)
-{
-  return *(tKey*)A == *(tKey*)B;
-}
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define TINKER_HASHMAP_SSE2
+  #include <emmintrin.h>
+#endif
 
 // Good hash functions taken from here: https://nullprogram.com/blog/2018/07/31/
 inline uint32 MapHashFn32(uint32 x)
@@ -35,7 +36,83 @@ namespace Tk
 {
   namespace Core
   {
+    // One control byte per slot, Swiss table style. A full slot stores the low 7 bits of
+    // its key's hash (high bit clear), so most non-matching slots are rejected without
+    // ever touching the key.
+    namespace HashMapCtrl
+    {
+      enum : uint8
+      {
+        eEmpty = 0x80,
+        eDeleted = 0xFE,
+      };
+    } //namespace HashMapCtrl
+
+    // A window of control bytes that is scanned at once. Can start at any slot.
+    struct HashMapGroup
+    {
+      enum : uint32
+      {
+        eWidth = 16,
+      };
+
+#ifdef TINKER_HASHMAP_SSE2
+      __m128i m_ctrl;
+
+      explicit HashMapGroup(const uint8* ctrl)
+        : m_ctrl(_mm_loadu_si128((const __m128i*)ctrl))
+      {
+      }
+
+      // Returns a bitmask, one bit per slot in the group
+      uint32 Match(uint8 ctrlByte) const
+      {
+        return (uint32)_mm_movemask_epi8(
+          _mm_cmpeq_epi8(_mm_set1_epi8((char)ctrlByte), m_ctrl));
+      }
+
+      uint32 MatchEmptyOrDeleted() const
+      {
+        // Both special values have the high bit set
+        return (uint32)_mm_movemask_epi8(m_ctrl);
+      }
+#else
+      const uint8* m_ctrl;
+
+      explicit HashMapGroup(const uint8* ctrl)
+        : m_ctrl(ctrl)
+      {
+      }
+
+      uint32 Match(uint8 ctrlByte) const
+      {
+        uint32 mask = 0;
+        for (uint32 i = 0; i < eWidth; ++i)
+        {
+          mask |= (uint32)(m_ctrl[i] == ctrlByte) << i;
+        }
+        return mask;
+      }
+
+      uint32 MatchEmptyOrDeleted() const
+      {
+        uint32 mask = 0;
+        for (uint32 i = 0; i < eWidth; ++i)
+        {
+          mask |= (uint32)(m_ctrl[i] >> 7) << i;
+        }
+        return mask;
+      }
+#endif
+
+      uint32 MatchEmpty() const
+      {
+        return Match(HashMapCtrl::eEmpty);
+      }
+    };
+
     // Open addressing hashmap
+    // Type-erased base owns the tables and everything that only touches control bytes.
     struct HashMapBase
     {
       enum : uint32
@@ -43,67 +120,205 @@ namespace Tk
         eInvalidIndex = MAX_UINT32,
       }; // index, not key
 
-      enum : uint8
+      TINKER_API ~HashMapBase();
+
+      // Number of slots, not number of entries. Iterate over this and check
+      // IsSlotOccupied() to visit every entry.
+      uint32 Capacity() const
+      {
+        return m_size;
+      }
+
+      // Number of entries in the map
+      uint32 Size() const
+      {
+        return m_numEntries;
+      }
+
+      bool IsSlotOccupied(uint32 index) const
       {
-        eInvalidDataByte = 0xFF,
+        TINKER_ASSERT(index < m_size);
+        return (m_ctrl[index] & 0x80) == 0;
+      }
+
+    protected:
+      uint8* m_data; // key/value pairs, control bytes are in the same allocation
+      uint8* m_ctrl; // m_size bytes + a cloned first group so loads can wrap around
+      uint32 m_size; // 0 or a power of 2 >= the group width
+      uint32 m_numEntries;
+      uint32 m_growthLeft; // inserts into empty slots before the next rehash
+
+      static uint32 H1(uint32 hash)
+      {
+        return hash >> 7;
+      }
+
+      static uint8 H2(uint32 hash)
+      {
+        return (uint8)(hash & 0x7F);
+      }
+
+      // Max load factor of 7/8
+      static uint32 GrowthLimit(uint32 numSlots)
+      {
+        return numSlots - numSlots / 8;
+      }
+
+      // Triangular probing over group-sized steps, visits every group when the number of
+      // slots is a power of 2
+      struct ProbeSeq
+      {
+        uint32 m_mask;
+        uint32 m_offset;
+        uint32 m_index;
+
+        ProbeSeq(uint32 hash, uint32 mask)
+          : m_mask(mask), m_offset(hash & mask), m_index(0)
+        {
+        }
+
+        uint32 Offset(uint32 i) const
+        {
+          return (m_offset + i) & m_mask;
+        }
+
+        void Next()
+        {
+          m_index += HashMapGroup::eWidth;
+          m_offset = (m_offset + m_index) & m_mask;
+        }
       };
 
-      TINKER_API ~HashMapBase();
+      void SetCtrl(uint32 index, uint8 ctrlByte)
+      {
+        m_ctrl[index] = ctrlByte;
+        if (index < HashMapGroup::eWidth)
+        {
+          m_ctrl[m_size + index] = ctrlByte;
+        }
+      }
 
-    private:
-      uint32 ProbeFunc(uint32 index) const
+      // First empty or deleted slot in the probe sequence for this hash
+      uint32 FindFirstNonFull(uint32 hash) const
       {
-        return (index + 1) % m_size;
+        ProbeSeq seq(H1(hash), m_size - 1);
+        while (1)
+        {
+          const uint32 mask = HashMapGroup(m_ctrl + seq.m_offset).MatchEmptyOrDeleted();
+          if (mask)
+          {
+            return seq.Offset(CountTrailingZeros32(mask));
+          }
+          seq.Next();
+        }
       }
 
-      TINKER_API void ClearEntry(uint32 dataIndex, size_t dataPairSize,
-                                 size_t dataValueOffset);
+      static uint32 NumSlotsForNumEles(uint32 numEles);
 
-    protected:
-      uint8* m_data;
-      uint32 m_size;
-
-      TINKER_API void Reserve(uint32 numEles, uint32 dataPairSize);
-      TINKER_API void Clear(size_t dataPairSize);
-      TINKER_API uint32 FindIndex(uint32 index, void* key, size_t dataPairSize,
-                                  bool CompareKeysFunc(const void*, const void*),
-                                  const void* m_InvalidKey) const;
-      TINKER_API void* DataAtIndex(uint32 index, size_t dataPairSize,
-                                   size_t dataValueOffset) const;
-      TINKER_API void* KeyAtIndex(uint32 index, size_t dataPairSize) const;
-      TINKER_API uint32 Insert(uint32 index, void* key, void* value,
-                               bool CompareKeysFunc(const void*, const void*),
-                               size_t dataPairSize, size_t dataValueOffset,
-                               size_t dataValueSize, const void* m_InvalidKey);
-      TINKER_API void Remove(uint32 index, void* key,
-                             bool CompareKeysFunc(const void*, const void*),
-                             size_t ePairSize, size_t ePairValOffset, size_t ePairValSize,
-                             const void* m_InvalidKey);
+      // Replaces the current tables with new, all-empty ones. Returns the old pair data so
+      // the caller can reinsert and then free it with FreeTables().
+      TINKER_API uint8* AllocTables(uint32 numSlots, uint32 pairSize, uint32 pairAlignment);
+      TINKER_API void FreeTables(uint8* data);
+      TINKER_API void Clear();
+      TINKER_API void EraseAtIndex(uint32 index);
     };
 
+    inline uint32 HashMapBase::NumSlotsForNumEles(uint32 numEles)
+    {
+      uint32 numSlots = HashMapGroup::eWidth;
+      while (GrowthLimit(numSlots) < numEles)
+      {
+        numSlots *= 2;
+      }
+      return numSlots;
+    }
+
+    // Keys are compared with operator== and both keys and values are moved with memcpy
     template <typename tKey, typename tVal, uint32 HashFunc(tKey)>
     struct HashMap : public HashMapBase
     {
     private:
+      static_assert(std::is_trivially_copyable_v<tKey>);
+      static_assert(std::is_trivially_copyable_v<tVal>);
+
       struct Pair
       {
         tKey key;
         tVal value;
       };
 
-      enum
+      tKey m_InvalidKey;
+
+      Pair* Pairs() const
       {
-        ePairSize = sizeof(Pair),
-        ePairValSize = sizeof(Pair::value),
-        ePairValOffset =
-          sizeof(Pair) - sizeof(Pair::value), // TODO: struct alignment issues?
-      };
+        return (Pair*)m_data;
+      }
 
-      tKey m_InvalidKey;
+      uint32 FindIndexWithHash(const tKey& key, uint32 hash) const
+      {
+        ProbeSeq seq(H1(hash), m_size - 1);
+        const Pair* pairs = Pairs();
+        while (1)
+        {
+          HashMapGroup group(m_ctrl + seq.m_offset);
+          uint32 match = group.Match(H2(hash));
+          while (match)
+          {
+            const uint32 index = seq.Offset(CountTrailingZeros32(match));
+            if (pairs[index].key == key)
+            {
+              return index;
+            }
+            match &= match - 1;
+          }
+
+          // Inserts always take the first non-full slot, so an empty slot ends the chain
+          if (group.MatchEmpty())
+          {
+            return eInvalidIndex;
+          }
+          seq.Next();
+        }
+      }
 
-      uint32 Hash(tKey val, uint32 dataSizeMax) const
+      void Rehash(uint32 newNumSlots)
       {
-        return HashFunc(val) % dataSizeMax;
+        const uint32 oldNumSlots = m_size;
+        const uint8* oldCtrl = m_ctrl;
+        uint8* oldData = AllocTables(newNumSlots, sizeof(Pair), alignof(Pair));
+        const Pair* oldPairs = (const Pair*)oldData;
+
+        Pair* pairs = Pairs();
+        for (uint32 i = 0; i < oldNumSlots; ++i)
+        {
+          if ((oldCtrl[i] & 0x80) == 0)
+          {
+            const uint32 hash = HashFunc(oldPairs[i].key);
+            const uint32 index = FindFirstNonFull(hash);
+            SetCtrl(index, H2(hash));
+            memcpy(&pairs[index], &oldPairs[i], sizeof(Pair));
+          }
+        }
+        m_growthLeft -= m_numEntries;
+
+        FreeTables(oldData);
+      }
+
+      void GrowForInsert()
+      {
+        if (m_size == 0)
+        {
+          Rehash(HashMapGroup::eWidth);
+        }
+        else if (m_numEntries <= GrowthLimit(m_size) / 2)
+        {
+          // Mostly tombstones, clean them up in a table of the same size
+          Rehash(m_size);
+        }
+        else
+        {
+          Rehash(m_size * 2);
+        }
       }
 
     public:
@@ -111,64 +326,114 @@ namespace Tk
         : HashMapBase()
       {
         m_data = nullptr;
+        m_ctrl = nullptr;
         m_size = 0;
+        m_numEntries = 0;
+        m_growthLeft = 0;
         memset(&m_InvalidKey, 0xFF, sizeof(tKey));
       }
 
+      HashMap(const HashMap& other) = delete;
+      HashMap& operator=(const HashMap& other) = delete;
+
       tKey GetInvalidKey() const
       {
         return m_InvalidKey;
       }
 
-      uint32 Size() const
-      {
-        return m_size;
-      }
-
+      // Make room for numEles entries without any rehashing
       void Reserve(uint32 numEles)
       {
-        HashMapBase::Reserve(numEles, ePairSize);
+        const uint32 numSlots = NumSlotsForNumEles(numEles);
+        if (numSlots > m_size)
+        {
+          Rehash(numSlots);
+        }
       }
 
       void Clear()
       {
-        HashMapBase::Clear(ePairSize);
+        HashMapBase::Clear();
       }
 
       uint32 FindIndex(tKey key) const
       {
-        uint32 index = Hash(key, m_size);
-        return HashMapBase::FindIndex(index, &key, ePairSize, CompareKeys<tKey>,
-                                      &m_InvalidKey);
+        if (m_numEntries == 0)
+        {
+          return eInvalidIndex;
+        }
+        return FindIndexWithHash(key, HashFunc(key));
       }
 
       const tKey& KeyAtIndex(uint32 index) const
       {
-        return *(tKey*)HashMapBase::KeyAtIndex(index, ePairSize);
+        TINKER_ASSERT(index < m_size);
+        return Pairs()[index].key;
       }
 
       const tVal& DataAtIndex(uint32 index) const
       {
-        return *(tVal*)HashMapBase::DataAtIndex(index, ePairSize, ePairValOffset);
+        TINKER_ASSERT(index < m_size);
+        return Pairs()[index].value;
       }
 
       tVal& DataAtIndex(uint32 index)
       {
-        return *(tVal*)HashMapBase::DataAtIndex(index, ePairSize, ePairValOffset);
+        TINKER_ASSERT(index < m_size);
+        return Pairs()[index].value;
       }
 
+      // Overwrites the value if the key is already present. May rehash, which invalidates
+      // any previously returned indices.
       uint32 Insert(tKey key, tVal value)
       {
-        uint32 index = Hash(key, m_size);
-        return HashMapBase::Insert(index, &key, &value, CompareKeys<tKey>, ePairSize,
-                                   ePairValOffset, ePairValSize, &m_InvalidKey);
+        if (key == m_InvalidKey)
+        {
+          return eInvalidIndex;
+        }
+
+        uint32 hash = HashFunc(key);
+        if (m_numEntries > 0)
+        {
+          const uint32 existingIndex = FindIndexWithHash(key, hash);
+          if (existingIndex != eInvalidIndex)
+          {
+            Pairs()[existingIndex].value = value;
+            return existingIndex;
+          }
+        }
+
+        uint32 index = m_size ? FindFirstNonFull(hash) : 0;
+        if (m_size == 0 || (m_growthLeft == 0 && m_ctrl[index] == HashMapCtrl::eEmpty))
+        {
+          GrowForInsert();
+          index = FindFirstNonFull(hash);
+        }
+
+        if (m_ctrl[index] == HashMapCtrl::eEmpty)
+        {
+          --m_growthLeft;
+        }
+        SetCtrl(index, H2(hash));
+        Pair& pair = Pairs()[index];
+        pair.key = key;
+        pair.value = value;
+        ++m_numEntries;
+        return index;
       }
 
       void Remove(tKey key)
       {
-        uint32 index = Hash(key, m_size);
-        HashMapBase::Remove(index, &key, CompareKeys<tKey>, ePairSize, ePairValOffset,
-                            ePairValSize, &m_InvalidKey);
+        const uint32 index = FindIndex(key);
+        if (index == eInvalidIndex)
+        {
+          // TODO: should this code path error or not?
+          TINKER_ASSERT(0);
+        }
+        else
+        {
+          EraseAtIndex(index);
+        }
       }
     };
 
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "Mem.h"
+#include <atomic>
+#include <type_traits>
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Bounded multi producer multi consumer queue, fixed capacity (Vyukov).
+    // Every slot has a sequence number saying whose turn it is: a producer may fill
+    // position pos once its slot's sequence is pos, a consumer may empty it once it is
+    // pos + 1. Claiming a position is one CAS on the enqueue or dequeue counter, and
+    // producers and consumers only meet on the slot they hand over.
+    // TryEnqueue() fails when full and TryDequeue() when empty rather than waiting, so
+    // the caller decides whether to spin, sleep or go do something else. The batch
+    // versions claim as many neighbouring slots as are ready with a single CAS.
+    // Unlike RingBuffer any number of threads can be on either end.
+    // T must be trivially copyable, it's meant for pointers, handles and small structs.
+    template <typename T>
+    struct MPMCQueue
+    {
+    private:
+      static_assert(std::is_trivially_copyable_v<T>);
+
+      struct Slot
+      {
+        std::atomic<uint32> m_sequence;
+        T m_data;
+      };
+
+      Slot* m_slots = nullptr;
+      uint32 m_mask = 0;
+
+    public:
+      alignas(CACHE_LINE) std::atomic<uint32> m_enqueuePos = 0;
+      alignas(CACHE_LINE) std::atomic<uint32> m_dequeuePos = 0;
+
+      MPMCQueue() {}
+
+      ~MPMCQueue()
+      {
+        ExplicitFree();
+      }
+
+      // Not thread safe, nothing else can be using the queue
+      void Init(uint32 capacity)
+      {
+        TINKER_ASSERT(capacity > 0 && ISPOW2(capacity));
+        TINKER_ASSERT(capacity <= (1u << 31)); // positions are compared as int32
+        TINKER_ASSERT(!m_slots);
+        m_slots = (Slot*)CoreMallocAligned(capacity * sizeof(Slot), CACHE_LINE);
+        for (uint32 i = 0; i < capacity; ++i)
+        {
+          new (&m_slots[i].m_sequence) std::atomic<uint32>(i);
+        }
+        m_mask = capacity - 1;
+        m_enqueuePos = 0;
+        m_dequeuePos = 0;
+      }
+
+      void ExplicitFree()
+      {
+        if (m_slots)
+        {
+          CoreFreeAligned(m_slots);
+          m_slots = nullptr;
+          m_mask = 0;
+        }
+      }
+
+      uint32 Capacity() const
+      {
+        return m_mask + 1;
+      }
+
+      // Approximate when other threads are using the queue
+      uint32 Size() const
+      {
+        const uint32 dequeuePos = m_dequeuePos.load(std::memory_order_relaxed);
+        const uint32 enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+        const int32 size = (int32)(enqueuePos - dequeuePos);
+        return size > 0 ? Min((uint32)size, Capacity()) : 0;
+      }
+
+      // Returns false if the queue is full
+      bool TryEnqueue(T ele)
+      {
+        return TryEnqueueBatch(&ele, 1) == 1;
+      }
+
+      // Returns false if the queue is empty
+      bool TryDequeue(T* ele)
+      {
+        return TryDequeueBatch(ele, 1) == 1;
+      }
+
+      // Enqueues as many of the numEles in eles as fit right now, in order. Returns how
+      // many, 0 if the queue is full.
+      uint32 TryEnqueueBatch(const T* eles, uint32 numEles)
+      {
+        uint32 pos = m_enqueuePos.load(std::memory_order_relaxed);
+        while (numEles)
+        {
+          const uint32 numReady = NumSlotsReady(pos, 0, numEles);
+          if (numReady == 0)
+          {
+            // The first slot still holds an element from the last time around
+            const uint32 sequence =
+              m_slots[pos & m_mask].m_sequence.load(std::memory_order_acquire);
+            if ((int32)(sequence - pos) < 0)
+            {
+              return 0;
+            }
+            // Another producer claimed it first
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+            continue;
+          }
+
+          if (m_enqueuePos.compare_exchange_weak(pos, pos + numReady,
+                                                 std::memory_order_relaxed))
+          {
+            for (uint32 i = 0; i < numReady; ++i)
+            {
+              Slot* slot = &m_slots[(pos + i) & m_mask];
+              slot->m_data = eles[i];
+              // Publishes the element to the consumer of this position
+              slot->m_sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return numReady;
+          }
+          // pos was reloaded by the failed CAS
+        }
+        return 0;
+      }
+
+      // Dequeues up to maxEles into eles, oldest first. Returns how many, 0 if the
+      // queue is empty.
+      uint32 TryDequeueBatch(T* eles, uint32 maxEles)
+      {
+        uint32 pos = m_dequeuePos.load(std::memory_order_relaxed);
+        while (maxEles)
+        {
+          const uint32 numReady = NumSlotsReady(pos, 1, maxEles);
+          if (numReady == 0)
+          {
+            // The first slot hasn't been filled yet
+            const uint32 sequence =
+              m_slots[pos & m_mask].m_sequence.load(std::memory_order_acquire);
+            if ((int32)(sequence - (pos + 1)) < 0)
+            {
+              return 0;
+            }
+            // Another consumer claimed it first
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+            continue;
+          }
+
+          if (m_dequeuePos.compare_exchange_weak(pos, pos + numReady,
+                                                 std::memory_order_relaxed))
+          {
+            for (uint32 i = 0; i < numReady; ++i)
+            {
+              Slot* slot = &m_slots[(pos + i) & m_mask];
+              eles[i] = slot->m_data;
+              // Hands the slot to the producer one lap ahead
+              slot->m_sequence.store(pos + i + Capacity(), std::memory_order_release);
+            }
+            return numReady;
+          }
+        }
+        return 0;
+      }
+
+    private:
+      // How many slots from pos on are ready for this side, a slot is ready once its
+      // sequence is its position plus sequenceOffset. Only slots nobody else can touch
+      // until pos is claimed count, so a successful CAS from pos owns them all.
+      uint32 NumSlotsReady(uint32 pos, uint32 sequenceOffset, uint32 maxSlots) const
+      {
+        uint32 numReady = 0;
+        while (numReady < maxSlots)
+        {
+          const uint32 slotPos = pos + numReady;
+          const uint32 sequence =
+            m_slots[slotPos & m_mask].m_sequence.load(std::memory_order_acquire);
+          if (sequence != slotPos + sequenceOffset)
+          {
+            break;
+          }
+          ++numReady;
+        }
+        return numReady;
+      }
+    };
+  } //namespace Core
+} //namespace Tk
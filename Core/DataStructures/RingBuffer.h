@@ -51,9 +51,9 @@ namespace Tk
         }
       }
 
-      void Init(uint32 size)
+      void Init(uint32 initSize)
       {
-        _SIZE = POW2_ROUNDUP(size);
+        _SIZE = POW2_ROUNDUP(initSize);
         _MASK = _SIZE - 1;
         m_data = (T*)Tk::Core::CoreMallocAligned(_SIZE * sizeof(T), CACHE_LINE);
       }
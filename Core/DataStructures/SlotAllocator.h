@@ -0,0 +1,302 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "Mem.h"
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Two level bitmap over up to 64 * 64 slots: one bit per slot, plus a summary word
+    // with one bit per word of slots that has any bit set. Finding the lowest set bit is
+    // two bit scans however full or empty the bitmap is.
+    struct SlotBitmap
+    {
+      enum : uint32
+      {
+        eBitsPerWord = 64,
+        eMaxWords = 64,
+        eMaxSlots = eBitsPerWord * eMaxWords,
+        eInvalidSlot = MAX_UINT32,
+      };
+
+      uint64 m_words[eMaxWords];
+      uint64 m_summary;
+
+      void ClearAll()
+      {
+        for (uint32 uiWord = 0; uiWord < eMaxWords; ++uiWord)
+        {
+          m_words[uiWord] = 0;
+        }
+        m_summary = 0;
+      }
+
+      // Sets slots [0, numSlots)
+      void SetFirstN(uint32 numSlots)
+      {
+        TINKER_ASSERT(numSlots <= eMaxSlots);
+        ClearAll();
+        for (uint32 uiWord = 0; uiWord * eBitsPerWord < numSlots; ++uiWord)
+        {
+          const uint32 numBits =
+            Min(numSlots - uiWord * eBitsPerWord, (uint32)eBitsPerWord);
+          m_words[uiWord] = numBits == eBitsPerWord ? ~0ull : (1ull << numBits) - 1;
+          m_summary |= 1ull << uiWord;
+        }
+      }
+
+      void Set(uint32 slot)
+      {
+        TINKER_ASSERT(slot < eMaxSlots);
+        const uint32 word = slot / eBitsPerWord;
+        m_words[word] |= 1ull << (slot % eBitsPerWord);
+        m_summary |= 1ull << word;
+      }
+
+      void Unset(uint32 slot)
+      {
+        TINKER_ASSERT(slot < eMaxSlots);
+        const uint32 word = slot / eBitsPerWord;
+        m_words[word] &= ~(1ull << (slot % eBitsPerWord));
+        if (!m_words[word])
+        {
+          m_summary &= ~(1ull << word);
+        }
+      }
+
+      bool IsSet(uint32 slot) const
+      {
+        TINKER_ASSERT(slot < eMaxSlots);
+        return (m_words[slot / eBitsPerWord] >> (slot % eBitsPerWord)) & 1;
+      }
+
+      // Lowest set slot, eInvalidSlot if none are set
+      uint32 FindFirst() const
+      {
+        if (!m_summary)
+        {
+          return eInvalidSlot;
+        }
+        const uint32 word = CountTrailingZeros64(m_summary);
+        return word * eBitsPerWord + CountTrailingZeros64(m_words[word]);
+      }
+    };
+
+    // Hands out slot indices in [0, capacity), always the lowest free one so that the
+    // used indices stay packed at the front
+    struct SlotAllocator
+    {
+      enum : uint32
+      {
+        eMaxSlots = SlotBitmap::eMaxSlots,
+        eInvalidSlot = SlotBitmap::eInvalidSlot,
+      };
+
+      SlotBitmap m_free;
+      uint32 m_capacity = 0;
+      uint32 m_numAllocated = 0;
+
+      void Init(uint32 capacity)
+      {
+        TINKER_ASSERT(capacity <= eMaxSlots);
+        m_free.SetFirstN(capacity);
+        m_capacity = capacity;
+        m_numAllocated = 0;
+      }
+
+      // eInvalidSlot when every slot is in use
+      uint32 Alloc()
+      {
+        const uint32 slot = m_free.FindFirst();
+        if (slot != eInvalidSlot)
+        {
+          m_free.Unset(slot);
+          ++m_numAllocated;
+        }
+        return slot;
+      }
+
+      void Free(uint32 slot)
+      {
+        TINKER_ASSERT(IsAllocated(slot));
+        m_free.Set(slot);
+        --m_numAllocated;
+      }
+
+      bool IsAllocated(uint32 slot) const
+      {
+        return slot < m_capacity && !m_free.IsSet(slot);
+      }
+
+      uint32 NumAllocated() const
+      {
+        return m_numAllocated;
+      }
+
+      uint32 Capacity() const
+      {
+        return m_capacity;
+      }
+    };
+
+    // Slots with stable indices whose values are mirrored into NumCopies copies, where a
+    // copy can only be updated while nothing is reading it, e.g. a bindless descriptor
+    // array per frame in flight. Setting a slot marks it dirty in every copy, and each
+    // copy's Flush() hands back only its dirty slots, so a frame where nothing changed
+    // writes nothing. A freed slot goes back to the fallback value right away, but its
+    // index only gets handed out again once the same copy comes around, i.e. once every
+    // frame that might still read it has retired.
+    template <uint32 NumCopies>
+    struct MirroredSlotTable
+    {
+      SlotAllocator m_allocator;
+      SlotBitmap m_dirty[NumCopies];
+      SlotBitmap m_pendingFree[NumCopies];
+      uint32* m_values = nullptr;
+      uint32 m_fallbackValue = 0;
+      uint32 m_currentCopy = 0;
+
+      MirroredSlotTable()
+      {
+      }
+
+      MirroredSlotTable(const MirroredSlotTable& other) = delete;
+      MirroredSlotTable& operator=(const MirroredSlotTable& other) = delete;
+
+      ~MirroredSlotTable()
+      {
+        ExplicitFree();
+      }
+
+      // Every slot starts out dirty in every copy, so each copy's first Flush() fills the
+      // whole thing with fallbackValue
+      void Init(uint32 capacity, uint32 fallbackValue)
+      {
+        ExplicitFree();
+        m_allocator.Init(capacity);
+        m_values = (uint32*)CoreMallocAligned(capacity * sizeof(uint32), CACHE_LINE);
+        for (uint32 i = 0; i < capacity; ++i)
+        {
+          m_values[i] = fallbackValue;
+        }
+        for (uint32 uiCopy = 0; uiCopy < NumCopies; ++uiCopy)
+        {
+          m_dirty[uiCopy].SetFirstN(capacity);
+          m_pendingFree[uiCopy].ClearAll();
+        }
+        m_fallbackValue = fallbackValue;
+        m_currentCopy = 0;
+      }
+
+      void ExplicitFree()
+      {
+        CoreFreeAligned(m_values);
+        m_values = nullptr;
+      }
+
+      // Call at the start of a frame, once the last frame that used copyIndex has
+      // retired. Slots freed back then can now be handed out again.
+      void BeginFrame(uint32 copyIndex)
+      {
+        TINKER_ASSERT(copyIndex < NumCopies);
+        m_currentCopy = copyIndex;
+        SlotBitmap& pendingFree = m_pendingFree[copyIndex];
+        for (uint32 slot = pendingFree.FindFirst(); slot != SlotBitmap::eInvalidSlot;
+             slot = pendingFree.FindFirst())
+        {
+          pendingFree.Unset(slot);
+          m_allocator.Free(slot);
+        }
+      }
+
+      // Returns the new slot, or SlotAllocator::eInvalidSlot if the table is full
+      uint32 Alloc(uint32 value)
+      {
+        const uint32 slot = m_allocator.Alloc();
+        if (slot != SlotAllocator::eInvalidSlot)
+        {
+          Set(slot, value);
+        }
+        return slot;
+      }
+
+      void Set(uint32 slot, uint32 value)
+      {
+        TINKER_ASSERT(m_allocator.IsAllocated(slot));
+        if (m_values[slot] != value)
+        {
+          m_values[slot] = value;
+          for (uint32 uiCopy = 0; uiCopy < NumCopies; ++uiCopy)
+          {
+            m_dirty[uiCopy].Set(slot);
+          }
+        }
+      }
+
+      // Rewrites the slot in every copy even though its value is the same, e.g. when
+      // whatever the value refers to got recreated under the same handle
+      void MarkDirty(uint32 slot)
+      {
+        TINKER_ASSERT(slot < m_allocator.Capacity());
+        for (uint32 uiCopy = 0; uiCopy < NumCopies; ++uiCopy)
+        {
+          m_dirty[uiCopy].Set(slot);
+        }
+      }
+
+      uint32 Get(uint32 slot) const
+      {
+        TINKER_ASSERT(slot < m_allocator.Capacity());
+        return m_values[slot];
+      }
+
+      void Free(uint32 slot)
+      {
+        for (uint32 uiCopy = 0; uiCopy < NumCopies; ++uiCopy)
+        {
+          TINKER_ASSERT(!m_pendingFree[uiCopy].IsSet(slot)); // already freed
+        }
+        Set(slot, m_fallbackValue);
+        m_pendingFree[m_currentCopy].Set(slot);
+      }
+
+      // Writes out the slots that changed since the current copy was last flushed, along
+      // with their values. Both arrays need room for Capacity() entries. Returns how many
+      // were written.
+      uint32 Flush(uint32* dirtySlots, uint32* dirtyValues)
+      {
+        SlotBitmap& dirty = m_dirty[m_currentCopy];
+        uint32 numDirty = 0;
+        uint64 summary = dirty.m_summary;
+        while (summary)
+        {
+          const uint32 uiWord = CountTrailingZeros64(summary);
+          summary &= summary - 1;
+          uint64 word = dirty.m_words[uiWord];
+          while (word)
+          {
+            const uint32 slot =
+              uiWord * SlotBitmap::eBitsPerWord + CountTrailingZeros64(word);
+            dirtySlots[numDirty] = slot;
+            dirtyValues[numDirty] = m_values[slot];
+            ++numDirty;
+            word &= word - 1;
+          }
+        }
+        dirty.ClearAll();
+        return numDirty;
+      }
+
+      uint32 NumAllocated() const
+      {
+        return m_allocator.NumAllocated();
+      }
+
+      uint32 Capacity() const
+      {
+        return m_allocator.Capacity();
+      }
+    };
+  } //namespace Core
+} //namespace Tk
@@ -0,0 +1,120 @@
+#include "SoAVector.h"
+#include "Mem.h"
+#include <string.h>
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Bytes for one column of numEles elements, padded so the next column starts on a
+    // cache line
+    static size_t SoAColumnBytes(uint32 numEles, uint32 eleSize)
+    {
+      const size_t numBytes = (size_t)numEles * eleSize;
+      return (numBytes + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+    }
+
+    SoAVectorBase::~SoAVectorBase()
+    {
+      ExplicitFree();
+    }
+
+    void SoAVectorBase::ExplicitFree()
+    {
+      CoreFreeAligned(m_data);
+      m_data = nullptr;
+      for (uint32 uiCol = 0; uiCol < m_numColumns; ++uiCol)
+      {
+        m_columns[uiCol] = nullptr;
+      }
+      m_size = 0;
+      m_capacity = 0;
+    }
+
+    void SoAVectorBase::Reserve(uint32 numEles)
+    {
+      if (numEles > m_capacity)
+      {
+        FreeOldData(Realloc(numEles));
+      }
+    }
+
+    uint8* SoAVectorBase::Realloc(uint32 numEles)
+    {
+      size_t bytesToAllocate = 0;
+      for (uint32 uiCol = 0; uiCol < m_numColumns; ++uiCol)
+      {
+        bytesToAllocate += SoAColumnBytes(numEles, m_columnEleSizes[uiCol]);
+      }
+      uint8* newData = (uint8*)CoreMallocAligned(bytesToAllocate, CACHE_LINE);
+      TINKER_ASSERT(newData);
+
+      uint8* column = newData;
+      for (uint32 uiCol = 0; uiCol < m_numColumns; ++uiCol)
+      {
+        const uint32 eleSize = m_columnEleSizes[uiCol];
+        if (m_size > 0)
+        {
+          memcpy(column, m_columns[uiCol], (size_t)m_size * eleSize);
+        }
+        m_columns[uiCol] = column;
+        column += SoAColumnBytes(numEles, eleSize);
+      }
+
+      uint8* oldData = m_data;
+      m_data = newData;
+      m_capacity = numEles;
+      return oldData;
+    }
+
+    uint8* SoAVectorBase::Grow(uint32 minNumEles)
+    {
+      // Double the capacity so that N push backs are amortized O(N)
+      const uint64 newCapacity = Max((uint64)m_capacity * 2, (uint64)minNumEles);
+      TINKER_ASSERT(newCapacity <= (uint64)MAX_UINT32);
+      return Realloc((uint32)newCapacity);
+    }
+
+    void SoAVectorBase::FreeOldData(uint8* oldData)
+    {
+      CoreFreeAligned(oldData);
+    }
+
+    void SoAVectorBase::Resize(uint32 numEles)
+    {
+      Reserve(numEles);
+      if (m_size < numEles)
+      {
+        // Set new elements to 0
+        for (uint32 uiCol = 0; uiCol < m_numColumns; ++uiCol)
+        {
+          const uint32 eleSize = m_columnEleSizes[uiCol];
+          memset(m_columns[uiCol] + (size_t)m_size * eleSize, 0,
+                 (size_t)(numEles - m_size) * eleSize);
+        }
+      }
+      m_size = numEles;
+    }
+
+    void SoAVectorBase::Clear()
+    {
+      m_size = 0;
+    }
+
+    void SoAVectorBase::SwapRemove(uint32 index)
+    {
+      TINKER_ASSERT(index < m_size);
+      const uint32 lastIndex = m_size - 1;
+      if (index != lastIndex)
+      {
+        for (uint32 uiCol = 0; uiCol < m_numColumns; ++uiCol)
+        {
+          const uint32 eleSize = m_columnEleSizes[uiCol];
+          memcpy(m_columns[uiCol] + (size_t)index * eleSize,
+                 m_columns[uiCol] + (size_t)lastIndex * eleSize, eleSize);
+        }
+      }
+      --m_size;
+    }
+  } //namespace Core
+} //namespace Tk
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include <tuple>
+#include <type_traits>
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Typed view of one column, e.g. for a SIMD loop over just that field
+    template <typename T>
+    struct SoAColumn
+    {
+      T* m_data;
+      uint32 m_size;
+
+      uint32 Size() const
+      {
+        return m_size;
+      }
+
+      T* Data() const
+      {
+        return m_data;
+      }
+
+      T& operator[](uint32 index) const
+      {
+        TINKER_ASSERT(index < m_size);
+        return m_data[index];
+      }
+
+      T* begin() const
+      {
+        return m_data;
+      }
+
+      T* end() const
+      {
+        return m_data + m_size;
+      }
+    };
+
+    // Type-erased base class - avoid template compilation overhead
+    struct SoAVectorBase
+    {
+      enum : uint32
+      {
+        eMaxColumns = 16,
+      };
+
+      TINKER_API ~SoAVectorBase();
+
+      uint32 Size() const
+      {
+        return m_size;
+      }
+
+      uint32 Capacity() const
+      {
+        return m_capacity;
+      }
+
+      TINKER_API void Reserve(uint32 numEles);
+      // New rows are zeroed
+      TINKER_API void Resize(uint32 numEles);
+      TINKER_API void Clear();
+      // O(1) removal, moves the last row into the removed one in every column, so order
+      // is not kept
+      TINKER_API void SwapRemove(uint32 index);
+      TINKER_API void ExplicitFree();
+
+    protected:
+      // All columns share one allocation
+      uint8* m_data;
+      uint8* m_columns[eMaxColumns];
+      const uint32* m_columnEleSizes;
+      uint32 m_numColumns;
+      uint32 m_size;
+      uint32 m_capacity;
+
+      // Both move the rows into a new allocation and return the old one, to be freed with
+      // FreeOldData() once nothing reads from it any more
+      TINKER_API uint8* Realloc(uint32 numEles);
+      TINKER_API uint8* Grow(uint32 minNumEles);
+      TINKER_API void FreeOldData(uint8* oldData);
+    };
+
+    // Vector of rows where each field lives in its own column, so a loop over one field
+    // only pulls that field's bytes into the cache. Each column starts on a cache line
+    // and its capacity is padded out to the end of one, so SIMD loops can run whole
+    // vectors past Size() without leaving the column. Rows are moved with memcpy and
+    // Resize() zeroes new ones rather than constructing them, so fields have to be plain
+    // data. Only trivial destruction is checked, since the math types like m4f have
+    // their own copy constructors.
+    template <typename... Fields>
+    struct SoAVector : public SoAVectorBase
+    {
+      static_assert(sizeof...(Fields) > 0 && sizeof...(Fields) <= eMaxColumns);
+      static_assert((std::is_trivially_destructible_v<Fields> && ...));
+      static_assert(((alignof(Fields) <= CACHE_LINE) && ...));
+
+      template <uint32 ColumnIndex>
+      using FieldType = std::tuple_element_t<ColumnIndex, std::tuple<Fields...>>;
+
+    private:
+      static constexpr uint32 s_columnEleSizes[] = { sizeof(Fields)... };
+
+      template <uint32 ColumnIndex, typename Field, typename... OtherFields>
+      void WriteRow(uint32 index, const Field& value, const OtherFields&... otherValues)
+      {
+        ((Field*)m_columns[ColumnIndex])[index] = value;
+        if constexpr (sizeof...(OtherFields) > 0)
+        {
+          WriteRow<ColumnIndex + 1>(index, otherValues...);
+        }
+      }
+
+    public:
+      SoAVector()
+        : SoAVectorBase()
+      {
+        m_data = nullptr;
+        for (uint32 i = 0; i < eMaxColumns; ++i)
+        {
+          m_columns[i] = nullptr;
+        }
+        m_columnEleSizes = s_columnEleSizes;
+        m_numColumns = sizeof...(Fields);
+        m_size = 0;
+        m_capacity = 0;
+      }
+
+      SoAVector(const SoAVector& other) = delete;
+      SoAVector& operator=(const SoAVector& other) = delete;
+
+      // Returns the index of the new row. The values may come from this vector, a regrow
+      // keeps the old columns alive until the row has been written.
+      uint32 PushBack(const Fields&... values)
+      {
+        if (m_size == m_capacity)
+        {
+          uint8* oldData = Grow(m_size + 1);
+          WriteRow<0>(m_size, values...);
+          FreeOldData(oldData);
+        }
+        else
+        {
+          WriteRow<0>(m_size, values...);
+        }
+        return m_size++;
+      }
+
+      void Set(uint32 index, const Fields&... values)
+      {
+        TINKER_ASSERT(index < m_size);
+        WriteRow<0>(index, values...);
+      }
+
+      template <uint32 ColumnIndex>
+      FieldType<ColumnIndex>& Get(uint32 index)
+      {
+        TINKER_ASSERT(index < m_size);
+        return ((FieldType<ColumnIndex>*)m_columns[ColumnIndex])[index];
+      }
+
+      template <uint32 ColumnIndex>
+      const FieldType<ColumnIndex>& Get(uint32 index) const
+      {
+        TINKER_ASSERT(index < m_size);
+        return ((const FieldType<ColumnIndex>*)m_columns[ColumnIndex])[index];
+      }
+
+      // Only good until the next regrow
+      template <uint32 ColumnIndex>
+      SoAColumn<FieldType<ColumnIndex>> Column()
+      {
+        return { (FieldType<ColumnIndex>*)m_columns[ColumnIndex], m_size };
+      }
+
+      template <uint32 ColumnIndex>
+      SoAColumn<const FieldType<ColumnIndex>> Column() const
+      {
+        return { (const FieldType<ColumnIndex>*)m_columns[ColumnIndex], m_size };
+      }
+    };
+  } //namespace Core
+} //namespace Tk
@@ -1,4 +1,5 @@
 #include "Vector.h"
+#include "Allocators.h"
 #include "Mem.h"
 #include <string.h>
 
@@ -8,33 +9,98 @@ namespace Tk
   {
     VectorBase::~VectorBase()
     {
-      CoreFree(m_data);
+      FreeData();
+    }
+
+    void VectorBase::FreeData()
+    {
+      if (!m_allocator)
+      {
+        CoreFreeAligned(m_data);
+      }
       m_data = nullptr;
       m_size = 0;
       m_capacity = 0;
     }
 
-    void VectorBase::Reserve(uint32 numEles, uint32 eleSize)
+    void VectorBase::MoveFrom(VectorBase& other)
+    {
+      FreeData();
+      m_data = other.m_data;
+      m_size = other.m_size;
+      m_capacity = other.m_capacity;
+      m_allocator = other.m_allocator;
+
+      other.m_data = nullptr;
+      other.m_size = 0;
+      other.m_capacity = 0;
+    }
+
+    void VectorBase::Reserve(uint32 numEles, uint32 eleSize, uint32 eleAlignment,
+                             RelocateFunc* Relocate)
     {
       if (numEles > m_capacity)
       {
-        const size_t BytesToAllocate = (size_t)numEles * (size_t)eleSize;
-        TINKER_ASSERT(BytesToAllocate <= (size_t)MAX_UINT32);
-        void* newData = CoreMalloc(numEles * eleSize);
-        if (m_data && m_size > 0)
+        uint8* newData = AllocData(numEles, eleSize, eleAlignment);
+        ReplaceData(newData, numEles, eleSize, Relocate);
+      }
+    }
+
+    uint32 VectorBase::GrownCapacity(uint32 minNumEles, uint32 eleSize) const
+    {
+      // Double the capacity so that N push backs are amortized O(N)
+      uint64 newCapacity = Max((uint64)m_capacity * 2, (uint64)minNumEles);
+      newCapacity = Min(newCapacity, (uint64)MAX_UINT32 / eleSize);
+      TINKER_ASSERT(newCapacity >= minNumEles);
+      return (uint32)newCapacity;
+    }
+
+    uint8* VectorBase::AllocData(uint32 numEles, uint32 eleSize, uint32 eleAlignment)
+    {
+      const size_t BytesToAllocate = (size_t)numEles * (size_t)eleSize;
+      TINKER_ASSERT(BytesToAllocate <= (size_t)MAX_UINT32);
+
+      void* newData = nullptr;
+      if (m_allocator)
+      {
+        newData = m_allocator->Alloc(BytesToAllocate, eleAlignment);
+      }
+      else
+      {
+        newData = CoreMallocAligned(BytesToAllocate, eleAlignment);
+      }
+      TINKER_ASSERT(newData);
+      return (uint8*)newData;
+    }
+
+    void VectorBase::ReplaceData(uint8* newData, uint32 newCapacity, uint32 eleSize,
+                                 RelocateFunc* Relocate)
+    {
+      if (m_data && m_size > 0)
+      {
+        if (Relocate)
+        {
+          Relocate(newData, m_data, m_size);
+        }
+        else
         {
           memcpy(newData, m_data, m_size * eleSize);
-          CoreFree(m_data); // free old data
         }
+      }
 
-        m_data = (uint8*)newData;
-        m_capacity = numEles;
+      // Old data in an arena just stays there until the arena is reset
+      if (!m_allocator)
+      {
+        CoreFreeAligned(m_data);
       }
+
+      m_data = newData;
+      m_capacity = newCapacity;
     }
 
-    void VectorBase::Resize(uint32 numEles, uint32 eleSize)
+    void VectorBase::Resize(uint32 numEles, uint32 eleSize, uint32 eleAlignment)
     {
-      Reserve(numEles, eleSize);
+      Reserve(numEles, eleSize, eleAlignment, nullptr);
       if (m_size < numEles)
       {
         // Set new elements to 0
@@ -52,29 +118,41 @@ namespace Tk
       m_size = 0;
     }
 
-    void VectorBase::PushBackRaw(void* data, uint32 eleSize)
+    void VectorBase::AppendN(const void* data, uint32 numEles, uint32 eleSize,
+                             uint32 eleAlignment)
     {
-      if (m_size == m_capacity)
+      if (numEles == 0)
       {
-        // Alloc new data
-        uint32 newCapacity = m_capacity + 1;
-        void* newData = CoreMalloc(newCapacity * eleSize);
-        memcpy(newData, m_data, m_capacity * eleSize);
-        m_capacity = newCapacity;
-
-        // Replace data
-        CoreFree(m_data);
-        m_data = (uint8*)newData;
+        return;
       }
 
-      if (m_size < m_capacity)
+      if (m_size + numEles > m_capacity)
+      {
+        // Copy in the new elements before the old data is freed, data may point into it
+        const uint32 newCapacity = GrownCapacity(m_size + numEles, eleSize);
+        uint8* newData = AllocData(newCapacity, eleSize, eleAlignment);
+        memcpy(newData + m_size * eleSize, data, numEles * eleSize);
+        ReplaceData(newData, newCapacity, eleSize, nullptr);
+      }
+      else
+      {
+        memcpy(m_data + m_size * eleSize, data, numEles * eleSize);
+      }
+      m_size += numEles;
+    }
+
+    void VectorBase::SwapRemove(uint32 index, uint32 eleSize)
+    {
+      TINKER_ASSERT(index < m_size);
+      const uint32 lastIndex = m_size - 1;
+      if (index != lastIndex)
       {
-        memcpy(m_data + m_size * eleSize, data, eleSize);
-        ++m_size;
+        memcpy(m_data + index * eleSize, m_data + lastIndex * eleSize, eleSize);
       }
+      --m_size;
     }
 
-    uint32 VectorBase::Find(void* data, uint32 eleSize, CompareFunc Compare) const
+    uint32 VectorBase::Find(const void* data, uint32 eleSize, CompareFunc Compare) const
     {
       for (uint32 i = 0; i < m_size; ++i)
       {
@@ -1,14 +1,24 @@
 #pragma once
 
 #include "CoreDefines.h"
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace Tk
 {
   namespace Core
   {
+    struct LinearAllocator;
+
 #define CMP_FUNC(name) bool name(const void* A, const void* B)
     typedef CMP_FUNC(CompareFunc);
 
+    // Moves elements to new, non-overlapping memory and destroys the moved-from elements.
+    // Passing nullptr instead of a relocate func means the elements can just be memcpy'd.
+#define RELOCATE_FUNC(name) void name(void* Dst, void* Src, uint32 NumEles)
+    typedef RELOCATE_FUNC(RelocateFunc);
+
     // Type-erased base class - avoid template compilation overhead
     struct VectorBase
     {
@@ -24,24 +34,139 @@ namespace Tk
       uint32 m_size;
       uint32 m_capacity;
 
-      TINKER_API void Reserve(uint32 numEles, uint32 eleSize);
-      TINKER_API void Resize(uint32 numEles, uint32 eleSize);
+      // Optional, e.g. a per-frame arena. Memory is never freed back to the allocator, it
+      // gets reclaimed whenever the owner of the allocator resets it.
+      LinearAllocator* m_allocator;
+
+      TINKER_API void Reserve(uint32 numEles, uint32 eleSize, uint32 eleAlignment,
+                              RelocateFunc* Relocate);
+      // Capacity to grow to so that at least minNumEles fit
+      TINKER_API uint32 GrownCapacity(uint32 minNumEles, uint32 eleSize) const;
+      // Regrowing is split in two so that new elements can be built in the new memory
+      // while the old memory, which they may be copied from, is still alive
+      TINKER_API uint8* AllocData(uint32 numEles, uint32 eleSize, uint32 eleAlignment);
+      // Moves the current elements into newData and frees the old memory
+      TINKER_API void ReplaceData(uint8* newData, uint32 newCapacity, uint32 eleSize,
+                                  RelocateFunc* Relocate);
+      TINKER_API void Resize(uint32 numEles, uint32 eleSize, uint32 eleAlignment);
       TINKER_API void Clear();
-      TINKER_API void PushBackRaw(void* data, uint32 eleSize);
-      TINKER_API uint32 Find(void* data, uint32 eleSize, CompareFunc Compare) const;
+      TINKER_API void AppendN(const void* data, uint32 numEles, uint32 eleSize,
+                              uint32 eleAlignment);
+      TINKER_API void SwapRemove(uint32 index, uint32 eleSize);
+      TINKER_API uint32 Find(const void* data, uint32 eleSize, CompareFunc Compare) const;
+      TINKER_API void FreeData();
+      TINKER_API void MoveFrom(VectorBase& other);
     };
 
-    // NOTE: probably only works for POD types right now
     // Actual templated vector class
+    // Trivially copyable types go through the type-erased memcpy paths. Anything else is
+    // constructed, moved and destroyed properly.
     template <typename T>
     struct Vector : public VectorBase
     {
+    private:
+      enum : uint32
+      {
+        eEleSize = sizeof(T),
+        eEleAlignment = alignof(T),
+      };
+
+      static const bool IsTrivial = std::is_trivially_copyable_v<T>;
+
+      static RELOCATE_FUNC(RelocateEles)
+      {
+        T* dst = (T*)Dst;
+        T* src = (T*)Src;
+        for (uint32 i = 0; i < NumEles; ++i)
+        {
+          new (&dst[i]) T(std::move(src[i]));
+          src[i].~T();
+        }
+      }
+
+      static RelocateFunc* GetRelocateFunc()
+      {
+        if constexpr (IsTrivial)
+        {
+          return nullptr;
+        }
+        else
+        {
+          return RelocateEles;
+        }
+      }
+
+      void DestroyEles(uint32 first, uint32 last)
+      {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+          for (uint32 i = first; i < last; ++i)
+          {
+            ((T*)m_data)[i].~T();
+          }
+        }
+      }
+
+      // Construct(dst) builds numEles elements at dst. On a regrow they are built in the
+      // new memory before the old memory is freed, since the source may be an element
+      // of this vector, e.g. v.PushBackRaw(v[0]) on a full vector.
+      template <typename ConstructFunc>
+      void ConstructAtEnd(uint32 numEles, ConstructFunc Construct)
+      {
+        if (m_size + numEles > m_capacity)
+        {
+          const uint32 newCapacity =
+            VectorBase::GrownCapacity(m_size + numEles, eEleSize);
+          uint8* newData = VectorBase::AllocData(newCapacity, eEleSize, eEleAlignment);
+          Construct((T*)newData + m_size);
+          VectorBase::ReplaceData(newData, newCapacity, eEleSize, GetRelocateFunc());
+        }
+        else
+        {
+          Construct((T*)m_data + m_size);
+        }
+        m_size += numEles;
+      }
+
+    public:
       Vector()
         : VectorBase()
       {
         m_data = nullptr;
         m_size = 0;
         m_capacity = 0;
+        m_allocator = nullptr;
+      }
+
+      explicit Vector(LinearAllocator* allocator)
+        : Vector()
+      {
+        m_allocator = allocator;
+      }
+
+      Vector(const Vector& other) = delete;
+      Vector& operator=(const Vector& other) = delete;
+
+      Vector(Vector&& other)
+        : Vector()
+      {
+        VectorBase::MoveFrom(other);
+      }
+
+      Vector& operator=(Vector&& other)
+      {
+        if (this != &other)
+        {
+          DestroyEles(0, m_size);
+          VectorBase::MoveFrom(other);
+        }
+        return *this;
+      }
+
+      ~Vector()
+      {
+        DestroyEles(0, m_size);
+        m_size = 0;
       }
 
       const uint8* Data() const
@@ -59,24 +184,106 @@ namespace Tk
         return m_capacity;
       }
 
+      // Only valid before the vector has allocated anything
+      void SetAllocator(LinearAllocator* allocator)
+      {
+        TINKER_ASSERT(!m_data);
+        m_allocator = allocator;
+      }
+
       void Reserve(uint32 numEles)
       {
-        VectorBase::Reserve(numEles, sizeof(T));
+        VectorBase::Reserve(numEles, eEleSize, eEleAlignment, GetRelocateFunc());
       }
 
       void Resize(uint32 numEles)
       {
-        VectorBase::Resize(numEles, sizeof(T));
+        if constexpr (IsTrivial && std::is_trivially_default_constructible_v<T>)
+        {
+          VectorBase::Resize(numEles, eEleSize, eEleAlignment);
+        }
+        else
+        {
+          if (numEles > m_size)
+          {
+            Reserve(numEles);
+            for (uint32 i = m_size; i < numEles; ++i)
+            {
+              new (&((T*)m_data)[i]) T();
+            }
+          }
+          else
+          {
+            DestroyEles(numEles, m_size);
+          }
+          m_size = numEles;
+        }
       }
 
       void Clear()
       {
+        DestroyEles(0, m_size);
         VectorBase::Clear();
       }
 
       void PushBackRaw(const T& data)
       {
-        VectorBase::PushBackRaw((void*)&data, sizeof(T));
+        Emplace(data);
+      }
+
+      // Constructs the new element directly in the vector's memory. Only a regrow goes
+      // through the type-erased base.
+      template <typename... Args>
+      T& Emplace(Args&&... args)
+      {
+        T* newEle = nullptr;
+        auto construct = [&](T* dst)
+        {
+          newEle = new (dst) T(std::forward<Args>(args)...);
+        };
+        ConstructAtEnd(1, construct);
+        return *newEle;
+      }
+
+      // Copies numEles elements onto the end of the vector with at most one regrow
+      void AppendN(const T* data, uint32 numEles)
+      {
+        if constexpr (IsTrivial)
+        {
+          VectorBase::AppendN(data, numEles, eEleSize, eEleAlignment);
+        }
+        else
+        {
+          auto construct = [&](T* dst)
+          {
+            for (uint32 i = 0; i < numEles; ++i)
+            {
+              new (&dst[i]) T(data[i]);
+            }
+          };
+          ConstructAtEnd(numEles, construct);
+        }
+      }
+
+      // O(1) removal, moves the last element into the removed slot so order is not kept
+      void SwapRemove(uint32 index)
+      {
+        TINKER_ASSERT(index < m_size);
+        if constexpr (IsTrivial)
+        {
+          VectorBase::SwapRemove(index, eEleSize);
+        }
+        else
+        {
+          T* eles = (T*)m_data;
+          const uint32 lastIndex = m_size - 1;
+          if (index != lastIndex)
+          {
+            eles[index] = std::move(eles[lastIndex]);
+          }
+          eles[lastIndex].~T();
+          --m_size;
+        }
       }
 
       static CMP_FUNC(DefaultEqualsCompare)
@@ -86,7 +293,7 @@ namespace Tk
 
       uint32 Find(const T& data) const
       {
-        return VectorBase::Find((void*)&data, sizeof(T), DefaultEqualsCompare);
+        return VectorBase::Find(&data, eEleSize, DefaultEqualsCompare);
       }
 
       const T& operator[](uint32 index) const
@@ -100,6 +307,26 @@ namespace Tk
         TINKER_ASSERT(index < m_size);
         return ((T*)(m_data))[index];
       }
+
+      T* begin()
+      {
+        return (T*)m_data;
+      }
+
+      T* end()
+      {
+        return (T*)m_data + m_size;
+      }
+
+      const T* begin() const
+      {
+        return (const T*)m_data;
+      }
+
+      const T* end() const
+      {
+        return (const T*)m_data + m_size;
+      }
     };
   } //namespace Core
 } //namespace Tk
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "Mem.h"
+#include <atomic>
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Chase-Lev work stealing deque, fixed capacity.
+    // The owning thread pushes and pops at the bottom (LIFO), any other thread steals
+    // from the top (FIFO). Push() fails when full rather than growing, so the owner
+    // decides where overflow goes and stealers never read a buffer that got freed.
+    // T must be trivially copyable, it's meant for pointers and handles.
+    template <typename T>
+    struct WorkStealingDeque
+    {
+    private:
+      std::atomic<T>* m_data = nullptr;
+      int64 m_mask = 0;
+
+    public:
+      alignas(CACHE_LINE) std::atomic<int64> m_top = 0;
+      alignas(CACHE_LINE) std::atomic<int64> m_bottom = 0;
+
+      WorkStealingDeque() {}
+
+      ~WorkStealingDeque()
+      {
+        ExplicitFree();
+      }
+
+      void Init(uint32 capacity)
+      {
+        TINKER_ASSERT(capacity > 0 && ISPOW2(capacity));
+        TINKER_ASSERT(!m_data);
+        m_data = (std::atomic<T>*)CoreMallocAligned(capacity * sizeof(std::atomic<T>),
+                                                    CACHE_LINE);
+        for (uint32 i = 0; i < capacity; ++i)
+        {
+          new (&m_data[i]) std::atomic<T>();
+        }
+        m_mask = (int64)capacity - 1;
+        m_top = 0;
+        m_bottom = 0;
+      }
+
+      void ExplicitFree()
+      {
+        if (m_data)
+        {
+          CoreFreeAligned(m_data);
+          m_data = nullptr;
+          m_mask = 0;
+        }
+      }
+
+      uint32 Capacity() const
+      {
+        return (uint32)(m_mask + 1);
+      }
+
+      // Approximate when other threads are stealing
+      uint32 Size() const
+      {
+        const int64 bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64 top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? (uint32)(bottom - top) : 0;
+      }
+
+      // Owner only. Returns false if the deque is full.
+      bool Push(T ele)
+      {
+        const int64 bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64 top = m_top.load(std::memory_order_acquire);
+        if (bottom - top > m_mask)
+        {
+          return false;
+        }
+
+        m_data[bottom & m_mask].store(ele, std::memory_order_relaxed);
+        // Publishes the element, and whatever it points to, to stealers
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+      }
+
+      // Owner only. Takes the most recently pushed element.
+      bool Pop(T* ele)
+      {
+        const int64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        // Stealers have to see the reserved bottom before we read top
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+          // Empty
+          m_bottom.store(bottom + 1, std::memory_order_relaxed);
+          return false;
+        }
+
+        *ele = m_data[bottom & m_mask].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+          // Last element, race any stealers for it
+          const bool won = m_top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+          m_bottom.store(bottom + 1, std::memory_order_relaxed);
+          return won;
+        }
+        return true;
+      }
+
+      // Any thread. Takes the oldest element. Fails if empty or if another thread won
+      // the race for the same element.
+      bool Steal(T* ele)
+      {
+        int64 top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64 bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+          return false;
+        }
+
+        // Read before claiming it, the owner can overwrite the slot as soon as top moves
+        const T value = m_data[top & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+        {
+          return false;
+        }
+        *ele = value;
+        return true;
+      }
+    };
+  } //namespace Core
+} //namespace Tk
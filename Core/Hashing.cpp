@@ -1,21 +1,42 @@
-#pragma once
-
 #include "Hashing.h"
 
-//#define XXH_PRIVATE_API
-/*#define XXH_INLINE_ALL
-#include "xxhash.h"*/
-
-//#define DEFAULT_STRING_HASH_SEED ((uint64)0x87654321)
+// Pulls in XXH3 along with the runtime CPU feature dispatch for its long input loops.
+// Compiled in this one translation unit so nothing else sees the xxhash internals.
+#define XXH_DISPATCH_DISABLE_REPLACE
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include "ThirdParty/xxHash-0.8.2/xxh_x86dispatch.c"
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
 
 namespace Tk
 {
   namespace Core
   {
-    /*Hash Hash64(const void* dataBuf, uint32 numBytes)
+    static_assert(sizeof(XXH3_state_t) <= HashState::eStateSize);
+    static_assert(alignof(XXH3_state_t) <= alignof(HashState));
+
+    TINKER_API Hash Hash64(const void* data, size_t numBytes, uint64 seed)
+    {
+      return Hash((uint64)XXH3_64bits_withSeed_dispatch(data, numBytes, seed));
+    }
+
+    TINKER_API void HashState::Reset(uint64 seed)
+    {
+      XXH3_INITSTATE((XXH3_state_t*)m_state);
+      XXH3_64bits_reset_withSeed((XXH3_state_t*)m_state, seed);
+    }
+
+    TINKER_API void HashState::Update(const void* data, size_t numBytes)
+    {
+      XXH3_64bits_update_dispatch((XXH3_state_t*)m_state, data, numBytes);
+    }
+
+    TINKER_API Hash HashState::Digest() const
     {
-        XXH64_hash_t hash = XXH64(dataBuf, numBytes, DEFAULT_STRING_HASH_SEED);
-        return Hash((uint64)hash);
-    }*/
-  }
+      return Hash((uint64)XXH3_64bits_digest((const XXH3_state_t*)m_state));
+    }
+  } //namespace Core
 } //namespace Tk
@@ -1,13 +1,7 @@
 #pragma once
 
 #include "CoreDefines.h"
-
-#define XXH_PRIVATE_API
-#define XXH_INLINE_ALL
-#define XXH_NO_STDLIB
-#define XXH_NO_XXH3
 #include "ThirdParty/constexpr-xxh3/constexpr-xxh3.h"
-#include "ThirdParty/xxHash-0.8.2/xxhash.h"
 
 #define DEFAULT_STRING_HASH_SEED ((uint64)0x12'34'56'78'87'65'43'21)
 
@@ -25,12 +19,55 @@ namespace Tk
         : m_val(val)
       {
       }
+
+      constexpr bool operator==(const Hash& other) const
+      {
+        return m_val == other.m_val;
+      }
+
+      constexpr bool operator!=(const Hash& other) const
+      {
+        return m_val != other.m_val;
+      }
     };
+
+    // Runtime XXH3 64. Long inputs go through whichever of the SSE2/AVX2/AVX512 loops the
+    // CPU supports, picked once at startup. Same value as the compile time HASH_64 for the
+    // same bytes.
+    TINKER_API Hash Hash64(const void* data, size_t numBytes,
+                           uint64 seed = DEFAULT_STRING_HASH_SEED);
+
+    // Incremental XXH3 64 for data that shows up in pieces, e.g. streaming in a large
+    // asset file. Digest() matches Hash64() over all of the bytes passed to Update().
+    struct HashState
+    {
+      enum : uint32
+      {
+        eStateSize = 576, // sizeof(XXH3_state_t), checked in Hashing.cpp
+      };
+
+      alignas(64) uint8 m_state[eStateSize];
+
+      HashState()
+      {
+        Reset();
+      }
+
+      TINKER_API void Reset(uint64 seed = DEFAULT_STRING_HASH_SEED);
+      TINKER_API void Update(const void* data, size_t numBytes);
+      TINKER_API Hash Digest() const;
+    };
+
+    // Compile time hash of a string literal. The null terminator is not hashed so that
+    // HASH_64("name") == HASH_64_RUNTIME("name", strlen("name")).
+    template <size_t strLen>
+    consteval uint64 HashStringLiteral(const char (&str)[strLen])
+    {
+      return constexpr_xxh3::XXH3_64bits_withSeed_const(str, strLen - 1,
+                                                        DEFAULT_STRING_HASH_SEED);
+    }
   } //namespace Core
 } //namespace Tk
 
-#define HASH_64(buf)                                                                     \
-  Tk::Core::Hash(constexpr_xxh3::XXH3_64bits_withSeed_const(buf, sizeof(buf),            \
-                                                            DEFAULT_STRING_HASH_SEED))
-#define HASH_64_RUNTIME(buf, len)                                                        \
-  Tk::Core::Hash((uint64)(XXH64(buf, len, DEFAULT_STRING_HASH_SEED)))
+#define HASH_64(str) Tk::Core::Hash(Tk::Core::HashStringLiteral(str))
+#define HASH_64_RUNTIME(buf, len) Tk::Core::Hash64(buf, len)
@@ -2,7 +2,9 @@
 
 #include "CoreDefines.h"
 #include <float.h>
+#include <smmintrin.h>
 #include <string.h>
+#include <xmmintrin.h>
 
 namespace Tk
 {
@@ -1199,10 +1201,7 @@ namespace Tk
       }
     };
 
-// Vector Ops
-#include <smmintrin.h>
-#include <xmmintrin.h>
-
+    // Vector Ops
     // mulps - SSE1
     // mulloepi32 - SSE4.1
 
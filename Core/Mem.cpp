@@ -1,13 +1,35 @@
 #include "Mem.h"
 #include "Platform/PlatformGameAPI.h"
+#include "Utility/AllocatorRegistry.h"
 
 namespace Tk
 {
   namespace Core
   {
+#ifdef TINKER_CORE_HEAP_TLSF
+    // Every Core allocation comes out of one locked TLSF heap instead of the CRT
+    static const size_t CoreHeapPoolSize = 1024 * 1024 * 64;
+
+    static TLSFHeap& GetCoreHeap()
+    {
+      // Never shut down, allocations can still be freed during static destruction
+      static TLSFHeap* heap = []() {
+        static TLSFHeap coreHeap;
+        coreHeap.Init(CoreHeapPoolSize, CoreHeapPoolSize, true);
+        Utility::RegisterAllocator(coreHeap, "Core heap");
+        return &coreHeap;
+      }();
+      return *heap;
+    }
+#endif
+
     void* CoreMalloc(size_t size)
     {
+#ifdef TINKER_CORE_HEAP_TLSF
+      void* ptr = GetCoreHeap().Alloc(size);
+#else
       void* ptr = malloc(size);
+#endif
 #ifdef ENABLE_MEM_TRACKING
       Utility::RecordMemAlloc((uint64)size, ptr);
 #endif
@@ -16,15 +38,23 @@ namespace Tk
 
     void CoreFree(void* ptr)
     {
-      free(ptr);
 #ifdef ENABLE_MEM_TRACKING
       Utility::RecordMemDealloc(ptr);
+#endif
+#ifdef TINKER_CORE_HEAP_TLSF
+      GetCoreHeap().Free(ptr);
+#else
+      free(ptr);
 #endif
     }
 
     void* CoreMallocAligned(size_t size, size_t alignment)
     {
+#ifdef TINKER_CORE_HEAP_TLSF
+      void* ptr = GetCoreHeap().AllocAligned(size, alignment);
+#else
       void* ptr = Tk::Platform::AllocAlignedRaw(size, alignment);
+#endif
 #ifdef ENABLE_MEM_TRACKING
       Utility::RecordMemAlloc((uint64)size, ptr);
 #endif
@@ -33,10 +63,21 @@ namespace Tk
 
     void CoreFreeAligned(void* ptr)
     {
-      Tk::Platform::FreeAlignedRaw(ptr);
 #ifdef ENABLE_MEM_TRACKING
       Utility::RecordMemDealloc(ptr);
+#endif
+#ifdef TINKER_CORE_HEAP_TLSF
+      GetCoreHeap().Free(ptr);
+#else
+      Tk::Platform::FreeAlignedRaw(ptr);
 #endif
     }
+
+#ifdef TINKER_CORE_HEAP_TLSF
+    TINKER_API TLSFHeapStats GetCoreHeapStats()
+    {
+      return GetCoreHeap().GetStats();
+    }
+#endif
   } //namespace Core
 } //namespace Tk
@@ -3,6 +3,10 @@
 #include "CoreDefines.h"
 #include "Utility/MemTracker.h"
 
+#ifdef TINKER_CORE_HEAP_TLSF
+#include "TLSFHeap.h"
+#endif
+
 namespace Tk
 {
   namespace Core
@@ -11,5 +15,10 @@ namespace Tk
     TINKER_API void CoreFree(void* ptr);
     TINKER_API void* CoreMallocAligned(size_t size, size_t alignment);
     TINKER_API void CoreFreeAligned(void* ptr);
+
+#ifdef TINKER_CORE_HEAP_TLSF
+    // Stats for the heap behind the functions above
+    TINKER_API TLSFHeapStats GetCoreHeapStats();
+#endif
   } //namespace Core
 } //namespace Tk
@@ -0,0 +1,81 @@
+#ifdef __linux__
+#include "Platform/PlatformGameAPI.h"
+#include "Utility/Logging.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+namespace Tk
+{
+  namespace Platform
+  {
+    FILE_EXISTS(CheckFileExists)
+    {
+      struct stat fileStat;
+      return stat(filename, &fileStat) == 0;
+    }
+
+    MAKE_DIRECTORY(MakeDirectory)
+    {
+      mkdir(pathname, 0755);
+    }
+
+    GET_ENTIRE_FILE_SIZE(GetEntireFileSize)
+    {
+      struct stat fileStat;
+      if (stat(filename, &fileStat) == 0)
+      {
+        return SafeTruncateUint64((uint64)fileStat.st_size);
+      }
+      else
+      {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to open file!",
+                                  Core::Utility::LogSeverity::eCritical);
+        return 0;
+      }
+    }
+
+    READ_ENTIRE_FILE(ReadEntireFile)
+    {
+      // User must specify a file size and the dest buffer.
+      TINKER_ASSERT(fileSizeInBytes && buffer);
+
+      FILE* file = fopen(filename, "rb");
+      if (file)
+      {
+        size_t numBytesRead = fread(buffer, 1, fileSizeInBytes, file);
+        TINKER_ASSERT(numBytesRead == fileSizeInBytes);
+        fclose(file);
+        return 0;
+      }
+      else
+      {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to open file!",
+                                  Core::Utility::LogSeverity::eCritical);
+        return 1;
+      }
+    }
+
+    WRITE_ENTIRE_FILE(WriteEntireFile)
+    {
+      // User must specify a file size and the dest buffer.
+      TINKER_ASSERT(fileSizeInBytes && buffer);
+
+      FILE* file = fopen(filename, "wb");
+      if (file)
+      {
+        size_t numBytesWritten = fwrite(buffer, 1, fileSizeInBytes, file);
+        TINKER_ASSERT(numBytesWritten == fileSizeInBytes);
+        fclose(file);
+        return 0;
+      }
+      else
+      {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to open file!",
+                                  Tk::Core::Utility::LogSeverity::eCritical);
+        return 1;
+      }
+    }
+  } //namespace Platform
+} //namespace Tk
+#endif
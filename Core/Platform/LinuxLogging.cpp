@@ -0,0 +1,43 @@
+#ifdef __linux__
+#include "Utility/Logging.h"
+#include <stdio.h>
+
+namespace Tk
+{
+  namespace Core
+  {
+    namespace Utility
+    {
+      void LogMsg(const char* prefix, const char* msg, uint32 severity)
+      {
+        const char* severityMsg;
+        switch (severity)
+        {
+          case LogSeverity::eInfo:
+          {
+            severityMsg = "Info";
+            break;
+          }
+          case LogSeverity::eWarning:
+          {
+            severityMsg = "Warning";
+            break;
+          }
+          case LogSeverity::eCritical:
+          {
+            severityMsg = "Critical";
+            break;
+          }
+          default:
+          {
+            severityMsg = "Unknown Severity";
+            break;
+          }
+        }
+
+        fprintf(stderr, "[%s][%s] %s\n", prefix, severityMsg, msg);
+      }
+    } //namespace Utility
+  } //namespace Core
+} //namespace Tk
+#endif
@@ -0,0 +1,149 @@
+#ifdef __linux__
+#include "PlatformGameAPI.h"
+#include "StringTypes.h"
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+namespace Tk
+{
+  namespace Platform
+  {
+    // I/O
+    PRINT_DEBUG_STRING(PrintDebugString)
+    {
+      fputs(str, stderr);
+    }
+
+    ALLOC_ALIGNED_RAW(AllocAlignedRaw)
+    {
+      // aligned_alloc wants the size to be a multiple of the alignment
+      return aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+    }
+
+    FREE_ALIGNED_RAW(FreeAlignedRaw)
+    {
+      free(ptr);
+    }
+
+    // Transparent huge pages only get used for 2MB aligned ranges
+    static const size_t HugePageSize = 1024 * 1024 * 2;
+
+    RESERVE_ADDRESS_SPACE(ReserveAddressSpace)
+    {
+      // PROT_NONE + MAP_NORESERVE only takes address space, no swap or overcommit charge
+      const int mapFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+      if (!(flags & VirtualMemFlags::eHugePages))
+      {
+        void* ptr = mmap(NULL, size, PROT_NONE, mapFlags, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+      }
+
+      // Over-reserve and trim so the range starts on a huge page boundary
+      uint8* ptr = (uint8*)mmap(NULL, size + HugePageSize, PROT_NONE, mapFlags, -1, 0);
+      if (ptr == (uint8*)MAP_FAILED)
+      {
+        return nullptr;
+      }
+      uint8* alignedPtr =
+        (uint8*)(((size_t)ptr + HugePageSize - 1) & ~(size_t)(HugePageSize - 1));
+      if (alignedPtr > ptr)
+      {
+        munmap(ptr, alignedPtr - ptr);
+      }
+      munmap(alignedPtr + size, (ptr + HugePageSize) - alignedPtr);
+      madvise(alignedPtr, size, MADV_HUGEPAGE);
+      return alignedPtr;
+    }
+
+    COMMIT_PAGES(CommitPages)
+    {
+      return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+    }
+
+    DECOMMIT_PAGES(DecommitPages)
+    {
+      madvise(ptr, size, MADV_DONTNEED);
+      mprotect(ptr, size, PROT_NONE);
+    }
+
+    RELEASE_ADDRESS_SPACE(ReleaseAddressSpace)
+    {
+      munmap(ptr, size);
+    }
+
+    CAPTURE_STACK_TRACE(CaptureStackTrace)
+    {
+      static_assert(sizeof(void*) == sizeof(uint64));
+      // backtrace() can't skip frames, so capture into a local buffer and drop the
+      // innermost ones, this function included
+      const uint32 maxLocalFrames = 64;
+      void* localFrames[maxLocalFrames];
+      const uint32 numToSkip = framesToSkip + 1;
+      const int numCaptured =
+        backtrace(localFrames, (int)Min(maxFrames + numToSkip, maxLocalFrames));
+      if (numCaptured <= (int)numToSkip)
+      {
+        return 0;
+      }
+
+      const uint32 numFrames = Min((uint32)numCaptured - numToSkip, maxFrames);
+      for (uint32 i = 0; i < numFrames; ++i)
+      {
+        frames[i] = (uint64)localFrames[numToSkip + i];
+      }
+      return numFrames;
+    }
+
+    SYMBOLIZE_ADDRESS(SymbolizeAddress)
+    {
+      // Long template names get cut off rather than asserting
+      Tk::Core::StrBuilder str(buffer, bufferSize);
+      auto AppendTruncated = [&](const char* name)
+      {
+        str.Append(name, Min((uint32)strlen(name), str.LenRemaining()));
+      };
+
+      // Only finds exported symbols, link with -rdynamic to see everything
+      Dl_info info = {};
+      bool foundSymbol = false;
+      if (dladdr((void*)address, &info))
+      {
+        if (info.dli_fname)
+        {
+          const char* fileName = info.dli_fname;
+          for (const char* c = info.dli_fname; *c; ++c)
+          {
+            if (*c == '/')
+            {
+              fileName = c + 1;
+            }
+          }
+          AppendTruncated(fileName);
+          AppendTruncated("!");
+        }
+        if (info.dli_sname)
+        {
+          int status = 0;
+          char* demangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+          AppendTruncated(status == 0 ? demangled : info.dli_sname);
+          free(demangled);
+          foundSymbol = true;
+        }
+      }
+
+      if (!foundSymbol)
+      {
+        char hexBuffer[32];
+        snprintf(hexBuffer, ARRAYCOUNT(hexBuffer), "%llx", (unsigned long long)address);
+        AppendTruncated("0x");
+        AppendTruncated(hexBuffer);
+      }
+      str.NullTerminate();
+    }
+  } //namespace Platform
+} //namespace Tk
+#endif
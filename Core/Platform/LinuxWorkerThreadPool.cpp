@@ -0,0 +1,156 @@
+#ifdef __linux__
+#include "WorkerThreadPoolPlatform.h"
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace Tk
+{
+  namespace Platform
+  {
+    namespace ThreadPool
+    {
+      static void* LinuxWorkerThreadStart(void* arg)
+      {
+        WorkerThreadMain(arg);
+        return nullptr;
+      }
+
+      bool CreateWorkerThread(void* arg, uint32 stackSize)
+      {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, stackSize);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        pthread_t thread;
+        const int err = pthread_create(&thread, &attr, LinuxWorkerThreadStart, arg);
+        pthread_attr_destroy(&attr);
+        return err == 0;
+      }
+
+      // -1 if the file is missing, e.g. sysfs isn't mounted in a container
+      static int64 ReadCpuTopologyValue(uint32 cpu, const char* name)
+      {
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/%s", cpu,
+                 name);
+        FILE* file = fopen(path, "r");
+        if (!file)
+        {
+          return -1;
+        }
+        long long value = -1;
+        if (fscanf(file, "%lld", &value) != 1)
+        {
+          value = -1;
+        }
+        fclose(file);
+        return (int64)value;
+      }
+
+      uint32 GetCoreOrder(uint32* logicalCores, uint32 maxCores, uint32* numPhysical)
+      {
+        *numPhysical = 0;
+
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        {
+          const long numOnline = sysconf(_SC_NPROCESSORS_ONLN);
+          const uint32 numCores = Min(numOnline > 0 ? (uint32)numOnline : 1u, maxCores);
+          for (uint32 i = 0; i < numCores; ++i)
+          {
+            logicalCores[i] = i;
+          }
+          *numPhysical = numCores;
+          return numCores;
+        }
+
+        // Physical core of each allowed cpu, package and core id together
+        const uint32 maxCpus = 256;
+        uint32 cpus[maxCpus];
+        int64 coreKeys[maxCpus];
+        uint32 numCpus = 0;
+        for (uint32 cpu = 0; cpu < CPU_SETSIZE && numCpus < maxCpus; ++cpu)
+        {
+          if (!CPU_ISSET(cpu, &allowed))
+          {
+            continue;
+          }
+          const int64 package = ReadCpuTopologyValue(cpu, "physical_package_id");
+          const int64 core = ReadCpuTopologyValue(cpu, "core_id");
+          cpus[numCpus] = cpu;
+          // Unknown topology counts every cpu as its own core
+          coreKeys[numCpus] = (package < 0 || core < 0) ? -1 - (int64)cpu
+                                                        : (package << 32) | core;
+          ++numCpus;
+        }
+
+        // First pass takes the lowest numbered cpu of each physical core, the second
+        // the rest
+        bool taken[maxCpus] = {};
+        uint32 numCores = 0;
+        for (uint32 i = 0; i < numCpus && numCores < maxCores; ++i)
+        {
+          bool firstOfCore = true;
+          for (uint32 j = 0; j < i; ++j)
+          {
+            if (coreKeys[j] == coreKeys[i])
+            {
+              firstOfCore = false;
+              break;
+            }
+          }
+          if (firstOfCore)
+          {
+            logicalCores[numCores++] = cpus[i];
+            taken[i] = true;
+          }
+        }
+        *numPhysical = numCores;
+        for (uint32 i = 0; i < numCpus && numCores < maxCores; ++i)
+        {
+          if (!taken[i])
+          {
+            logicalCores[numCores++] = cpus[i];
+          }
+        }
+        return numCores;
+      }
+
+      void PinCurrentThread(uint32 logicalCore)
+      {
+        if (logicalCore < CPU_SETSIZE)
+        {
+          cpu_set_t cpus;
+          CPU_ZERO(&cpus);
+          CPU_SET(logicalCore, &cpus);
+          pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        }
+      }
+
+      // Private futexes, the pool never shares them with another process
+      void WaitOnValue(std::atomic<uint32>* address, uint32 expected, uint32 timeoutMs)
+      {
+        timespec timeout = {};
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (long)(timeoutMs % 1000) * 1000000;
+        syscall(SYS_futex, (uint32*)address, FUTEX_WAIT_PRIVATE, expected,
+                timeoutMs == THREAD_WAIT_INFINITE ? nullptr : &timeout, nullptr, 0);
+      }
+
+      void WakeOnValue(std::atomic<uint32>* address, uint32 numToWake)
+      {
+        const int maxToWake = 0x7FFFFFFF;
+        syscall(SYS_futex, (uint32*)address, FUTEX_WAKE_PRIVATE,
+                numToWake >= (uint32)maxToWake ? maxToWake : (int)numToWake, nullptr,
+                nullptr, 0);
+      }
+    } //namespace ThreadPool
+  } //namespace Platform
+} //namespace Tk
+#endif
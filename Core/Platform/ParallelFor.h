@@ -0,0 +1,195 @@
+#pragma once
+
+#include "PlatformGameThreadAPI.h"
+
+namespace Tk
+{
+  namespace Platform
+  {
+    // A range is never split into more chunks than this, bigger ranges get a bigger
+    // grain size
+    const uint32 ParallelForMaxChunks = 4096;
+    // Chunks per thread when the grain size is picked automatically. More than one so
+    // that stealing can even out chunks that take longer than others.
+    const uint32 ParallelForChunksPerThread = 8;
+
+    // Items per chunk. 0 picks one from the number of worker threads.
+    inline uint32 ParallelForGrainSize(uint32 numItems, uint32 grainSize)
+    {
+      if (!grainSize)
+      {
+        const uint32 numThreads = GetNumWorkerThreads() + 1; // the caller helps too
+        grainSize = numItems / (numThreads * ParallelForChunksPerThread);
+      }
+      const uint32 minGrainSize =
+        (uint32)(((uint64)numItems + ParallelForMaxChunks - 1) / ParallelForMaxChunks);
+      return Max(Max(grainSize, minGrainSize), 1u);
+    }
+
+    // Splits [begin, end) into fixed chunks of grainSize items and runs
+    // func(chunkIndex, chunkBegin, chunkEnd) for each one across the thread pool.
+    // A range of chunks gets halved and the upper half launched as a job until one
+    // chunk is left, so idle workers steal big halves and keep splitting them locally.
+    // Each split point is used exactly once, so the job for the split at chunk boundary
+    // mid lives in m_jobs[mid - 1] and the jobs can all be allocated up front.
+    template <typename ChunkFunc>
+    struct ParallelForContext
+    {
+      struct RangeJob : public WorkerJob
+      {
+        ParallelForContext* m_context;
+        uint32 m_firstChunk;
+        uint32 m_lastChunk;
+
+        RangeJob(ParallelForContext* context)
+          : m_context(context)
+          , m_firstChunk(0)
+          , m_lastChunk(0)
+        {
+          m_name = "ParallelFor";
+        }
+
+        void operator()() override
+        {
+          m_context->RunChunks(m_firstChunk, m_lastChunk);
+        }
+      };
+
+      ChunkFunc& m_func;
+      uint32 m_begin;
+      uint32 m_end;
+      uint32 m_grainSize;
+      RangeJob* m_jobs;
+      JobCounter m_counter;
+
+      ParallelForContext(ChunkFunc& func, uint32 begin, uint32 end, uint32 grainSize)
+        : m_func(func)
+        , m_begin(begin)
+        , m_end(end)
+        , m_grainSize(grainSize)
+        , m_jobs(nullptr)
+      {
+      }
+
+      void RunChunks(uint32 firstChunk, uint32 lastChunk)
+      {
+        while (lastChunk - firstChunk > 1)
+        {
+          const uint32 mid = firstChunk + (lastChunk - firstChunk) / 2;
+          RangeJob* job = &m_jobs[mid - 1];
+          job->m_firstChunk = mid;
+          job->m_lastChunk = lastChunk;
+          LaunchJob(job, &m_counter, nullptr);
+          lastChunk = mid;
+        }
+
+        const uint32 chunkBegin = m_begin + firstChunk * m_grainSize;
+        const uint32 chunkEnd = Min(m_end - chunkBegin, m_grainSize) + chunkBegin;
+        m_func(firstChunk, chunkBegin, chunkEnd);
+      }
+    };
+
+    // The calling thread runs chunks too, then helps with whatever is left until the
+    // whole range is done
+    template <typename ChunkFunc>
+    void ParallelForChunks(uint32 begin, uint32 end, uint32 grainSize, ChunkFunc& func)
+    {
+      if (begin >= end)
+      {
+        return;
+      }
+
+      const uint32 numChunks = (end - begin + grainSize - 1) / grainSize;
+      if (numChunks == 1)
+      {
+        func(0, begin, end);
+        return;
+      }
+
+      typedef ParallelForContext<ChunkFunc> Context;
+      Context context(func, begin, end, grainSize);
+      const uint32 numJobs = numChunks - 1;
+      context.m_jobs = (typename Context::RangeJob*)Core::CoreMallocAligned(
+        numJobs * sizeof(typename Context::RangeJob), CACHE_LINE);
+      for (uint32 i = 0; i < numJobs; ++i)
+      {
+        new (&context.m_jobs[i]) typename Context::RangeJob(&context);
+      }
+
+      context.RunChunks(0, numChunks);
+      WaitOnJobCounter(&context.m_counter, false);
+
+      for (uint32 i = 0; i < numJobs; ++i)
+      {
+        context.m_jobs[i].~RangeJob();
+      }
+      Core::CoreFreeAligned(context.m_jobs);
+    }
+
+    // Runs func(i) for every i in [begin, end)
+    template <typename Func>
+    void ParallelFor(uint32 begin, uint32 end, uint32 grainSize, Func func)
+    {
+      if (begin >= end)
+      {
+        return;
+      }
+
+      auto chunkFunc = [&](uint32, uint32 chunkBegin, uint32 chunkEnd)
+      {
+        for (uint32 i = chunkBegin; i < chunkEnd; ++i)
+        {
+          func(i);
+        }
+      };
+      ParallelForChunks(begin, end, ParallelForGrainSize(end - begin, grainSize),
+                        chunkFunc);
+    }
+
+    // Returns reduce(...reduce(reduce(identity, map(begin)), map(begin + 1))...) with the
+    // work split like ParallelFor(). Each chunk reduces its own items, then the chunk
+    // results get reduced in order on the calling thread, so reduce has to be
+    // associative but needn't be commutative. With a fixed grainSize, float results are
+    // the same on every run and every core count.
+    template <typename T, typename MapFunc, typename ReduceFunc>
+    T ParallelReduce(uint32 begin, uint32 end, uint32 grainSize, T identity, MapFunc map,
+                     ReduceFunc reduce)
+    {
+      if (begin >= end)
+      {
+        return identity;
+      }
+
+      // Chunk results on their own cache lines so workers don't share them
+      struct alignas(CACHE_LINE) ChunkResult
+      {
+        T m_value;
+      };
+
+      grainSize = ParallelForGrainSize(end - begin, grainSize);
+      const uint32 numChunks = (end - begin + grainSize - 1) / grainSize;
+      ChunkResult* results = (ChunkResult*)Core::CoreMallocAligned(
+        numChunks * sizeof(ChunkResult), CACHE_LINE);
+
+      auto chunkFunc = [&](uint32 chunkIndex, uint32 chunkBegin, uint32 chunkEnd)
+      {
+        T value = identity;
+        for (uint32 i = chunkBegin; i < chunkEnd; ++i)
+        {
+          value = reduce(value, map(i));
+        }
+        new (&results[chunkIndex].m_value) T(value);
+      };
+      ParallelForChunks(begin, end, grainSize, chunkFunc);
+
+      T value = identity;
+      for (uint32 i = 0; i < numChunks; ++i)
+      {
+        value = reduce(value, results[i].m_value);
+        results[i].m_value.~T();
+      }
+      Core::CoreFreeAligned(results);
+      return value;
+    }
+  } //namespace Platform
+} //namespace Tk
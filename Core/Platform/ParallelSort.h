@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Allocators.h"
+#include "ParallelFor.h"
+#include "Sorting.h"
+#include <string.h>
+#include <type_traits>
+
+namespace Tk
+{
+  namespace Platform
+  {
+    // Smaller ranges go straight to IntroSort() on the calling thread
+    const uint32 ParallelSortMinEles = 1 << 14;
+    // Most runs the range is first cut into, one per thread rounded up to a power of two
+    const uint32 ParallelSortMaxRuns = 64;
+    // Each merge round is split into about this many pieces per thread
+    const uint32 ParallelSortPiecesPerThread = 4;
+
+    // How many of the first numOut merged elements come from A. Ties go to A, so an
+    // element of A comes out before any equal element of B.
+    template <typename T, typename LessFunc>
+    uint32 MergeSplit(const T* A, uint32 numA, const T* B, uint32 numB, uint32 numOut,
+                      LessFunc& Less)
+    {
+      uint32 lo = numOut > numB ? numOut - numB : 0;
+      uint32 hi = Min(numOut, numA);
+      while (lo < hi)
+      {
+        const uint32 mid = lo + (hi - lo) / 2;
+        if (!Less(B[numOut - mid - 1], A[mid]))
+        {
+          // A[mid] comes out before B[numOut - mid - 1], so take more from A
+          lo = mid + 1;
+        }
+        else
+        {
+          hi = mid;
+        }
+      }
+      return lo;
+    }
+
+    template <typename T, typename LessFunc>
+    void MergeRuns(const T* A, uint32 numA, const T* B, uint32 numB, T* dst,
+                   LessFunc& Less)
+    {
+      uint32 i = 0;
+      uint32 j = 0;
+      while (i < numA && j < numB)
+      {
+        if (Less(B[j], A[i]))
+        {
+          *dst++ = B[j++];
+        }
+        else
+        {
+          *dst++ = A[i++];
+        }
+      }
+      while (i < numA)
+      {
+        *dst++ = A[i++];
+      }
+      while (j < numB)
+      {
+        *dst++ = B[j++];
+      }
+    }
+
+    // Parallel merge sort. The range is cut into one run per thread, the runs get sorted
+    // with IntroSort() in parallel, then neighbouring runs are merged until one is left.
+    // Every merge is split into pieces by binary searching where each piece's output
+    // starts, so the last rounds with only a couple of big merges still use every thread.
+    // Needs numEles elements of scratch from scratchArena, e.g. a LinearAllocator or the
+    // thread scratch arena, which is rewound before returning. Falls back to IntroSort()
+    // if the arena is out of room. Not stable, T has to be trivially copyable.
+    template <typename T, typename LessFunc, typename Arena>
+    void ParallelSort(T* data, uint32 numEles, LessFunc Less, Arena& scratchArena)
+    {
+      static_assert(std::is_trivially_copyable_v<T>);
+
+      const uint32 numThreads = GetNumWorkerThreads() + 1; // the caller helps too
+      if (numEles < ParallelSortMinEles || numThreads == 1)
+      {
+        Core::IntroSort(data, numEles, Less);
+        return;
+      }
+
+      Core::ScopedArenaMarker<Arena> scratchScope(scratchArena);
+      T* scratch = (T*)scratchArena.Alloc(numEles * sizeof(T), CACHE_LINE);
+      if (!scratch)
+      {
+        Core::IntroSort(data, numEles, Less);
+        return;
+      }
+
+      const uint32 numRuns = Min(POW2_ROUNDUP(numThreads), ParallelSortMaxRuns);
+      const uint32 runSize = (numEles + numRuns - 1) / numRuns;
+      auto sortRun = [&](uint32, uint32 runBegin, uint32 runEnd)
+      {
+        Core::IntroSort(data + runBegin, runEnd - runBegin, Less);
+      };
+      ParallelForChunks(0, numEles, runSize, sortRun);
+
+      T* src = data;
+      T* dst = scratch;
+      for (uint32 mergedSize = runSize; mergedSize < numEles; mergedSize *= 2)
+      {
+        const uint32 numMerges = (numEles + mergedSize * 2 - 1) / (mergedSize * 2);
+        const uint32 piecesPerMerge =
+          Max(numThreads * ParallelSortPiecesPerThread / numMerges, 1u);
+        auto mergePiece = [&](uint32 pieceIndex)
+        {
+          const uint32 mergeIndex = pieceIndex / piecesPerMerge;
+          const uint32 piece = pieceIndex % piecesPerMerge;
+          const uint32 mergeBegin = mergeIndex * mergedSize * 2;
+          const uint32 numA = Min(mergedSize, numEles - mergeBegin);
+          const uint32 numB = Min(mergedSize, numEles - mergeBegin - numA);
+          const T* A = src + mergeBegin;
+          const T* B = A + numA;
+
+          const uint64 numOut = numA + numB;
+          const uint32 outBegin = (uint32)(numOut * piece / piecesPerMerge);
+          const uint32 outEnd = (uint32)(numOut * (piece + 1) / piecesPerMerge);
+          const uint32 aBegin = MergeSplit(A, numA, B, numB, outBegin, Less);
+          const uint32 aEnd = MergeSplit(A, numA, B, numB, outEnd, Less);
+          MergeRuns(A + aBegin, aEnd - aBegin, B + (outBegin - aBegin),
+                    (outEnd - aEnd) - (outBegin - aBegin), dst + mergeBegin + outBegin,
+                    Less);
+        };
+        ParallelFor(0, numMerges * piecesPerMerge, 1, mergePiece);
+
+        T* tmp = src;
+        src = dst;
+        dst = tmp;
+      }
+
+      if (src != data)
+      {
+        auto copyBack = [&](uint32, uint32 chunkBegin, uint32 chunkEnd)
+        {
+          memcpy(data + chunkBegin, src + chunkBegin,
+                 (chunkEnd - chunkBegin) * sizeof(T));
+        };
+        ParallelForChunks(0, numEles, runSize, copyBack);
+      }
+    }
+  } //namespace Platform
+} //namespace Tk
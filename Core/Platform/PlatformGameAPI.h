@@ -43,6 +43,40 @@ namespace Tk
 #define FREE_ALIGNED_RAW(name) TINKER_API void name(void* ptr)
     FREE_ALIGNED_RAW(FreeAlignedRaw);
 
+    // Virtual memory. Reserved address space costs nothing until pages in it are
+    // committed, so an allocator can reserve for its worst case and commit as it grows.
+    // Sizes and pointers passed to commit/decommit must be multiples of
+    // VirtualMemPageSize.
+    const size_t VirtualMemPageSize = 4096;
+
+    namespace VirtualMemFlags
+    {
+      enum : uint32
+      {
+        eNone = 0,
+        // Back the range with transparent huge pages where the OS has them (madvise on
+        // Linux). Ignored on Windows, where large pages have to be committed up front.
+        eHugePages = 0x1,
+      };
+    } //namespace VirtualMemFlags
+
+    // Returns nullptr on failure
+#define RESERVE_ADDRESS_SPACE(name) TINKER_API void* name(size_t size, uint32 flags)
+    RESERVE_ADDRESS_SPACE(ReserveAddressSpace);
+
+    // Returns false if the OS is out of memory, the range is left uncommitted
+#define COMMIT_PAGES(name) TINKER_API bool name(void* ptr, size_t size)
+    COMMIT_PAGES(CommitPages);
+
+    // Gives the physical pages back, the range stays reserved and reads as zero when
+    // committed again
+#define DECOMMIT_PAGES(name) TINKER_API void name(void* ptr, size_t size)
+    DECOMMIT_PAGES(DecommitPages);
+
+    // Takes the size that was reserved
+#define RELEASE_ADDRESS_SPACE(name) TINKER_API void name(void* ptr, size_t size)
+    RELEASE_ADDRESS_SPACE(ReleaseAddressSpace);
+
 #define READ_ENTIRE_FILE(name)                                                           \
   TINKER_API uint32 name(const char* filename, uint32 fileSizeInBytes, uint8* buffer)
     READ_ENTIRE_FILE(ReadEntireFile);
@@ -73,30 +107,16 @@ namespace Tk
 #define FIND_FILE_CLOSE(name) TINKER_API void name(FileHandle handle)
     FIND_FILE_CLOSE(FindFileClose);
 
-    struct StackTraceEntry
-    {
-      StackTraceEntry* next;
-
-      static const uint32 MaxNameBufferSize = 2048;
-      Tk::Core::StrFixedBuffer<MaxNameBufferSize> moduleName;
-      Tk::Core::StrFixedBuffer<MaxNameBufferSize> functionName;
-      Tk::Core::StrFixedBuffer<MaxNameBufferSize> fileName;
-      uint32 lineNum;
-
-      void Init()
-      {
-        moduleName.Clear();
-        functionName.Clear();
-        fileName.Clear();
-        lineNum = 0;
-        next = nullptr;
-      }
-    };
+    // Return addresses of the calling thread's stack, innermost first. Cheap enough to
+    // call on hot paths, no symbol lookups.
+#define CAPTURE_STACK_TRACE(name)                                                        \
+  uint32 name(uint64* frames, uint32 maxFrames, uint32 framesToSkip)
+    CAPTURE_STACK_TRACE(CaptureStackTrace);
 
-#define WALK_STACK_TRACE(name)                                                           \
-  uint32 name(StackTraceEntry** topOfStack,                                              \
-              Tk::Core::LinearAllocator& stackEntryAllocator)
-    WALK_STACK_TRACE(WalkStackTrace);
+    // "module!function" for an address from CaptureStackTrace(), or the address in hex
+    // when no symbols are loaded
+#define SYMBOLIZE_ADDRESS(name) void name(uint64 address, char* buffer, uint32 bufferSize)
+    SYMBOLIZE_ADDRESS(SymbolizeAddress);
 
 #define INIT_NETWORK_CONNECTION(name) TINKER_API int name()
     INIT_NETWORK_CONNECTION(InitNetworkConnection);
@@ -1,16 +1,58 @@
 #pragma once
 
+#include "Allocators.h"
 #include "CoreDefines.h"
 #include "Mem.h"
+#include "SpinLock.h"
+#include <atomic>
 
 namespace Tk
 {
   namespace Platform
   {
+    struct WorkerJob;
+
+    // Workers take the highest priority job they can find. Background jobs only run on
+    // some of the workers, see ThreadPool::SetNumBackgroundWorkers(), so however many
+    // are queued the other workers stay free for frame work.
+    namespace JobPriority
+    {
+      enum : uint32
+      {
+        eFrameCritical = 0, // needed to finish the current frame
+        eNormal,
+        eBackground, // streaming, cooking, file IO, anything not waited on this frame
+        eCount,
+      };
+    }
+
+    // Number of unfinished jobs launched against it. Jobs can also be launched with a
+    // counter as a dependency, then they only get queued once it reaches zero, so
+    // read -> parse -> upload chains don't need a wait between each step.
+    // A counter can be reused once it reaches zero. Only destroy it after
+    // WaitOnJobCounter() returned, a job may still be releasing it otherwise.
+    struct JobCounter
+    {
+      alignas(CACHE_LINE) std::atomic<uint32> m_count = 0;
+      std::atomic<uint32> m_numParked = 0;
+      Core::SpinLock m_lock;
+      WorkerJob* m_waitingJobs = nullptr; // guarded by m_lock
+
+      bool IsDone() const
+      {
+        return m_count.load(std::memory_order_acquire) == 0;
+      }
+    };
+
     struct WorkerJob
     {
     public:
-      alignas(CACHE_LINE) volatile uint32 m_done = 0;
+      alignas(CACHE_LINE) std::atomic<uint32> m_done = 0;
+      JobCounter* m_counter = nullptr; // decremented when the job is done
+      WorkerJob* m_nextWaiting = nullptr; // next job waiting on the same dependency
+      uint32 m_poolHandle = TINKER_INVALID_HANDLE; // if it came from the job pool
+      const char* m_name = nullptr; // shown by the job profiler, a string literal
+      uint32 m_priority = JobPriority::eNormal; // set before the job is enqueued
 
       virtual ~WorkerJob() {}
 
@@ -36,47 +78,167 @@ namespace Tk
       };
     };
 
-    inline void WaitOnJob(WorkerJob* job)
+    // Stores the callable in place rather than behind its own allocation. These are all
+    // one size, so they come out of a pool with per-thread caches, and creating jobs
+    // doesn't touch the heap once the pool has grown to the most jobs alive at once.
+    struct InlineJob : public WorkerJob
     {
-      while (!job->m_done)
-        ;
+    public:
+      enum : uint32
+      {
+        eMaxFuncSize = 64,
+        eMaxFuncAlignment = 16,
+      };
+
+      alignas(eMaxFuncAlignment) uint8 m_func[eMaxFuncSize];
+      void (*m_invoke)(void* func) = nullptr;
+      void (*m_destroy)(void* func) = nullptr;
+
+      virtual ~InlineJob()
+      {
+        if (m_destroy)
+        {
+          m_destroy(m_func);
+        }
+      }
+
+      void operator()() override
+      {
+        m_invoke(m_func);
+      }
+    };
+
+    // An empty job from the pool, from any thread
+#define ALLOC_INLINE_JOB(name) TINKER_API InlineJob* name()
+    ALLOC_INLINE_JOB(AllocInlineJob);
+
+    // Frees a job from CreateNewThreadJob(), pooled or not. Any thread can free it, once
+    // it's done.
+#define FREE_JOB(name) TINKER_API void name(WorkerJob* Job)
+    FREE_JOB(FreeJob);
+
+    // Decrements the counter and queues the jobs waiting on it if it reached zero.
+    // RunJob() calls this for jobs launched with a counter.
+#define SIGNAL_JOB_COUNTER(name) TINKER_API void name(JobCounter* Counter)
+    SIGNAL_JOB_COUNTER(SignalJobCounter);
+
+    // Runs the job on the calling thread and marks it done. Whatever the job allocated
+    // from the thread's scratch arena is freed before it's marked done.
+    inline void RunJob(WorkerJob* job)
+    {
+      {
+        Tk::Core::ScopedThreadScratch scratchScope(Tk::Core::GetThreadScratch());
+        (*job)();
+      }
+      // Whoever waits on the job can free it as soon as it's marked done
+      JobCounter* counter = job->m_counter;
+      job->m_done.store(1, std::memory_order_release);
+      if (counter)
+      {
+        SignalJobCounter(counter);
+      }
     }
 
+    // Waiting runs other queued jobs on the calling thread instead of spinning. That
+    // can be any job, so don't wait while holding a lock a job might need.
+#define WAIT_ON_JOB(name) TINKER_API void name(WorkerJob* Job)
+    WAIT_ON_JOB(WaitOnJob);
+
+    // Once there's nothing left to help with for a while, AllowParking lets the thread
+    // sleep until the counter reaches zero. Leave it off for waits that are expected to
+    // be short, waking up costs more than spinning.
+#define WAIT_ON_JOB_COUNTER(name)                                                        \
+  TINKER_API void name(JobCounter* Counter, bool AllowParking)
+    WAIT_ON_JOB_COUNTER(WaitOnJobCounter);
+
+    // Jobs that get enqueued and waited on together. Up to eInlineCapacity of them fit
+    // in the list itself, bigger lists allocate their array, the jobs stay pooled.
     struct WorkerJobList
     {
     public:
+      enum : uint32
+      {
+        eInlineCapacity = 256,
+      };
+
       uint32 m_numJobs;
-      WorkerJob* m_jobs[256]; // TODO: make this a templated sized array or something
+      uint32 m_capacity;
+      WorkerJob** m_jobs;
+      WorkerJob* m_inlineJobs[eInlineCapacity];
 
       WorkerJobList()
         : m_numJobs(0)
+        , m_capacity(eInlineCapacity)
+        , m_jobs(m_inlineJobs)
+      {
+      }
+
+      ~WorkerJobList()
       {
+        if (m_jobs != m_inlineJobs)
+        {
+          Tk::Core::CoreFreeAligned(m_jobs);
+        }
       }
 
-      ~WorkerJobList() {}
+      WorkerJobList(const WorkerJobList& other) = delete;
+      WorkerJobList& operator=(const WorkerJobList& other) = delete;
 
+      // numJobs empty slots to fill in
       void Init(uint32 numJobs)
       {
+        m_numJobs = 0;
+        Reserve(numJobs);
         m_numJobs = numJobs;
-        for (uint32 i = 0; i < ARRAYCOUNT(m_jobs); ++i)
+        for (uint32 i = 0; i < m_numJobs; ++i)
         {
           m_jobs[i] = nullptr;
         }
       }
 
+      void Reserve(uint32 capacity)
+      {
+        if (capacity <= m_capacity)
+        {
+          return;
+        }
+
+        WorkerJob** newJobs = (WorkerJob**)Tk::Core::CoreMallocAligned(
+          capacity * sizeof(WorkerJob*), CACHE_LINE);
+        for (uint32 i = 0; i < m_numJobs; ++i)
+        {
+          newJobs[i] = m_jobs[i];
+        }
+        if (m_jobs != m_inlineJobs)
+        {
+          Tk::Core::CoreFreeAligned(m_jobs);
+        }
+        m_jobs = newJobs;
+        m_capacity = capacity;
+      }
+
+      // For lists whose size isn't known up front
+      void Add(WorkerJob* job)
+      {
+        if (m_numJobs == m_capacity)
+        {
+          Reserve(m_capacity * 2);
+        }
+        m_jobs[m_numJobs++] = job;
+      }
+
+      // Frees the jobs, the list can be reused afterwards
       void FreeList()
       {
-        if (m_jobs)
+        for (uint32 i = 0; i < m_numJobs; ++i)
         {
-          for (uint32 i = 0; i < m_numJobs; ++i)
+          if (m_jobs[i])
           {
-            if (m_jobs[i])
-            {
-              m_jobs[i]->~WorkerJob();
-              Tk::Core::CoreFreeAligned(m_jobs[i]);
-            }
+            FreeJob(m_jobs[i]);
+            m_jobs[i] = nullptr;
           }
         }
+        m_numJobs = 0;
       }
 
       void WaitOnJobs()
@@ -91,13 +253,36 @@ namespace Tk
       }
     };
 
+    // Free with FreeJob(). Callables up to InlineJob::eMaxFuncSize go in a pooled job,
+    // anything bigger gets its own allocation, so capture big state by pointer.
     template <typename T>
     WorkerJob* CreateNewThreadJob(T t)
     {
-      uint8* NewJobMem =
-        (uint8*)Tk::Core::CoreMallocAligned(sizeof(JobFunc<T>), CACHE_LINE);
-      JobFunc<T>* NewJob = new (NewJobMem) JobFunc<T>(t);
-      NewJob->m_done = 0;
+      if constexpr (sizeof(T) <= InlineJob::eMaxFuncSize
+                    && alignof(T) <= InlineJob::eMaxFuncAlignment)
+      {
+        InlineJob* NewJob = AllocInlineJob();
+        new (NewJob->m_func) T(std::move(t));
+        NewJob->m_invoke = [](void* func) { (*(T*)func)(); };
+        NewJob->m_destroy = [](void* func) { ((T*)func)->~T(); };
+        return NewJob;
+      }
+      else
+      {
+        uint8* NewJobMem =
+          (uint8*)Tk::Core::CoreMallocAligned(sizeof(JobFunc<T>), CACHE_LINE);
+        JobFunc<T>* NewJob = new (NewJobMem) JobFunc<T>(t);
+        NewJob->m_done = 0;
+        return NewJob;
+      }
+    }
+
+    // Name shows up in the job profiler's timeline, it has to be a string literal
+    template <typename T>
+    WorkerJob* CreateNewThreadJob(const char* Name, T t)
+    {
+      WorkerJob* NewJob = CreateNewThreadJob(std::move(t));
+      NewJob->m_name = Name;
       return NewJob;
     }
 
@@ -107,5 +292,15 @@ namespace Tk
 #define ENQUEUE_WORKER_THREAD_JOB_LIST(name) TINKER_API void name(WorkerJobList* JobList)
     ENQUEUE_WORKER_THREAD_JOB_LIST(EnqueueWorkerThreadJobList_Unassisted);
     ENQUEUE_WORKER_THREAD_JOB_LIST(EnqueueWorkerThreadJobList_Assisted);
+
+    // Counter, if not null, is incremented now and decremented when the job is done.
+    // If DependsOn is not null and not zero, the job is only queued once it reaches zero.
+#define LAUNCH_JOB(name)                                                                 \
+  TINKER_API void name(WorkerJob* Job, JobCounter* Counter, JobCounter* DependsOn)
+    LAUNCH_JOB(LaunchJob);
+
+    // Not counting the threads that help while waiting
+#define GET_NUM_WORKER_THREADS(name) TINKER_API uint32 name()
+    GET_NUM_WORKER_THREADS(GetNumWorkerThreads);
   } //namespace Platform
 } //namespace Tk
@@ -1,10 +1,12 @@
 #include "CoreDefines.h"
 #include "PlatformGameAPI.h"
 #include "ThirdParty/imgui-docking/backends/imgui_impl_win32.h"
+#include "Utility/JobProfiler.h"
 #include "Utility/Logging.h"
+#include "Utility/MemTracker.h"
 #include "Utility/ScopedTimer.h"
 #include "Win32Client.h"
-#include "Win32WorkerThreadPool.h"
+#include "WorkerThreadPool.h"
 
 #define WIN32_LEAN_AND_MEAN
 // clang-format off
@@ -19,6 +21,7 @@
 #ifndef TINKER_PLATFORM_HOTLOAD_FILENAME
   #define TINKER_PLATFORM_HOTLOAD_FILENAME "TinkerGame_hotload.dll"
 #endif
+#define MAIN_THREAD_SCRATCH_BLOCK_SIZE 1024 * 1024 * 4
 
 static GAME_UPDATE(GameUpdateStub)
 {
@@ -151,58 +154,6 @@ namespace Tk
       return &g_WindowHandles;
     }
 
-    ENQUEUE_WORKER_THREAD_JOB(EnqueueWorkerThreadJob)
-    {
-#ifdef TINKER_PLATFORM_ENABLE_MULTITHREAD
-      ThreadPool::EnqueueSingleJob(Job);
-#else
-      (*Job)();
-      Job->m_done = 1;
-#endif
-    }
-
-    ENQUEUE_WORKER_THREAD_JOB_LIST(EnqueueWorkerThreadJobList_Unassisted)
-    {
-#ifdef TINKER_PLATFORM_ENABLE_MULTITHREAD
-      ThreadPool::EnqueueJobList(JobList);
-#else
-      for (uint32 uiJob = 0; uiJob < JobList->m_numJobs; ++uiJob)
-      {
-        (*(JobList->m_jobs[uiJob]))();
-        JobList->m_jobs[uiJob]->m_done = 1;
-      }
-#endif
-    }
-
-    ENQUEUE_WORKER_THREAD_JOB_LIST(EnqueueWorkerThreadJobList_Assisted)
-    {
-#ifdef TINKER_PLATFORM_ENABLE_MULTITHREAD
-      uint32 NumJobs = JobList->m_numJobs;
-      uint32 NumThreads = ThreadPool::NumWorkerThreads() + 1;
-      uint32 NumJobsPerThread = NumJobs / NumThreads;
-      uint32 NumJobsLeftover = NumJobs % NumThreads;
-
-      uint32 NumMainThreadJobs =
-        NumJobsPerThread; // main thread never does any leftover jobs for now
-      ThreadPool::EnqueueJobSubList(JobList, NumJobs - NumMainThreadJobs);
-
-      // Main thread work
-      for (uint32 uiJob = NumJobs - NumMainThreadJobs; uiJob < JobList->m_numJobs;
-           ++uiJob)
-      {
-        (*(JobList->m_jobs[uiJob]))();
-        JobList->m_jobs[uiJob]->m_done = 1;
-      }
-
-#else
-      for (uint32 uiJob = 0; uiJob < JobList->m_numJobs; ++uiJob)
-      {
-        (*(JobList->m_jobs[uiJob]))();
-        JobList->m_jobs[uiJob]->m_done = 1;
-      }
-#endif
-    }
-
     INIT_NETWORK_CONNECTION(InitNetworkConnection)
     {
       if (Network::InitClient() != 0)
@@ -656,8 +607,11 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
     }
 #endif
 
+    Tk::Core::InitThreadScratch(MAIN_THREAD_SCRATCH_BLOCK_SIZE);
+    Tk::Core::Utility::SetJobProfilerThreadName("Main");
+
 #ifdef TINKER_PLATFORM_ENABLE_MULTITHREAD
-    ThreadPool::Startup(g_SystemInfo.dwNumberOfProcessors / 2);
+    ThreadPool::Startup(ThreadPool::DefaultNumWorkerThreads());
 #endif
   }
 
@@ -666,6 +620,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
   {
     {
       //TIMED_SCOPED_BLOCK("-----> Total Frame");
+      JOB_PROFILE_SCOPE("Frame");
 
       {
         //TIMED_SCOPED_BLOCK("Process window messages");
@@ -684,6 +639,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 
       {
         //TIMED_SCOPED_BLOCK("Game Update");
+        JOB_PROFILE_SCOPE("Game update");
 
         int error =
           g_GameCode.GameUpdate(g_GlobalAppParams.m_windowWidth,
@@ -697,6 +653,9 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
           break;
         }
       }
+
+      // Everything the game put in the main thread's scratch arena was for this frame
+      Tk::Core::GetThreadScratch().ResetState();
     }
 
     if (ReloadGameCode(&g_GameCode))
@@ -704,7 +663,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 // Reset application resources
 #ifdef TINKER_PLATFORM_ENABLE_MULTITHREAD
       ThreadPool::Shutdown();
-      ThreadPool::Startup(g_SystemInfo.dwNumberOfProcessors / 2);
+      ThreadPool::Startup(ThreadPool::DefaultNumWorkerThreads());
 #endif
     }
   }
@@ -714,8 +673,18 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 #ifdef TINKER_PLATFORM_ENABLE_MULTITHREAD
   ThreadPool::Shutdown();
 #endif
+  Tk::Core::ShutdownThreadScratch();
 
 #ifdef ENABLE_MEM_TRACKING
+  // Symbols are needed to print the allocation profile
+  Tk::Core::Utility::DebugOutputAllMemAllocs();
+  if (Tk::Core::Utility::DumpMemProfileFolded(
+        "..\\Output\\MemProfile.folded",
+        Tk::Core::Utility::MemProfileValue::eAllocatedBytes))
+  {
+    Tk::Core::Utility::LogMsg("Platform", "Failed to write allocation profile!",
+                              Tk::Core::Utility::LogSeverity::eWarning);
+  }
   SymCleanup(GetCurrentProcess());
 #endif
 
@@ -21,121 +21,89 @@ namespace Tk
       _aligned_free(ptr);
     }
 
-#include <dbghelp.h>
+    RESERVE_ADDRESS_SPACE(ReserveAddressSpace)
+    {
+      // MEM_LARGE_PAGES needs SeLockMemoryPrivilege and has to be reserved and committed
+      // in one go, so eHugePages is ignored
+      return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+    }
 
-    WALK_STACK_TRACE(WalkStackTrace)
+    COMMIT_PAGES(CommitPages)
     {
-#ifndef ENABLE_MEM_TRACKING
-      return 1;
-#else
+      return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+    }
 
-      SymSetOptions(SYMOPT_LOAD_LINES);
+    DECOMMIT_PAGES(DecommitPages)
+    {
+      VirtualFree(ptr, size, MEM_DECOMMIT);
+    }
 
-      DWORD machine = IMAGE_FILE_MACHINE_AMD64; // TODO check architecture?
+    RELEASE_ADDRESS_SPACE(ReleaseAddressSpace)
+    {
+      VirtualFree(ptr, 0, MEM_RELEASE);
+    }
 
-      HANDLE process = GetCurrentProcess();
-      HANDLE thread = GetCurrentThread();
-      CONTEXT context = {};
-      context.ContextFlags = CONTEXT_FULL;
-      RtlCaptureContext(&context);
+#include <dbghelp.h>
 
-      STACKFRAME frame = {};
-  #if _WIN32
-      frame.AddrPC.Offset = context.Rip;
-      frame.AddrPC.Mode = AddrModeFlat;
-      frame.AddrFrame.Offset = context.Rbp;
-      frame.AddrFrame.Mode = AddrModeFlat;
-      frame.AddrStack.Offset = context.Rsp;
-      frame.AddrStack.Mode = AddrModeFlat;
-  #else
-      frame.AddrPC.Offset = context.Eip;
-      frame.AddrPC.Mode = AddrModeFlat;
-      frame.AddrFrame.Offset = context.Ebp;
-      frame.AddrFrame.Mode = AddrModeFlat;
-      frame.AddrStack.Offset = context.Esp;
-      frame.AddrStack.Mode = AddrModeFlat;
-  #endif
+    CAPTURE_STACK_TRACE(CaptureStackTrace)
+    {
+      static_assert(sizeof(PVOID) == sizeof(uint64));
+      // Skip this function too
+      return (uint32)RtlCaptureStackBackTrace(framesToSkip + 1, maxFrames, (PVOID*)frames,
+                                              NULL);
+    }
 
-      auto ProcessStackWalk = [&](StackTraceEntry* stackTraceEntry)
+    SYMBOLIZE_ADDRESS(SymbolizeAddress)
+    {
+      // Long template names get cut off rather than asserting
+      Tk::Core::StrBuilder str(buffer, bufferSize);
+      auto AppendTruncated = [&](const char* name)
       {
-        DWORD64 functionAddress = frame.AddrPC.Offset;
-
-        DWORD64 moduleBase = SymGetModuleBase(process, frame.AddrPC.Offset);
-        if (moduleBase)
-        {
-          char moduleScratchBuf[StackTraceEntry::MaxNameBufferSize];
-          GetModuleFileNameA((HINSTANCE)moduleBase, moduleScratchBuf,
-                             stackTraceEntry->MaxNameBufferSize);
-          stackTraceEntry->moduleName.Append(&moduleScratchBuf[0]);
-        }
-        else
-        {
-          stackTraceEntry->moduleName.Append("InvalidModule");
-        }
-
-        char symbolBuffer[sizeof(IMAGEHLP_SYMBOL) + stackTraceEntry->MaxNameBufferSize];
-        PIMAGEHLP_SYMBOL symbol = (PIMAGEHLP_SYMBOL)symbolBuffer;
-        symbol->SizeOfStruct =
-          sizeof(IMAGEHLP_SYMBOL) + stackTraceEntry->MaxNameBufferSize;
-        symbol->MaxNameLength = stackTraceEntry->MaxNameBufferSize - 1;
-
-        if (SymGetSymFromAddr(process, frame.AddrPC.Offset, NULL, symbol))
-        {
-          stackTraceEntry->functionName.Append(symbol->Name,
-                                               uint32(strlen(symbol->Name)));
-          stackTraceEntry->functionName.NullTerminate();
-        }
-        else
-        {
-          stackTraceEntry->functionName.Append("InvalidFunction");
-        }
-
-        DWORD offset = 0;
-        IMAGEHLP_LINE line;
-        line.SizeOfStruct = sizeof(IMAGEHLP_LINE);
-
-        if (SymGetLineFromAddr(process, frame.AddrPC.Offset, &offset, &line))
-        {
-          stackTraceEntry->fileName.Append(line.FileName, uint32(strlen(line.FileName)));
-          stackTraceEntry->fileName.NullTerminate();
-          stackTraceEntry->lineNum = line.LineNumber;
-        }
-        else
-        {
-          stackTraceEntry->fileName.Append("InvalidFile");
-          stackTraceEntry->lineNum = 0;
-        }
+        str.Append(name, Min((uint32)strlen(name), str.LenRemaining()));
       };
 
-      StackTraceEntry* currentStackFrame = (StackTraceEntry*)stackEntryAllocator.Alloc(
-        sizeof(StackTraceEntry), alignof(StackTraceEntry));
-      currentStackFrame->Init();
-      if (StackWalk(machine, process, thread, &frame, &context, NULL,
-                    SymFunctionTableAccess, SymGetModuleBase, NULL))
+      bool foundSymbol = false;
+#ifdef ENABLE_MEM_TRACKING
+      // Needs SymInitialize(), which the app only calls when mem tracking is enabled
+      HANDLE process = GetCurrentProcess();
+      DWORD64 moduleBase = SymGetModuleBase64(process, address);
+      if (moduleBase)
       {
-        *topOfStack = currentStackFrame;
-        ProcessStackWalk(currentStackFrame);
+        char moduleName[MAX_PATH];
+        const DWORD len = GetModuleFileNameA((HINSTANCE)moduleBase, moduleName, MAX_PATH);
+        const char* fileName = moduleName;
+        for (DWORD i = 0; i < len; ++i)
+        {
+          if (moduleName[i] == '\\' || moduleName[i] == '/')
+          {
+            fileName = &moduleName[i + 1];
+          }
+        }
+        AppendTruncated(fileName);
+        AppendTruncated("!");
       }
-      else
+
+      const uint32 maxNameLen = 1024;
+      alignas(IMAGEHLP_SYMBOL64) char
+        symbolBuffer[sizeof(IMAGEHLP_SYMBOL64) + maxNameLen];
+      PIMAGEHLP_SYMBOL64 symbol = (PIMAGEHLP_SYMBOL64)symbolBuffer;
+      symbol->SizeOfStruct = sizeof(IMAGEHLP_SYMBOL64);
+      symbol->MaxNameLength = maxNameLen - 1;
+      if (SymGetSymFromAddr64(process, address, NULL, symbol))
       {
-        return 1;
+        AppendTruncated(symbol->Name);
+        foundSymbol = true;
       }
+#endif
 
-      while (StackWalk(machine, process, thread, &frame, &context, NULL,
-                       SymFunctionTableAccess, SymGetModuleBase, NULL))
+      if (!foundSymbol)
       {
-        StackTraceEntry* newStackFrame = (StackTraceEntry*)stackEntryAllocator.Alloc(
-          sizeof(StackTraceEntry), alignof(StackTraceEntry));
-        newStackFrame->Init();
-        currentStackFrame->next = newStackFrame;
-        currentStackFrame = currentStackFrame->next;
-
-        ProcessStackWalk(currentStackFrame);
+        char hexBuffer[32];
+        _ui64toa_s(address, hexBuffer, ARRAYCOUNT(hexBuffer), 16);
+        AppendTruncated("0x");
+        AppendTruncated(hexBuffer);
       }
-
-      return 0;
-
-#endif
+      str.NullTerminate();
     }
   } //namespace Platform
 } //namespace Tk
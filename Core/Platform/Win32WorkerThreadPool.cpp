@@ -1,132 +1,116 @@
-#include "Win32WorkerThreadPool.h"
-#include "PlatformGameAPI.h"
-#include <emmintrin.h>
+#ifdef _WIN32
+#include "WorkerThreadPoolPlatform.h"
 #include <process.h>
 #include <windows.h>
 
-#define NUM_JOBS_PER_WORKER 512
-#define WORKER_THREAD_STACK_SIZE 1024 * 1024 * 2
-#define MAX_THREADS 16u
-
 namespace Tk
 {
   namespace Platform
   {
     namespace ThreadPool
     {
-      typedef struct thread_info
+      static void __cdecl Win32WorkerThreadStart(void* arg)
       {
-        alignas(CACHE_LINE) volatile uint32 terminate = 0;
-        volatile bool didTerminate = 1;
-        uint32 threadId = 0;
-        alignas(CACHE_LINE) uint64 semaphoreHandle = TINKER_INVALID_HANDLE;
-        alignas(CACHE_LINE) Core::RingBuffer<WorkerJob*> jobs;
-      } ThreadInfo;
-
-      static ThreadInfo g_Threads[MAX_THREADS];
-      static volatile uint32 g_NumThreads = 0;
-      static volatile uint32 g_SchedulerCounter = 0;
+        WorkerThreadMain(arg);
+      }
 
-      uint32 NumWorkerThreads()
+      bool CreateWorkerThread(void* arg, uint32 stackSize)
       {
-        return g_NumThreads;
+        return _beginthread(Win32WorkerThreadStart, stackSize, arg) != (uintptr_t)-1;
       }
 
-      void __cdecl WorkerThreadFunction(void* arg)
+      uint32 GetCoreOrder(uint32* logicalCores, uint32 maxCores, uint32* numPhysical)
       {
-        ThreadInfo* info = (ThreadInfo*)(arg);
+        *numPhysical = 0;
 
-      outer_loop:
-        while (!info->terminate)
+        // Only processor group 0, threads start there and it holds up to 64 cores
+        SYSTEM_LOGICAL_PROCESSOR_INFORMATION info[256];
+        DWORD infoSize = sizeof(info);
+        if (!GetLogicalProcessorInformation(info, &infoSize))
         {
-          const uint32 limit = 4096;
-          uint32 count = 0;
-
-          while (count++ < limit)
+          SYSTEM_INFO systemInfo = {};
+          GetSystemInfo(&systemInfo);
+          const uint32 numCores = Min((uint32)systemInfo.dwNumberOfProcessors, maxCores);
+          for (uint32 i = 0; i < numCores; ++i)
           {
-            uint32 head = info->jobs.m_head.load(std::memory_order_acquire);
-            uint32 tail = info->jobs.m_tail.load(std::memory_order_acquire);
+            logicalCores[i] = i;
+          }
+          *numPhysical = numCores;
+          return numCores;
+        }
 
-            if (head - tail > 0)
+        DWORD_PTR processMask = 0;
+        DWORD_PTR systemMask = 0;
+        GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask);
+
+        const uint32 numInfos = infoSize / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+        uint32 numCores = 0;
+        // First pass takes the lowest allowed logical core of each physical core, the
+        // second the rest
+        for (uint32 pass = 0; pass < 2; ++pass)
+        {
+          for (uint32 uiInfo = 0; uiInfo < numInfos; ++uiInfo)
+          {
+            if (info[uiInfo].Relationship != RelationProcessorCore)
             {
-              WorkerJob* job;
-              info->jobs.Dequeue(&job);
-              (*job)();
-              job->m_done = 1;
-              goto outer_loop; // reset counter until sema
+              continue;
             }
-            _mm_pause();
-            _mm_pause();
-            _mm_pause();
-            _mm_pause();
-          }
 
-          WaitForSingleObjectEx((HANDLE)info->semaphoreHandle, INFINITE, FALSE);
-        }
+            uint64 mask = (uint64)(info[uiInfo].ProcessorMask & processMask);
+            if (pass == 0 && mask)
+            {
+              mask &= ~(mask - 1);
+            }
+            else if (pass == 1)
+            {
+              mask &= mask - 1;
+            }
 
-        info->didTerminate = 1;
-      }
+            for (uint32 core = 0; core < 64 && numCores < maxCores; ++core)
+            {
+              if (mask & (1ull << core))
+              {
+                logicalCores[numCores++] = core;
+              }
+            }
+          }
 
-      void Startup(uint32 NumThreads)
-      {
-        g_NumThreads = Min(NumThreads, MAX_THREADS);
-        for (uint32 i = 0; i < g_NumThreads; ++i)
-        {
-          g_Threads[i].jobs.Init(NUM_JOBS_PER_WORKER);
-          g_Threads[i].terminate = 0;
-          g_Threads[i].didTerminate = 0;
-          g_Threads[i].threadId = i;
-          g_Threads[i].semaphoreHandle = (uint64)CreateSemaphoreEx(
-            0, 0, NUM_JOBS_PER_WORKER, 0, 0, SEMAPHORE_ALL_ACCESS);
-          _beginthread(WorkerThreadFunction, WORKER_THREAD_STACK_SIZE, &g_Threads[i]);
+          if (pass == 0)
+          {
+            *numPhysical = numCores;
+          }
         }
+        return numCores;
       }
 
-      void Shutdown()
+      void PinCurrentThread(uint32 logicalCore)
       {
-        // Tell the threads to wake up and terminate ASAP
-        for (uint32 i = 0; i < g_NumThreads; ++i)
+        if (logicalCore < 64)
         {
-          g_Threads[i].terminate = 1;
-          ReleaseSemaphore((HANDLE)g_Threads[i].semaphoreHandle, 1, 0);
-        }
-        // Wait for the threads to finish their current tasks, then terminate
-        for (uint32 i = 0; i < g_NumThreads; ++i)
-        {
-          while (!g_Threads[i].didTerminate)
-            ;
-        }
-
-        // Free the job buffers
-        for (uint32 i = 0; i < g_NumThreads; ++i)
-        {
-          g_Threads[i].jobs.ExplicitFree();
+          SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << logicalCore);
         }
       }
 
-      void EnqueueSingleJob(WorkerJob* Job)
+      void WaitOnValue(std::atomic<uint32>* address, uint32 expected, uint32 timeoutMs)
       {
-        g_Threads[g_SchedulerCounter].jobs.Enqueue(Job);
-        ReleaseSemaphore((HANDLE)g_Threads[g_SchedulerCounter].semaphoreHandle, 1, 0);
-        g_SchedulerCounter = (g_SchedulerCounter + 1) % g_NumThreads;
+        WaitOnAddress((volatile VOID*)address, (PVOID)&expected, sizeof(expected),
+                      timeoutMs == THREAD_WAIT_INFINITE ? INFINITE : timeoutMs);
       }
 
-      void EnqueueJobList(WorkerJobList* JobList)
+      void WakeOnValue(std::atomic<uint32>* address, uint32 numToWake)
       {
-        uint32 NumJobs = JobList->m_numJobs;
-        for (uint32 uiJob = 0; uiJob < NumJobs; ++uiJob)
+        // There's no wake n, but the pool never has more than a few sleepers
+        if (numToWake == THREAD_WAKE_ALL)
         {
-          EnqueueSingleJob(JobList->m_jobs[uiJob]);
+          WakeByAddressAll((PVOID)address);
+          return;
         }
-      }
-
-      void EnqueueJobSubList(WorkerJobList* JobList, uint32 NumJobs)
-      {
-        for (uint32 uiJob = 0; uiJob < NumJobs; ++uiJob)
+        for (uint32 i = 0; i < numToWake; ++i)
         {
-          EnqueueSingleJob(JobList->m_jobs[uiJob]);
+          WakeByAddressSingle((PVOID)address);
         }
       }
     } //namespace ThreadPool
   } //namespace Platform
 } //namespace Tk
+#endif
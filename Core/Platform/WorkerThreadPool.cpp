@@ -0,0 +1,789 @@
+#include "WorkerThreadPool.h"
+#include "DataStructures/WorkStealingDeque.h"
+#include "PlatformGameAPI.h"
+#include "SpinLock.h"
+#include "StringTypes.h"
+#include "Utility/AllocatorRegistry.h"
+#include "Utility/JobProfiler.h"
+#include "WorkerThreadPoolPlatform.h"
+#include <emmintrin.h>
+
+#define NUM_JOBS_PER_WORKER 4096
+#define NUM_INJECTED_JOBS 4096
+#define WORKER_THREAD_STACK_SIZE 1024 * 1024 * 2
+#define MAX_THREADS 16u
+#define MAX_CORES 256u
+#define WORKER_THREAD_SCRATCH_BLOCK_SIZE 1024 * 1024 * 4
+#define JOB_WAIT_SPINS_BEFORE_PARK 4096
+#define JOB_POOL_JOBS_PER_PAGE 4096
+// Parked waiters wake up this often to help with jobs queued after they parked
+#define JOB_WAIT_PARK_TIMEOUT_MS 1
+
+namespace Tk
+{
+  namespace Platform
+  {
+    namespace ThreadPool
+    {
+      // Work stealing scheduler.
+      // Jobs enqueued from a worker go on the bottom of that worker's own deque and get
+      // popped LIFO, so spawned work runs hot in cache. Jobs enqueued from any other
+      // thread go to a shared injection queue. Idle workers take from their own deque,
+      // then the injection queue, then steal the oldest job from a random other worker,
+      // so one long job only holds up the worker running it.
+      // Every priority has its own deques and injection queue. Higher priorities are
+      // checked first, and background jobs only run on the first few workers, so the
+      // others are always there for frame work however much background work is queued.
+      typedef struct thread_info
+      {
+        alignas(CACHE_LINE) std::atomic<uint32> terminate = 0;
+        std::atomic<uint32> didTerminate = 1;
+        uint32 threadId = 0;
+        uint32 randState = 0;
+        uint32 logicalCore = TINKER_INVALID_HANDLE; // to pin to
+        Core::WorkStealingDeque<WorkerJob*> jobs[JobPriority::eCount];
+      } ThreadInfo;
+
+      // Multi producer multi consumer, grows when full. Only external submissions go
+      // through here, so the lock is not on the path of work the workers spawn.
+      struct InjectionQueue
+      {
+        Core::SpinLock m_lock;
+        WorkerJob** m_jobs = nullptr;
+        uint32 m_capacity = 0;
+        uint32 m_head = 0;
+        alignas(CACHE_LINE) std::atomic<uint32> m_size = 0;
+
+        void Init(uint32 capacity)
+        {
+          m_jobs = (WorkerJob**)Core::CoreMallocAligned(capacity * sizeof(WorkerJob*),
+                                                        CACHE_LINE);
+          m_capacity = capacity;
+          m_head = 0;
+          m_size = 0;
+        }
+
+        void ExplicitFree()
+        {
+          Core::CoreFreeAligned(m_jobs);
+          m_jobs = nullptr;
+          m_capacity = 0;
+        }
+
+        void Push(WorkerJob** jobs, uint32 numJobs)
+        {
+          m_lock.Lock();
+          const uint32 size = m_size.load(std::memory_order_relaxed);
+          if (size + numJobs > m_capacity)
+          {
+            uint32 newCapacity = m_capacity * 2;
+            while (size + numJobs > newCapacity)
+            {
+              newCapacity *= 2;
+            }
+            WorkerJob** newJobs = (WorkerJob**)Core::CoreMallocAligned(
+              newCapacity * sizeof(WorkerJob*), CACHE_LINE);
+            for (uint32 i = 0; i < size; ++i)
+            {
+              newJobs[i] = m_jobs[(m_head + i) % m_capacity];
+            }
+            Core::CoreFreeAligned(m_jobs);
+            m_jobs = newJobs;
+            m_capacity = newCapacity;
+            m_head = 0;
+          }
+          for (uint32 i = 0; i < numJobs; ++i)
+          {
+            m_jobs[(m_head + size + i) % m_capacity] = jobs[i];
+          }
+          m_size.store(size + numJobs, std::memory_order_seq_cst);
+          m_lock.Unlock();
+        }
+
+        bool Pop(WorkerJob** job)
+        {
+          if (!m_size.load(std::memory_order_relaxed))
+          {
+            return false;
+          }
+
+          bool found = false;
+          m_lock.Lock();
+          const uint32 size = m_size.load(std::memory_order_relaxed);
+          if (size)
+          {
+            *job = m_jobs[m_head];
+            m_head = (m_head + 1) % m_capacity;
+            m_size.store(size - 1, std::memory_order_relaxed);
+            found = true;
+          }
+          m_lock.Unlock();
+          return found;
+        }
+      };
+
+      static ThreadInfo g_Threads[MAX_THREADS];
+      // Zero while the pool isn't running. Published after the deques are set up, so
+      // anything that loads it nonzero can index g_Threads below it.
+      static std::atomic<uint32> g_NumThreads = 0;
+      static InjectionQueue g_InjectionQueues[JobPriority::eCount];
+      // Workers below this index can run background jobs
+      static std::atomic<uint32> g_NumBackgroundWorkers = 1;
+
+      // Idle workers park on a futex style semaphore, m_wakeTokens. Submitters only
+      // touch it when someone is actually asleep, and only hand out as many tokens as
+      // there are new jobs, so enqueueing while the workers spin costs no syscall.
+      struct SleepGroup
+      {
+        alignas(CACHE_LINE) std::atomic<uint32> m_numSleeping = 0;
+        alignas(CACHE_LINE) std::atomic<uint32> m_wakeTokens = 0;
+      };
+
+      // Workers that can run background jobs sleep apart from the others, so that
+      // background jobs only wake workers that can take them
+      namespace SleepGroupIndex
+      {
+        enum : uint32
+        {
+          eFrameWorkers = 0,
+          eBackgroundWorkers,
+          eCount,
+        };
+      }
+      static SleepGroup g_SleepGroups[SleepGroupIndex::eCount];
+
+      static thread_local ThreadInfo* t_Worker = nullptr;
+      // For threads outside the pool that help while waiting
+      static thread_local uint32 t_HelperRandState = 0x2545F491u;
+
+      // Lives as long as the process, jobs can be freed after Shutdown() and created
+      // before Startup()
+      static Core::PoolAllocator<InlineJob>& GetJobPool()
+      {
+        static Core::PoolAllocator<InlineJob>* pool = []() {
+          static Core::PoolAllocator<InlineJob> jobPool;
+          jobPool.Init(JOB_POOL_JOBS_PER_PAGE, CACHE_LINE);
+          Core::Utility::RegisterAllocator(jobPool, "Worker jobs");
+          return &jobPool;
+        }();
+        return *pool;
+      }
+
+      uint32 NumWorkerThreads()
+      {
+        return g_NumThreads.load(std::memory_order_relaxed);
+      }
+
+      void SetNumBackgroundWorkers(uint32 NumWorkers)
+      {
+        const uint32 numThreads = g_NumThreads.load(std::memory_order_relaxed);
+        g_NumBackgroundWorkers.store(CLAMP(NumWorkers, 1u, Max(numThreads, 1u)),
+                                     std::memory_order_relaxed);
+      }
+
+      uint32 NumBackgroundWorkers()
+      {
+        return g_NumBackgroundWorkers.load(std::memory_order_relaxed);
+      }
+
+      uint32 DefaultNumWorkerThreads()
+      {
+        uint32 cores[MAX_CORES];
+        uint32 numPhysical = 0;
+        GetCoreOrder(cores, MAX_CORES, &numPhysical);
+        return Min(Max(numPhysical, 2u) - 1, MAX_THREADS);
+      }
+
+      static uint32 NextRandom(uint32* randState)
+      {
+        // xorshift32
+        uint32 x = *randState;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        *randState = x;
+        return x;
+      }
+
+      // Priorities a thread takes jobs from are the ones below this. Threads outside the
+      // pool never take background jobs, a frame waiting on its own work shouldn't end up
+      // running a long one.
+      static uint32 NumPrioritiesFor(ThreadInfo* info)
+      {
+        const uint32 numBackgroundWorkers =
+          g_NumBackgroundWorkers.load(std::memory_order_relaxed);
+        if (info && info->threadId < numBackgroundWorkers)
+        {
+          return JobPriority::eCount;
+        }
+        return JobPriority::eBackground;
+      }
+
+      // info is null for threads outside the pool, they don't have a deque of their own.
+      // numThreads is one load of g_NumThreads by the caller, it has to be nonzero.
+      static bool FindJob(ThreadInfo* info, uint32 numThreads, uint32* randState,
+                          WorkerJob** job)
+      {
+        // Everything local to this thread before any stealing, so a worker busy with
+        // its own jobs doesn't go through every other worker's deques for each one.
+        // The size check saves Pop()'s fence on the lanes that are empty.
+        const uint32 numPriorities = NumPrioritiesFor(info);
+        for (uint32 priority = 0; priority < numPriorities; ++priority)
+        {
+          if ((info && info->jobs[priority].Size() && info->jobs[priority].Pop(job))
+              || g_InjectionQueues[priority].Pop(job))
+          {
+            return true;
+          }
+        }
+
+        for (uint32 priority = 0; priority < numPriorities; ++priority)
+        {
+          const uint32 firstVictim = NextRandom(randState) % numThreads;
+          for (uint32 i = 0; i < numThreads; ++i)
+          {
+            ThreadInfo* victim = &g_Threads[(firstVictim + i) % numThreads];
+            if (victim != info && victim->jobs[priority].Steal(job))
+            {
+              Core::Utility::RecordJobEvent(Core::Utility::JobEventType::eInstant,
+                                            "Steal", victim->threadId);
+              return true;
+            }
+          }
+        }
+        return false;
+      }
+
+      // Everything the pool runs goes through here, so the job profiler sees it
+      static void RunQueuedJob(WorkerJob* job)
+      {
+        // The job can be freed once it's done, so its name isn't read after
+        Core::Utility::RecordJobEvent(Core::Utility::JobEventType::eBegin,
+                                      job->m_name ? job->m_name : "Job", 0);
+        RunJob(job);
+        Core::Utility::RecordJobEvent(Core::Utility::JobEventType::eEnd, nullptr, 0);
+      }
+
+      static bool AnyJobsQueued(uint32 numPriorities)
+      {
+        const uint32 numThreads = g_NumThreads.load(std::memory_order_acquire);
+        for (uint32 priority = 0; priority < numPriorities; ++priority)
+        {
+          if (g_InjectionQueues[priority].m_size.load(std::memory_order_seq_cst))
+          {
+            return true;
+          }
+          for (uint32 i = 0; i < numThreads; ++i)
+          {
+            if (g_Threads[i].jobs[priority].Size())
+            {
+              return true;
+            }
+          }
+        }
+        return false;
+      }
+
+      // Takes a sleeper token so exactly one submitter releases the semaphore for it
+      static bool TryClaimSleeper(SleepGroup* group)
+      {
+        uint32 numSleeping = group->m_numSleeping.load(std::memory_order_seq_cst);
+        while (numSleeping)
+        {
+          if (group->m_numSleeping.compare_exchange_weak(numSleeping, numSleeping - 1,
+                                                         std::memory_order_seq_cst))
+          {
+            return true;
+          }
+        }
+        return false;
+      }
+
+      static void ParkWorker(SleepGroup* group)
+      {
+        while (true)
+        {
+          uint32 numTokens = group->m_wakeTokens.load(std::memory_order_acquire);
+          while (numTokens)
+          {
+            if (group->m_wakeTokens.compare_exchange_weak(numTokens, numTokens - 1,
+                                                          std::memory_order_acquire))
+            {
+              return;
+            }
+          }
+          // Returns straight away if a token showed up since the load
+          WaitOnValue(&group->m_wakeTokens, 0, THREAD_WAIT_INFINITE);
+        }
+      }
+
+      static void ReleaseWorkers(SleepGroup* group, uint32 numToWake)
+      {
+        group->m_wakeTokens.fetch_add(numToWake, std::memory_order_release);
+        WakeOnValue(&group->m_wakeTokens, numToWake);
+      }
+
+      static void WakeWorkers(uint32 priority, uint32 numJobs)
+      {
+        // Pairs with the fence in the worker between announcing it's going to sleep
+        // and checking the queues one last time, so one of the two sees the other
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Frame workers first, background workers are better left free for background
+        // jobs. Background jobs only wake background workers. Worker 0 always is one,
+        // so it's either awake or asleep in that group, whatever the setting was when
+        // the others went to sleep.
+        uint32 numLeft = numJobs;
+        uint32 groupIndex = priority == JobPriority::eBackground
+                              ? SleepGroupIndex::eBackgroundWorkers
+                              : SleepGroupIndex::eFrameWorkers;
+        for (; groupIndex < SleepGroupIndex::eCount && numLeft; ++groupIndex)
+        {
+          SleepGroup* group = &g_SleepGroups[groupIndex];
+          uint32 numToWake = 0;
+          while (numToWake < numLeft && TryClaimSleeper(group))
+          {
+            ++numToWake;
+          }
+          if (numToWake)
+          {
+            ReleaseWorkers(group, numToWake);
+          }
+          numLeft -= numToWake;
+        }
+      }
+
+      void WorkerThreadMain(void* arg)
+      {
+        ThreadInfo* info = (ThreadInfo*)(arg);
+        t_Worker = info;
+        if (info->logicalCore != TINKER_INVALID_HANDLE)
+        {
+          PinCurrentThread(info->logicalCore);
+        }
+        Core::InitThreadScratch(WORKER_THREAD_SCRATCH_BLOCK_SIZE);
+
+        char nameBuffer[Core::Utility::eMaxJobProfilerThreadNameLen];
+        Core::StrBuilder name(nameBuffer, ARRAYCOUNT(nameBuffer));
+        name.Append("Worker ").AppendU64(info->threadId);
+        Core::Utility::SetJobProfilerThreadName(name.CStr());
+
+      outer_loop:
+        while (!info->terminate)
+        {
+          const uint32 limit = 4096;
+          uint32 count = 0;
+
+          while (count++ < limit)
+          {
+            WorkerJob* job;
+            // Never zero while a worker is running, Shutdown() waits for them first
+            if (FindJob(info, g_NumThreads.load(std::memory_order_acquire), &info->randState,
+                        &job))
+            {
+              RunQueuedJob(job);
+              goto outer_loop; // reset counter until sema
+            }
+            _mm_pause();
+            _mm_pause();
+            _mm_pause();
+            _mm_pause();
+          }
+
+          const uint32 numPriorities = NumPrioritiesFor(info);
+          SleepGroup* group = &g_SleepGroups[numPriorities == JobPriority::eCount
+                                               ? SleepGroupIndex::eBackgroundWorkers
+                                               : SleepGroupIndex::eFrameWorkers];
+          group->m_numSleeping.fetch_add(1, std::memory_order_seq_cst);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (info->terminate || AnyJobsQueued(numPriorities))
+          {
+            // If a submitter already took our token, there's a wake token extra and
+            // some worker just wakes up once for nothing
+            TryClaimSleeper(group);
+            continue;
+          }
+          Core::Utility::RecordJobEvent(Core::Utility::JobEventType::eBegin, "Parked", 0);
+          ParkWorker(group);
+          Core::Utility::RecordJobEvent(Core::Utility::JobEventType::eEnd, nullptr, 0);
+        }
+
+        Core::Utility::ReleaseJobProfilerThread();
+        Core::ShutdownThreadScratch();
+        t_Worker = nullptr;
+        // Everything this thread touched is visible to Shutdown() once it sees this
+        info->didTerminate.store(1, std::memory_order_release);
+      }
+
+      void Startup(uint32 NumThreads)
+      {
+        Startup(NumThreads, CorePinning::eNone);
+      }
+
+      void Startup(uint32 NumThreads, uint32 Pinning)
+      {
+        const uint32 numThreads = Max(Min(NumThreads, MAX_THREADS), 1u);
+        g_NumBackgroundWorkers = Max(numThreads / 2, 1u);
+        for (uint32 i = 0; i < SleepGroupIndex::eCount; ++i)
+        {
+          g_SleepGroups[i].m_numSleeping = 0;
+          g_SleepGroups[i].m_wakeTokens = 0;
+        }
+        for (uint32 i = 0; i < JobPriority::eCount; ++i)
+        {
+          g_InjectionQueues[i].Init(NUM_INJECTED_JOBS);
+        }
+
+        uint32 cores[MAX_CORES];
+        uint32 numCores = 0;
+        if (Pinning != CorePinning::eNone)
+        {
+          uint32 numPhysical = 0;
+          numCores = GetCoreOrder(cores, MAX_CORES, &numPhysical);
+          if (Pinning == CorePinning::eLogicalCores)
+          {
+            // Back in the OS's numbering
+            for (uint32 i = 1; i < numCores; ++i)
+            {
+              const uint32 core = cores[i];
+              uint32 j = i;
+              for (; j > 0 && cores[j - 1] > core; --j)
+              {
+                cores[j] = cores[j - 1];
+              }
+              cores[j] = core;
+            }
+          }
+          else
+          {
+            numCores = numPhysical;
+          }
+        }
+
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+          for (uint32 priority = 0; priority < JobPriority::eCount; ++priority)
+          {
+            g_Threads[i].jobs[priority].Init(NUM_JOBS_PER_WORKER);
+          }
+          g_Threads[i].terminate = 0;
+          g_Threads[i].didTerminate = 0;
+          g_Threads[i].threadId = i;
+          g_Threads[i].randState = 0x9E3779B9u * (i + 1);
+          // With more workers than cores they wrap around and share
+          g_Threads[i].logicalCore =
+            numCores ? cores[(i + 1) % numCores] : TINKER_INVALID_HANDLE;
+        }
+        // Every deque has to exist before any worker tries to steal from it
+        g_NumThreads.store(numThreads, std::memory_order_release);
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+          if (!CreateWorkerThread(&g_Threads[i], WORKER_THREAD_STACK_SIZE))
+          {
+            // Its deques just stay empty, they're never pushed to from outside the worker
+            g_Threads[i].didTerminate = 1;
+            TINKER_ASSERT(0);
+          }
+        }
+      }
+
+      void Shutdown()
+      {
+        const uint32 numThreads = g_NumThreads.load(std::memory_order_relaxed);
+
+        // Tell the threads to wake up and terminate ASAP
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+          g_Threads[i].terminate = 1;
+        }
+        for (uint32 i = 0; i < SleepGroupIndex::eCount; ++i)
+        {
+          ReleaseWorkers(&g_SleepGroups[i], numThreads);
+        }
+        // Wait for the threads to finish their current tasks, then terminate
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+          while (!g_Threads[i].didTerminate.load(std::memory_order_acquire))
+            ;
+        }
+
+        // Helpers that load it from here on see the pool as stopped
+        g_NumThreads.store(0, std::memory_order_release);
+
+        // Free the job buffers
+        for (uint32 i = 0; i < numThreads; ++i)
+        {
+          for (uint32 priority = 0; priority < JobPriority::eCount; ++priority)
+          {
+            g_Threads[i].jobs[priority].ExplicitFree();
+          }
+        }
+        for (uint32 i = 0; i < JobPriority::eCount; ++i)
+        {
+          g_InjectionQueues[i].ExplicitFree();
+        }
+      }
+
+      bool RunPendingJob()
+      {
+        // Loaded once, a second read could see Shutdown()'s zero
+        const uint32 numThreads = g_NumThreads.load(std::memory_order_acquire);
+        if (!numThreads)
+        {
+          return false;
+        }
+
+        ThreadInfo* worker = t_Worker;
+        uint32* randState = worker ? &worker->randState : &t_HelperRandState;
+        WorkerJob* job;
+        if (FindJob(worker, numThreads, randState, &job))
+        {
+          RunQueuedJob(job);
+          return true;
+        }
+        return false;
+      }
+
+      static void EnqueueJobsWithPriority(uint32 priority, WorkerJob** jobs,
+                                          uint32 numJobs)
+      {
+        // A worker that can't run background jobs still keeps them, the background
+        // workers steal them
+        ThreadInfo* worker = t_Worker;
+        uint32 numPushed = 0;
+        if (worker)
+        {
+          while (numPushed < numJobs && worker->jobs[priority].Push(jobs[numPushed]))
+          {
+            ++numPushed;
+          }
+        }
+        if (numPushed < numJobs)
+        {
+          // Not a worker, or its deque is full
+          g_InjectionQueues[priority].Push(&jobs[numPushed], numJobs - numPushed);
+        }
+        WakeWorkers(priority, numJobs);
+      }
+
+      static void EnqueueJobs(WorkerJob** jobs, uint32 numJobs)
+      {
+        if (!g_NumThreads.load(std::memory_order_acquire))
+        {
+          // Pool not started, run them right here
+          for (uint32 i = 0; i < numJobs; ++i)
+          {
+            RunQueuedJob(jobs[i]);
+          }
+          return;
+        }
+
+        // Runs of jobs with the same priority go in together
+        uint32 first = 0;
+        while (first < numJobs)
+        {
+          const uint32 priority = jobs[first]->m_priority;
+          TINKER_ASSERT(priority < JobPriority::eCount);
+          uint32 end = first + 1;
+          while (end < numJobs && jobs[end]->m_priority == priority)
+          {
+            ++end;
+          }
+          EnqueueJobsWithPriority(priority, &jobs[first], end - first);
+          first = end;
+        }
+      }
+
+      void EnqueueSingleJob(WorkerJob* Job)
+      {
+        EnqueueJobs(&Job, 1);
+      }
+
+      void EnqueueJobList(WorkerJobList* JobList)
+      {
+        EnqueueJobs(JobList->m_jobs, JobList->m_numJobs);
+      }
+
+      void EnqueueJobSubList(WorkerJobList* JobList, uint32 NumJobs)
+      {
+        EnqueueJobs(JobList->m_jobs, NumJobs);
+      }
+    } //namespace ThreadPool
+
+    ALLOC_INLINE_JOB(AllocInlineJob)
+    {
+      Core::PoolAllocator<InlineJob>& pool = ThreadPool::GetJobPool();
+      const uint32 handle = pool.Alloc();
+      TINKER_ASSERT(handle != TINKER_INVALID_HANDLE);
+      InlineJob* job = new (pool.PtrFromHandle(handle)) InlineJob();
+      job->m_poolHandle = handle;
+      return job;
+    }
+
+    FREE_JOB(FreeJob)
+    {
+      const uint32 poolHandle = Job->m_poolHandle;
+      Job->~WorkerJob();
+      if (poolHandle != TINKER_INVALID_HANDLE)
+      {
+        ThreadPool::GetJobPool().Dealloc(poolHandle);
+      }
+      else
+      {
+        Core::CoreFreeAligned(Job);
+      }
+    }
+
+    ENQUEUE_WORKER_THREAD_JOB(EnqueueWorkerThreadJob)
+    {
+      ThreadPool::EnqueueSingleJob(Job);
+    }
+
+    ENQUEUE_WORKER_THREAD_JOB_LIST(EnqueueWorkerThreadJobList_Unassisted)
+    {
+      ThreadPool::EnqueueJobList(JobList);
+    }
+
+    ENQUEUE_WORKER_THREAD_JOB_LIST(EnqueueWorkerThreadJobList_Assisted)
+    {
+      uint32 NumJobs = JobList->m_numJobs;
+      uint32 NumThreads = ThreadPool::NumWorkerThreads() + 1;
+      uint32 NumJobsPerThread = NumJobs / NumThreads;
+
+      uint32 NumMainThreadJobs =
+        NumJobsPerThread; // main thread never does any leftover jobs for now
+      ThreadPool::EnqueueJobSubList(JobList, NumJobs - NumMainThreadJobs);
+
+      // Main thread work
+      for (uint32 uiJob = NumJobs - NumMainThreadJobs; uiJob < JobList->m_numJobs;
+           ++uiJob)
+      {
+        ThreadPool::RunQueuedJob(JobList->m_jobs[uiJob]);
+      }
+    }
+
+    LAUNCH_JOB(LaunchJob)
+    {
+      Job->m_counter = Counter;
+      Job->m_nextWaiting = nullptr;
+      if (Counter)
+      {
+        Counter->m_count.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      if (DependsOn)
+      {
+        // SignalJobCounter() takes the waiting list under the same lock, so the job
+        // either sees the counter at zero or gets released with the others
+        DependsOn->m_lock.Lock();
+        if (DependsOn->m_count.load(std::memory_order_acquire))
+        {
+          Job->m_nextWaiting = DependsOn->m_waitingJobs;
+          DependsOn->m_waitingJobs = Job;
+          DependsOn->m_lock.Unlock();
+          return;
+        }
+        DependsOn->m_lock.Unlock();
+      }
+      ThreadPool::EnqueueSingleJob(Job);
+    }
+
+    SIGNAL_JOB_COUNTER(SignalJobCounter)
+    {
+      // Only the decrement to zero has anything to release
+      uint32 count = Counter->m_count.load(std::memory_order_relaxed);
+      while (count > 1)
+      {
+        if (Counter->m_count.compare_exchange_weak(count, count - 1,
+                                                   std::memory_order_acq_rel))
+        {
+          return;
+        }
+      }
+
+      // Waiters take the lock once the count hits zero, so the counter stays alive
+      // until this is done with it
+      WorkerJob* waitingJobs = nullptr;
+      Counter->m_lock.Lock();
+      if (Counter->m_count.fetch_sub(1, std::memory_order_seq_cst) == 1)
+      {
+        waitingJobs = Counter->m_waitingJobs;
+        Counter->m_waitingJobs = nullptr;
+        if (Counter->m_numParked.load(std::memory_order_seq_cst))
+        {
+          ThreadPool::WakeOnValue(&Counter->m_count, THREAD_WAKE_ALL);
+        }
+      }
+      Counter->m_lock.Unlock();
+
+      // The list is in reverse launch order
+      WorkerJob* reversed = nullptr;
+      while (waitingJobs)
+      {
+        WorkerJob* next = waitingJobs->m_nextWaiting;
+        waitingJobs->m_nextWaiting = reversed;
+        reversed = waitingJobs;
+        waitingJobs = next;
+      }
+      while (reversed)
+      {
+        WorkerJob* next = reversed->m_nextWaiting;
+        reversed->m_nextWaiting = nullptr;
+        ThreadPool::EnqueueSingleJob(reversed);
+        reversed = next;
+      }
+    }
+
+    GET_NUM_WORKER_THREADS(GetNumWorkerThreads)
+    {
+      return ThreadPool::NumWorkerThreads();
+    }
+
+    WAIT_ON_JOB(WaitOnJob)
+    {
+      while (!Job->m_done.load(std::memory_order_acquire))
+      {
+        if (!ThreadPool::RunPendingJob())
+        {
+          _mm_pause();
+        }
+      }
+    }
+
+    WAIT_ON_JOB_COUNTER(WaitOnJobCounter)
+    {
+      uint32 numIdleSpins = 0;
+      while (true)
+      {
+        const uint32 count = Counter->m_count.load(std::memory_order_acquire);
+        if (!count)
+        {
+          break;
+        }
+
+        if (ThreadPool::RunPendingJob())
+        {
+          numIdleSpins = 0;
+        }
+        else if (AllowParking && ++numIdleSpins > JOB_WAIT_SPINS_BEFORE_PARK)
+        {
+          // Returns straight away if the count already changed
+          Counter->m_numParked.fetch_add(1, std::memory_order_seq_cst);
+          Core::Utility::RecordJobEvent(Core::Utility::JobEventType::eBegin, "Parked", 0);
+          ThreadPool::WaitOnValue(&Counter->m_count, count, JOB_WAIT_PARK_TIMEOUT_MS);
+          Core::Utility::RecordJobEvent(Core::Utility::JobEventType::eEnd, nullptr, 0);
+          Counter->m_numParked.fetch_sub(1, std::memory_order_relaxed);
+          numIdleSpins = 0;
+        }
+        else
+        {
+          _mm_pause();
+        }
+      }
+
+      // The job that released the counter may still be holding its lock
+      Counter->m_lock.Lock();
+      Counter->m_lock.Unlock();
+    }
+  } //namespace Platform
+} //namespace Tk
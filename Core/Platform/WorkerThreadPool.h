@@ -0,0 +1,46 @@
+#pragma once
+
+#include "PlatformGameAPI.h"
+
+namespace Tk
+{
+  namespace Platform
+  {
+    namespace ThreadPool
+    {
+      namespace CorePinning
+      {
+        enum : uint32
+        {
+          eNone = 0, // the OS schedules workers anywhere
+          ePhysicalCores, // one worker per physical core, SMT siblings last
+          eLogicalCores, // one worker per logical core, in the OS's numbering
+        };
+      }
+
+      // Pinned workers skip the first core of the order, it's left to the thread
+      // calling Startup()
+      void Startup(uint32 NumThreads);
+      void Startup(uint32 NumThreads, uint32 Pinning);
+      void Shutdown();
+      void EnqueueSingleJob(WorkerJob* Job);
+      void EnqueueJobList(WorkerJobList* JobList);
+      void EnqueueJobSubList(WorkerJobList* JobList, uint32 NumJobs);
+      // Runs one queued job on the calling thread, any thread can help this way.
+      // Threads outside the pool leave background jobs to the workers. Returns false if
+      // there was nothing to run.
+      bool RunPendingJob();
+
+      uint32 NumWorkerThreads();
+      // How many workers can run background jobs, at least 1 and at most all of them.
+      // Startup() sets it to half the workers. Workers pick up a change the next time
+      // they look for a job.
+      void SetNumBackgroundWorkers(uint32 NumWorkers);
+      uint32 NumBackgroundWorkers();
+      // One worker per physical core other than the caller's. SMT siblings share a
+      // core's execution units, so more workers than that rarely makes jobs finish
+      // sooner.
+      uint32 DefaultNumWorkerThreads();
+    } //namespace ThreadPool
+  } //namespace Platform
+} //namespace Tk
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include <atomic>
+
+// What the worker thread pool needs from the OS. Implemented once per platform, in
+// Win32WorkerThreadPool.cpp and LinuxWorkerThreadPool.cpp.
+
+#define THREAD_WAIT_INFINITE MAX_UINT32
+#define THREAD_WAKE_ALL MAX_UINT32
+
+namespace Tk
+{
+  namespace Platform
+  {
+    namespace ThreadPool
+    {
+      // Implemented by the pool, every worker thread runs this
+      void WorkerThreadMain(void* arg);
+      // Starts a detached thread running WorkerThreadMain(arg). The pool tracks when
+      // its threads are done itself.
+      bool CreateWorkerThread(void* arg, uint32 stackSize);
+
+      // Logical core ids, one per physical core first, then the SMT siblings. Only
+      // the cores this process is allowed to run on. Returns how many were written and
+      // how many of those are physical cores.
+      uint32 GetCoreOrder(uint32* logicalCores, uint32 maxCores, uint32* numPhysical);
+      void PinCurrentThread(uint32 logicalCore);
+
+      // Sleeps while *address == expected, for at most timeoutMs. Can return early,
+      // callers check the value again.
+      void WaitOnValue(std::atomic<uint32>* address, uint32 expected, uint32 timeoutMs);
+      // Wakes up to numToWake threads sleeping on address
+      void WakeOnValue(std::atomic<uint32>* address, uint32 numToWake);
+    } //namespace ThreadPool
+  } //namespace Platform
+} //namespace Tk
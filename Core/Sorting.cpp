@@ -0,0 +1,251 @@
+#include "Sorting.h"
+#include "Platform/ParallelFor.h"
+
+#include <atomic>
+
+namespace Tk
+{
+  namespace Core
+  {
+    enum : uint32
+    {
+      eRadixBits = 8,
+      eRadixBuckets = 1 << eRadixBits,
+      // Per pass counts for every chunk live on the calling thread's stack
+      eMaxRadixSortChunks = 16,
+    };
+
+    static inline uint64 RadixKey(uint32 ele)
+    {
+      return ele;
+    }
+
+    static inline uint64 RadixKey(uint64 ele)
+    {
+      return ele;
+    }
+
+    static inline uint64 RadixKey(const RadixSortPair32& ele)
+    {
+      return ele.m_key;
+    }
+
+    static inline uint64 RadixKey(const RadixSortPair64& ele)
+    {
+      return ele.m_key;
+    }
+
+    static inline uint32 RadixDigit(uint64 key, uint32 pass)
+    {
+      return (uint32)(key >> (pass * eRadixBits)) & (eRadixBuckets - 1);
+    }
+
+    // Turns counts into the index each bucket starts at
+    static void RadixPrefixSum(uint32* bucketCounts)
+    {
+      uint32 offset = 0;
+      for (uint32 uiBucket = 0; uiBucket < eRadixBuckets; ++uiBucket)
+      {
+        const uint32 count = bucketCounts[uiBucket];
+        bucketCounts[uiBucket] = offset;
+        offset += count;
+      }
+    }
+
+    template <typename tEle, uint32 NumPasses>
+    static void RadixSortSerial(tEle* data, uint32 numEles, tEle* scratch)
+    {
+      if (numEles < 2)
+      {
+        return;
+      }
+
+      // One read of the keys counts the digits for every pass
+      uint32 counts[NumPasses][eRadixBuckets] = {};
+      for (uint32 i = 0; i < numEles; ++i)
+      {
+        uint64 key = RadixKey(data[i]);
+        for (uint32 pass = 0; pass < NumPasses; ++pass)
+        {
+          ++counts[pass][key & (eRadixBuckets - 1)];
+          key >>= eRadixBits;
+        }
+      }
+
+      const uint64 firstKey = RadixKey(data[0]);
+      tEle* src = data;
+      tEle* dst = scratch;
+      for (uint32 pass = 0; pass < NumPasses; ++pass)
+      {
+        uint32* bucketOffsets = counts[pass];
+        if (bucketOffsets[RadixDigit(firstKey, pass)] == numEles)
+        {
+          // Every key has the same digit, this pass wouldn't move anything
+          continue;
+        }
+
+        RadixPrefixSum(bucketOffsets);
+        for (uint32 i = 0; i < numEles; ++i)
+        {
+          dst[bucketOffsets[RadixDigit(RadixKey(src[i]), pass)]++] = src[i];
+        }
+
+        tEle* tmp = src;
+        src = dst;
+        dst = tmp;
+      }
+
+      if (src != data)
+      {
+        memcpy(data, src, numEles * sizeof(tEle));
+      }
+    }
+
+    // Every pass counts each chunk's digits, works out where each chunk's elements go
+    // for every bucket, then moves them. Chunks go in order within each bucket, so the
+    // sort stays stable.
+    template <typename tEle, uint32 NumPasses>
+    static void RadixSortParallelImpl(tEle* data, uint32 numEles, tEle* scratch)
+    {
+      const uint32 numThreads = Platform::GetNumWorkerThreads() + 1;
+      if (numEles < RadixSortParallelMinEles || numThreads == 1)
+      {
+        RadixSortSerial<tEle, NumPasses>(data, numEles, scratch);
+        return;
+      }
+
+      const uint32 maxChunks = Min(numThreads, (uint32)eMaxRadixSortChunks);
+      const uint32 grainSize = (numEles + maxChunks - 1) / maxChunks;
+      const uint32 numChunks = (numEles + grainSize - 1) / grainSize;
+
+      // Total digit counts for every pass up front, just to find the passes to skip
+      std::atomic<uint32> totalCounts[NumPasses][eRadixBuckets] = {};
+      auto countAllDigits = [&](uint32, uint32 chunkBegin, uint32 chunkEnd)
+      {
+        uint32 counts[NumPasses][eRadixBuckets] = {};
+        for (uint32 i = chunkBegin; i < chunkEnd; ++i)
+        {
+          uint64 key = RadixKey(data[i]);
+          for (uint32 pass = 0; pass < NumPasses; ++pass)
+          {
+            ++counts[pass][key & (eRadixBuckets - 1)];
+            key >>= eRadixBits;
+          }
+        }
+        for (uint32 pass = 0; pass < NumPasses; ++pass)
+        {
+          for (uint32 uiBucket = 0; uiBucket < eRadixBuckets; ++uiBucket)
+          {
+            if (counts[pass][uiBucket])
+            {
+              totalCounts[pass][uiBucket].fetch_add(counts[pass][uiBucket],
+                                                    std::memory_order_relaxed);
+            }
+          }
+        }
+      };
+      Platform::ParallelForChunks(0, numEles, grainSize, countAllDigits);
+
+      const uint64 firstKey = RadixKey(data[0]);
+      uint32 chunkOffsets[eMaxRadixSortChunks][eRadixBuckets];
+      tEle* src = data;
+      tEle* dst = scratch;
+      for (uint32 pass = 0; pass < NumPasses; ++pass)
+      {
+        if (totalCounts[pass][RadixDigit(firstKey, pass)].load(std::memory_order_relaxed)
+            == numEles)
+        {
+          continue;
+        }
+
+        auto countDigits = [&](uint32 chunkIndex, uint32 chunkBegin, uint32 chunkEnd)
+        {
+          uint32* counts = chunkOffsets[chunkIndex];
+          memset(counts, 0, eRadixBuckets * sizeof(uint32));
+          for (uint32 i = chunkBegin; i < chunkEnd; ++i)
+          {
+            ++counts[RadixDigit(RadixKey(src[i]), pass)];
+          }
+        };
+        Platform::ParallelForChunks(0, numEles, grainSize, countDigits);
+
+        uint32 offset = 0;
+        for (uint32 uiBucket = 0; uiBucket < eRadixBuckets; ++uiBucket)
+        {
+          for (uint32 uiChunk = 0; uiChunk < numChunks; ++uiChunk)
+          {
+            const uint32 count = chunkOffsets[uiChunk][uiBucket];
+            chunkOffsets[uiChunk][uiBucket] = offset;
+            offset += count;
+          }
+        }
+
+        auto scatter = [&](uint32 chunkIndex, uint32 chunkBegin, uint32 chunkEnd)
+        {
+          uint32* bucketOffsets = chunkOffsets[chunkIndex];
+          for (uint32 i = chunkBegin; i < chunkEnd; ++i)
+          {
+            dst[bucketOffsets[RadixDigit(RadixKey(src[i]), pass)]++] = src[i];
+          }
+        };
+        Platform::ParallelForChunks(0, numEles, grainSize, scatter);
+
+        tEle* tmp = src;
+        src = dst;
+        dst = tmp;
+      }
+
+      if (src != data)
+      {
+        auto copyBack = [&](uint32, uint32 chunkBegin, uint32 chunkEnd)
+        {
+          memcpy(data + chunkBegin, src + chunkBegin,
+                 (chunkEnd - chunkBegin) * sizeof(tEle));
+        };
+        Platform::ParallelForChunks(0, numEles, grainSize, copyBack);
+      }
+    }
+
+    void RadixSort(uint32* data, uint32 numEles, uint32* scratch)
+    {
+      RadixSortSerial<uint32, 4>(data, numEles, scratch);
+    }
+
+    void RadixSort(uint64* data, uint32 numEles, uint64* scratch)
+    {
+      RadixSortSerial<uint64, 8>(data, numEles, scratch);
+    }
+
+    void RadixSort(RadixSortPair32* data, uint32 numEles, RadixSortPair32* scratch)
+    {
+      RadixSortSerial<RadixSortPair32, 4>(data, numEles, scratch);
+    }
+
+    void RadixSort(RadixSortPair64* data, uint32 numEles, RadixSortPair64* scratch)
+    {
+      RadixSortSerial<RadixSortPair64, 8>(data, numEles, scratch);
+    }
+
+    void RadixSortParallel(uint32* data, uint32 numEles, uint32* scratch)
+    {
+      RadixSortParallelImpl<uint32, 4>(data, numEles, scratch);
+    }
+
+    void RadixSortParallel(uint64* data, uint32 numEles, uint64* scratch)
+    {
+      RadixSortParallelImpl<uint64, 8>(data, numEles, scratch);
+    }
+
+    void RadixSortParallel(RadixSortPair32* data, uint32 numEles,
+                           RadixSortPair32* scratch)
+    {
+      RadixSortParallelImpl<RadixSortPair32, 4>(data, numEles, scratch);
+    }
+
+    void RadixSortParallel(RadixSortPair64* data, uint32 numEles,
+                           RadixSortPair64* scratch)
+    {
+      RadixSortParallelImpl<RadixSortPair64, 8>(data, numEles, scratch);
+    }
+  } //namespace Core
+} //namespace Tk
@@ -86,5 +86,192 @@ namespace Tk
       MergeSortRecursive((uint8*)data, numEles, eleSize, Compare, tmpList);
       Tk::Core::CoreFree(tmpList);
     }
+
+    // Ranges this short get an insertion sort rather than more partitioning
+    const uint32 IntroSortInsertionMaxEles = 16;
+
+    template <typename T>
+    void SwapEles(T& a, T& b)
+    {
+      T tmp = a;
+      a = b;
+      b = tmp;
+    }
+
+    template <typename T, typename LessFunc>
+    void InsertionSort(T* data, uint32 numEles, LessFunc& Less)
+    {
+      for (uint32 i = 1; i < numEles; ++i)
+      {
+        T ele = data[i];
+        uint32 j = i;
+        while (j > 0 && Less(ele, data[j - 1]))
+        {
+          data[j] = data[j - 1];
+          --j;
+        }
+        data[j] = ele;
+      }
+    }
+
+    template <typename T, typename LessFunc>
+    void HeapSiftDown(T* data, uint32 root, uint32 numEles, LessFunc& Less)
+    {
+      T ele = data[root];
+      while (1)
+      {
+        uint32 child = root * 2 + 1;
+        if (child >= numEles)
+        {
+          break;
+        }
+        if (child + 1 < numEles && Less(data[child], data[child + 1]))
+        {
+          ++child;
+        }
+        if (!Less(ele, data[child]))
+        {
+          break;
+        }
+        data[root] = data[child];
+        root = child;
+      }
+      data[root] = ele;
+    }
+
+    template <typename T, typename LessFunc>
+    void HeapSort(T* data, uint32 numEles, LessFunc& Less)
+    {
+      for (uint32 i = numEles / 2; i-- > 0;)
+      {
+        HeapSiftDown(data, i, numEles, Less);
+      }
+      for (uint32 last = numEles; last-- > 1;)
+      {
+        SwapEles(data[0], data[last]);
+        HeapSiftDown(data, 0, last, Less);
+      }
+    }
+
+    template <typename T, typename LessFunc>
+    void IntroSortRecursive(T* data, uint32 numEles, uint32 depthLimit, LessFunc& Less)
+    {
+      while (numEles > IntroSortInsertionMaxEles)
+      {
+        if (depthLimit == 0)
+        {
+          // Bad pivots keep coming up, heapsort can't go quadratic
+          HeapSort(data, numEles, Less);
+          return;
+        }
+        --depthLimit;
+
+        // Median of three, which also leaves an element no greater than the pivot at the
+        // front and one no less at the back to stop the scans below
+        const uint32 mid = numEles / 2;
+        T* first = &data[0];
+        T* middle = &data[mid];
+        T* last = &data[numEles - 1];
+        if (Less(*middle, *first))
+        {
+          SwapEles(*middle, *first);
+        }
+        if (Less(*last, *middle))
+        {
+          SwapEles(*last, *middle);
+          if (Less(*middle, *first))
+          {
+            SwapEles(*middle, *first);
+          }
+        }
+        const T pivot = *middle;
+
+        // Hoare partition, [0, j] ends up no greater than the pivot and the rest no less.
+        // The pivot isn't the last element, so neither side can be empty.
+        int64 i = -1;
+        int64 j = numEles;
+        while (1)
+        {
+          do
+          {
+            ++i;
+          } while (Less(data[i], pivot));
+          do
+          {
+            --j;
+          } while (Less(pivot, data[j]));
+          if (i >= j)
+          {
+            break;
+          }
+          SwapEles(data[i], data[j]);
+        }
+        const uint32 numLeft = (uint32)j + 1;
+
+        // Recurse into the smaller side and loop on the bigger one, so the stack stays
+        // O(log n) deep
+        if (numLeft < numEles - numLeft)
+        {
+          IntroSortRecursive(data, numLeft, depthLimit, Less);
+          data += numLeft;
+          numEles -= numLeft;
+        }
+        else
+        {
+          IntroSortRecursive(data + numLeft, numEles - numLeft, depthLimit, Less);
+          numEles = numLeft;
+        }
+      }
+      InsertionSort(data, numEles, Less);
+    }
+
+    // In place comparison sort: quicksort with median of three pivots, heapsort once the
+    // recursion goes too deep, insertion sort for short ranges. Never allocates, not
+    // stable. Less(a, b) returns true if a goes before b. Unlike MergeSort()'s
+    // callback it's a template parameter, so a lambda gets inlined.
+    template <typename T, typename LessFunc>
+    void IntroSort(T* data, uint32 numEles, LessFunc Less)
+    {
+      if (numEles < 2)
+      {
+        return;
+      }
+      IntroSortRecursive(data, numEles, 2 * (32 - CountLeadingZeros32(numEles)), Less);
+    }
+
+    // LSD radix sort, one byte of the key per pass, stable. No compares, so it's much
+    // faster than MergeSort() for plain integer keys, and a pass is skipped when every
+    // key has the same value in that byte, e.g. the upper bytes of small IDs.
+    // scratch has room for numEles elements and is clobbered, the result ends up back in
+    // data. Keys are unsigned, flip the sign bit of signed keys first.
+    struct RadixSortPair32
+    {
+      uint32 m_key;
+      uint32 m_index; // carried along, e.g. where the element the key came from lives
+    };
+
+    struct RadixSortPair64
+    {
+      uint64 m_key;
+      uint32 m_index;
+    };
+
+    TINKER_API void RadixSort(uint32* data, uint32 numEles, uint32* scratch);
+    TINKER_API void RadixSort(uint64* data, uint32 numEles, uint64* scratch);
+    TINKER_API void RadixSort(RadixSortPair32* data, uint32 numEles,
+                              RadixSortPair32* scratch);
+    TINKER_API void RadixSort(RadixSortPair64* data, uint32 numEles,
+                              RadixSortPair64* scratch);
+
+    // Same result as RadixSort(), with each pass split across the thread pool. Inputs
+    // under RadixSortParallelMinEles, or no worker threads, sort on the calling thread.
+    // Allocates its jobs like ParallelFor() does.
+    const uint32 RadixSortParallelMinEles = 1 << 16;
+    TINKER_API void RadixSortParallel(uint32* data, uint32 numEles, uint32* scratch);
+    TINKER_API void RadixSortParallel(uint64* data, uint32 numEles, uint64* scratch);
+    TINKER_API void RadixSortParallel(RadixSortPair32* data, uint32 numEles,
+                                      RadixSortPair32* scratch);
+    TINKER_API void RadixSortParallel(RadixSortPair64* data, uint32 numEles,
+                                      RadixSortPair64* scratch);
   } //namespace Core
 } //namespace Tk
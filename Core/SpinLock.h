@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include <atomic>
+#include <emmintrin.h>
+#include <thread>
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Test-and-test-and-set lock for short critical sections. Gives up the time slice
+    // after spinning for a while, in case the holder got preempted.
+    struct SpinLock
+    {
+      enum : uint32
+      {
+        eSpinsBeforeYield = 64,
+      };
+
+      alignas(CACHE_LINE) std::atomic<uint32> m_locked = 0;
+
+      void Lock()
+      {
+        while (m_locked.exchange(1, std::memory_order_acquire))
+        {
+          uint32 numSpins = 0;
+          while (m_locked.load(std::memory_order_relaxed))
+          {
+            if (++numSpins < eSpinsBeforeYield)
+            {
+              _mm_pause();
+            }
+            else
+            {
+              std::this_thread::yield();
+              numSpins = 0;
+            }
+          }
+        }
+      }
+
+      void Unlock()
+      {
+        m_locked.store(0, std::memory_order_release);
+      }
+    };
+  } //namespace Core
+} //namespace Tk
@@ -0,0 +1,81 @@
+#include "StringTable.h"
+#include <string.h>
+
+namespace Tk
+{
+  namespace Core
+  {
+    TINKER_API void StringTable::Init(uint32 arenaSize)
+    {
+      TINKER_ASSERT(!m_chars.m_ownedMemPtr);
+      m_chars.Init(arenaSize, 1);
+    }
+
+    TINKER_API void StringTable::Shutdown()
+    {
+      m_chars.ExplicitFree();
+      m_entries.Clear();
+      m_idsByHash.Clear();
+    }
+
+    TINKER_API uint32 StringTable::FindByHash(Hash hash) const
+    {
+      const uint32 index = m_idsByHash.FindIndex(hash.m_val);
+      if (index == HashMapBase::eInvalidIndex)
+      {
+        return eInvalidID;
+      }
+      return m_idsByHash.DataAtIndex(index);
+    }
+
+    TINKER_API uint32 StringTable::Find(const char* str, uint32 len) const
+    {
+      const uint32 id = FindByHash(Hash64(str, len));
+      if (id != eInvalidID)
+      {
+        // Two different strings with the same 64 bit hash would need a real fallback.
+        // Until that ever happens, just catch it.
+        TINKER_ASSERT(Len(id) == len && memcmp(Str(id), str, len) == 0);
+      }
+      return id;
+    }
+
+    TINKER_API uint32 StringTable::Intern(const char* str, uint32 len)
+    {
+      const Hash hash = Hash64(str, len);
+      const uint32 existingID = FindByHash(hash);
+      if (existingID != eInvalidID)
+      {
+        TINKER_ASSERT(Len(existingID) == len && memcmp(Str(existingID), str, len) == 0);
+        return existingID;
+      }
+
+      // The hashmap reserves an all-ones key
+      if (hash.m_val == m_idsByHash.GetInvalidKey())
+      {
+        TINKER_ASSERT(0);
+        return eInvalidID;
+      }
+
+      char* chars = (char*)m_chars.Alloc(len + 1, 1);
+      if (!chars)
+      {
+        // Out of arena space
+        TINKER_ASSERT(0);
+        return eInvalidID;
+      }
+      memcpy(chars, str, len);
+      chars[len] = '\0';
+
+      Entry entry;
+      entry.m_hash = hash.m_val;
+      entry.m_offset = (uint32)(chars - (char*)m_chars.m_ownedMemPtr);
+      entry.m_len = len;
+
+      const uint32 id = m_entries.Size();
+      m_entries.PushBackRaw(entry);
+      m_idsByHash.Insert(hash.m_val, id);
+      return id;
+    }
+  } //namespace Core
+} //namespace Tk
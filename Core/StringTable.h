@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "Allocators.h"
+#include "Hashing.h"
+#include "DataStructures/HashMap.h"
+#include "DataStructures/Vector.h"
+
+namespace Tk
+{
+  namespace Core
+  {
+    // Interns strings into one arena and hands out 32-bit IDs. Interning the same string
+    // twice gives the same ID, so interned names can be compared by ID alone. Each string
+    // keeps its hash, which is the same value HASH_64 produces at compile time, so
+    // a literal can be looked up with FindByHash without touching the characters.
+    // Strings are null terminated and never move. Not thread-safe for writes - intern up
+    // front and then share the table read-only.
+    struct StringTable
+    {
+      enum : uint32
+      {
+        eInvalidID = MAX_UINT32,
+      };
+
+    private:
+      struct Entry
+      {
+        uint64 m_hash;
+        uint32 m_offset;
+        uint32 m_len;
+      };
+
+      LinearAllocator m_chars;
+      Vector<Entry> m_entries;
+      HashMap<uint64, uint32, MapHashFn64> m_idsByHash;
+
+    public:
+      StringTable() {}
+
+      StringTable(const StringTable& other) = delete;
+      StringTable& operator=(const StringTable& other) = delete;
+
+      // Room for arenaSize bytes of characters, including a null terminator per string
+      TINKER_API void Init(uint32 arenaSize);
+      TINKER_API void Shutdown();
+
+      // Returns the existing ID if the string is already in the table
+      TINKER_API uint32 Intern(const char* str, uint32 len);
+      TINKER_API uint32 Find(const char* str, uint32 len) const;
+      TINKER_API uint32 FindByHash(Hash hash) const;
+
+      uint32 Intern(const char* str)
+      {
+        return Intern(str, (uint32)strlen(str));
+      }
+
+      uint32 Find(const char* str) const
+      {
+        return Find(str, (uint32)strlen(str));
+      }
+
+      uint32 NumStrings() const
+      {
+        return m_entries.Size();
+      }
+
+      const char* Str(uint32 id) const
+      {
+        TINKER_ASSERT(id < m_entries.Size());
+        return (const char*)m_chars.m_ownedMemPtr + m_entries[id].m_offset;
+      }
+
+      uint32 Len(uint32 id) const
+      {
+        TINKER_ASSERT(id < m_entries.Size());
+        return m_entries[id].m_len;
+      }
+
+      Hash GetHash(uint32 id) const
+      {
+        TINKER_ASSERT(id < m_entries.Size());
+        return Hash(m_entries[id].m_hash);
+      }
+    };
+  } //namespace Core
+} //namespace Tk
@@ -1,12 +1,48 @@
 #pragma once
 
 #include "CoreDefines.h"
+#include "Allocators.h"
+#include <cmath>
 #include <cstring>
+#include <cwchar>
 
 namespace Tk
 {
   namespace Core
   {
+    // Same contract as wcstombs_s: returns the number of bytes the converted string
+    // needs, including the null terminator. dst can be null to only query that size,
+    // otherwise it's always null terminated.
+    inline size_t WCharToMultiByte(char* dst, size_t dstSize, const wchar_t* src,
+                                   size_t srcLen)
+    {
+#ifdef _MSC_VER
+      size_t numBytes = 0;
+      wcstombs_s(&numBytes, dst, dstSize, src, srcLen);
+      return numBytes;
+#else
+      mbstate_t state = {};
+      const wchar_t* srcPos = src;
+      if (!dst)
+      {
+        const size_t numBytes = wcsnrtombs(NULL, &srcPos, srcLen, 0, &state);
+        return numBytes == (size_t)-1 ? 0 : numBytes + 1;
+      }
+
+      if (!dstSize)
+      {
+        return 0;
+      }
+      size_t numBytes = wcsnrtombs(dst, &srcPos, srcLen, dstSize - 1, &state);
+      if (numBytes == (size_t)-1)
+      {
+        numBytes = 0;
+      }
+      dst[numBytes] = '\0';
+      return numBytes + 1;
+#endif
+    }
+
     template <uint32 tLen>
     struct StrFixedBuffer
     {
@@ -61,19 +97,17 @@ namespace Tk
 
       void AppendWChar(const wchar_t* strToAppend, uint32 strToAppendLen)
       {
-        size_t numCharsWritten = 0;
-        wcstombs_s(&numCharsWritten, NULL, 0, strToAppend,
-                   strToAppendLen); // returns number of bytes needed
+        size_t numCharsWritten = WCharToMultiByte(NULL, 0, strToAppend, strToAppendLen);
 
         if (VerifyNoOverflow(m_len, (uint32)numCharsWritten))
         {
           uint32 maxBytesToWrite = Min((uint32)numCharsWritten, tLen - m_len);
-          wcstombs_s(&numCharsWritten, &m_data[m_len], maxBytesToWrite, strToAppend,
-                     strToAppendLen);
+          numCharsWritten = WCharToMultiByte(&m_data[m_len], maxBytesToWrite, strToAppend,
+                                             strToAppendLen);
 
-          /* Note: wcstombs_s will write a null terminator if one was not encountered in
-             the src str. This string class will assume that the null terminator was not
-             written. */
+          /* Note: WCharToMultiByte will write a null terminator if one was not
+             encountered in the src str. This string class will assume that the null
+             terminator was not written. */
           m_len += (uint32)(numCharsWritten ? numCharsWritten - 1 : 0);
         }
       }
@@ -106,5 +140,243 @@ namespace Tk
         return 1;
       }
     };
+
+    // Two ASCII digits per entry, for formatting integers two digits at a time
+    inline constexpr char g_StrDigitPairs[201] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+
+    // Builds a string into memory owned by someone else - a stack buffer or an allocation
+    // out of a LinearAllocator. Unlike StrFixedBuffer, the memory is never zeroed, so
+    // CStr() or NullTerminate() has to be called to get a null terminated string.
+    // Overflowing asserts and truncates.
+    struct StrBuilder
+    {
+      char* m_data = nullptr;
+      uint32 m_len = 0;
+      uint32 m_capacity = 0; // includes room for the null terminator
+
+      StrBuilder() {}
+
+      StrBuilder(char* buffer, uint32 capacity)
+      {
+        TINKER_ASSERT(buffer);
+        TINKER_ASSERT(capacity > 0);
+        m_data = buffer;
+        m_capacity = capacity;
+      }
+
+      StrBuilder(LinearAllocator* allocator, uint32 capacity)
+      {
+        TINKER_ASSERT(capacity > 0);
+        m_data = (char*)allocator->Alloc(capacity, 1);
+        TINKER_ASSERT(m_data);
+        m_capacity = m_data ? capacity : 0;
+      }
+
+      const char* Data() const
+      {
+        return m_data;
+      }
+
+      uint32 Len() const
+      {
+        return m_len;
+      }
+
+      uint32 LenRemaining() const
+      {
+        return m_capacity ? m_capacity - 1 - m_len : 0;
+      }
+
+      void Clear()
+      {
+        m_len = 0;
+      }
+
+      void Truncate(uint32 len)
+      {
+        TINKER_ASSERT(len <= m_len);
+        m_len = len;
+      }
+
+      // For when the string is read straight out of the buffer it was built in
+      void NullTerminate()
+      {
+        TINKER_ASSERT(m_capacity > 0);
+        m_data[m_len] = '\0';
+      }
+
+      const char* CStr()
+      {
+        NullTerminate();
+        return m_data;
+      }
+
+      StrBuilder& Append(const char* str, uint32 len)
+      {
+        len = ClampToRemaining(len);
+        memcpy(&m_data[m_len], str, len);
+        m_len += len;
+        return *this;
+      }
+
+      StrBuilder& Append(const char* str)
+      {
+        return Append(str, (uint32)strlen(str));
+      }
+
+      StrBuilder& AppendWChar(const wchar_t* str, uint32 len)
+      {
+        size_t numCharsWritten = WCharToMultiByte(NULL, 0, str, len);
+
+        // numCharsWritten includes the null terminator, which CStr() writes instead
+        const uint32 numChars = ClampToRemaining(
+          (uint32)(numCharsWritten ? numCharsWritten - 1 : 0));
+        WCharToMultiByte(&m_data[m_len], numChars + 1, str, len);
+        m_len += numChars;
+        return *this;
+      }
+
+      StrBuilder& AppendChar(char c)
+      {
+        if (ClampToRemaining(1))
+        {
+          m_data[m_len++] = c;
+        }
+        return *this;
+      }
+
+      StrBuilder& AppendU64(uint64 val)
+      {
+        char digits[20];
+        uint32 first = 20;
+        while (val >= 100)
+        {
+          const uint32 pair = (uint32)(val % 100) * 2;
+          val /= 100;
+          first -= 2;
+          digits[first] = g_StrDigitPairs[pair];
+          digits[first + 1] = g_StrDigitPairs[pair + 1];
+        }
+        if (val >= 10)
+        {
+          first -= 2;
+          digits[first] = g_StrDigitPairs[val * 2];
+          digits[first + 1] = g_StrDigitPairs[val * 2 + 1];
+        }
+        else
+        {
+          digits[--first] = (char)('0' + val);
+        }
+        return Append(&digits[first], 20 - first);
+      }
+
+      StrBuilder& AppendI64(int64 val)
+      {
+        if (val < 0)
+        {
+          AppendChar('-');
+          // Negate as unsigned so that INT64_MIN doesn't overflow
+          return AppendU64(0 - (uint64)val);
+        }
+        return AppendU64((uint64)val);
+      }
+
+      // Fixed point, like printf("%.*f") without the locale or format string parsing.
+      // Values too large for 64 bits once scaled are written with an exponent instead,
+      // e.g. 1.50e+25.
+      StrBuilder& AppendFloat(double val, uint32 numDecimals = 2)
+      {
+        // Checked before the exponent loop below, which would never end for inf. Done on
+        // the bits since fast math builds are free to fold std::isinf/isnan to false.
+        uint64 bits;
+        memcpy(&bits, &val, sizeof(bits));
+        const uint64 exponentMask = 0x7FF0000000000000ull;
+        const uint64 mantissaMask = 0x000FFFFFFFFFFFFFull;
+        const bool isFinite = (bits & exponentMask) != exponentMask;
+        if (!isFinite && (bits & mantissaMask))
+        {
+          return Append("nan", 3);
+        }
+        if (val < 0.0)
+        {
+          AppendChar('-');
+          val = -val;
+        }
+        if (!isFinite)
+        {
+          return Append("inf", 3);
+        }
+
+        static const uint64 powersOf10[] = {
+          1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+          100000000ull, 1000000000ull,
+        };
+        numDecimals = Min(numDecimals, (uint32)ARRAYCOUNT(powersOf10) - 1);
+        const uint64 scale = powersOf10[numDecimals];
+
+        int32 exponent = 0;
+        if (val * (double)scale >= 1.8e19)
+        {
+          while (val >= 10.0)
+          {
+            val /= 10.0;
+            ++exponent;
+          }
+        }
+
+        // Exact halves round to even, same as printf
+        const double scaledVal = val * (double)scale;
+        uint64 scaled = (uint64)scaledVal;
+        const double roundingError = scaledVal - (double)scaled;
+        if (roundingError > 0.5 || (roundingError == 0.5 && (scaled & 1)))
+        {
+          ++scaled;
+        }
+        if (exponent && scaled >= 10 * scale)
+        {
+          // Rounded up out of [1, 10), e.g. 9.999e+25 to two decimals
+          scaled /= 10;
+          ++exponent;
+        }
+        AppendU64(scaled / scale);
+        if (numDecimals > 0)
+        {
+          AppendChar('.');
+          // Leading zeros of the fractional part
+          const uint64 frac = scaled % scale;
+          for (uint32 i = numDecimals - 1; i > 0 && frac < powersOf10[i]; --i)
+          {
+            AppendChar('0');
+          }
+          AppendU64(frac);
+        }
+
+        if (exponent)
+        {
+          Append("e+", 2);
+          if (exponent < 10)
+          {
+            AppendChar('0');
+          }
+          AppendU64((uint64)exponent);
+        }
+        return *this;
+      }
+
+    private:
+      uint32 ClampToRemaining(uint32 len)
+      {
+        const uint32 remaining = LenRemaining();
+        if (len > remaining)
+        {
+          TINKER_ASSERT(0);
+          return remaining;
+        }
+        return len;
+      }
+    };
   } //namespace Core
 } //namespace Tk
@@ -0,0 +1,518 @@
+#include "TLSFHeap.h"
+#include "Platform/PlatformGameAPI.h"
+#include "Utility/AllocatorRegistry.h"
+
+namespace Tk
+{
+  namespace Core
+  {
+    typedef TLSFHeap::BlockHeader BlockHeader;
+
+    enum : size_t
+    {
+      eBlockFreeBit = 1 << 0,
+      eBlockPrevFreeBit = 1 << 1,
+      eBlockFlagsMask = eBlockFreeBit | eBlockPrevFreeBit,
+
+      // User memory starts after m_prevPhys and m_size, and the next block's header
+      // starts right after this block's memory
+      eBlockStartOffset = 2 * sizeof(size_t),
+      eBlockOverhead = 2 * sizeof(size_t),
+      // Room for the free list links
+      eBlockSizeMin = sizeof(BlockHeader) - eBlockStartOffset,
+    };
+    // Cast since comparing enumerators of two different enums is deprecated
+    static_assert((size_t)eBlockStartOffset == (size_t)TLSFHeap::eAlignSize
+                  && (size_t)eBlockOverhead == (size_t)TLSFHeap::eAlignSize);
+    static_assert(TLSFHeap::eSLIndexCount <= 32 && TLSFHeap::eFLIndexCount <= 32);
+
+    static const size_t g_BlockSizeMax = (size_t)1 << TLSFHeap::eFLIndexMax;
+
+    // Index of the highest set bit
+    static uint32 FLS(size_t x)
+    {
+      return 63 - CountLeadingZeros64((uint64)x);
+    }
+
+    static size_t AlignUp(size_t x, size_t align)
+    {
+      return (x + align - 1) & ~(align - 1);
+    }
+
+    static size_t BlockSize(const BlockHeader* block)
+    {
+      return block->m_size & ~(size_t)eBlockFlagsMask;
+    }
+
+    static void BlockSetSize(BlockHeader* block, size_t size)
+    {
+      block->m_size = size | (block->m_size & eBlockFlagsMask);
+    }
+
+    static bool BlockIsLast(const BlockHeader* block)
+    {
+      return BlockSize(block) == 0;
+    }
+
+    static bool BlockIsFree(const BlockHeader* block)
+    {
+      return (block->m_size & eBlockFreeBit) != 0;
+    }
+
+    static bool BlockIsPrevFree(const BlockHeader* block)
+    {
+      return (block->m_size & eBlockPrevFreeBit) != 0;
+    }
+
+    static void BlockSetFree(BlockHeader* block, bool isFree)
+    {
+      block->m_size = isFree ? (block->m_size | eBlockFreeBit)
+                             : (block->m_size & ~(size_t)eBlockFreeBit);
+    }
+
+    static void BlockSetPrevFree(BlockHeader* block, bool isPrevFree)
+    {
+      block->m_size = isPrevFree ? (block->m_size | eBlockPrevFreeBit)
+                                 : (block->m_size & ~(size_t)eBlockPrevFreeBit);
+    }
+
+    static uint8* BlockToPtr(const BlockHeader* block)
+    {
+      return (uint8*)block + eBlockStartOffset;
+    }
+
+    static BlockHeader* BlockFromPtr(const void* ptr)
+    {
+      return (BlockHeader*)((uint8*)ptr - eBlockStartOffset);
+    }
+
+    // Header of the block that would start size bytes into this block's memory
+    static BlockHeader* BlockAtOffset(const BlockHeader* block, size_t size)
+    {
+      return (BlockHeader*)(BlockToPtr(block) + size + eBlockOverhead
+                            - eBlockStartOffset);
+    }
+
+    static BlockHeader* BlockNext(const BlockHeader* block)
+    {
+      TINKER_ASSERT(!BlockIsLast(block));
+      return BlockAtOffset(block, BlockSize(block));
+    }
+
+    static BlockHeader* BlockLinkNext(BlockHeader* block)
+    {
+      BlockHeader* next = BlockNext(block);
+      next->m_prevPhys = block;
+      return next;
+    }
+
+    static void BlockMarkAsFree(BlockHeader* block)
+    {
+      BlockHeader* next = BlockLinkNext(block);
+      BlockSetPrevFree(next, true);
+      BlockSetFree(block, true);
+    }
+
+    static void BlockMarkAsUsed(BlockHeader* block)
+    {
+      BlockHeader* next = BlockNext(block);
+      BlockSetPrevFree(next, false);
+      BlockSetFree(block, false);
+    }
+
+    static bool BlockCanSplit(const BlockHeader* block, size_t size)
+    {
+      return BlockSize(block) >= sizeof(BlockHeader) + size;
+    }
+
+    // Splits off everything past size into a new free block
+    static BlockHeader* BlockSplit(BlockHeader* block, size_t size)
+    {
+      BlockHeader* remaining = BlockAtOffset(block, size);
+      const size_t remainingSize = BlockSize(block) - (size + eBlockOverhead);
+      TINKER_ASSERT(remainingSize >= eBlockSizeMin);
+
+      remaining->m_size = 0;
+      BlockSetSize(remaining, remainingSize);
+      BlockSetSize(block, size);
+      BlockMarkAsFree(remaining);
+      return remaining;
+    }
+
+    static BlockHeader* BlockAbsorb(BlockHeader* prev, BlockHeader* block)
+    {
+      TINKER_ASSERT(!BlockIsLast(prev));
+      prev->m_size += BlockSize(block) + eBlockOverhead;
+      BlockLinkNext(prev);
+      return prev;
+    }
+
+    // Rounds a request up to a block size, 0 if it is too big for any block
+    static size_t AdjustRequestSize(size_t size, size_t align)
+    {
+      const size_t aligned = AlignUp(size, align);
+      return aligned < g_BlockSizeMax ? Max(aligned, (size_t)eBlockSizeMin) : 0;
+    }
+
+    static void MappingInsert(size_t size, uint32* fl, uint32* sl)
+    {
+      if (size < TLSFHeap::eSmallBlockSize)
+      {
+        // Small blocks are all in the first level, linearly
+        *fl = 0;
+        *sl = (uint32)size / (TLSFHeap::eSmallBlockSize / TLSFHeap::eSLIndexCount);
+      }
+      else
+      {
+        const uint32 bit = FLS(size);
+        *sl = (uint32)(size >> (bit - TLSFHeap::eSLIndexCountLog2))
+              ^ (1u << TLSFHeap::eSLIndexCountLog2);
+        *fl = bit - (TLSFHeap::eFLIndexShift - 1);
+      }
+    }
+
+    // Rounds up to the next bin, so that any block in the bin found fits the request
+    static void MappingSearch(size_t size, uint32* fl, uint32* sl)
+    {
+      if (size >= TLSFHeap::eSmallBlockSize)
+      {
+        size += ((size_t)1 << (FLS(size) - TLSFHeap::eSLIndexCountLog2)) - 1;
+      }
+      MappingInsert(size, fl, sl);
+    }
+
+    TINKER_API void TLSFHeap::Init(size_t initialPoolSize, size_t growSize,
+                                   bool threadSafe)
+    {
+      TINKER_ASSERT(!m_pools);
+
+      m_nullBlock.m_prevPhys = nullptr;
+      m_nullBlock.m_size = 0;
+      m_nullBlock.m_nextFree = &m_nullBlock;
+      m_nullBlock.m_prevFree = &m_nullBlock;
+      m_flBitmap = 0;
+      for (uint32 fl = 0; fl < eFLIndexCount; ++fl)
+      {
+        m_slBitmaps[fl] = 0;
+        for (uint32 sl = 0; sl < eSLIndexCount; ++sl)
+        {
+          m_blocks[fl][sl] = &m_nullBlock;
+        }
+      }
+
+      m_stats = {};
+      m_growSize = growSize;
+      m_threadSafe = threadSafe;
+      AddPool(initialPoolSize);
+    }
+
+    TINKER_API void TLSFHeap::Shutdown()
+    {
+      // Unregister first, stats can be read from another thread until then
+      if (m_isRegistered)
+      {
+        Utility::UnregisterAllocator(this);
+        m_isRegistered = false;
+      }
+
+      PoolHeader* pool = m_pools;
+      while (pool)
+      {
+        PoolHeader* next = pool->m_next;
+        Platform::FreeAlignedRaw(pool);
+        pool = next;
+      }
+      m_pools = nullptr;
+      m_stats = {};
+    }
+
+    // Fits a block of at least minBlockSize
+    bool TLSFHeap::AddPool(size_t minBlockSize)
+    {
+      // Rounding up in MappingSearch() asks for up to 1/32 more than the block size,
+      // plus the pool's own header and the zero sized block at the end
+      const size_t poolSize =
+        AlignUp(Max(m_growSize, minBlockSize + minBlockSize / eSLIndexCount)
+                  + sizeof(PoolHeader) + 2 * eBlockOverhead,
+                eAlignSize);
+      PoolHeader* pool = (PoolHeader*)Platform::AllocAlignedRaw(poolSize, CACHE_LINE);
+      if (!pool)
+      {
+        return false;
+      }
+      pool->m_next = m_pools;
+      pool->m_size = poolSize;
+      m_pools = pool;
+      ++m_stats.m_numPools;
+      m_stats.m_reserved += poolSize;
+
+      // One free block covering the pool, then a zero sized used block that stops
+      // merging past the end
+      const size_t blockSize = poolSize - sizeof(PoolHeader) - 2 * eBlockOverhead;
+      BlockHeader* block = (BlockHeader*)((uint8*)pool + sizeof(PoolHeader));
+      block->m_size = blockSize;
+      BlockSetFree(block, true);
+      BlockSetPrevFree(block, false);
+      InsertBlock(block);
+
+      BlockHeader* last = BlockLinkNext(block);
+      last->m_size = 0;
+      BlockSetFree(last, false);
+      BlockSetPrevFree(last, true);
+      return true;
+    }
+
+    void TLSFHeap::RemoveFreeBlock(BlockHeader* block, uint32 fl, uint32 sl)
+    {
+      BlockHeader* prev = block->m_prevFree;
+      BlockHeader* next = block->m_nextFree;
+      next->m_prevFree = prev;
+      prev->m_nextFree = next;
+
+      if (m_blocks[fl][sl] == block)
+      {
+        m_blocks[fl][sl] = next;
+        if (next == &m_nullBlock)
+        {
+          m_slBitmaps[fl] &= ~(1u << sl);
+          if (!m_slBitmaps[fl])
+          {
+            m_flBitmap &= ~(1u << fl);
+          }
+        }
+      }
+    }
+
+    void TLSFHeap::InsertFreeBlock(BlockHeader* block, uint32 fl, uint32 sl)
+    {
+      BlockHeader* current = m_blocks[fl][sl];
+      block->m_nextFree = current;
+      block->m_prevFree = &m_nullBlock;
+      current->m_prevFree = block;
+
+      m_blocks[fl][sl] = block;
+      m_flBitmap |= 1u << fl;
+      m_slBitmaps[fl] |= 1u << sl;
+    }
+
+    void TLSFHeap::RemoveBlock(BlockHeader* block)
+    {
+      uint32 fl, sl;
+      MappingInsert(BlockSize(block), &fl, &sl);
+      RemoveFreeBlock(block, fl, sl);
+    }
+
+    void TLSFHeap::InsertBlock(BlockHeader* block)
+    {
+      uint32 fl, sl;
+      MappingInsert(BlockSize(block), &fl, &sl);
+      InsertFreeBlock(block, fl, sl);
+    }
+
+    // First non-empty bin at or above fl/sl, which are updated to that bin
+    BlockHeader* TLSFHeap::SearchSuitableBlock(uint32* fl, uint32* sl)
+    {
+      uint32 slMap = m_slBitmaps[*fl] & (~0u << *sl);
+      if (!slMap)
+      {
+        const uint32 flMap = *fl + 1 < 32 ? m_flBitmap & (~0u << (*fl + 1)) : 0;
+        if (!flMap)
+        {
+          return nullptr;
+        }
+        *fl = CountTrailingZeros32(flMap);
+        slMap = m_slBitmaps[*fl];
+      }
+      *sl = CountTrailingZeros32(slMap);
+      return m_blocks[*fl][*sl];
+    }
+
+    BlockHeader* TLSFHeap::MergePrev(BlockHeader* block)
+    {
+      if (BlockIsPrevFree(block))
+      {
+        BlockHeader* prev = block->m_prevPhys;
+        TINKER_ASSERT(BlockIsFree(prev));
+        RemoveBlock(prev);
+        block = BlockAbsorb(prev, block);
+      }
+      return block;
+    }
+
+    BlockHeader* TLSFHeap::MergeNext(BlockHeader* block)
+    {
+      BlockHeader* next = BlockNext(block);
+      if (BlockIsFree(next))
+      {
+        TINKER_ASSERT(!BlockIsLast(block));
+        RemoveBlock(next);
+        block = BlockAbsorb(block, next);
+      }
+      return block;
+    }
+
+    // Gives the space past size back to the free lists
+    void TLSFHeap::TrimFree(BlockHeader* block, size_t size)
+    {
+      TINKER_ASSERT(BlockIsFree(block));
+      if (BlockCanSplit(block, size))
+      {
+        BlockHeader* remaining = BlockSplit(block, size);
+        BlockLinkNext(block);
+        BlockSetPrevFree(remaining, true);
+        InsertBlock(remaining);
+      }
+    }
+
+    // Gives the space before the last size bytes back to the free lists, for alignment
+    BlockHeader* TLSFHeap::TrimFreeLeading(BlockHeader* block, size_t size)
+    {
+      BlockHeader* remaining = block;
+      if (BlockCanSplit(block, size))
+      {
+        remaining = BlockSplit(block, size - eBlockOverhead);
+        BlockSetPrevFree(remaining, true);
+        BlockLinkNext(block);
+        InsertBlock(block);
+      }
+      return remaining;
+    }
+
+    BlockHeader* TLSFHeap::LocateFree(size_t size)
+    {
+      if (!size)
+      {
+        return nullptr;
+      }
+
+      uint32 fl, sl;
+      MappingSearch(size, &fl, &sl);
+      BlockHeader* block = nullptr;
+      if (fl < eFLIndexCount)
+      {
+        block = SearchSuitableBlock(&fl, &sl);
+      }
+
+      if (!block && fl < eFLIndexCount && AddPool(size))
+      {
+        MappingSearch(size, &fl, &sl);
+        block = SearchSuitableBlock(&fl, &sl);
+        TINKER_ASSERT(block);
+      }
+
+      if (block)
+      {
+        TINKER_ASSERT(BlockSize(block) >= size);
+        RemoveFreeBlock(block, fl, sl);
+      }
+      return block;
+    }
+
+    void* TLSFHeap::PrepareUsed(BlockHeader* block, size_t size)
+    {
+      if (!block)
+      {
+        return nullptr;
+      }
+
+      TrimFree(block, size);
+      BlockMarkAsUsed(block);
+
+      ++m_stats.m_numAllocs;
+      m_stats.m_allocated += BlockSize(block);
+      m_stats.m_highWaterMark = Max(m_stats.m_highWaterMark, m_stats.m_allocated);
+      return BlockToPtr(block);
+    }
+
+    TINKER_API void* TLSFHeap::Alloc(size_t size)
+    {
+      const size_t adjustedSize = AdjustRequestSize(size, eAlignSize);
+
+      Lock();
+      TINKER_ASSERT(m_pools);
+      void* ptr = PrepareUsed(LocateFree(adjustedSize), adjustedSize);
+      Unlock();
+      return ptr;
+    }
+
+    TINKER_API void* TLSFHeap::AllocAligned(size_t size, size_t alignment)
+    {
+      TINKER_ASSERT(ISPOW2(alignment));
+      if (alignment <= eAlignSize)
+      {
+        return Alloc(size);
+      }
+
+      const size_t adjustedSize = AdjustRequestSize(size, eAlignSize);
+
+      // Ask for enough to be able to trim off a free block in front of the aligned
+      // pointer, that leading block can't be smaller than a block header
+      const size_t gapMin = sizeof(BlockHeader);
+      const size_t sizeWithGap =
+        AdjustRequestSize(adjustedSize + alignment + gapMin, eAlignSize);
+
+      Lock();
+      TINKER_ASSERT(m_pools);
+      BlockHeader* block = LocateFree(adjustedSize ? sizeWithGap : 0);
+      if (block)
+      {
+        uint8* ptr = BlockToPtr(block);
+        uint8* aligned = (uint8*)AlignUp((size_t)ptr, alignment);
+        size_t gap = (size_t)(aligned - ptr);
+
+        if (gap && gap < gapMin)
+        {
+          // Too small to be a block, move on to the next aligned address past the gap
+          const size_t gapRemaining = gapMin - gap;
+          const size_t offset = Max(gapRemaining, alignment);
+          aligned = (uint8*)AlignUp((size_t)(aligned + offset), alignment);
+          gap = (size_t)(aligned - ptr);
+        }
+
+        if (gap)
+        {
+          TINKER_ASSERT(gap >= gapMin);
+          block = TrimFreeLeading(block, gap);
+        }
+      }
+      void* result = PrepareUsed(block, adjustedSize);
+      Unlock();
+      return result;
+    }
+
+    TINKER_API void TLSFHeap::Free(void* ptr)
+    {
+      if (!ptr)
+      {
+        return;
+      }
+
+      BlockHeader* block = BlockFromPtr(ptr);
+
+      // Neighbours update this header's flags under the lock
+      Lock();
+      TINKER_ASSERT(!BlockIsFree(block)); // double free
+      --m_stats.m_numAllocs;
+      m_stats.m_allocated -= BlockSize(block);
+
+      BlockMarkAsFree(block);
+      block = MergePrev(block);
+      block = MergeNext(block);
+      InsertBlock(block);
+      Unlock();
+    }
+
+    TINKER_API TLSFHeapStats TLSFHeap::GetStats()
+    {
+      Lock();
+      const TLSFHeapStats stats = m_stats;
+      Unlock();
+      return stats;
+    }
+
+    TINKER_API size_t TLSFHeap::UsableSize(const void* ptr)
+    {
+      return ptr ? BlockSize(BlockFromPtr(ptr)) : 0;
+    }
+  } //namespace Core
+} //namespace Tk
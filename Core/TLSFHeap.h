@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "SpinLock.h"
+
+namespace Tk
+{
+  namespace Core
+  {
+    struct TLSFHeapStats
+    {
+      size_t m_numPools;
+      size_t m_reserved; // pool memory taken from the platform
+      size_t m_allocated; // bytes in live blocks
+      size_t m_highWaterMark; // most bytes in live blocks at once
+      size_t m_numAllocs; // live allocations
+    };
+
+    // Two-level segregated fit heap (Masmano et al.). Free blocks are binned by size into
+    // 32 linear subranges of each power of 2, with a bitmap per level, so finding a free
+    // block that fits is two bit scans and alloc/free are O(1) regardless of how many
+    // blocks are live. Neighbouring free blocks are merged on free, which bounds
+    // fragmentation. Pointers are 16 byte aligned, larger alignments are O(1) too.
+    // The heap grows by adding pools from the platform and never gives them back until
+    // Shutdown(). A heap can be locked for use from any thread, or left unlocked for a
+    // single owner, e.g. one heap per subsystem or per thread.
+    struct TLSFHeap
+    {
+      enum : uint32
+      {
+        eSLIndexCountLog2 = 5,
+        eSLIndexCount = 1 << eSLIndexCountLog2,
+        eAlignSizeLog2 = 4,
+        eAlignSize = 1 << eAlignSizeLog2,
+        eFLIndexMax = 38, // blocks up to 256 GB
+        eFLIndexShift = eSLIndexCountLog2 + eAlignSizeLog2,
+        eFLIndexCount = eFLIndexMax - eFLIndexShift + 1,
+        eSmallBlockSize = 1 << eFLIndexShift,
+      };
+
+      TINKER_API void Init(size_t initialPoolSize, size_t growSize, bool threadSafe);
+      // Also unregisters the heap from the allocator registry
+      TINKER_API void Shutdown();
+
+      // nullptr only if the platform is out of memory
+      TINKER_API void* Alloc(size_t size);
+      TINKER_API void* AllocAligned(size_t size, size_t alignment);
+      TINKER_API void Free(void* ptr);
+      TINKER_API TLSFHeapStats GetStats();
+
+      // Can be more than was asked for, since blocks are rounded up to eAlignSize
+      TINKER_API static size_t UsableSize(const void* ptr);
+
+      bool IsInitted() const
+      {
+        return m_pools != nullptr;
+      }
+
+      bool m_isRegistered = false;
+
+      // Implementation details, public for the helpers in TLSFHeap.cpp
+
+      // Every block is preceded by m_prevPhys and m_size, so user pointers stay 16 byte
+      // aligned. The free list links are only valid while the block is free and live in
+      // the first bytes of its memory.
+      struct BlockHeader
+      {
+        BlockHeader* m_prevPhys;
+        size_t m_size; // low bits are flags, sizes are multiples of eAlignSize
+        BlockHeader* m_nextFree;
+        BlockHeader* m_prevFree;
+      };
+
+      struct alignas(32) PoolHeader
+      {
+        PoolHeader* m_next;
+        size_t m_size;
+      };
+
+    private:
+      // Free lists end in m_nullBlock rather than nullptr
+      BlockHeader m_nullBlock;
+      uint32 m_flBitmap;
+      uint32 m_slBitmaps[eFLIndexCount];
+      BlockHeader* m_blocks[eFLIndexCount][eSLIndexCount];
+
+      PoolHeader* m_pools = nullptr;
+      size_t m_growSize;
+      SpinLock m_lock;
+      bool m_threadSafe;
+
+      TLSFHeapStats m_stats;
+
+      void Lock()
+      {
+        if (m_threadSafe)
+        {
+          m_lock.Lock();
+        }
+      }
+
+      void Unlock()
+      {
+        if (m_threadSafe)
+        {
+          m_lock.Unlock();
+        }
+      }
+
+      void RemoveFreeBlock(BlockHeader* block, uint32 fl, uint32 sl);
+      void InsertFreeBlock(BlockHeader* block, uint32 fl, uint32 sl);
+      void RemoveBlock(BlockHeader* block);
+      void InsertBlock(BlockHeader* block);
+      BlockHeader* SearchSuitableBlock(uint32* fl, uint32* sl);
+      BlockHeader* MergePrev(BlockHeader* block);
+      BlockHeader* MergeNext(BlockHeader* block);
+      void TrimFree(BlockHeader* block, size_t size);
+      BlockHeader* TrimFreeLeading(BlockHeader* block, size_t size);
+      BlockHeader* LocateFree(size_t size);
+      void* PrepareUsed(BlockHeader* block, size_t size);
+      bool AddPool(size_t minBlockSize);
+    };
+  } //namespace Core
+} //namespace Tk
@@ -0,0 +1,246 @@
+#include "Utility/AllocatorRegistry.h"
+#include "Allocators.h"
+#include "Platform/PlatformGameAPI.h"
+#include "SpinLock.h"
+#include "StringTypes.h"
+#include "TLSFHeap.h"
+
+#include <string.h>
+
+namespace Tk
+{
+  namespace Core
+  {
+    namespace Utility
+    {
+      struct RegisteredAllocator
+      {
+        const void* m_allocator;
+        GetAllocatorStatsFunc m_getStats;
+        char m_name[eMaxAllocatorNameLen];
+      };
+
+      // Stats are read under the lock, so an allocator can't be unregistered and
+      // destroyed while its stats function is running
+      static RegisteredAllocator g_Allocators[eMaxRegisteredAllocators];
+      static uint32 g_NumAllocators = 0;
+      static SpinLock g_RegistryLock;
+
+      static AllocatorStats GetLinearAllocatorStats(const void* allocator)
+      {
+        const LinearAllocator& linear = *(const LinearAllocator*)allocator;
+        const ArenaStats arena = linear.GetStats();
+        AllocatorStats stats = {};
+        stats.m_capacity = linear.Capacity();
+        stats.m_committed = arena.m_reserved;
+        stats.m_used = arena.m_used;
+        stats.m_highWaterMark = arena.m_highWaterMark;
+        stats.m_numAllocs = arena.m_numAllocs;
+        return stats;
+      }
+
+      static AllocatorStats GetChainedLinearAllocatorStats(const void* allocator)
+      {
+        const ArenaStats arena = ((const ChainedLinearAllocator*)allocator)->GetStats();
+        AllocatorStats stats = {};
+        stats.m_capacity = arena.m_reserved;
+        stats.m_committed = arena.m_reserved;
+        stats.m_used = arena.m_used;
+        stats.m_highWaterMark = arena.m_highWaterMark;
+        stats.m_numAllocs = arena.m_numAllocs;
+        return stats;
+      }
+
+      static AllocatorStats GetPoolAllocatorStats(const void* allocator)
+      {
+        const PoolAllocatorBase& pool = *(const PoolAllocatorBase*)allocator;
+        const PoolAllocatorStats poolStats = pool.GetStats();
+        const size_t eleSize = pool.ElementSize();
+        AllocatorStats stats = {};
+        stats.m_capacity = poolStats.m_capacity * eleSize;
+        stats.m_committed = stats.m_capacity;
+        stats.m_used = poolStats.m_numAllocated * eleSize;
+        // Pools only grow once they run out of free elements and never shrink
+        stats.m_highWaterMark = stats.m_capacity;
+        stats.m_numAllocs = poolStats.m_numAllocated;
+        return stats;
+      }
+
+      static AllocatorStats GetTLSFHeapStats(const void* allocator)
+      {
+        const TLSFHeapStats heapStats = ((TLSFHeap*)allocator)->GetStats();
+        AllocatorStats stats = {};
+        stats.m_capacity = heapStats.m_reserved;
+        stats.m_committed = heapStats.m_reserved;
+        stats.m_used = heapStats.m_allocated;
+        stats.m_highWaterMark = heapStats.m_highWaterMark;
+        stats.m_numAllocs = heapStats.m_numAllocs;
+        return stats;
+      }
+
+      TINKER_API void RegisterAllocator(const void* allocator, const char* name,
+                                        GetAllocatorStatsFunc getStats)
+      {
+        TINKER_ASSERT(allocator);
+        TINKER_ASSERT(getStats);
+
+        g_RegistryLock.Lock();
+        RegisteredAllocator* entry = nullptr;
+        for (uint32 i = 0; i < g_NumAllocators; ++i)
+        {
+          if (g_Allocators[i].m_allocator == allocator)
+          {
+            entry = &g_Allocators[i]; // registering again renames it
+            break;
+          }
+        }
+        if (!entry && g_NumAllocators < eMaxRegisteredAllocators)
+        {
+          entry = &g_Allocators[g_NumAllocators++];
+        }
+        TINKER_ASSERT(entry);
+
+        if (entry)
+        {
+          entry->m_allocator = allocator;
+          entry->m_getStats = getStats;
+          const size_t nameLen = Min(strlen(name), (size_t)eMaxAllocatorNameLen - 1);
+          memcpy(entry->m_name, name, nameLen);
+          entry->m_name[nameLen] = '\0';
+        }
+        g_RegistryLock.Unlock();
+      }
+
+      TINKER_API void RegisterAllocator(LinearAllocator& allocator, const char* name)
+      {
+        RegisterAllocator(&allocator, name, GetLinearAllocatorStats);
+        allocator.m_isRegistered = true;
+      }
+
+      TINKER_API void RegisterAllocator(ChainedLinearAllocator& allocator,
+                                        const char* name)
+      {
+        RegisterAllocator(&allocator, name, GetChainedLinearAllocatorStats);
+        allocator.m_isRegistered = true;
+      }
+
+      TINKER_API void RegisterAllocator(PoolAllocatorBase& allocator, const char* name)
+      {
+        RegisterAllocator(&allocator, name, GetPoolAllocatorStats);
+        allocator.m_isRegistered = true;
+      }
+
+      TINKER_API void RegisterAllocator(TLSFHeap& allocator, const char* name)
+      {
+        RegisterAllocator(&allocator, name, GetTLSFHeapStats);
+        allocator.m_isRegistered = true;
+      }
+
+      TINKER_API void UnregisterAllocator(const void* allocator)
+      {
+        g_RegistryLock.Lock();
+        for (uint32 i = 0; i < g_NumAllocators; ++i)
+        {
+          if (g_Allocators[i].m_allocator == allocator)
+          {
+            // Keep registration order for display
+            memmove(&g_Allocators[i], &g_Allocators[i + 1],
+                    (g_NumAllocators - i - 1) * sizeof(RegisteredAllocator));
+            --g_NumAllocators;
+            break;
+          }
+        }
+        g_RegistryLock.Unlock();
+      }
+
+      TINKER_API uint32 GetAllocatorStats(AllocatorStatsEntry* entries,
+                                          uint32 maxEntries)
+      {
+        g_RegistryLock.Lock();
+        const uint32 numEntries = Min(g_NumAllocators, maxEntries);
+        for (uint32 i = 0; i < numEntries; ++i)
+        {
+          memcpy(entries[i].m_name, g_Allocators[i].m_name, eMaxAllocatorNameLen);
+          entries[i].m_stats = g_Allocators[i].m_getStats(g_Allocators[i].m_allocator);
+        }
+        g_RegistryLock.Unlock();
+        return numEntries;
+      }
+
+      TINKER_API uint32 WriteAllocatorStatsJSON(char* buffer, uint32 bufferSize)
+      {
+        uint32 len = 0;
+        auto Write = [&](const char* str, uint32 strLen)
+        {
+          if (len < bufferSize)
+          {
+            memcpy(&buffer[len], str, Min(strLen, bufferSize - len));
+          }
+          len += strLen;
+        };
+        auto WriteStr = [&](const char* str)
+        {
+          Write(str, (uint32)strlen(str));
+        };
+        auto WriteField = [&](const char* key, uint64 value, bool last)
+        {
+          char fieldBuffer[64];
+          StrBuilder field(fieldBuffer, ARRAYCOUNT(fieldBuffer));
+          field.Append(", \"").Append(key).Append("\": ").AppendU64(value);
+          if (last)
+          {
+            field.Append(" }");
+          }
+          Write(field.Data(), field.Len());
+        };
+
+        AllocatorStatsEntry entries[eMaxRegisteredAllocators];
+        const uint32 numEntries = GetAllocatorStats(entries, eMaxRegisteredAllocators);
+
+        WriteStr("{\n  \"allocators\": [");
+        for (uint32 i = 0; i < numEntries; ++i)
+        {
+          const AllocatorStatsEntry& entry = entries[i];
+          WriteStr(i ? ",\n    { \"name\": \"" : "\n    { \"name\": \"");
+          for (const char* c = entry.m_name; *c; ++c)
+          {
+            if (*c == '"' || *c == '\\')
+            {
+              WriteStr("\\");
+            }
+            Write(c, 1);
+          }
+          WriteStr("\"");
+          WriteField("capacity", entry.m_stats.m_capacity, false);
+          WriteField("committed", entry.m_stats.m_committed, false);
+          WriteField("used", entry.m_stats.m_used, false);
+          WriteField("peak", entry.m_stats.m_highWaterMark, false);
+          WriteField("allocs", entry.m_stats.m_numAllocs, true);
+        }
+        WriteStr("\n  ]\n}\n");
+        return len;
+      }
+
+      TINKER_API uint32 DumpAllocatorStatsJSON(const char* filename)
+      {
+        // Allocators can be registered while writing, so retry with more room if it
+        // doesn't fit
+        uint32 capacity = 1024 * 16;
+        while (true)
+        {
+          char* buffer = (char*)Platform::AllocAlignedRaw(capacity, CACHE_LINE);
+          const uint32 len = WriteAllocatorStatsJSON(buffer, capacity);
+          if (len <= capacity)
+          {
+            const uint32 result =
+              Platform::WriteEntireFile(filename, len, (uint8*)buffer);
+            Platform::FreeAlignedRaw(buffer);
+            return result;
+          }
+          Platform::FreeAlignedRaw(buffer);
+          capacity = len + len / 4;
+        }
+      }
+    } //namespace Utility
+  } //namespace Core
+} //namespace Tk
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreDefines.h"
+
+namespace Tk
+{
+  namespace Core
+  {
+    struct LinearAllocator;
+    struct ChainedLinearAllocator;
+    struct PoolAllocatorBase;
+    struct TLSFHeap;
+
+    namespace Utility
+    {
+      // All sizes in bytes
+      struct AllocatorStats
+      {
+        size_t m_capacity; // most the allocator can hand out, or m_committed if it grows
+        size_t m_committed; // memory actually taken from the heap or the OS
+        size_t m_used;
+        size_t m_highWaterMark;
+        // Live allocations, or allocations since Init() for arenas, which free in bulk
+        uint64 m_numAllocs;
+      };
+
+      typedef AllocatorStats (*GetAllocatorStatsFunc)(const void* allocator);
+
+      enum : uint32
+      {
+        eMaxRegisteredAllocators = 256,
+        eMaxAllocatorNameLen = 64,
+      };
+
+      struct AllocatorStatsEntry
+      {
+        char m_name[eMaxAllocatorNameLen];
+        AllocatorStats m_stats;
+      };
+
+      // Named allocators whose stats can be read at any time, for the debug UI and for
+      // sizing fixed budgets. Registration survives ExplicitFree() and Init() again.
+      // The Core allocators unregister themselves when destroyed, or on Shutdown() for
+      // TLSF heaps. Anything registered with a custom stats function has to call
+      // UnregisterAllocator() before it frees anything its stats function reads, since
+      // stats can be read from any thread. Names are copied.
+      TINKER_API void RegisterAllocator(const void* allocator, const char* name,
+                                        GetAllocatorStatsFunc getStats);
+      TINKER_API void RegisterAllocator(LinearAllocator& allocator, const char* name);
+      TINKER_API void RegisterAllocator(ChainedLinearAllocator& allocator,
+                                        const char* name);
+      TINKER_API void RegisterAllocator(PoolAllocatorBase& allocator, const char* name);
+      TINKER_API void RegisterAllocator(TLSFHeap& allocator, const char* name);
+      TINKER_API void UnregisterAllocator(const void* allocator);
+
+      // Fills entries in registration order and returns how many were written. Stats
+      // are read without stopping the allocators, so they are approximate for
+      // allocators other threads are using.
+      TINKER_API uint32 GetAllocatorStats(AllocatorStatsEntry* entries,
+                                          uint32 maxEntries);
+
+      // { "allocators": [ { "name": ..., "capacity": ..., ... }, ... ] }
+      // Returns the length of the whole document, which is more than was written if
+      // bufferSize was too small.
+      TINKER_API uint32 WriteAllocatorStatsJSON(char* buffer, uint32 bufferSize);
+      // Returns 0 on success, like Platform::WriteEntireFile()
+      TINKER_API uint32 DumpAllocatorStatsJSON(const char* filename);
+    } //namespace Utility
+  } //namespace Core
+} //namespace Tk
@@ -0,0 +1,402 @@
+#include "Utility/JobProfiler.h"
+#include "Platform/PlatformGameAPI.h"
+#include "SpinLock.h"
+#include "StringTypes.h"
+
+#include <chrono>
+#include <string.h>
+
+namespace Tk
+{
+  namespace Core
+  {
+    namespace Utility
+    {
+      // Relaxed atomics, the trace can be read while the owning thread overwrites it
+      struct JobEvent
+      {
+        std::atomic<uint64> m_timestamp;
+        std::atomic<const char*> m_name;
+        std::atomic<uint32> m_type;
+        std::atomic<uint32> m_arg;
+      };
+
+      struct JobEventCopy
+      {
+        uint64 m_timestamp;
+        const char* m_name;
+        uint32 m_type;
+        uint32 m_arg;
+      };
+
+      struct JobEventRing
+      {
+        alignas(CACHE_LINE) std::atomic<uint64> m_numEvents; // only the owner writes it
+        JobEvent* m_events;
+        bool m_inUse; // guarded by g_RingsLock
+        char m_name[eMaxJobProfilerThreadNameLen]; // set once, before it's published
+      };
+
+      std::atomic<uint32> g_JobProfilerEnabled = 0;
+
+      // Rings are never freed, a thread's ring is handed on to the next thread with its
+      // name
+      static JobEventRing g_Rings[eMaxJobProfilerThreads];
+      static std::atomic<uint32> g_NumRings = 0;
+      static SpinLock g_RingsLock;
+      static uint32 g_NumUnnamedThreads = 0;
+
+      // Cycle counts and times are all guarded by g_RingsLock. The cycle counter is
+      // converted to time against when profiling was first enabled, the longer ago the
+      // more accurate.
+      static uint64 g_CalibrationCycles = 0;
+      static int64 g_CalibrationNs = 0;
+      static uint64 g_TraceStartCycles = 0;
+
+      static thread_local JobEventRing* t_Ring = nullptr;
+      static thread_local bool t_NoRingLeft = false;
+      static thread_local char t_ThreadName[eMaxJobProfilerThreadNameLen] = {};
+
+      static uint64 ReadCycleCounter()
+      {
+#ifdef _MSC_VER
+        return __rdtsc();
+#else
+        return __builtin_ia32_rdtsc();
+#endif
+      }
+
+      static int64 ReadTimeNs()
+      {
+        using Clock = std::chrono::steady_clock;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 Clock::now().time_since_epoch())
+          .count();
+      }
+
+      static JobEventRing* AcquireRing()
+      {
+        g_RingsLock.Lock();
+        if (!t_ThreadName[0])
+        {
+          StrBuilder name(t_ThreadName, eMaxJobProfilerThreadNameLen);
+          name.Append("Thread ").AppendU64(g_NumUnnamedThreads++).CStr();
+        }
+
+        JobEventRing* ring = nullptr;
+        const uint32 numRings = g_NumRings.load(std::memory_order_relaxed);
+        for (uint32 i = 0; i < numRings; ++i)
+        {
+          if (!g_Rings[i].m_inUse && !strcmp(g_Rings[i].m_name, t_ThreadName))
+          {
+            ring = &g_Rings[i];
+            break;
+          }
+        }
+        if (!ring && numRings < eMaxJobProfilerThreads)
+        {
+          // Not from the Core heap, so it doesn't show up in the allocation profile
+          ring = &g_Rings[numRings];
+          ring->m_events = (JobEvent*)Platform::AllocAlignedRaw(
+            sizeof(JobEvent) * eJobProfilerEventsPerThread, CACHE_LINE);
+          ring->m_numEvents.store(0, std::memory_order_relaxed);
+          memcpy(ring->m_name, t_ThreadName, eMaxJobProfilerThreadNameLen);
+          g_NumRings.store(numRings + 1, std::memory_order_release);
+        }
+        if (ring)
+        {
+          ring->m_inUse = true;
+        }
+        t_Ring = ring;
+        t_NoRingLeft = !ring;
+        g_RingsLock.Unlock();
+        return ring;
+      }
+
+      void WriteJobEvent(uint32 type, const char* name, uint32 arg)
+      {
+        JobEventRing* ring = t_Ring;
+        if (!ring)
+        {
+          if (t_NoRingLeft)
+          {
+            return;
+          }
+          ring = AcquireRing();
+          if (!ring)
+          {
+            return;
+          }
+        }
+
+        const uint64 index = ring->m_numEvents.load(std::memory_order_relaxed);
+        // A reader that sees any of the stores below also sees the count from before
+        // them, which is how it knows the slot is being overwritten
+        std::atomic_thread_fence(std::memory_order_release);
+        JobEvent& event = ring->m_events[index & (eJobProfilerEventsPerThread - 1)];
+        event.m_timestamp.store(ReadCycleCounter(), std::memory_order_relaxed);
+        event.m_name.store(name, std::memory_order_relaxed);
+        event.m_type.store(type, std::memory_order_relaxed);
+        event.m_arg.store(arg, std::memory_order_relaxed);
+        ring->m_numEvents.store(index + 1, std::memory_order_release);
+      }
+
+      TINKER_API void SetJobProfilerThreadName(const char* name)
+      {
+        // The next event takes the ring that goes with the new name
+        ReleaseJobProfilerThread();
+        StrBuilder threadName(t_ThreadName, eMaxJobProfilerThreadNameLen);
+        threadName.Append(name).CStr();
+      }
+
+      void ReleaseJobProfilerThread()
+      {
+        g_RingsLock.Lock();
+        if (t_Ring)
+        {
+          t_Ring->m_inUse = false;
+        }
+        g_RingsLock.Unlock();
+        t_Ring = nullptr;
+        t_NoRingLeft = false;
+        t_ThreadName[0] = '\0';
+      }
+
+      TINKER_API void SetJobProfilerEnabled(bool enabled)
+      {
+        g_RingsLock.Lock();
+        if (enabled && !g_CalibrationCycles)
+        {
+          g_CalibrationNs = ReadTimeNs();
+          g_CalibrationCycles = ReadCycleCounter();
+          g_TraceStartCycles = g_CalibrationCycles;
+        }
+        g_JobProfilerEnabled.store(enabled ? 1 : 0, std::memory_order_relaxed);
+        g_RingsLock.Unlock();
+      }
+
+      TINKER_API bool IsJobProfilerEnabled()
+      {
+        return g_JobProfilerEnabled.load(std::memory_order_relaxed) != 0;
+      }
+
+      TINKER_API void ClearJobTrace()
+      {
+        g_RingsLock.Lock();
+        g_TraceStartCycles = ReadCycleCounter();
+        g_RingsLock.Unlock();
+      }
+
+      TINKER_API void BeginProfileScope(const char* name)
+      {
+        RecordJobEvent(JobEventType::eBegin, name, 0);
+      }
+
+      TINKER_API void EndProfileScope()
+      {
+        RecordJobEvent(JobEventType::eEnd, nullptr, 0);
+      }
+
+      TINKER_API uint32 WriteJobTraceJSON(char* buffer, uint32 bufferSize)
+      {
+        uint32 len = 0;
+        auto Write = [&](const char* str, uint32 strLen)
+        {
+          if (len < bufferSize)
+          {
+            memcpy(&buffer[len], str, Min(strLen, bufferSize - len));
+          }
+          len += strLen;
+        };
+        auto WriteStr = [&](const char* str)
+        {
+          Write(str, (uint32)strlen(str));
+        };
+        auto WriteName = [&](const char* name)
+        {
+          WriteStr("\"");
+          for (const char* c = name; *c; ++c)
+          {
+            if (*c == '"' || *c == '\\')
+            {
+              WriteStr("\\");
+            }
+            Write(c, 1);
+          }
+          WriteStr("\"");
+        };
+
+        g_RingsLock.Lock();
+        const uint64 calibrationCycles = g_CalibrationCycles;
+        const int64 calibrationNs = g_CalibrationNs;
+        const uint64 traceStartCycles = g_TraceStartCycles;
+        g_RingsLock.Unlock();
+
+        const uint64 elapsedCycles = ReadCycleCounter() - calibrationCycles;
+        const int64 elapsedNs = ReadTimeNs() - calibrationNs;
+        const double nsPerCycle =
+          (elapsedNs > 0 && elapsedCycles) ? (double)elapsedNs / (double)elapsedCycles
+                                           : 1.0;
+
+        auto WriteEventStart = [&](const char* phase, uint32 tid, bool isFirst)
+        {
+          char eventBuffer[64];
+          StrBuilder event(eventBuffer, ARRAYCOUNT(eventBuffer));
+          event.Append(isFirst ? "\n    { " : ",\n    { ");
+          event.Append("\"ph\": \"").Append(phase);
+          event.Append("\", \"pid\": 1, \"tid\": ").AppendU64(tid);
+          Write(event.Data(), event.Len());
+        };
+        auto WriteTimestamp = [&](uint64 cycles)
+        {
+          // Microseconds, to the nanosecond
+          const uint64 ns = cycles > traceStartCycles
+                              ? (uint64)((double)(cycles - traceStartCycles) * nsPerCycle)
+                              : 0;
+          const uint64 fraction = ns % 1000;
+          char tsBuffer[48];
+          StrBuilder ts(tsBuffer, ARRAYCOUNT(tsBuffer));
+          ts.Append(", \"ts\": ").AppendU64(ns / 1000).AppendChar('.');
+          ts.AppendChar((char)('0' + fraction / 100));
+          ts.AppendChar((char)('0' + fraction / 10 % 10));
+          ts.AppendChar((char)('0' + fraction % 10));
+          Write(ts.Data(), ts.Len());
+        };
+
+        JobEventCopy* events = (JobEventCopy*)Platform::AllocAlignedRaw(
+          sizeof(JobEventCopy) * eJobProfilerEventsPerThread, CACHE_LINE);
+
+        WriteStr("{\n  \"traceEvents\": [");
+        bool first = true;
+        const uint32 numRings = g_NumRings.load(std::memory_order_acquire);
+        for (uint32 uiRing = 0; uiRing < numRings; ++uiRing)
+        {
+          const JobEventRing& ring = g_Rings[uiRing];
+          // Nothing writes to a ring nobody owns while the lock is held, so all of it is
+          // valid. Otherwise the owner can be overwriting the oldest event.
+          g_RingsLock.Lock();
+          const bool isOwned = ring.m_inUse;
+          if (isOwned)
+          {
+            g_RingsLock.Unlock();
+          }
+
+          const uint64 numEvents = ring.m_numEvents.load(std::memory_order_acquire);
+          const uint64 firstEvent = numEvents > eJobProfilerEventsPerThread
+                                      ? numEvents - eJobProfilerEventsPerThread
+                                      : 0;
+          for (uint64 i = firstEvent; i < numEvents; ++i)
+          {
+            const JobEvent& event =
+              ring.m_events[i & (eJobProfilerEventsPerThread - 1)];
+            JobEventCopy& copy = events[i - firstEvent];
+            copy.m_timestamp = event.m_timestamp.load(std::memory_order_relaxed);
+            copy.m_name = event.m_name.load(std::memory_order_relaxed);
+            copy.m_type = event.m_type.load(std::memory_order_relaxed);
+            copy.m_arg = event.m_arg.load(std::memory_order_relaxed);
+          }
+          // Anything the owner started overwriting while they were copied is left out
+          std::atomic_thread_fence(std::memory_order_acquire);
+          const uint64 numEventsAfter = ring.m_numEvents.load(std::memory_order_relaxed);
+          uint64 firstValidEvent = firstEvent;
+          if (!isOwned)
+          {
+            g_RingsLock.Unlock();
+          }
+          else if (numEventsAfter >= eJobProfilerEventsPerThread)
+          {
+            firstValidEvent = Max(firstValidEvent,
+                                  numEventsAfter - eJobProfilerEventsPerThread + 1);
+          }
+
+          WriteEventStart("M", uiRing, first);
+          WriteStr(", \"name\": \"thread_name\", \"args\": { \"name\": ");
+          WriteName(ring.m_name);
+          WriteStr(" } }");
+          first = false;
+
+          // Ends whose begin was overwritten or cleared would close the wrong span
+          uint32 depth = 0;
+          for (uint64 i = firstValidEvent; i < numEvents; ++i)
+          {
+            const JobEventCopy& event = events[i - firstEvent];
+            if (event.m_timestamp < traceStartCycles)
+            {
+              continue;
+            }
+
+            switch (event.m_type)
+            {
+              case JobEventType::eBegin:
+              {
+                ++depth;
+                WriteEventStart("B", uiRing, false);
+                WriteStr(", \"name\": ");
+                WriteName(event.m_name ? event.m_name : "Unnamed");
+                WriteTimestamp(event.m_timestamp);
+                WriteStr(" }");
+                break;
+              }
+
+              case JobEventType::eEnd:
+              {
+                if (depth)
+                {
+                  --depth;
+                  WriteEventStart("E", uiRing, false);
+                  WriteTimestamp(event.m_timestamp);
+                  WriteStr(" }");
+                }
+                break;
+              }
+
+              case JobEventType::eInstant:
+              {
+                char argBuffer[48];
+                StrBuilder arg(argBuffer, ARRAYCOUNT(argBuffer));
+                arg.Append(", \"args\": { \"value\": ").AppendU64(event.m_arg);
+                arg.Append(" } }");
+                WriteEventStart("i", uiRing, false);
+                WriteStr(", \"s\": \"t\", \"name\": ");
+                WriteName(event.m_name ? event.m_name : "Unnamed");
+                WriteTimestamp(event.m_timestamp);
+                Write(arg.Data(), arg.Len());
+                break;
+              }
+
+              default:
+              {
+                break;
+              }
+            }
+          }
+        }
+        WriteStr("\n  ],\n  \"displayTimeUnit\": \"ns\"\n}\n");
+
+        Platform::FreeAlignedRaw(events);
+        return len;
+      }
+
+      TINKER_API uint32 DumpJobTraceJSON(const char* filename)
+      {
+        // Threads keep recording while writing, so retry with more room if it doesn't
+        // fit
+        uint32 capacity = 1024 * 1024;
+        while (true)
+        {
+          char* buffer = (char*)Platform::AllocAlignedRaw(capacity, CACHE_LINE);
+          const uint32 len = WriteJobTraceJSON(buffer, capacity);
+          if (len <= capacity)
+          {
+            const uint32 result =
+              Platform::WriteEntireFile(filename, len, (uint8*)buffer);
+            Platform::FreeAlignedRaw(buffer);
+            return result;
+          }
+          Platform::FreeAlignedRaw(buffer);
+          capacity = len + len / 4;
+        }
+      }
+    } //namespace Utility
+  } //namespace Core
+} //namespace Tk
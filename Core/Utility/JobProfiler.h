@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include <atomic>
+
+namespace Tk
+{
+  namespace Core
+  {
+    namespace Utility
+    {
+      // Timeline of which thread ran which job and when, for chrome://tracing or
+      // ui.perfetto.dev. Every thread records into its own ring buffer of its most recent
+      // events, so recording never takes a lock and old events get overwritten rather
+      // than the ring growing. Timestamps are raw cycle counter reads, only converted to
+      // time when the trace is written. Off by default, and while off each call site
+      // costs one relaxed load. Names are stored as pointers, so they have to be string
+      // literals or otherwise outlive the trace.
+      namespace JobEventType
+      {
+        enum : uint32
+        {
+          eBegin = 0, // nests, e.g. a job run by a thread waiting inside another job
+          eEnd,
+          eInstant, // arg is written out with it
+        };
+      } //namespace JobEventType
+
+      enum : uint32
+      {
+        eMaxJobProfilerThreads = 64,
+        eJobProfilerEventsPerThread = 1 << 16,
+        eMaxJobProfilerThreadNameLen = 32,
+      };
+
+      // Core only, the game goes through the exported functions below
+      extern std::atomic<uint32> g_JobProfilerEnabled;
+      void WriteJobEvent(uint32 type, const char* name, uint32 arg);
+
+      inline void RecordJobEvent(uint32 type, const char* name, uint32 arg)
+      {
+        if (g_JobProfilerEnabled.load(std::memory_order_relaxed))
+        {
+          WriteJobEvent(type, name, arg);
+        }
+      }
+
+      // A thread's ring is only allocated once it records its first event. Threads
+      // that never named themselves show up as "Thread <n>".
+      TINKER_API void SetJobProfilerThreadName(const char* name);
+      // Lets a thread that starts later with the same name, like a worker after the
+      // pool restarts, carry on in the same ring
+      void ReleaseJobProfilerThread();
+
+      TINKER_API void SetJobProfilerEnabled(bool enabled);
+      TINKER_API bool IsJobProfilerEnabled();
+      // Events recorded so far are left out of the traces written after this
+      TINKER_API void ClearJobTrace();
+
+      TINKER_API void BeginProfileScope(const char* name);
+      TINKER_API void EndProfileScope();
+
+      struct ProfileScope
+      {
+        ProfileScope(const char* name)
+        {
+          BeginProfileScope(name);
+        }
+
+        ~ProfileScope()
+        {
+          EndProfileScope();
+        }
+      };
+
+      // Chrome trace event format, { "traceEvents": [ ... ] }. Events are read without
+      // stopping the threads recording them, those being overwritten while this reads
+      // are left out. Returns the length of the whole document, which is more than was
+      // written if bufferSize was too small.
+      TINKER_API uint32 WriteJobTraceJSON(char* buffer, uint32 bufferSize);
+      // Returns 0 on success, like Platform::WriteEntireFile()
+      TINKER_API uint32 DumpJobTraceJSON(const char* filename);
+    } //namespace Utility
+  } //namespace Core
+} //namespace Tk
+
+#define JOB_PROFILE_SCOPE(name) Tk::Core::Utility::ProfileScope _jobProfileScope(name);
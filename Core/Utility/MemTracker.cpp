@@ -1,9 +1,9 @@
 #include "Utility/MemTracker.h"
-#include "DataStructures/HashMap.h"
 #include "Platform/PlatformGameAPI.h"
-//#include "Allocators.h"
-//#include "StringTypes.h"
+#include "StringTypes.h"
 
+#include <atomic>
+#include <math.h>
 #include <string.h>
 
 namespace Tk
@@ -12,221 +12,433 @@ namespace Tk
   {
     namespace Utility
     {
-      Tk::Core::LinearAllocator StackTraceEntryAllocator;
+      enum : uint32
+      {
+        eMaxStackFrames = 32,
+        eFramesToSkip = 2, // RecordMemAlloc() and CoreMalloc()
+        eMaxCallSites = 4096,
+        eInvalidCallSite = MAX_UINT32,
+        eLiveBucketsLog2 = 13,
+        eNumLiveBuckets = 1 << eLiveBucketsLog2,
+        eLiveBucketSize = 8,
+        eMaxSymbolLen = 256,
+        eNumTopCallSitesToPrint = 10,
+      };
 
-      struct MemRecord
+      struct MemCallSite
       {
-        uint64 memPtr = 0;
-        uint64 sizeInBytes = 0;
-        uint8 bWasDeallocated = 0;
+        std::atomic<uint64> m_hash; // 0 until claimed
+        std::atomic<uint32> m_numFrames; // 0 until m_frames is written
+        uint64 m_frames[eMaxStackFrames]; // innermost first
+        std::atomic<uint64> m_numSamples;
+        std::atomic<uint64> m_allocatedBytes;
+        std::atomic<int64> m_liveBytes;
+        std::atomic<int64> m_peakLiveBytes;
+      };
 
-        Tk::Platform::StackTraceEntry* firstStackTraceEntry = nullptr;
+      // Sampled allocations that haven't been freed yet. A bucket is one cache line, so
+      // checking an unsampled free against it costs a single miss. Samples that land in
+      // a full bucket still count as allocated, just not as live.
+      struct alignas(CACHE_LINE) MemLiveBucket
+      {
+        std::atomic<uint64> m_ptrs[eLiveBucketSize]; // 0 if the slot is free
+      };
 
-        MemRecord() {}
+      struct MemLiveSample
+      {
+        uint32 m_callSite;
+        int64 m_weight;
+      };
 
-        /*bool operator==(const MemRecord& other) const
-        {
-            // Only check if memptr is same
-            return (memPtr == other.memPtr);
-        }*/
+      struct MemSamplerThreadState
+      {
+        int64 m_bytesUntilSample;
+        uint64 m_rngState; // 0 until the thread's first allocation
       };
 
-#define MAX_ALLOCS_RECORDED 65'536
+      static MemCallSite g_CallSites[eMaxCallSites];
+      static MemLiveBucket g_LiveBuckets[eNumLiveBuckets];
+      // Only touched by the thread that claimed the matching slot in g_LiveBuckets
+      static MemLiveSample g_LiveSamples[eNumLiveBuckets][eLiveBucketSize];
+      static std::atomic<uint64> g_SampleInterval = MemSampleIntervalDefault;
+      static std::atomic<uint64> g_NumDroppedSamples = 0;
 
-      struct MemTracker
-      {
-        HashMap<uint64, MemRecord, MapHashFn64> m_AllocRecords;
-        uint8 bEnableAllocRecording = 0;
+      static thread_local MemSamplerThreadState t_SamplerState;
 
-        MemTracker()
+      // Gaps between samples are exponentially distributed, which makes sampling a
+      // Poisson process over allocated bytes
+      static int64 NextSampleInterval(MemSamplerThreadState& state)
+      {
+        const uint64 mean = g_SampleInterval.load(std::memory_order_relaxed);
+        if (mean <= 1)
         {
-#ifdef ENABLE_MEM_TRACKING
-          m_AllocRecords.Reserve(MAX_ALLOCS_RECORDED);
-          bEnableAllocRecording =
-            1; // prevents this first actual map allocation from being recorded
+          return 1;
+        }
+
+        // xorshift64*
+        state.m_rngState ^= state.m_rngState >> 12;
+        state.m_rngState ^= state.m_rngState << 25;
+        state.m_rngState ^= state.m_rngState >> 27;
+        const uint64 rand = state.m_rngState * 0x2545F4914F6CDD1Dull;
 
-          // Have to manually allocate memory for the mem tracker since it'll call into
-          // the mem tracking code before it's fully initted :)
-          const uint32 allocatorSizeInBytes = 1024 * 1024 * 128;
-          void* stackTraceAllocation =
-            Tk::Platform::AllocAlignedRaw(allocatorSizeInBytes, CACHE_LINE);
-          StackTraceEntryAllocator.Init(
-            stackTraceAllocation,
-            allocatorSizeInBytes); // TODO: use linked list of linear allocators ideally
-#endif
+        // Uniform in (0, 1]
+        const double u = (double)((rand >> 11) + 1) * (1.0 / 9007199254740992.0);
+        return (int64)(-log(u) * (double)mean) + 1;
+      }
+
+      static void InitSamplerState(MemSamplerThreadState& state)
+      {
+        // Any per thread value works as a seed, as long as it isn't 0
+        state.m_rngState = ((uint64)&state * 0x9E3779B97F4A7C15ull) | 1;
+        state.m_bytesUntilSample = NextSampleInterval(state);
+      }
+
+      // An allocation of size bytes is sampled with probability 1 - e^(-size / interval),
+      // dividing by that makes the expected weight equal to the size
+      static int64 SampleWeight(uint64 sizeInBytes)
+      {
+        const double interval =
+          (double)Max(g_SampleInterval.load(std::memory_order_relaxed), (uint64)1);
+        const double size = (double)sizeInBytes;
+        return sizeInBytes ? (int64)(size / (1.0 - exp(-size / interval))) : 0;
+      }
+
+      static uint64 HashStackFrames(const uint64* frames, uint32 numFrames)
+      {
+        uint64 hash = 0xCBF29CE484222325ull;
+        for (uint32 i = 0; i < numFrames; ++i)
+        {
+          hash = (hash ^ frames[i]) * 0x9E3779B97F4A7C15ull;
+          hash ^= hash >> 29;
         }
+        return hash ? hash : 1;
+      }
 
-        ~MemTracker()
+      static uint32 FindOrAddCallSite(const uint64* frames, uint32 numFrames)
+      {
+        const uint64 hash = HashStackFrames(frames, numFrames);
+        for (uint32 probe = 0; probe < eMaxCallSites; ++probe)
         {
-#ifdef ENABLE_MEM_TRACKING
-          bEnableAllocRecording = 0;
-          DebugOutputAllMemAllocs();
-          StackTraceEntryAllocator.ExplicitFree();
-#endif
+          const uint32 index = (uint32)(hash + probe) & (eMaxCallSites - 1);
+          MemCallSite& site = g_CallSites[index];
+
+          uint64 existing = site.m_hash.load(std::memory_order_acquire);
+          if (!existing)
+          {
+            if (site.m_hash.compare_exchange_strong(existing, hash,
+                                                    std::memory_order_acq_rel))
+            {
+              memcpy(site.m_frames, frames, numFrames * sizeof(uint64));
+              site.m_numFrames.store(numFrames, std::memory_order_release);
+              return index;
+            }
+            // Someone else claimed it first, existing is now their hash
+          }
+
+          if (existing == hash)
+          {
+            return index;
+          }
         }
-      };
+        return eInvalidCallSite;
+      }
 
-      static MemTracker g_MemTracker;
+      static MemLiveBucket& LiveBucketFromPtr(uint64 ptr, uint32* bucketIndex)
+      {
+        *bucketIndex =
+          (uint32)(((ptr >> 4) * 0x9E3779B97F4A7C15ull) >> (64 - eLiveBucketsLog2));
+        return g_LiveBuckets[*bucketIndex];
+      }
 
-      void RecordMemAlloc(uint64 sizeInBytes, void* memPtr)
+      static bool AddLiveSample(uint64 ptr, uint32 callSite, int64 weight)
       {
-        if (!g_MemTracker.bEnableAllocRecording)
+        uint32 bucketIndex;
+        MemLiveBucket& bucket = LiveBucketFromPtr(ptr, &bucketIndex);
+        for (uint32 i = 0; i < eLiveBucketSize; ++i)
         {
+          uint64 expected = 0;
+          if (!bucket.m_ptrs[i].load(std::memory_order_relaxed)
+              && bucket.m_ptrs[i].compare_exchange_strong(expected, ptr,
+                                                          std::memory_order_acquire))
+          {
+            g_LiveSamples[bucketIndex][i] = { callSite, weight };
+            return true;
+          }
+        }
+        return false;
+      }
+
+      static void RecordSample(uint64 sizeInBytes, uint64 ptr, const uint64* frames,
+                               uint32 numFrames)
+      {
+        const uint32 callSite = FindOrAddCallSite(frames, numFrames);
+        if (callSite == eInvalidCallSite)
+        {
+          g_NumDroppedSamples.fetch_add(1, std::memory_order_relaxed);
           return;
         }
 
-        uint64 ptrAsU64 = (uint64)memPtr;
+        MemCallSite& site = g_CallSites[callSite];
+        const int64 weight = SampleWeight(sizeInBytes);
+        site.m_numSamples.fetch_add(1, std::memory_order_relaxed);
+        site.m_allocatedBytes.fetch_add((uint64)weight, std::memory_order_relaxed);
 
-        // Grab stack trace of allocation
-        Tk::Platform::StackTraceEntry* topOfStack = nullptr;
-        uint32 error =
-          Tk::Platform::WalkStackTrace(&topOfStack, StackTraceEntryAllocator);
-        if (error != 0)
+        if (!AddLiveSample(ptr, callSite, weight))
         {
-          TINKER_ASSERT("Failed to get stack trace in mem tracker!");
+          g_NumDroppedSamples.fetch_add(1, std::memory_order_relaxed);
+          return;
         }
 
-        // Finalize memory alloc record struct
-        MemRecord m;
-        m.sizeInBytes = sizeInBytes;
-        m.memPtr = ptrAsU64;
-        m.bWasDeallocated = 0;
-        m.firstStackTraceEntry = topOfStack;
-        g_MemTracker.m_AllocRecords.Insert(ptrAsU64, m);
+        const int64 liveBytes =
+          site.m_liveBytes.fetch_add(weight, std::memory_order_relaxed) + weight;
+        int64 peak = site.m_peakLiveBytes.load(std::memory_order_relaxed);
+        while (liveBytes > peak
+               && !site.m_peakLiveBytes.compare_exchange_weak(peak, liveBytes,
+                                                              std::memory_order_relaxed))
+          ;
       }
 
-      void RecordMemDealloc(void* memPtr)
+      void RecordMemAlloc(uint64 sizeInBytes, void* memPtr)
       {
-        if (!g_MemTracker.bEnableAllocRecording || !memPtr)
+        if (!memPtr)
         {
           return;
         }
 
-        uint32 index = g_MemTracker.m_AllocRecords.FindIndex((uint64)memPtr);
+        MemSamplerThreadState& state = t_SamplerState;
+        if (!state.m_rngState)
+        {
+          InitSamplerState(state);
+        }
 
-        if (index == g_MemTracker.m_AllocRecords.eInvalidIndex)
+        state.m_bytesUntilSample -= (int64)sizeInBytes;
+        if (state.m_bytesUntilSample > 0)
         {
-          // Memory not allocated yet
-          TINKER_ASSERT(0);
+          return;
         }
-        else
+        state.m_bytesUntilSample = NextSampleInterval(state);
+
+        uint64 frames[eMaxStackFrames];
+        const uint32 numFrames =
+          Platform::CaptureStackTrace(frames, eMaxStackFrames, eFramesToSkip);
+        RecordSample(sizeInBytes, (uint64)memPtr, frames, numFrames);
+      }
+
+      // Has to be called before the memory is freed, otherwise another thread could
+      // allocate and sample the same address in between
+      void RecordMemDealloc(void* memPtr)
+      {
+        if (!memPtr)
         {
-          MemRecord& m = g_MemTracker.m_AllocRecords.DataAtIndex(index);
-          if (m.bWasDeallocated == 1)
-          {
-            // Double free
-            TINKER_ASSERT(0);
-          }
-          else
+          return;
+        }
+
+        const uint64 ptr = (uint64)memPtr;
+        uint32 bucketIndex;
+        MemLiveBucket& bucket = LiveBucketFromPtr(ptr, &bucketIndex);
+        for (uint32 i = 0; i < eLiveBucketSize; ++i)
+        {
+          if (bucket.m_ptrs[i].load(std::memory_order_relaxed) == ptr)
           {
-            m.bWasDeallocated = 1;
+            const MemLiveSample sample = g_LiveSamples[bucketIndex][i];
+            bucket.m_ptrs[i].store(0, std::memory_order_release);
+            g_CallSites[sample.m_callSite].m_liveBytes.fetch_sub(
+              sample.m_weight, std::memory_order_relaxed);
+            return;
           }
         }
       }
 
-      static uint32 LastIndexOf(const char pathDelimiter, const char* stringBuf,
-                                uint32 stringBufLen)
+      TINKER_API void SetMemSampleInterval(uint64 meanBytesBetweenSamples)
       {
-        uint32 finalDirIndex = 0;
-        for (uint32 i = 0; i < stringBufLen; ++i)
+        g_SampleInterval.store(Max(meanBytesBetweenSamples, (uint64)1),
+                               std::memory_order_relaxed);
+
+        MemSamplerThreadState& state = t_SamplerState;
+        if (!state.m_rngState)
         {
-          if (stringBuf[i] == pathDelimiter)
+          InitSamplerState(state);
+        }
+        state.m_bytesUntilSample = NextSampleInterval(state);
+      }
+
+      TINKER_API MemProfileStats GetMemProfileStats()
+      {
+        MemProfileStats stats = {};
+        for (uint32 i = 0; i < eMaxCallSites; ++i)
+        {
+          const MemCallSite& site = g_CallSites[i];
+          if (!site.m_hash.load(std::memory_order_acquire))
           {
-            finalDirIndex = i;
+            continue;
           }
+          ++stats.m_numCallSites;
+          stats.m_numSamples += site.m_numSamples.load(std::memory_order_relaxed);
+          stats.m_allocatedBytes += site.m_allocatedBytes.load(std::memory_order_relaxed);
+          stats.m_liveBytes +=
+            (uint64)Max(site.m_liveBytes.load(std::memory_order_relaxed), (int64)0);
         }
-
-        return finalDirIndex;
+        stats.m_numDroppedSamples = g_NumDroppedSamples.load(std::memory_order_relaxed);
+        return stats;
       }
 
-#ifdef _ENGINE_ROOT_PATH
-  #define ENGINE_ROOT_PATH STRINGIFY(_ENGINE_ROOT_PATH)
-#else
-  #define ENGINE_ROOT_PATH "./"
-#endif
-      static const uint32 absolutePathPrefixLen = (uint32)strlen(ENGINE_ROOT_PATH);
-
-      static void ProcessStackTraceStrings(Tk::Platform::StackTraceEntry* stackTrace)
+      static int64 CallSiteValue(const MemCallSite& site, uint32 value)
       {
-        for (uint32 i = 0; i < Tk::Platform::StackTraceEntry::MaxNameBufferSize; ++i)
+        switch (value)
         {
-          if (stackTrace->moduleName[i] == '\\')
+          case MemProfileValue::eAllocatedBytes:
+          {
+            return (int64)site.m_allocatedBytes.load(std::memory_order_relaxed);
+          }
+          case MemProfileValue::eLiveBytes:
           {
-            stackTrace->moduleName[i] = '/';
+            return site.m_liveBytes.load(std::memory_order_relaxed);
           }
-          if (stackTrace->functionName[i] == '\\')
+          case MemProfileValue::ePeakLiveBytes:
           {
-            stackTrace->functionName[i] = '/';
+            return site.m_peakLiveBytes.load(std::memory_order_relaxed);
           }
-          if (stackTrace->fileName[i] == '\\')
+          default:
           {
-            stackTrace->fileName[i] = '/';
+            TINKER_ASSERT(0);
+            return 0;
           }
         }
       }
 
-      void DebugOutputAllMemAllocs()
+      TINKER_API uint32 WriteMemProfileFolded(char* buffer, uint32 bufferSize,
+                                              uint32 value)
       {
-        // TODO: You can't really track deallocations perfectly due to destructor order
-        // not being guaranteed, but cool test
+        uint32 len = 0;
+        auto Write = [&](const char* str, uint32 strLen)
+        {
+          if (len < bufferSize)
+          {
+            memcpy(&buffer[len], str, Min(strLen, bufferSize - len));
+          }
+          len += strLen;
+        };
 
-        Platform::PrintDebugString(
-          "\n***** MEMTRACKER: Dumping all alloc records *****\n\n");
-        for (uint32 i = 0; i < g_MemTracker.m_AllocRecords.Size(); ++i)
+        for (uint32 i = 0; i < eMaxCallSites; ++i)
         {
-          uint64 key = g_MemTracker.m_AllocRecords.KeyAtIndex(i);
-          if (key == g_MemTracker.m_AllocRecords.GetInvalidKey())
+          const MemCallSite& site = g_CallSites[i];
+          const uint32 numFrames = site.m_numFrames.load(std::memory_order_acquire);
+          const int64 siteValue = CallSiteValue(site, value);
+          if (!numFrames || siteValue <= 0)
           {
             continue;
           }
 
-          const MemRecord& record = g_MemTracker.m_AllocRecords.DataAtIndex(i);
-          //if (!record.bWasDeallocated)
+          // Outermost frame first
+          for (uint32 uiFrame = numFrames; uiFrame-- > 0;)
           {
-            Platform::PrintDebugString("Allocation: ");
+            char symbol[eMaxSymbolLen];
+            Platform::SymbolizeAddress(site.m_frames[uiFrame], symbol, eMaxSymbolLen);
+            const uint32 symbolLen = (uint32)strlen(symbol);
+            for (uint32 uiChar = 0; uiChar < symbolLen; ++uiChar)
+            {
+              // Frame separator in the folded format
+              if (symbol[uiChar] == ';')
+              {
+                symbol[uiChar] = ':';
+              }
+            }
+            Write(symbol, symbolLen);
+            Write(uiFrame ? ";" : " ", 1);
+          }
 
-            // Allocation size
-            // TODO don't use an array like this?
-            char buffer[256];
-            memset(buffer, 0, ARRAYCOUNT(buffer));
-            _itoa_s((int)record.sizeInBytes, buffer, ARRAYCOUNT(buffer), 10);
-            Platform::PrintDebugString(buffer);
-            Platform::PrintDebugString(" bytes");
-            Platform::PrintDebugString("\n");
+          char valueBuffer[32];
+          StrBuilder valueStr(valueBuffer, ARRAYCOUNT(valueBuffer));
+          valueStr.AppendU64((uint64)siteValue).AppendChar('\n');
+          Write(valueStr.Data(), valueStr.Len());
+        }
+        return len;
+      }
 
-            Tk::Platform::StackTraceEntry* stackTrace = record.firstStackTraceEntry;
-            Tk::Core::StrFixedBuffer<Tk::Platform::StackTraceEntry::MaxNameBufferSize>
-              stackPrintBuf;
-            while (stackTrace)
+      TINKER_API uint32 DumpMemProfileFolded(const char* filename, uint32 value)
+      {
+        // Not from the Core heap, so dumping doesn't show up in the profile. Call sites
+        // can still be added while writing, so retry with more room if it doesn't fit.
+        uint32 capacity = 1024 * 64;
+        while (true)
+        {
+          char* buffer = (char*)Platform::AllocAlignedRaw(capacity, CACHE_LINE);
+          const uint32 len = WriteMemProfileFolded(buffer, capacity, value);
+          if (len <= capacity)
+          {
+            const uint32 result =
+              Platform::WriteEntireFile(filename, len, (uint8*)buffer);
+            Platform::FreeAlignedRaw(buffer);
+            return result;
+          }
+          Platform::FreeAlignedRaw(buffer);
+          capacity = len + len / 4;
+        }
+      }
+
+      void DebugOutputAllMemAllocs()
+      {
+        const MemProfileStats stats = GetMemProfileStats();
+
+        char lineBuffer[eMaxSymbolLen + 64];
+        StrBuilder line(lineBuffer, ARRAYCOUNT(lineBuffer));
+        line.Append("\n***** MEMTRACKER: ").AppendU64(stats.m_numSamples);
+        line.Append(" samples, ").AppendU64(stats.m_numCallSites);
+        line.Append(" call sites, ").AppendU64(stats.m_liveBytes);
+        line.Append(" bytes live (estimated) *****\n\n");
+        Platform::PrintDebugString(line.CStr());
+
+        // Call sites with the most live bytes, biggest first
+        uint32 printed[eNumTopCallSitesToPrint];
+        uint32 numPrinted = 0;
+        while (numPrinted < eNumTopCallSitesToPrint)
+        {
+          uint32 best = eInvalidCallSite;
+          for (uint32 i = 0; i < eMaxCallSites; ++i)
+          {
+            const MemCallSite& site = g_CallSites[i];
+            bool alreadyPrinted = false;
+            for (uint32 j = 0; j < numPrinted; ++j)
             {
-              stackPrintBuf.Clear();
-              ProcessStackTraceStrings(stackTrace);
-
-              // Trim path off module name
-              uint32 lastDirDelimiterIndex = LastIndexOf(
-                '/', stackTrace->moduleName.Data(), stackTrace->moduleName.Len());
-
-              stackPrintBuf.Append(
-                stackTrace->moduleName.Data() + lastDirDelimiterIndex + 1);
-              stackPrintBuf.Append("!");
-              stackPrintBuf.Append(stackTrace->functionName.Data());
-              stackPrintBuf.Append(" in file: ");
-              stackPrintBuf.Append(stackTrace->fileName.Data() + absolutePathPrefixLen);
-              stackPrintBuf.Append(":");
-
-              // Line number
-              memset(buffer, 0, ARRAYCOUNT(buffer));
-              _itoa_s((int)stackTrace->lineNum, buffer, ARRAYCOUNT(buffer), 10);
-              stackPrintBuf.Append(buffer);
-
-              stackPrintBuf.Append("\n");
-              stackPrintBuf.NullTerminate();
-              Platform::PrintDebugString(stackPrintBuf.Data());
-
-              stackTrace = stackTrace->next;
+              alreadyPrinted |= printed[j] == i;
             }
-            Platform::PrintDebugString("\n");
+            if (!alreadyPrinted
+                && site.m_numFrames.load(std::memory_order_acquire)
+                && site.m_liveBytes.load(std::memory_order_relaxed) > 0
+                && (best == eInvalidCallSite
+                    || site.m_liveBytes.load(std::memory_order_relaxed)
+                         > g_CallSites[best].m_liveBytes.load(std::memory_order_relaxed)))
+            {
+              best = i;
+            }
+          }
+          if (best == eInvalidCallSite)
+          {
+            break;
+          }
+          printed[numPrinted++] = best;
+
+          const MemCallSite& site = g_CallSites[best];
+          line.Clear();
+          line.Append("Live: ");
+          line.AppendI64(site.m_liveBytes.load(std::memory_order_relaxed));
+          line.Append(" bytes, peak: ");
+          line.AppendI64(site.m_peakLiveBytes.load(std::memory_order_relaxed));
+          line.Append(" bytes, allocated: ");
+          line.AppendU64(site.m_allocatedBytes.load(std::memory_order_relaxed));
+          line.Append(" bytes\n");
+          Platform::PrintDebugString(line.CStr());
+
+          const uint32 numFrames = site.m_numFrames.load(std::memory_order_relaxed);
+          for (uint32 uiFrame = 0; uiFrame < numFrames; ++uiFrame)
+          {
+            char symbol[eMaxSymbolLen];
+            Platform::SymbolizeAddress(site.m_frames[uiFrame], symbol, eMaxSymbolLen);
+            line.Clear();
+            line.Append("  ").Append(symbol).Append("\n");
+            Platform::PrintDebugString(line.CStr());
           }
+          Platform::PrintDebugString("\n");
         }
         Platform::PrintDebugString("********************\n");
       }
@@ -8,9 +8,51 @@ namespace Tk
   {
     namespace Utility
     {
-      // TODO: make this stuff thread-safe
+      // Sampling allocation profiler. Allocations are sampled on average once every
+      // sample interval bytes (a Poisson process over allocated bytes, so big
+      // allocations are more likely to get picked), and each sample is weighted so that
+      // the totals per call site estimate the real number of bytes. Call sites are keyed
+      // by a hash of the raw stack, symbols are only looked up when dumping. Threads only
+      // touch a thread local byte counter between samples and never take a lock, so it
+      // can stay on under real load.
+      const uint64 MemSampleIntervalDefault = 512 * 1024;
+
+      struct MemProfileStats
+      {
+        uint64 m_numSamples;
+        uint64 m_numCallSites;
+        uint64 m_allocatedBytes; // estimated bytes allocated since startup
+        uint64 m_liveBytes; // estimated bytes allocated and not freed yet
+        uint64 m_numDroppedSamples; // call site or live sample tables were full
+      };
+
+      namespace MemProfileValue
+      {
+        enum : uint32
+        {
+          eAllocatedBytes = 0,
+          eLiveBytes,
+          ePeakLiveBytes,
+        };
+      } //namespace MemProfileValue
+
       void RecordMemAlloc(uint64 sizeInBytes, void* memPtr);
       void RecordMemDealloc(void* memPtr);
+
+      // Takes effect for each thread after its next sample, and right away on this one.
+      // 1 samples every allocation.
+      TINKER_API void SetMemSampleInterval(uint64 meanBytesBetweenSamples);
+      TINKER_API MemProfileStats GetMemProfileStats();
+
+      // Folded stacks, one "root;...;leaf value" line per call site, which is what
+      // flamegraph.pl, inferno and speedscope read. Returns the length of the whole
+      // profile, which is more than was written if bufferSize was too small.
+      TINKER_API uint32 WriteMemProfileFolded(char* buffer, uint32 bufferSize,
+                                              uint32 value);
+      // Returns 0 on success, like Platform::WriteEntireFile()
+      TINKER_API uint32 DumpMemProfileFolded(const char* filename, uint32 value);
+
+      // Prints the call sites with the most live bytes
       void DebugOutputAllMemAllocs();
     } //namespace Utility
   } //namespace Core
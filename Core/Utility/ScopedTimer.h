@@ -5,6 +5,7 @@
 #ifdef PERFORMANCE_TIMERS
   #include "Logging.h"
   #include <chrono>
+  #include <stdio.h>
 
   #define MAX_MSG_LEN 128
   #define MAX_TIME_DIGITS 16 + 1 // + 1 for the dot in a decimal
@@ -50,8 +51,8 @@ namespace Tk
           auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
             (currentTime - m_startTime));
 
-          _ultoa_s((uint32)duration.count(), m_msg + m_msgSizeBeforeTimer,
-                   MAX_TIME_DIGITS, 10);
+          snprintf(m_msg + m_msgSizeBeforeTimer, MAX_TIME_DIGITS, "%u",
+                   (uint32)duration.count());
           Utility::LogMsg("Core - Performance", m_msg, Utility::LogSeverity::eInfo);
         }
       };
@@ -11,6 +11,8 @@
 #include "Sorting.h"
 #include "StringTypes.h"
 #include "ThirdParty/imgui-docking/imgui.h"
+#include "Utility/AllocatorRegistry.h"
+#include "Utility/JobProfiler.h"
 
 static const uint32 MAX_VERTS = 1024 * 1024;
 static const uint32 MAX_IDXS = MAX_VERTS * 3;
@@ -482,6 +484,8 @@ namespace DebugUI
 
   static bool mainMenu_SelectedOverview = false;
   static bool mainMenu_SelectedRPTimings = false;
+  static bool mainMenu_SelectedAllocators = false;
+  static bool mainMenu_SelectedJobProfiler = false;
 
   void UI_MainMenu()
   {
@@ -492,6 +496,8 @@ namespace DebugUI
     {
       mainMenu_SelectedOverview = false;
       mainMenu_SelectedRPTimings = false;
+      mainMenu_SelectedAllocators = false;
+      mainMenu_SelectedJobProfiler = false;
       return;
     }
 
@@ -505,6 +511,17 @@ namespace DebugUI
         if (ImGui::MenuItem("GPU Render Pass Timings", NULL, &mainMenu_SelectedRPTimings))
         {
         }
+        if (ImGui::MenuItem("Job Profiler", NULL, &mainMenu_SelectedJobProfiler))
+        {
+        }
+
+        ImGui::EndMenu();
+      }
+      if (ImGui::BeginMenu("Memory"))
+      {
+        if (ImGui::MenuItem("Allocators", NULL, &mainMenu_SelectedAllocators))
+        {
+        }
 
         ImGui::EndMenu();
       }
@@ -724,17 +741,17 @@ namespace DebugUI
 
           if (shouldCopyToClip)
           {
-            static Tk::Core::StrFixedBuffer<1'048'576> csvOutput;
-            csvOutput.Clear();
+            static char csvBuffer[1'048'576];
+            Tk::Core::StrBuilder csvOutput(csvBuffer, ARRAYCOUNT(csvBuffer));
 
             // Headers
             const char* delimiter = ",";
             for (uint32 uiValue = 0; uiValue < numCols; ++uiValue)
             {
               csvOutput.Append(headerStrings[uiValue]);
-              csvOutput.Append(delimiter);
+              csvOutput.Append(delimiter, 1);
             }
-            csvOutput.Append("\n");
+            csvOutput.AppendChar('\n');
 
             // Data
             for (uint32 i = 0; i < entryDisplayList.Size(); ++i)
@@ -742,20 +759,16 @@ namespace DebugUI
               const DisplayTimestampEntry& displayEntry = entryDisplayList[i];
 
               csvOutput.Append(displayEntry.name);
-              csvOutput.Append(delimiter);
+              csvOutput.Append(delimiter, 1);
               for (uint32 uiValue = 0; uiValue < DisplayTimestampEntry::DisplayCount;
                    ++uiValue)
               {
-                int result = sprintf_s(csvOutput.EndOfStrPtr(), csvOutput.LenRemaining(),
-                                       "%.2f", displayEntry.timeData[uiValue]);
-                TINKER_ASSERT(result != -1);
-                csvOutput.m_len += result;
-                csvOutput.Append(delimiter);
+                csvOutput.AppendFloat(displayEntry.timeData[uiValue], 2);
+                csvOutput.Append(delimiter, 1);
               }
-              csvOutput.Append("\n");
+              csvOutput.AppendChar('\n');
             }
-            csvOutput.NullTerminate();
-            ImGui::SetClipboardText(csvOutput.m_data);
+            ImGui::SetClipboardText(csvOutput.CStr());
 
             shouldCopyToClip = false;
           }
@@ -792,4 +805,104 @@ namespace DebugUI
       ImGui::End();
     }
   }
+
+  void UI_MemoryStats()
+  {
+    using namespace Tk;
+    using namespace Core::Utility;
+
+    if (!mainMenu_SelectedAllocators)
+    {
+      return;
+    }
+
+    if (ImGui::Begin("Allocators"))
+    {
+      static AllocatorStatsEntry entries[eMaxRegisteredAllocators];
+      const uint32 numEntries = GetAllocatorStats(entries, eMaxRegisteredAllocators);
+
+      if (ImGui::Button("Dump JSON"))
+      {
+        Platform::MakeDirectory("..\\Output");
+        DumpAllocatorStatsJSON("..\\Output\\AllocatorStats.json");
+      }
+
+      ImGuiTableFlags_ tableFlags =
+        (ImGuiTableFlags_)(ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit
+                           | ImGuiTableFlags_PadOuterX | ImGuiTableFlags_Resizable);
+
+      const uint32 numCols = 7;
+      if (ImGui::BeginTable("Allocators Table", numCols, tableFlags))
+      {
+        const char* headerStrings[numCols] = {
+          "Name", "Usage", "Used (MB)", "Peak (MB)", "Committed (MB)", "Capacity (MB)",
+          "Allocs",
+        };
+        for (uint32 uiCol = 0; uiCol < numCols; ++uiCol)
+        {
+          ImGui::TableSetupColumn(headerStrings[uiCol]);
+        }
+        ImGui::TableHeadersRow();
+
+        const float bytesToMB = 1.0f / (1024.0f * 1024.0f);
+        for (uint32 i = 0; i < numEntries; ++i)
+        {
+          const AllocatorStats& stats = entries[i].m_stats;
+
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::Text("%s", entries[i].m_name);
+          ImGui::TableNextColumn();
+          const float usedFraction =
+            stats.m_capacity ? (float)stats.m_used / (float)stats.m_capacity : 0.0f;
+          ImGui::ProgressBar(usedFraction, ImVec2(100.0f, 0.0f));
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", (float)stats.m_used * bytesToMB);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", (float)stats.m_highWaterMark * bytesToMB);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", (float)stats.m_committed * bytesToMB);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", (float)stats.m_capacity * bytesToMB);
+          ImGui::TableNextColumn();
+          ImGui::Text("%llu", (unsigned long long)stats.m_numAllocs);
+        }
+
+        ImGui::EndTable();
+      }
+    }
+    ImGui::End();
+  }
+
+  void UI_JobProfiler()
+  {
+    using namespace Tk;
+    using namespace Core::Utility;
+
+    if (!mainMenu_SelectedJobProfiler)
+    {
+      return;
+    }
+
+    if (ImGui::Begin("Job Profiler"))
+    {
+      bool enabled = IsJobProfilerEnabled();
+      if (ImGui::Checkbox("Record", &enabled))
+      {
+        SetJobProfilerEnabled(enabled);
+      }
+      if (ImGui::Button("Clear"))
+      {
+        ClearJobTrace();
+      }
+      ImGui::SameLine();
+      // Open in chrome://tracing or ui.perfetto.dev
+      if (ImGui::Button("Dump trace JSON"))
+      {
+        Platform::MakeDirectory("..\\Output");
+        DumpJobTraceJSON("..\\Output\\JobTrace.json");
+      }
+    }
+    ImGui::End();
+  }
 } //namespace DebugUI
@@ -23,4 +23,6 @@ namespace DebugUI
   void UI_MainMenu();
   void UI_PerformanceOverview();
   void UI_RenderPassStats();
+  void UI_MemoryStats();
+  void UI_JobProfiler();
 } //namespace DebugUI
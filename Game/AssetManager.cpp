@@ -3,6 +3,7 @@
 #include "Graphics/Common/GraphicsCommon.h"
 #include "Mem.h"
 #include "Platform/PlatformGameAPI.h"
+#include "Utility/AllocatorRegistry.h"
 #include "Utility/Logging.h"
 #include "Utility/ScopedTimer.h"
 #include <string.h>
@@ -12,8 +13,10 @@ using namespace Platform;
 
 AssetManager g_AssetManager;
 
-static const uint64 AssetFileMemorySize = 1024 * 1024 * 1024;
-static Tk::Core::LinearAllocator g_AssetFileScratchMemory;
+// Grows as needed, files bigger than a block get a block of their own
+static const uint64 AssetFileScratchBlockSize = 1024 * 1024 * 64;
+static const uint32 AssetStringTableSize = 1024 * 64;
+static Tk::Core::ChainedLinearAllocator g_AssetFileScratchMemory;
 
 // For storing dumping obj vertex data during parsing
 static Tk::Core::Asset::OBJParseScratchBuffers ScratchBuffers;
@@ -83,41 +86,18 @@ namespace AssetCooker
     return FileData;
   }
 
-  void GetCookedDataFileName(const char* inAssetFileName, char* outCookedFileName,
-                             uint32 outNameMaxLen)
+  // Writes the null terminated cooked file path and returns its length
+  uint32 GetCookedDataFileName(Tk::Core::Hash assetNameHash, char* outCookedFileName,
+                               uint32 outNameMaxLen)
   {
-    Tk::Core::StrFixedBuffer<2048> MeshNameStr;
-    MeshNameStr.Clear();
-
+    Tk::Core::StrBuilder MeshNameStr(outCookedFileName, outNameMaxLen);
     MeshNameStr.Append(COOKED_ASSETS_PATH);
     MeshNameStr.Append("Mesh_");
-    const Tk::Core::Hash nameHash =
-      HASH_64_RUNTIME(inAssetFileName, (uint32)strlen(inAssetFileName));
-    _ui64toa_s(nameHash.m_val, MeshNameStr.EndOfStrPtr(), MeshNameStr.LenRemaining(), 10);
-    MeshNameStr.UpdateLen();
-    MeshNameStr.Append(".");
+    MeshNameStr.AppendU64(assetNameHash.m_val);
+    MeshNameStr.AppendChar('.');
     MeshNameStr.Append(fileSuffix);
     MeshNameStr.NullTerminate();
-
-    if (MeshNameStr.m_len > outNameMaxLen)
-    {
-      // TODO error
-    }
-    else
-    {
-      memcpy(outCookedFileName, MeshNameStr.m_data, MeshNameStr.m_len);
-    }
-  }
-
-  bool IsCookedDataFilePresentForAsset(const char* assetName)
-  {
-    Tk::Core::StrFixedBuffer<2048> MeshNameStr;
-    MeshNameStr.Clear();
-    GetCookedDataFileName(assetName, MeshNameStr.EndOfStrPtr(),
-                          MeshNameStr.LenRemaining());
-    MeshNameStr.UpdateLen();
-
-    return Tk::Platform::CheckFileExists(MeshNameStr.m_data);
+    return MeshNameStr.Len();
   }
 } //namespace AssetCooker
 
@@ -127,11 +107,14 @@ void AssetManager::FreeMemory()
   VertUVAllocator.ExplicitFree();
   VertNormalAllocator.ExplicitFree();
   VertIndexAllocator.ExplicitFree();
+  m_assetStrings.Shutdown();
 }
 
 void AssetManager::LoadAllAssets()
 {
-  g_AssetFileScratchMemory.Init(AssetFileMemorySize, CACHE_LINE);
+  g_AssetFileScratchMemory.Init(AssetFileScratchBlockSize, CACHE_LINE);
+  Core::Utility::RegisterAllocator(g_AssetFileScratchMemory, "Asset file scratch");
+  m_assetStrings.Init(AssetStringTableSize);
   AssetCooker::Init();
 
   // Meshes
@@ -149,28 +132,36 @@ void AssetManager::LoadAllAssets()
       meshFileAlreadyCooked[TINKER_MAX_MESHES] = {}; // TODO needs to get replaced with a
                                                      // system that makes more sense
 
+    // Every name and path is built once here, everything after refers to them by ID
+    uint32 meshNameIDs[TINKER_MAX_MESHES] = {};
+    uint32 meshCookedPathIDs[TINKER_MAX_MESHES] = {};
+    uint32 meshLoadPathIDs[TINKER_MAX_MESHES] = {};
+
     for (uint32 uiAsset = 0; uiAsset < m_numMeshAssets; ++uiAsset)
     {
-      static const uint32 filepathMax = 2048;
-      Tk::Core::StrFixedBuffer<2048> AssetLoadPath;
-      AssetLoadPath.Clear();
+      meshNameIDs[uiAsset] = m_assetStrings.Intern(meshFileNames[uiAsset]);
+      const Tk::Core::Hash nameHash = m_assetStrings.GetHash(meshNameIDs[uiAsset]);
+
+      char cookedFileName[512];
+      const uint32 cookedFileNameLen = AssetCooker::GetCookedDataFileName(
+        nameHash, cookedFileName, ARRAYCOUNT(cookedFileName));
+      meshCookedPathIDs[uiAsset] =
+        m_assetStrings.Intern(cookedFileName, cookedFileNameLen);
 
       // Check if cooked asset data file exists and use that size instead
       meshFileAlreadyCooked[uiAsset] =
-        (uint32)AssetCooker::IsCookedDataFilePresentForAsset(meshFileNames[uiAsset]);
+        (uint32)Tk::Platform::CheckFileExists(cookedFileName);
       if (meshFileAlreadyCooked[uiAsset])
       {
-        AssetCooker::GetCookedDataFileName(meshFileNames[uiAsset],
-                                           AssetLoadPath.EndOfStrPtr(),
-                                           AssetLoadPath.LenRemaining());
-        AssetLoadPath.UpdateLen();
+        meshLoadPathIDs[uiAsset] = meshCookedPathIDs[uiAsset];
       }
       else
       {
-        AssetLoadPath.Append(meshFilePaths[uiAsset]);
+        meshLoadPathIDs[uiAsset] = m_assetStrings.Intern(meshFilePaths[uiAsset]);
       }
 
-      const uint32 fileSize = Tk::Platform::GetEntireFileSize(AssetLoadPath.m_data);
+      const uint32 fileSize =
+        Tk::Platform::GetEntireFileSize(m_assetStrings.Str(meshLoadPathIDs[uiAsset]));
       meshFileSizes[uiAsset] = fileSize;
       totalMeshFileBytes += fileSize;
     }
@@ -203,32 +194,19 @@ void AssetManager::LoadAllAssets()
           uint32 currentMeshFileSize = meshFileSizes[uiAsset];
           accumFileOffset += currentMeshFileSize + 1; // Account for manual EOF byte
 
-          // Duplicated logic from above
-          static const uint32 filepathMax = 2048;
-          Tk::Core::StrFixedBuffer<2048> AssetLoadPath;
-          AssetLoadPath.Clear();
-
-          // Check if cooked asset data file exists and use that size instead
-          meshFileAlreadyCooked[uiAsset] =
-            (uint32)AssetCooker::IsCookedDataFilePresentForAsset(meshFileNames[uiAsset]);
-          if (meshFileAlreadyCooked[uiAsset])
-          {
-            AssetCooker::GetCookedDataFileName(meshFileNames[uiAsset],
-                                               AssetLoadPath.EndOfStrPtr(),
-                                               AssetLoadPath.LenRemaining());
-            AssetLoadPath.UpdateLen();
-          }
-          else
-          {
-            AssetLoadPath.Append(meshFilePaths[uiAsset]);
-          }
-
+          // The string table is read-only while the jobs run
+          const char* assetLoadPath = m_assetStrings.Str(meshLoadPathIDs[uiAsset]);
+          const uint64 nameHash = m_assetStrings.GetHash(meshNameIDs[uiAsset]).m_val;
+          auto* meshIDsByName = &m_meshIDsByName;
           jobs.m_jobs[uiAsset] = Platform::CreateNewThreadJob(
+            "Read mesh file",
             [=]()
             {
-              Tk::Platform::ReadEntireFile(AssetLoadPath.m_data, currentMeshFileSize,
+              Tk::Platform::ReadEntireFile(assetLoadPath, currentMeshFileSize,
                                            currentMeshFile);
               currentMeshFile[currentMeshFileSize] = '\0'; // Mark EOF
+
+              meshIDsByName->Insert(nameHash, uiAsset);
             });
         }
         Tk::Platform::EnqueueWorkerThreadJobList_Assisted(&jobs);
@@ -243,28 +221,12 @@ void AssetManager::LoadAllAssets()
           uint32 currentMeshFileSize = meshFileSizes[uiAsset];
           accumFileOffset += currentMeshFileSize + 1; // Account for manual EOF byte
 
-          // Duplicated logic from above
-          static const uint32 filepathMax = 2048;
-          Tk::Core::StrFixedBuffer<2048> AssetLoadPath;
-          AssetLoadPath.Clear();
-
-          // Check if cooked asset data file exists and use that size instead
-          meshFileAlreadyCooked[uiAsset] =
-            (uint32)AssetCooker::IsCookedDataFilePresentForAsset(meshFileNames[uiAsset]);
-          if (meshFileAlreadyCooked[uiAsset])
-          {
-            AssetCooker::GetCookedDataFileName(meshFileNames[uiAsset],
-                                               AssetLoadPath.EndOfStrPtr(),
-                                               AssetLoadPath.LenRemaining());
-            AssetLoadPath.UpdateLen();
-          }
-          else
-          {
-            AssetLoadPath.Append(meshFilePaths[uiAsset]);
-          }
-
+          ReadEntireFile(m_assetStrings.Str(meshLoadPathIDs[uiAsset]),
+                         currentMeshFileSize, currentMeshFile);
           currentMeshFile[currentMeshFileSize] = '\0'; // Mark EOF
-          ReadEntireFile(meshFilePaths[uiAsset], currentMeshFileSize, currentMeshFile);
+
+          m_meshIDsByName.Insert(m_assetStrings.GetHash(meshNameIDs[uiAsset]).m_val,
+                                 uiAsset);
         }
       }
     }
@@ -273,22 +235,33 @@ void AssetManager::LoadAllAssets()
     {
       TIMED_SCOPED_BLOCK("Parse mesh Files - single threaded");
 
+      // Only reserved, pages get committed as the parser fills them
       const uint32 MAX_VERT_BUFFER_SIZE =
         1024
         * 1024
         * 128; // TODO: reduce this when we don't have to store all the attr buffers in
                // the same linear allocator by doing graphics right here
-      VertPosAllocator.Init(MAX_VERT_BUFFER_SIZE, CACHE_LINE);
-      VertUVAllocator.Init(MAX_VERT_BUFFER_SIZE, CACHE_LINE);
-      VertNormalAllocator.Init(MAX_VERT_BUFFER_SIZE, CACHE_LINE);
-      VertIndexAllocator.Init(MAX_VERT_BUFFER_SIZE, CACHE_LINE);
-
-      ScratchBuffers = {};
-      ScratchBuffers.VertPosAllocator.Init(MAX_VERT_BUFFER_SIZE, CACHE_LINE);
-      ScratchBuffers.VertUVAllocator.Init(MAX_VERT_BUFFER_SIZE, CACHE_LINE);
-      ScratchBuffers.VertNormalAllocator.Init(MAX_VERT_BUFFER_SIZE, CACHE_LINE);
-
-      CookedDataAllocator.Init(MAX_COOKED_BUFFER_SIZE, CACHE_LINE);
+      const uint32 vmFlags = VirtualMemFlags::eNone;
+      VertPosAllocator.InitReserved(MAX_VERT_BUFFER_SIZE, vmFlags);
+      VertUVAllocator.InitReserved(MAX_VERT_BUFFER_SIZE, vmFlags);
+      VertNormalAllocator.InitReserved(MAX_VERT_BUFFER_SIZE, vmFlags);
+      VertIndexAllocator.InitReserved(MAX_VERT_BUFFER_SIZE, vmFlags);
+
+      ScratchBuffers.VertPosAllocator.InitReserved(MAX_VERT_BUFFER_SIZE, vmFlags);
+      ScratchBuffers.VertUVAllocator.InitReserved(MAX_VERT_BUFFER_SIZE, vmFlags);
+      ScratchBuffers.VertNormalAllocator.InitReserved(MAX_VERT_BUFFER_SIZE, vmFlags);
+
+      CookedDataAllocator.InitReserved(MAX_COOKED_BUFFER_SIZE, vmFlags);
+
+      using Core::Utility::RegisterAllocator;
+      RegisterAllocator(VertPosAllocator, "Mesh positions");
+      RegisterAllocator(VertUVAllocator, "Mesh UVs");
+      RegisterAllocator(VertNormalAllocator, "Mesh normals");
+      RegisterAllocator(VertIndexAllocator, "Mesh indices");
+      RegisterAllocator(ScratchBuffers.VertPosAllocator, "OBJ parse positions");
+      RegisterAllocator(ScratchBuffers.VertUVAllocator, "OBJ parse UVs");
+      RegisterAllocator(ScratchBuffers.VertNormalAllocator, "OBJ parse normals");
+      RegisterAllocator(CookedDataAllocator, "Cooked mesh data");
 
       accumFileOffset = 0;
       uint32 accumNumVerts = 0;
@@ -319,11 +292,6 @@ void AssetManager::LoadAllAssets()
           // m_allMeshData at all
 
           {
-            // Duplicated logic from above
-            static const uint32 filepathMax = 2048;
-            Tk::Core::StrFixedBuffer<2048> AssetLoadPath;
-            AssetLoadPath.Clear();
-
             // NOTE: This is exactly how the graphics buffer will be written to. That code
             // should unified with this logic
 
@@ -359,12 +327,8 @@ void AssetManager::LoadAllAssets()
             memcpy(cookedDataBufferIndex, m_allMeshData[uiAsset].m_vertexBufferData_Index,
                    sizeof(uint32) * header.numVertices);
 
-            AssetCooker::GetCookedDataFileName(meshFileNames[uiAsset],
-                                               AssetLoadPath.EndOfStrPtr(),
-                                               AssetLoadPath.LenRemaining());
-            AssetLoadPath.UpdateLen();
-            Tk::Platform::WriteEntireFile(AssetLoadPath.m_data, cookedDataBufferSize,
-                                          cookedDataBufferHeader);
+            Tk::Platform::WriteEntireFile(m_assetStrings.Str(meshCookedPathIDs[uiAsset]),
+                                          cookedDataBufferSize, cookedDataBufferHeader);
           }
 
           ScratchBuffers.ResetState();
@@ -430,6 +394,7 @@ void AssetManager::LoadAllAssets()
     {
       Platform::WorkerJobList jobs;
       jobs.Init(m_numTextureAssets);
+      Platform::JobCounter texturesRead;
       for (uint32 uiAsset = 0; uiAsset < m_numTextureAssets; ++uiAsset)
       {
         uint8* currentTextureFile = textureFileDataBuffer + accumFileOffset;
@@ -437,15 +402,18 @@ void AssetManager::LoadAllAssets()
         accumFileOffset += currentTextureFileSize;
 
         jobs.m_jobs[uiAsset] = Platform::CreateNewThreadJob(
+          "Read texture file",
           [=]()
           {
             ReadEntireFile(textureFilePaths[uiAsset], currentTextureFileSize,
                            currentTextureFile);
           });
 
-        EnqueueWorkerThreadJob(jobs.m_jobs[uiAsset]);
+        LaunchJob(jobs.m_jobs[uiAsset], &texturesRead, nullptr);
       }
-      jobs.WaitOnJobs();
+      // Reads block on the disk, so sleep rather than spin once there's nothing to help
+      // with
+      WaitOnJobCounter(&texturesRead, true);
       jobs.FreeList();
     }
     else
@@ -514,6 +482,7 @@ void AssetManager::LoadAllAssets()
 
     // Allocate exactly enough space for each texture, cache-line aligned
     m_textureBufferAllocator.Init(totalActualTextureSize, CACHE_LINE);
+    Core::Utility::RegisterAllocator(m_textureBufferAllocator, "Texture data");
 
     accumFileOffset = 0;
     for (uint32 uiAsset = 0; uiAsset < m_numTextureAssets; ++uiAsset)
@@ -854,3 +823,15 @@ const MeshAttributeData& AssetManager::GetMeshAttrDataByID(uint32 meshID) const
   TINKER_ASSERT(meshID < TINKER_MAX_MESHES);
   return m_allMeshData[meshID];
 }
+
+uint32 AssetManager::GetMeshIDByName(const char* meshName) const
+{
+  return GetMeshIDByName(HASH_64_RUNTIME(meshName, (uint32)strlen(meshName)));
+}
+
+uint32 AssetManager::GetMeshIDByName(Tk::Core::Hash meshNameHash) const
+{
+  uint32 meshID = TINKER_INVALID_HANDLE;
+  m_meshIDsByName.Find(meshNameHash.m_val, &meshID);
+  return meshID;
+}
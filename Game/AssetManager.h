@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Allocators.h"
+#include "DataStructures/ConcurrentHashMap.h"
+#include "StringTable.h"
 #include "GraphicsTypes.h"
 
 #ifdef _ASSETS_DIR
@@ -27,6 +29,13 @@ private:
   TextureMetadata m_allTextureMetadata[TINKER_MAX_TEXTURES];
   Tk::Graphics::ResourceHandle m_allTextureGraphicsHandles[TINKER_MAX_TEXTURES];
 
+  // Mesh asset name hash -> mesh ID. Filled in by the load jobs and safe to query from
+  // any thread.
+  Tk::Core::ConcurrentHashMap<uint64, uint32, MapHashFn64> m_meshIDsByName;
+
+  // Asset names and file paths, built once at load time
+  Tk::Core::StringTable m_assetStrings;
+
   void CreateVertexBufferDescriptor(uint32 meshID);
 
 public:
@@ -48,6 +57,10 @@ public:
   StaticMeshData* GetMeshGraphicsDataByID(uint32 meshID);
   Tk::Graphics::ResourceHandle GetTextureGraphicsDataByID(uint32 textureID) const;
   const MeshAttributeData& GetMeshAttrDataByID(uint32 meshID) const;
+  // Returns TINKER_INVALID_HANDLE if no mesh with that name was loaded
+  uint32 GetMeshIDByName(const char* meshName) const;
+  // Same, for names hashed at compile time with HASH_64
+  uint32 GetMeshIDByName(Tk::Core::Hash meshNameHash) const;
 };
 
 extern AssetManager g_AssetManager;
@@ -1,6 +1,6 @@
 #include "BindlessSystem.h"
 #include "Core/Allocators.h"
-#include "Core/DataStructures/Vector.h"
+#include "Core/DataStructures/SlotAllocator.h"
 
 using namespace Tk;
 
@@ -11,9 +11,14 @@ namespace BindlessSystem
   // Bindless texture/buffer arrays
   static Graphics::DescriptorHandle
     BindlessDescriptors[BindlessArrayID::eMax]; // API bindless descriptor array objects
-  static Tk::Core::Vector<Graphics::ResourceHandle> BindlessDescriptorDataLists
-    [BindlessArrayID::eNumBindlessTextureTypes]; // per-frame populated data for each
-                                                 // bindless descriptor
+  // Resource handle in each slot of each bindless descriptor, mirrored into the
+  // descriptor for every frame in flight
+  static Tk::Core::MirroredSlotTable<MAX_FRAMES_IN_FLIGHT>
+    BindlessSlotTables[BindlessArrayID::eNumBindlessTextureTypes];
+  // Slots that changed since the current frame's descriptors were written
+  static uint32 BindlessDirtySlots[DESCRIPTOR_BINDLESS_ARRAY_LIMIT];
+  static uint32 BindlessDirtyValues[DESCRIPTOR_BINDLESS_ARRAY_LIMIT];
+  static Graphics::ResourceHandle BindlessDirtyResources[DESCRIPTOR_BINDLESS_ARRAY_LIMIT];
   static uint32 BindlessDescriptorIDs[BindlessArrayID::eMax] = // descriptor ID per
                                                                // bindless descriptor
     { Graphics::DESCLAYOUT_ID_BINDLESS_TEXTURES_RGBA8_SAMPLED,
@@ -26,8 +31,10 @@ namespace BindlessSystem
     };
   // TODO static assert
 
-  // Constant buffer
-  static Tk::Core::LinearAllocator BindlessConstantBufferAllocator;
+  // Constant buffer. CPU-side data is staged in the frame arena and copied to the GPU
+  // buffer in one go at Flush().
+  static uint8* BindlessConstantData = nullptr;
+  static uint32 BindlessConstantDataSize = 0;
   static Graphics::ResourceHandle BindlessConstantBuffer =
     Graphics::DefaultResHandle_Invalid;
 
@@ -37,14 +44,15 @@ namespace BindlessSystem
     return BindlessDescriptors[bindlessID];
   }
 
-  void ResetFrame()
+  void ResetFrame(Tk::Core::ChainedLinearAllocator* frameArena)
   {
-    for (uint32 i = 0; i < ARRAYCOUNT(BindlessDescriptorDataLists); ++i)
+    const uint32 frameInFlight = Graphics::GetCurrentFrameInFlightIndex();
+    for (uint32 i = 0; i < ARRAYCOUNT(BindlessSlotTables); ++i)
     {
-      BindlessDescriptorDataLists[i].Clear();
-      BindlessDescriptorDataLists[i].Reserve(DESCRIPTOR_BINDLESS_ARRAY_LIMIT);
+      BindlessSlotTables[i].BeginFrame(frameInFlight);
     }
-    BindlessConstantBufferAllocator.ResetState();
+    BindlessConstantData = frameArena->Alloc(BindlessConstantDataMaxBytes, 16);
+    BindlessConstantDataSize = 0;
   }
 
   void Create()
@@ -57,9 +65,17 @@ namespace BindlessSystem
       BindlessDescriptors[i] = Graphics::CreateDescriptor(BindlessDescriptorIDs[i]);
     }
 
-    // Constant buffer
-    BindlessConstantBufferAllocator.Init(BindlessConstantDataMaxBytes, 16);
+    // Every slot starts out as the fallback resource, the first Flush() for each frame in
+    // flight writes the whole array
+    for (uint32 i = 0; i < ARRAYCOUNT(BindlessSlotTables); ++i)
+    {
+      const Graphics::ResourceHandle fallbackResource =
+        Graphics::GetDefaultResource(BindlessDescriptorFallbackIDs[i]).res;
+      BindlessSlotTables[i].Init(DESCRIPTOR_BINDLESS_ARRAY_LIMIT,
+                                 fallbackResource.m_hRes);
+    }
 
+    // Constant buffer
     Graphics::ResourceDesc desc = {};
     desc.resourceType = Graphics::ResourceType::eBuffer1D;
     desc.debugLabel = "Bindless constant buffer";
@@ -85,8 +101,13 @@ namespace BindlessSystem
         BindlessDescriptors[i] = Graphics::DefaultDescHandle_Invalid;
       }
     }
+    for (uint32 i = 0; i < ARRAYCOUNT(BindlessSlotTables); ++i)
+    {
+      BindlessSlotTables[i].ExplicitFree();
+    }
 
-    BindlessConstantBufferAllocator.ExplicitFree();
+    BindlessConstantData = nullptr;
+    BindlessConstantDataSize = 0;
 
     Graphics::DestroyResource(BindlessConstantBuffer);
     BindlessConstantBuffer = Graphics::DefaultResHandle_Invalid;
@@ -94,55 +115,71 @@ namespace BindlessSystem
 
   void Flush()
   {
-    // Pad each list with default/fallback resources, then write to each descriptor object
+    // Write just the changed slots into this frame's copy of each descriptor object
     for (uint32 i = 0; i < BindlessArrayID::eNumBindlessTextureTypes; ++i)
     {
-      Tk::Core::Vector<Graphics::ResourceHandle>& BindlessDescriptorData =
-        BindlessDescriptorDataLists[i];
-      const Graphics::ResourceHandle fallbackResource =
-        Graphics::GetDefaultResource(BindlessDescriptorFallbackIDs[i]).res;
+      const uint32 numDirty =
+        BindlessSlotTables[i].Flush(BindlessDirtySlots, BindlessDirtyValues);
+      if (numDirty == 0)
+      {
+        continue;
+      }
 
-      const uint32 numFallbackResNeeded =
-        DESCRIPTOR_BINDLESS_ARRAY_LIMIT - BindlessDescriptorData.Size();
-      for (uint32 uiFallback = 0; uiFallback < numFallbackResNeeded; ++uiFallback)
+      for (uint32 uiDirty = 0; uiDirty < numDirty; ++uiDirty)
       {
-        BindlessDescriptorData.PushBackRaw(fallbackResource);
+        BindlessDirtyResources[uiDirty] =
+          Graphics::ResourceHandle(BindlessDirtyValues[uiDirty]);
       }
-      Graphics::WriteDescriptorArray(
-        BindlessDescriptors[i], DESCRIPTOR_BINDLESS_ARRAY_LIMIT,
-        (Graphics::ResourceHandle*)BindlessDescriptorData.Data(),
-        Graphics::DescUpdateConfigFlags::Transient);
+      Graphics::WriteDescriptorArray(BindlessDescriptors[i], numDirty,
+                                     BindlessDirtyResources, BindlessDirtySlots,
+                                     Graphics::DescUpdateConfigFlags::Transient);
     }
 
     // Write constant buffer from cpu to gpu buffer
-    const uint32 memcpySizeInBytes = (uint32)BindlessConstantBufferAllocator.Size();
+    const uint32 memcpySizeInBytes = BindlessConstantDataSize;
     TINKER_ASSERT(memcpySizeInBytes <= BindlessConstantDataMaxBytes);
     Tk::Graphics::MemoryMappedBufferPtr bufferPtr =
       Tk::Graphics::MapResource(BindlessConstantBuffer);
-    bufferPtr.MemcpyInto(BindlessConstantBufferAllocator.Data(), memcpySizeInBytes);
+    bufferPtr.MemcpyInto(BindlessConstantData, memcpySizeInBytes);
     // TODO: debug functionality where we memset the remaining to zero or something
     Tk::Graphics::UnmapResource(BindlessConstantBuffer);
   }
 
-  uint32 BindResourceForFrame(Tk::Graphics::ResourceHandle resource,
-                              uint32 bindlessArrayID)
+  uint32 BindResource(Tk::Graphics::ResourceHandle resource, uint32 bindlessArrayID)
+  {
+    TINKER_ASSERT(bindlessArrayID < BindlessArrayID::eNumBindlessTextureTypes);
+    const uint32 bindlessIndex =
+      BindlessSlotTables[bindlessArrayID].Alloc(resource.m_hRes);
+    // If this fails, every slot in the bindless array is in use
+    TINKER_ASSERT(bindlessIndex != Tk::Core::SlotAllocator::eInvalidSlot);
+    return bindlessIndex;
+  }
+
+  void RebindResource(uint32 bindlessIndex, Tk::Graphics::ResourceHandle resource,
+                      uint32 bindlessArrayID)
+  {
+    TINKER_ASSERT(bindlessArrayID < BindlessArrayID::eNumBindlessTextureTypes);
+    BindlessSlotTables[bindlessArrayID].Set(bindlessIndex, resource.m_hRes);
+    // A recreated resource can come back with the same handle, so always rewrite it
+    BindlessSlotTables[bindlessArrayID].MarkDirty(bindlessIndex);
+  }
+
+  void UnbindResource(uint32 bindlessIndex, uint32 bindlessArrayID)
   {
-    Tk::Core::Vector<Tk::Graphics::ResourceHandle>& BindlessDescriptorData =
-      BindlessDescriptorDataLists[bindlessArrayID];
-    const uint32 currentSize = BindlessDescriptorData.Size();
-    TINKER_ASSERT(currentSize < DESCRIPTOR_BINDLESS_ARRAY_LIMIT);
-    BindlessDescriptorData.PushBackRaw(resource);
-    return currentSize;
+    TINKER_ASSERT(bindlessArrayID < BindlessArrayID::eNumBindlessTextureTypes);
+    BindlessSlotTables[bindlessArrayID].Free(bindlessIndex);
   }
 
   uint32 PushStructIntoConstantBuffer(const void* srcData, size_t sizeInBytes,
                                       size_t alignment)
   {
-    TINKER_ASSERT(sizeInBytes <= BindlessConstantDataMaxBytes);
-    void* constantsDataPtr =
-      BindlessConstantBufferAllocator.Alloc(sizeInBytes, (uint32)alignment);
-    memcpy(constantsDataPtr, srcData, sizeInBytes);
-    return (uint32)((uint8*)constantsDataPtr
-                    - (uint8*)BindlessConstantBufferAllocator.Data());
+    TINKER_ASSERT(BindlessConstantData);
+    TINKER_ASSERT(ISPOW2(alignment));
+    const uint32 offset =
+      (BindlessConstantDataSize + (uint32)alignment - 1) & ~((uint32)alignment - 1);
+    TINKER_ASSERT(offset + sizeInBytes <= BindlessConstantDataMaxBytes);
+    memcpy(BindlessConstantData + offset, srcData, sizeInBytes);
+    BindlessConstantDataSize = offset + (uint32)sizeInBytes;
+    return offset;
   }
 } //namespace BindlessSystem
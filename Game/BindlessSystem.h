@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Core/Allocators.h"
 #include "Graphics/Common/GraphicsCommon.h"
 
 namespace BindlessSystem
@@ -25,13 +26,23 @@ namespace BindlessSystem
 
   void Create();
   void Destroy();
-  void ResetFrame();
+  // Constant buffer data for the frame is staged in frameArena. Bindless indices that
+  // were unbound the last time this frame in flight came around get reused from here on.
+  void ResetFrame(Tk::Core::ChainedLinearAllocator* frameArena);
+  // Only writes the bindless descriptor entries that changed since this frame in flight's
+  // descriptors were last written
   void Flush();
 
-  // Returns the index that this resource will be populated at in the bindless descriptor
-  // for this frame
-  uint32 BindResourceForFrame(Tk::Graphics::ResourceHandle resource,
-                              uint32 bindlessArrayID);
+  // Returns the index that this resource will be at in the bindless descriptor, which
+  // stays the same until it gets unbound
+  uint32 BindResource(Tk::Graphics::ResourceHandle resource, uint32 bindlessArrayID);
+  // Points an index at a different resource, e.g. a render target recreated on resize.
+  // The entry is always rewritten, even if the handle didn't change.
+  void RebindResource(uint32 bindlessIndex, Tk::Graphics::ResourceHandle resource,
+                      uint32 bindlessArrayID);
+  // The index shows the fallback resource from the next Flush() on, and gets handed out
+  // again once no frame in flight can still be reading it
+  void UnbindResource(uint32 bindlessIndex, uint32 bindlessArrayID);
 
   // Returns the offset into the constant buffer where the first byte of the data provided
   // was written
@@ -23,6 +23,7 @@
 #include "RenderPasses/ZPrepassRenderPass.h"
 #include "Scene.h"
 #include "ShaderCompiler/ShaderCompiler.h"
+#include "Utility/AllocatorRegistry.h"
 #include "Utility/ScopedTimer.h"
 #include "View.h"
 #include <string.h>
@@ -42,6 +43,10 @@ static Tk::Platform::WindowHandles* g_windowHandles = nullptr;
 Tk::Graphics::GraphicsCommandStream g_graphicsCommandStream;
 Tk::Graphics::CommandBuffer g_FrameCommandBuffer;
 
+// Transient per-frame data, freed once the GPU is done with the frame
+static const uint32 FrameArenaBlockSize = 1024 * 256;
+static Tk::Core::FrameArena<MAX_FRAMES_IN_FLIGHT> g_FrameArena;
+
 // For now, this owns all RTs
 GameGraphicsData gameGraphicsData = {};
 static GameRenderPass gameRenderPassList[eRenderPass_Max] = {};
@@ -215,29 +220,50 @@ static void WriteSwapChainCopyResources()
   Graphics::WriteDescriptorSimple(defaultQuad.m_descriptor, &vbHandles);
 }
 
-static void RegisterActiveTextures()
+// Bindless indices of the resources used this frame, bound once at init
+// TODO: eventually these indices will be hooked up to a material system so that at draw
+// time we can pass these indices as a constant to the gpu for bindless descriptor
+// indexing
+static uint32 textureBindlessIndices[2] = {};
+static uint32 computeCopySrcBindlessIndex = BindlessSystem::BindlessIndexMax;
+static uint32 computeCopyDstBindlessIndex = BindlessSystem::BindlessIndexMax;
+
+static void BindActiveTextures()
 {
-  uint32 index = BindlessSystem::BindlessIndexMax;
-  index = BindlessSystem::BindResourceForFrame(
-    g_AssetManager.GetTextureGraphicsDataByID(0),
-    BindlessSystem::BindlessArrayID::eTexturesRGBA8Sampled);
-  index = BindlessSystem::BindResourceForFrame(
-    g_AssetManager.GetTextureGraphicsDataByID(1),
-    BindlessSystem::BindlessArrayID::eTexturesRGBA8Sampled);
-  // TODO: eventually these indices will be hooked up to a material system so that at draw
-  // time we can pass these indices as a constant to the gpu for bindless descriptor
-  // indexing
+  for (uint32 i = 0; i < ARRAYCOUNT(textureBindlessIndices); ++i)
+  {
+    textureBindlessIndices[i] = BindlessSystem::BindResource(
+      g_AssetManager.GetTextureGraphicsDataByID(i),
+      BindlessSystem::BindlessArrayID::eTexturesRGBA8Sampled);
+  }
 
   // WIP: Push some render targets into the bindless array for compute copy test pass
+  computeCopySrcBindlessIndex =
+    BindlessSystem::BindResource(gameGraphicsData.m_rtColorToneMappedHandle,
+                                 BindlessSystem::BindlessArrayID::eTexturesRGBA8RW);
+  computeCopyDstBindlessIndex =
+    BindlessSystem::BindResource(gameGraphicsData.m_computeColorHandle,
+                                 BindlessSystem::BindlessArrayID::eTexturesRGBA8RW);
+}
+
+// The render targets get recreated on resize, the indices stay the same
+static void RebindWindowResizeDependentTextures()
+{
+  BindlessSystem::RebindResource(computeCopySrcBindlessIndex,
+                                 gameGraphicsData.m_rtColorToneMappedHandle,
+                                 BindlessSystem::BindlessArrayID::eTexturesRGBA8RW);
+  BindlessSystem::RebindResource(computeCopyDstBindlessIndex,
+                                 gameGraphicsData.m_computeColorHandle,
+                                 BindlessSystem::BindlessArrayID::eTexturesRGBA8RW);
+}
+
+static void PushMaterialConstants()
+{
   // TODO: move this struct building to elsewhere
   alignas(16) ShaderDescriptors::Material_ComputeCopyImage2D copyConstants = {};
   copyConstants.dims = v2ui(currentWindowWidth, currentWindowHeight);
-  copyConstants.srcIndexBindless = BindlessSystem::BindResourceForFrame(
-    gameGraphicsData.m_rtColorToneMappedHandle,
-    BindlessSystem::BindlessArrayID::eTexturesRGBA8RW);
-  copyConstants.dstIndexBindless = BindlessSystem::BindResourceForFrame(
-    gameGraphicsData.m_computeColorHandle,
-    BindlessSystem::BindlessArrayID::eTexturesRGBA8RW);
+  copyConstants.srcIndexBindless = computeCopySrcBindlessIndex;
+  copyConstants.dstIndexBindless = computeCopyDstBindlessIndex;
   uint32 materialDataByteOffset = BindlessSystem::PushStructIntoConstantBuffer(
     &copyConstants, sizeof(copyConstants),
     alignof(ShaderDescriptors::Material_ComputeCopyImage2D));
@@ -246,6 +272,7 @@ static void RegisterActiveTextures()
 static void CreateAllDescriptors()
 {
   BindlessSystem::Create();
+  BindActiveTextures();
 
   // Tone mapping
   gameGraphicsData.m_toneMappingDescHandle =
@@ -376,6 +403,14 @@ static uint32 GameInit(uint32 windowWidth, uint32 windowHeight)
     (Tk::Graphics::GraphicsCommand*)Tk::Core::CoreMallocAligned(
       g_graphicsCommandStream.m_maxCommands * sizeof(Tk::Graphics::GraphicsCommand),
       CACHE_LINE);
+  g_FrameArena.Init(FrameArenaBlockSize, CACHE_LINE);
+  for (uint32 uiFrame = 0; uiFrame < MAX_FRAMES_IN_FLIGHT; ++uiFrame)
+  {
+    char nameBuffer[32];
+    Tk::Core::StrBuilder name(nameBuffer, ARRAYCOUNT(nameBuffer));
+    name.Append("Frame arena ").AppendU64(uiFrame);
+    Tk::Core::Utility::RegisterAllocator(g_FrameArena.m_arenas[uiFrame], name.CStr());
+  }
 
   if (Tk::ShaderCompiler::Init() != Tk::ShaderCompiler::ErrCode::Success)
   {
@@ -488,6 +523,9 @@ extern "C" GAME_UPDATE(GameUpdate)
     }
   }
 
+  // AcquireFrame() waited on this frame's fence, so its previous contents are free
+  g_FrameArena.BeginFrame(Tk::Graphics::GetCurrentFrameInFlightIndex());
+
   DebugUI::NewFrame();
 
   UpdateAxisVectors(&g_gameCamera);
@@ -500,12 +538,14 @@ extern "C" GAME_UPDATE(GameUpdate)
     g_InputManager.UpdateAndDoCallbacks(inputStateDeltas);
   }
 
-  BindlessSystem::ResetFrame();
+  BindlessSystem::ResetFrame(&g_FrameArena.Current());
 
   // Update Imgui menus
   DebugUI::UI_MainMenu();
   DebugUI::UI_PerformanceOverview();
   DebugUI::UI_RenderPassStats();
+  DebugUI::UI_MemoryStats();
+  DebugUI::UI_JobProfiler();
   {
     // TODO: put this in View::Update() and write to the data repository from there
     alignas(16) m4f viewProj = g_projMat * CameraViewMatrix(&g_gameCamera);
@@ -518,10 +558,11 @@ extern "C" GAME_UPDATE(GameUpdate)
     (void)firstGlobalDataByteOffset;
   }
 
-  // Update bindless resource descriptors
-  RegisterActiveTextures(); // TODO: this will eventually be automatically managed by some
-                            // material system (maybe even tracks what's currently in the
-                            // scene)
+  // Bindless descriptors only get written for indices that changed, but material
+  // constants are pushed every frame
+  PushMaterialConstants(); // TODO: this will eventually be automatically managed by some
+                           // material system (maybe even tracks what's currently in the
+                           // scene)
 
   // Update scene and view
   {
@@ -628,6 +669,7 @@ extern "C" GAME_WINDOW_RESIZE(GameWindowResize)
       PerspectiveProjectionMatrix((float)currentWindowWidth / currentWindowHeight);
 
     CreateGameRenderingResources(newWindowWidth, newWindowHeight);
+    RebindWindowResizeDependentTextures();
     WriteToneMappingResources();
     WriteSwapChainCopyResources();
   }
@@ -663,5 +705,12 @@ extern "C" GAME_DESTROY(GameDestroy)
     Tk::Graphics::DestroySwapChain(g_windowHandles);
     Tk::Graphics::DestroyContext();
     Tk::Core::CoreFreeAligned(g_graphicsCommandStream.m_graphicsCommands);
+    // Unregister before freeing, stats can be read from another thread
+    for (uint32 uiFrame = 0; uiFrame < MAX_FRAMES_IN_FLIGHT; ++uiFrame)
+    {
+      Tk::Core::Utility::UnregisterAllocator(&g_FrameArena.m_arenas[uiFrame]);
+      g_FrameArena.m_arenas[uiFrame].m_isRegistered = false;
+    }
+    g_FrameArena.ExplicitFree();
   }
 }
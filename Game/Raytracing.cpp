@@ -1,9 +1,11 @@
 #include "Raytracing.h"
+#include "Allocators.h"
 #include "AssetFileParsing.h"
 #include "AssetManager.h"
 #include "Camera.h"
 #include "GraphicsTypes.h"
 #include "Mem.h"
+#include "Platform/ParallelFor.h"
 #include "Platform/PlatformGameAPI.h"
 #include "Utility/ScopedTimer.h"
 #include <string.h>
@@ -32,9 +34,13 @@ void RaytraceTest()
 {
   TIMED_SCOPED_BLOCK("Raytrace test");
 
+  // Triangle and image buffers only live for this test
+  Tk::Core::ChainedLinearAllocator& scratch = Tk::Core::GetThreadScratch();
+  Tk::Core::ScopedThreadScratch scratchScope(scratch);
+
   const MeshAttributeData& data = g_AssetManager.GetMeshAttrDataByID(2);
   uint32 numVerts = data.m_numVertices;
-  v3f* triData = (v3f*)Tk::Core::CoreMalloc(numVerts * sizeof(v3f));
+  v3f* triData = (v3f*)scratch.Alloc(numVerts * sizeof(v3f), alignof(v3f));
   for (uint32 i = 0; i < numVerts; ++i)
   {
     const v4f& ptVec4 = ((v4f*)data.m_vertexBufferData_Pos)[i];
@@ -43,7 +49,7 @@ void RaytraceTest()
 
   const uint32 width = 256;
   const uint32 height = 256;
-  uint32* img = (uint32*)Tk::Core::CoreMalloc(sizeof(uint32) * width * height);
+  uint32* img = (uint32*)scratch.Alloc(sizeof(uint32) * width * height, CACHE_LINE);
   memset(img, 0, width * height * sizeof(uint32));
 
   v3f camEye = v3f(27, 27, 27);
@@ -51,95 +57,98 @@ void RaytraceTest()
   float aspect = (float)width / height;
   float tanFov = tanf(fovy * 0.5f);
 
-  for (uint32 px = 0; px < width; ++px)
-  {
-    for (uint32 py = 0; py < height; ++py)
+  // Columns are independent, each one writes its own pixels
+  Tk::Platform::ParallelFor(
+    0, width, 1,
+    [&](uint32 px)
     {
-      v3f rayOrigin = v3f();
-      v3f rayDir = v3f();
-
-      // Cast ray from camera
-      // TODO: move this
+      for (uint32 py = 0; py < height; ++py)
       {
-        v4f coord = v4f((float)px, (float)py, 1.0, 1.0);
-        coord.x /= width;
-        coord.y /= height;
-
-        // shift by half a pixel
-        coord.x += 0.5f / width;
-        coord.y += 0.5f / height;
-        coord.x = coord.x * 2 - 1;
-        coord.y = coord.y * 2 - 1;
-
-        rayOrigin = camEye;
-        v3f look = camRef - camEye;
-        float len = Length(look);
-        Normalize(look);
-        v3f right = Cross(look, v3f(0, 0, 1));
-        Normalize(right);
-        v3f up = Cross(right, look);
-        Normalize(up);
-
-        v3f H = right * len * tanFov * aspect;
-        v3f V = up * len * tanFov;
-
-        v3f screenPt = camRef + H * coord.x + V * coord.y;
-        rayDir = screenPt - camEye;
-        Normalize(rayDir);
-      }
+        v3f rayOrigin = v3f();
+        v3f rayDir = v3f();
 
-      Tk::Core::Raytracing::Ray ray;
-      ray.origin = rayOrigin;
-      ray.dir = rayDir;
+        // Cast ray from camera
+        // TODO: move this
+        {
+          v4f coord = v4f((float)px, (float)py, 1.0, 1.0);
+          coord.x /= width;
+          coord.y /= height;
+
+          // shift by half a pixel
+          coord.x += 0.5f / width;
+          coord.y += 0.5f / height;
+          coord.x = coord.x * 2 - 1;
+          coord.y = coord.y * 2 - 1;
+
+          rayOrigin = camEye;
+          v3f look = camRef - camEye;
+          float len = Length(look);
+          Normalize(look);
+          v3f right = Cross(look, v3f(0, 0, 1));
+          Normalize(right);
+          v3f up = Cross(right, look);
+          Normalize(up);
+
+          v3f H = right * len * tanFov * aspect;
+          v3f V = up * len * tanFov;
+
+          v3f screenPt = camRef + H * coord.x + V * coord.y;
+          rayDir = screenPt - camEye;
+          Normalize(rayDir);
+        }
 
-      uint8 channel[4] = {};
-      channel[3] = 255;
+        Tk::Core::Raytracing::Ray ray;
+        ray.origin = rayOrigin;
+        ray.dir = rayDir;
 
-      Tk::Core::Raytracing::Intersection isx;
-      isx.InitInvalid();
-      RayMeshIntersectNaive(ray, triData, numVerts / 3, isx);
+        uint8 channel[4] = {};
+        channel[3] = 255;
 
-      if (isx.t > 0.0f)
-      {
-        v3f* meshNormals =
-          (v3f*)data.m_vertexBufferData_Normal; // skip pos and uvs in buffer
-        v3f interpNormal = meshNormals[isx.hitTri * 3] * isx.bary[0]
-                           + meshNormals[isx.hitTri * 3 + 1] * isx.bary[1]
-                           + meshNormals[isx.hitTri * 3 + 2] * isx.bary[2];
-        Normalize(interpNormal);
-
-        v3f lightDir = v3f(-1, -1, 1);
-        Normalize(lightDir);
-        float lambert = Dot(interpNormal, lightDir);
-        lambert *= 0.7f;
-        lambert = Max(0.05f, lambert);
-        // Linear to SRGB
-        if (lambert > 0.0031308f)
+        Tk::Core::Raytracing::Intersection isx;
+        isx.InitInvalid();
+        RayMeshIntersectNaive(ray, triData, numVerts / 3, isx);
+
+        if (isx.t > 0.0f)
         {
-          lambert = 1.055f * (powf(lambert, 1.0f / 2.4f)) - 0.055f;
+          v3f* meshNormals =
+            (v3f*)data.m_vertexBufferData_Normal; // skip pos and uvs in buffer
+          v3f interpNormal = meshNormals[isx.hitTri * 3] * isx.bary[0]
+                             + meshNormals[isx.hitTri * 3 + 1] * isx.bary[1]
+                             + meshNormals[isx.hitTri * 3 + 2] * isx.bary[2];
+          Normalize(interpNormal);
+
+          v3f lightDir = v3f(-1, -1, 1);
+          Normalize(lightDir);
+          float lambert = Dot(interpNormal, lightDir);
+          lambert *= 0.7f;
+          lambert = Max(0.05f, lambert);
+          // Linear to SRGB
+          if (lambert > 0.0031308f)
+          {
+            lambert = 1.055f * (powf(lambert, 1.0f / 2.4f)) - 0.055f;
+          }
+          else
+          {
+            lambert = 12.92f * lambert;
+          }
+
+          uint8 asUnorm = (uint8)(lambert * 255);
+          channel[0] = asUnorm;
+          channel[1] = asUnorm;
+          channel[2] = asUnorm;
+
+          // BGRA
+          img[py * width + px] = (uint32)(channel[2]
+                                          | (channel[1] << 8)
+                                          | (channel[0] << 16)
+                                          | (channel[3] << 24));
         }
         else
         {
-          lambert = 12.92f * lambert;
+          // No intersection
         }
-
-        uint8 asUnorm = (uint8)(lambert * 255);
-        channel[0] = asUnorm;
-        channel[1] = asUnorm;
-        channel[2] = asUnorm;
-
-        // BGRA
-        img[py * width + px] = (uint32)(channel[2]
-                                        | (channel[1] << 8)
-                                        | (channel[0] << 16)
-                                        | (channel[3] << 24));
-      }
-      else
-      {
-        // No intersection
       }
-    }
-  }
+    });
 
   // Output image
   Buffer imgBuffer = {};
@@ -153,7 +162,4 @@ void RaytraceTest()
                               Tk::Core::Utility::LogSeverity::eWarning);
   }
   imgBuffer.Dealloc();
-  Tk::Core::CoreFree(img);
-
-  Tk::Core::CoreFree(triData);
 }
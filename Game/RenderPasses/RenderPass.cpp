@@ -40,7 +40,9 @@ void RecordRenderPassCommands(GameRenderPass* renderPass, View* view, Scene* sce
 
   if (scene->m_numInstances > 0)
   {
-    uint32 currentAssetID = scene->m_instances_sorted[0].m_assetID;
+    const Tk::Core::SoAColumn<uint32> assetIDs =
+      scene->m_instances_sorted.Column<Scene::eSortedAssetID>();
+    uint32 currentAssetID = assetIDs[0];
     uint32 currentNumInstances = 1;
     uint32 uiInstance = 1;
     while (uiInstance <= scene->m_numInstances)
@@ -50,7 +52,7 @@ void RecordRenderPassCommands(GameRenderPass* renderPass, View* view, Scene* sce
       uint32 nextAssetID = TINKER_INVALID_HANDLE;
       if (!finalDrawCall)
       {
-        nextAssetID = scene->m_instances_sorted[uiInstance].m_assetID;
+        nextAssetID = assetIDs[uiInstance];
       }
       if (finalDrawCall || nextAssetID != currentAssetID)
       {
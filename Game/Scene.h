@@ -1,35 +1,47 @@
 #pragma once
 
+#include "DataStructures/HandlePool.h"
+#include "DataStructures/SoAVector.h"
 #include "DataStructures/Vector.h"
 #include "Generated/ShaderDescriptors_Reflection.h"
 #include "Graphics/Common/GraphicsCommon.h"
 #include "GraphicsTypes.h"
+#include "Sorting.h"
 
 struct InputManager;
 
 struct Instance
 {
-  enum
-  {
-    eIsActive = 0x1,
-  };
-
   uint32 m_handleToSelf;
   uint32 m_assetID;
-  uint32 m_flags;
+};
+
+struct SceneInstance
+{
+  Instance m_instance;
+  ShaderDescriptors::InstanceData_Basic m_data;
 };
 
 struct Scene
 {
-  Tk::Core::Vector<Instance> m_instances;
-  Tk::Core::Vector<ShaderDescriptors::InstanceData_Basic> m_instanceData;
+  // Live instances are packed densely, instance IDs are HandlePool handles
+  Tk::Core::HandlePool<SceneInstance> m_instances;
 
-  // Sorted copies of instance data
-  Tk::Core::Vector<Instance> m_instances_sorted;
-  Tk::Core::Vector<ShaderDescriptors::InstanceData_Basic> m_instanceData_sorted;
+  // Sorted copies of instance data, one column per field so that batching only reads
+  // asset IDs and the upload is a single copy of the instance data column
+  enum : uint32
+  {
+    eSortedHandle,
+    eSortedAssetID,
+    eSortedInstanceData,
+  };
+  Tk::Core::SoAVector<uint32, uint32, ShaderDescriptors::InstanceData_Basic>
+    m_instances_sorted;
+  // Asset ID and handle of each instance, and scratch space for sorting them
+  Tk::Core::Vector<Tk::Core::RadixSortPair32> m_sortPairs;
+  Tk::Core::Vector<Tk::Core::RadixSortPair32> m_sortScratch;
   uint32 m_firstInstanceDataByteOffset = 0;
 
-  uint32 m_maxInstances;
   uint32 m_numInstances;
   uint8 m_instanceListDirty;
 };
@@ -62,9 +62,7 @@ namespace Tk
                               Core::Utility::LogSeverity::eCritical);
       }
 
-      SwapChainDataMap.Reserve(
-        NUM_SWAP_CHAINS_STARTING_ALLOC_SIZE); // TODO the hash map data structure needs
-                                              // resize still so...
+      SwapChainDataMap.Reserve(NUM_SWAP_CHAINS_STARTING_ALLOC_SIZE);
     }
 
     void DestroyContext()
@@ -787,9 +787,11 @@ namespace Tk
             const DescriptorSetDataHandles* descSetDataHandles)
     WRITE_DESCRIPTOR_SIMPLE(WriteDescriptorSimple);
 
+// Writes entries[i] to array element arrayIndices[i], or to element i if arrayIndices is
+// nullptr
 #define WRITE_DESCRIPTOR_ARRAY(name)                                                     \
   void name(DescriptorHandle descSetHandle, uint32 numEntries, ResourceHandle* entries,  \
-            uint32 updateFlags)
+            const uint32* arrayIndices, uint32 updateFlags)
     WRITE_DESCRIPTOR_ARRAY(WriteDescriptorArray);
 
 #define SUBMIT_CMDS_IMMEDIATE(name)                                                      \
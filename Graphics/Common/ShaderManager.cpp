@@ -2,11 +2,13 @@
 #include "Allocators.h"
 #include "Graphics/Common/GraphicsCommon.h"
 #include "Platform/PlatformGameAPI.h"
+#include "Utility/AllocatorRegistry.h"
 
 #ifdef _SHADERS_SPV_DIR
   #define SHADERS_SPV_PATH STRINGIFY(_SHADERS_SPV_DIR)
 #endif
 
+// Reserved up front, committed as shaders get loaded
 static const uint32 totalShaderBytecodeMaxSizeInBytes = 1024 * 1024 * 100;
 static Tk::Core::LinearAllocator g_ShaderBytecodeAllocator;
 
@@ -93,11 +95,15 @@ namespace Tk
 
       void Startup()
       {
-        g_ShaderBytecodeAllocator.Init(totalShaderBytecodeMaxSizeInBytes, 1);
+        g_ShaderBytecodeAllocator.InitReserved(totalShaderBytecodeMaxSizeInBytes,
+                                               Platform::VirtualMemFlags::eNone);
+        Core::Utility::RegisterAllocator(g_ShaderBytecodeAllocator, "Shader bytecode");
       }
 
       void Shutdown()
       {
+        Core::Utility::UnregisterAllocator(&g_ShaderBytecodeAllocator);
+        g_ShaderBytecodeAllocator.m_isRegistered = false;
         g_ShaderBytecodeAllocator.ExplicitFree();
       }
 
@@ -110,7 +116,8 @@ namespace Tk
       void LoadAllShaders()
       {
         g_ShaderBytecodeAllocator.ExplicitFree();
-        g_ShaderBytecodeAllocator.Init(totalShaderBytecodeMaxSizeInBytes, 1);
+        g_ShaderBytecodeAllocator.InitReserved(totalShaderBytecodeMaxSizeInBytes,
+                                               Platform::VirtualMemFlags::eNone);
 
         bool bOk = false;
 
@@ -2,6 +2,7 @@
 #include "DataStructures/Vector.h"
 #include "Graphics/Vulkan/VulkanCreation.h"
 #include "Graphics/Vulkan/VulkanTypes.h"
+#include "Utility/AllocatorRegistry.h"
 #include "Utility/Logging.h"
 
 // TODO: move this to be a compile define or ini config entry
@@ -43,6 +44,28 @@ namespace Tk
     }
 #endif
 
+    static Core::Utility::AllocatorStats GetGPUMemAllocatorStats(const void* allocator)
+    {
+      const VulkanMemoryAllocator& gpuAllocator =
+        *(const VulkanMemoryAllocator*)allocator;
+      Core::Utility::AllocatorStats stats = {};
+      stats.m_capacity = gpuAllocator.m_AllocSizeLimit;
+      // The whole heap is allocated from the device up front
+      stats.m_committed = gpuAllocator.m_AllocSizeLimit;
+      stats.m_used = gpuAllocator.m_LastAllocOffset;
+      stats.m_highWaterMark = gpuAllocator.m_LastAllocOffset; // never frees
+      stats.m_numAllocs = gpuAllocator.m_NumAllocs;
+      return stats;
+    }
+
+    static const char* GPUMemAllocatorNames[] = {
+      "Vulkan device local buffers",
+      "Vulkan device local images",
+      "Vulkan host visible buffers",
+    };
+    static_assert(ARRAYCOUNT(GPUMemAllocatorNames)
+                  == (size_t)VulkanContextResources::eVulkanMemoryAllocatorMax);
+
     // This code exists so that we can preallocate proper VkDeviceMemory's before creating
     // any buffers for faster GPU memory allocation
     static void InitGPUMemAllocators()
@@ -166,12 +189,19 @@ namespace Tk
     {
       g_vulkanContextResources.DataAllocator.Init(VULKAN_SCRATCH_MEM_SIZE, 16);
 
-      g_vulkanContextResources.vulkanMemResourcePool.Init(VULKAN_RESOURCE_POOL_MAX, 16);
+      g_vulkanContextResources.vulkanMemResourcePool.Init(VULKAN_RESOURCE_POOL_MAX);
       g_vulkanContextResources.vulkanDescriptorResourcePool.Init(VULKAN_RESOURCE_POOL_MAX,
                                                                  16);
       g_vulkanContextResources.vulkanSwapChainDataPool.Init(
         NUM_SWAP_CHAINS_STARTING_ALLOC_SIZE, 16);
 
+      Core::Utility::RegisterAllocator(g_vulkanContextResources.DataAllocator,
+                                       "Vulkan scratch");
+      Core::Utility::RegisterAllocator(
+        g_vulkanContextResources.vulkanDescriptorResourcePool, "Vulkan descriptors");
+      Core::Utility::RegisterAllocator(g_vulkanContextResources.vulkanSwapChainDataPool,
+                                       "Vulkan swap chains");
+
       // Init shader pso permutations
       for (uint32 sid = 0; sid < VulkanContextResources::eMaxShaders; ++sid)
       {
@@ -746,6 +776,13 @@ namespace Tk
       InitVulkanDataTypesPerEnum();
 
       InitGPUMemAllocators();
+      for (uint32 uiAlloc = 0;
+           uiAlloc < ARRAYCOUNT(g_vulkanContextResources.GPUMemAllocators); ++uiAlloc)
+      {
+        Core::Utility::RegisterAllocator(
+          &g_vulkanContextResources.GPUMemAllocators[uiAlloc],
+          GPUMemAllocatorNames[uiAlloc], GetGPUMemAllocatorStats);
+      }
 
       g_vulkanContextResources.isInitted = true;
       return 0;
@@ -775,6 +812,8 @@ namespace Tk
       for (uint32 uiAlloc = 0;
            uiAlloc < ARRAYCOUNT(g_vulkanContextResources.GPUMemAllocators); ++uiAlloc)
       {
+        Core::Utility::UnregisterAllocator(
+          &g_vulkanContextResources.GPUMemAllocators[uiAlloc]);
         g_vulkanContextResources.GPUMemAllocators[uiAlloc].Destroy();
       }
 
@@ -800,6 +839,14 @@ namespace Tk
       vkDestroyDevice(g_vulkanContextResources.device, nullptr);
       vkDestroyInstance(g_vulkanContextResources.instance, nullptr);
 
+      // Unregister before freeing, stats can be read from another thread
+      Core::Utility::UnregisterAllocator(
+        &g_vulkanContextResources.vulkanDescriptorResourcePool);
+      g_vulkanContextResources.vulkanDescriptorResourcePool.m_isRegistered = false;
+      Core::Utility::UnregisterAllocator(
+        &g_vulkanContextResources.vulkanSwapChainDataPool);
+      g_vulkanContextResources.vulkanSwapChainDataPool.m_isRegistered = false;
+
       g_vulkanContextResources.vulkanMemResourcePool.ExplicitFree();
       g_vulkanContextResources.vulkanDescriptorResourcePool.ExplicitFree();
       g_vulkanContextResources.vulkanSwapChainDataPool.ExplicitFree();
@@ -260,9 +260,9 @@ namespace Tk
         for (uint32 uiDesc = 0; uiDesc < MAX_BINDINGS_PER_SET; ++uiDesc)
         {
           descBufferInfo[uiDesc].Clear();
-          descBufferInfo[uiDesc].Resize(DESCRIPTOR_BINDLESS_ARRAY_LIMIT);
+          descBufferInfo[uiDesc].Resize(numEntries);
           descImageInfo[uiDesc].Clear();
-          descImageInfo[uiDesc].Resize(DESCRIPTOR_BINDLESS_ARRAY_LIMIT);
+          descImageInfo[uiDesc].Resize(numEntries);
         }
 
         for (uint32 uiDesc = 0; uiDesc < MAX_BINDINGS_PER_SET; ++uiDesc)
@@ -273,6 +273,8 @@ namespace Tk
 
           for (uint32 uiEntry = 0; uiEntry < numEntries; ++uiEntry)
           {
+            const uint32 arrayElement = arrayIndices ? arrayIndices[uiEntry] : uiEntry;
+            TINKER_ASSERT(arrayElement < DESCRIPTOR_BINDLESS_ARRAY_LIMIT);
             const uint32 type = descLayout->params[uiDesc].type;
             if (type != DescriptorType::eMax)
             {
@@ -298,7 +300,7 @@ namespace Tk
 
                   descSetWrite.dstSet = *descriptorSet;
                   descSetWrite.dstBinding = uiDesc;
-                  descSetWrite.dstArrayElement = uiEntry;
+                  descSetWrite.dstArrayElement = arrayElement;
                   descSetWrite.descriptorType = GetVkDescriptorType(type);
                   descSetWrite.descriptorCount = 1;
                   descSetWrite.pImageInfo = &descImageInfo[uiDesc][uiEntry];
@@ -316,7 +318,7 @@ namespace Tk
 
                   descSetWrite.dstSet = *descriptorSet;
                   descSetWrite.dstBinding = uiDesc;
-                  descSetWrite.dstArrayElement = uiEntry;
+                  descSetWrite.dstArrayElement = arrayElement;
                   descSetWrite.descriptorType = GetVkDescriptorType(type);
                   descSetWrite.descriptorCount = 1;
                   descSetWrite.pImageInfo = &descImageInfo[uiDesc][uiEntry];
@@ -300,7 +300,7 @@ namespace Tk
       // Register swap chain images in the resource pool manually
       for (uint32 i = 0; i < DESIRED_NUM_SWAP_CHAIN_IMAGES; ++i)
       {
-        uint32 newResourceHandle = g_vulkanContextResources.vulkanMemResourcePool.Alloc();
+        uint32 newResourceHandle = g_vulkanContextResources.vulkanMemResourcePool.Create();
         TINKER_ASSERT(newResourceHandle != TINKER_INVALID_HANDLE);
         VulkanMemResourceChain* newResourceChain =
           g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(newResourceHandle);
@@ -376,7 +376,7 @@ namespace Tk
 
       for (uint32 i = 0; i < DESIRED_NUM_SWAP_CHAIN_IMAGES; ++i)
       {
-        g_vulkanContextResources.vulkanMemResourcePool.Dealloc(
+        g_vulkanContextResources.vulkanMemResourcePool.Destroy(
           swapChainData->swapChainResourceHandles[i].m_hRes);
       }
 
@@ -790,7 +790,7 @@ namespace Tk
     static ResourceHandle CreateBufferResource(uint32 sizeInBytes, uint32 bufferUsage,
                                                const char* debugLabel)
     {
-      uint32 newResourceHandle = g_vulkanContextResources.vulkanMemResourcePool.Alloc();
+      uint32 newResourceHandle = g_vulkanContextResources.vulkanMemResourcePool.Create();
       TINKER_ASSERT(newResourceHandle != TINKER_INVALID_HANDLE);
       VulkanMemResourceChain* newResourceChain =
         g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(newResourceHandle);
@@ -864,7 +864,7 @@ namespace Tk
                                               uint32 width, uint32 height,
                                               uint32 numArrayEles, const char* debugLabel)
     {
-      uint32 newResourceHandle = g_vulkanContextResources.vulkanMemResourcePool.Alloc();
+      uint32 newResourceHandle = g_vulkanContextResources.vulkanMemResourcePool.Create();
       TINKER_ASSERT(newResourceHandle != TINKER_INVALID_HANDLE);
       TINKER_ASSERT(imageUsageFlags);
       VulkanMemResourceChain* newResourceChain =
@@ -1023,7 +1023,7 @@ namespace Tk
           }
         }
       }
-      g_vulkanContextResources.vulkanMemResourcePool.Dealloc(handle.m_hRes);
+      g_vulkanContextResources.vulkanMemResourcePool.Destroy(handle.m_hRes);
     }
 
     void CreateSamplers()
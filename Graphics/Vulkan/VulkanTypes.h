@@ -2,6 +2,7 @@
 
 #include "Allocators.h"
 #include "CoreDefines.h"
+#include "DataStructures/HandlePool.h"
 #include "Graphics/Common/GraphicsCommon.h"
 
 #ifdef _WIN32
@@ -134,7 +135,7 @@ namespace Tk
 
       VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
       VkSampler linearSampler = VK_NULL_HANDLE;
-      Tk::Core::PoolAllocator<VulkanMemResourceChain> vulkanMemResourcePool;
+      Tk::Core::HandlePool<VulkanMemResourceChain> vulkanMemResourcePool;
       Tk::Core::PoolAllocator<VulkanDescriptorChain> vulkanDescriptorResourcePool;
       VkCommandPool commandPool = VK_NULL_HANDLE;
 
@@ -36,6 +36,7 @@ set "EnableUnityBuild=0"
 
 :: Features
 :: set "EnableMemTracking=1"
+:: set "EnableTLSFCoreHeap=1"
 
 pushd ..
 if NOT EXIST .\Build mkdir .\Build
@@ -102,6 +103,9 @@ set CompileDefines=%CompileDefines% /DTINKER_EXPORTING
 if "%EnableMemTracking%" == "1" (
     set CompileDefines=%CompileDefines% /DENABLE_MEM_TRACKING 
 )
+if "%EnableTLSFCoreHeap%" == "1" (
+    set CompileDefines=%CompileDefines% /DTINKER_CORE_HEAP_TLSF 
+)
 set CompileDefines=%CompileDefines% /D_ENGINE_ROOT_PATH=%AbsolutePathPrefix% 
 set CompileDefines=%CompileDefines% /D_GAME_DLL_PATH=TinkerGame.dll 
 set CompileDefines=%CompileDefines% /D_GAME_DLL_HOTLOADCOPY_PATH=TinkerGame_hotload.dll 
@@ -116,7 +120,7 @@ if "%BuildConfig%" == "Debug" (
     set CompileDefines=%CompileDefines%
     )
 
-set LibsToLink=user32.lib ws2_32.lib Shlwapi.lib 
+set LibsToLink=user32.lib ws2_32.lib Shlwapi.lib Synchronization.lib 
 if "%EnableMemTracking%" == "1" (
     set LibsToLink=%LibsToLink% dbghelp.lib 
 )
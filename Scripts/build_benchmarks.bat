@@ -35,13 +35,39 @@ rem ****************************************************************************
 rem TinkerBenchmark - benchmarking
 set SourceListBenchmark=../Benchmark/BenchmarkMain.cpp 
 set SourceListBenchmark=%SourceListBenchmark% ../Core/Platform/Win32PlatformGameAPI.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/Platform/Win32File.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/Platform/WorkerThreadPool.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/Utility/JobProfiler.cpp 
 set SourceListBenchmark=%SourceListBenchmark% ../Core/Platform/Win32WorkerThreadPool.cpp 
 set SourceListBenchmark=%SourceListBenchmark% ../Core/Platform/Win32Logging.cpp 
 set SourceListBenchmark=%SourceListBenchmark% ../Core/Mem.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/Hashing.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/Sorting.cpp 
 set SourceListBenchmark=%SourceListBenchmark% ../Core/Utility/MemTracker.cpp 
 set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/MathBenchmarks/VectorTypeBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/AlgorithmBenchmarks/HashingBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/AlgorithmBenchmarks/SortingBenchmarks.cpp 
 set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/DataStructureBenchmarks/HashMapBenchmarks.cpp 
 set SourceListBenchmark=%SourceListBenchmark% ../Core/DataStructures/HashMap.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/DataStructureBenchmarks/ConcurrentHashMapBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/DataStructures/ConcurrentHashMap.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/DataStructureBenchmarks/MPMCQueueBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/DataStructureBenchmarks/VectorBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/DataStructures/Vector.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/DataStructureBenchmarks/HandlePoolBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/DataStructures/HandlePool.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/DataStructureBenchmarks/SoAVectorBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/DataStructures/SoAVector.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/DataStructureBenchmarks/BindlessSlotBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/MemoryBenchmarks/PoolAllocatorBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/MemoryBenchmarks/TLSFHeapBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/Allocators.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/TLSFHeap.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Core/Utility/AllocatorRegistry.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/JobSystemBenchmarks/JobAllocationBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/JobSystemBenchmarks/JobPriorityBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/JobSystemBenchmarks/JobSchedulerBenchmarks.cpp 
+set SourceListBenchmark=%SourceListBenchmark% ../Benchmark/JobSystemBenchmarks/ParallelForBenchmarks.cpp 
 set CompileDefines=/DENABLE_MEM_TRACKING 
 
 if "%BuildConfig%" == "Debug" (
@@ -54,7 +80,8 @@ if "%BuildConfig%" == "Debug" (
     set CompileDefines=%CompileDefines%/DASSERTS_ENABLE=0
     )
 
-set CompileIncludePaths=/I ../Core 
+set CompileIncludePaths=/I ../ 
+set CompileIncludePaths=%CompileIncludePaths% /I ../Core 
 
 set OBJDir=%cd%\obj_benchmark\
 if NOT EXIST %OBJDir% mkdir %OBJDir%
@@ -62,7 +89,7 @@ set CommonCompileFlags=%CommonCompileFlags% /Fo:%OBJDir%
 
 echo.
 echo Building TinkerBenchmark.exe...
-cl %CommonCompileFlags% %CompileIncludePaths% %CompileDefines% %DebugCompileFlagsBenchmark% %SourceListBenchmark% /link %CommonLinkFlags% Winmm.lib %DebugLinkFlagsBenchmark% /out:TinkerBenchmark.exe
+cl %CommonCompileFlags% %CompileIncludePaths% %CompileDefines% %DebugCompileFlagsBenchmark% %SourceListBenchmark% /link %CommonLinkFlags% Winmm.lib Shlwapi.lib dbghelp.lib Synchronization.lib %DebugLinkFlagsBenchmark% /out:TinkerBenchmark.exe
 
 :DoneBuild
 popd
@@ -0,0 +1,98 @@
+#!/usr/bin/env bash
+
+buildConfig=$1
+if [ "$buildConfig" != "Debug" ] && [ "$buildConfig" != "Release" ]; then
+    echo Invalid build config specified.
+    exit 1
+fi
+
+echo ""
+echo "***** Building Tinker Benchmarks *****"
+
+# CXX picks the compiler, SANITIZE=address,undefined or SANITIZE=thread builds with sanitizers
+compiler=${CXX:-g++}
+commonCompileFlags="-std=c++20 -msse4.2 -g -fno-rtti -ffast-math -pthread -Wall -Werror"
+commonCompileFlags="$commonCompileFlags -Wno-unused-variable -Wno-unused-but-set-variable"
+commonCompileFlags="$commonCompileFlags -Wno-maybe-uninitialized"
+commonLinkFlags="-pthread -rdynamic -ldl"
+
+if [ "$buildConfig" == "Debug" ]; then
+    echo Debug mode specified.
+    commonCompileFlags="$commonCompileFlags -O0"
+else
+    echo Release mode specified.
+    commonCompileFlags="$commonCompileFlags -O2"
+fi
+
+if [ -n "$SANITIZE" ]; then
+    echo "Sanitizers: $SANITIZE"
+    commonCompileFlags="$commonCompileFlags -fsanitize=$SANITIZE -fno-omit-frame-pointer"
+    commonLinkFlags="$commonLinkFlags -fsanitize=$SANITIZE"
+    if [[ "$SANITIZE" == *thread* ]] && [[ "$compiler" == *g++* ]]; then
+        # gcc warns that TSan can't see std::atomic_thread_fence
+        commonCompileFlags="$commonCompileFlags -Wno-tsan"
+    fi
+fi
+
+buildDir="../Build"
+objDir="$buildDir/obj_benchmark"
+mkdir -p $buildDir
+mkdir -p $objDir
+pushd $buildDir > /dev/null
+
+compileIncludePaths="-I ../ -I ../Core"
+compileDefines="-DENABLE_MEM_TRACKING"
+if [ "$buildConfig" == "Debug" ]; then
+    compileDefines="$compileDefines -DASSERTS_ENABLE=1"
+else
+    compileDefines="$compileDefines -DASSERTS_ENABLE=0"
+fi
+
+sourceListBenchmark="../Benchmark/BenchmarkMain.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Platform/LinuxPlatformGameAPI.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Platform/LinuxFile.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Platform/WorkerThreadPool.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Utility/JobProfiler.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Platform/LinuxWorkerThreadPool.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Platform/LinuxLogging.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Mem.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Hashing.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Sorting.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Utility/MemTracker.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/MathBenchmarks/VectorTypeBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/AlgorithmBenchmarks/HashingBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/AlgorithmBenchmarks/SortingBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/DataStructureBenchmarks/HashMapBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/DataStructures/HashMap.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/DataStructureBenchmarks/ConcurrentHashMapBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/DataStructures/ConcurrentHashMap.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/DataStructureBenchmarks/MPMCQueueBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/DataStructureBenchmarks/VectorBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/DataStructures/Vector.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/DataStructureBenchmarks/HandlePoolBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/DataStructures/HandlePool.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/DataStructureBenchmarks/SoAVectorBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/DataStructures/SoAVector.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/DataStructureBenchmarks/BindlessSlotBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/MemoryBenchmarks/PoolAllocatorBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/MemoryBenchmarks/TLSFHeapBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Allocators.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/TLSFHeap.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Core/Utility/AllocatorRegistry.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/JobSystemBenchmarks/JobAllocationBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/JobSystemBenchmarks/JobPriorityBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/JobSystemBenchmarks/JobSchedulerBenchmarks.cpp"
+sourceListBenchmark="$sourceListBenchmark ../Benchmark/JobSystemBenchmarks/ParallelForBenchmarks.cpp"
+
+echo ""
+echo Building TinkerBenchmark...
+objList=""
+for src in $sourceListBenchmark; do
+    obj="$objDir/$(basename ${src%.cpp}).o"
+    $compiler $commonCompileFlags $compileIncludePaths $compileDefines -c $src -o $obj || exit 1
+    objList="$objList $obj"
+done
+$compiler -o TinkerBenchmark $objList $commonLinkFlags || exit 1
+echo Done.
+
+popd > /dev/null
@@ -65,6 +65,7 @@ set "EnableUnityBuild=0"
 
 :: Features
 :: set "EnableMemTracking=1"
+:: set "EnableTLSFCoreHeap=1"
 
 :: *********************************************************************************************************
 set CommonCompileFlags=/nologo /std:c++20 /W4 /WX /wd4127 /wd4530 /wd4201 /wd4324 /wd4100 /wd4189 /EHa- /GR- /Gm- /GS- /fp:fast /Zi /FS
@@ -133,6 +134,9 @@ set CompileDefines=%CompileDefines% /DASSERTS_ENABLE=1
 if "%EnableMemTracking%" == "1" (
     set CompileDefines=%CompileDefines% /DENABLE_MEM_TRACKING 
 )
+if "%EnableTLSFCoreHeap%" == "1" (
+    set CompileDefines=%CompileDefines% /DTINKER_CORE_HEAP_TLSF 
+)
 set CompileDefines=%CompileDefines% /D_ASSETS_DIR=..\\Assets\\ 
 set CompileDefines=%CompileDefines% /D_COOKED_ASSETS_DIR=..\\CookedAssets\\ 
 set CompileDefines=%CompileDefines% /D_SHADERS_SPV_DIR=..\\Shaders\\spv\\ 
@@ -58,6 +58,9 @@ set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Tools/ShaderCompiler/Mai
 set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Tools/ShaderCompiler/ShaderCompiler.cpp 
 set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Core/DataStructures/Vector.cpp 
 set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Core/Mem.cpp 
+set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Core/Allocators.cpp 
+set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Core/TLSFHeap.cpp 
+set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Core/Utility/AllocatorRegistry.cpp 
 set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Core/Platform/Win32File.cpp 
 set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Core/Platform/Win32Logging.cpp 
 set SourceListSC=%SourceListSC% %AbsolutePathPrefix%/../Core/Platform/Win32PlatformGameAPI.cpp 
@@ -31,16 +31,31 @@ if "%BuildConfig%" == "Debug" (
     set CommonCompileFlags=%CommonCompileFlags% /O2 /MT
     )
 
-set CompileIncludePaths=/I ../Core 
+set CompileIncludePaths=/I ../ 
+set CompileIncludePaths=%CompileIncludePaths% /I ../Core 
 
 rem *********************************************************************************************************
 rem TinkerTest - unit testing
 set SourceListTest=../Test/TestMain.cpp 
 set SourceListTest=%SourceListTest% ../Core/Platform/Win32PlatformGameAPI.cpp 
+set SourceListTest=%SourceListTest% ../Core/Platform/Win32File.cpp 
+set SourceListTest=%SourceListTest% ../Core/Platform/Win32Logging.cpp 
 set SourceListTest=%SourceListTest% ../Core/Utility/MemTracker.cpp 
 set SourceListTest=%SourceListTest% ../Core/DataStructures/Vector.cpp 
 set SourceListTest=%SourceListTest% ../Core/DataStructures/HashMap.cpp 
+set SourceListTest=%SourceListTest% ../Core/DataStructures/ConcurrentHashMap.cpp 
+set SourceListTest=%SourceListTest% ../Core/DataStructures/HandlePool.cpp 
+set SourceListTest=%SourceListTest% ../Core/DataStructures/SoAVector.cpp 
 set SourceListTest=%SourceListTest% ../Core/Mem.cpp 
+set SourceListTest=%SourceListTest% ../Core/Hashing.cpp 
+set SourceListTest=%SourceListTest% ../Core/Sorting.cpp 
+set SourceListTest=%SourceListTest% ../Core/StringTable.cpp 
+set SourceListTest=%SourceListTest% ../Core/Allocators.cpp 
+set SourceListTest=%SourceListTest% ../Core/TLSFHeap.cpp 
+set SourceListTest=%SourceListTest% ../Core/Utility/AllocatorRegistry.cpp 
+set SourceListTest=%SourceListTest% ../Core/Platform/WorkerThreadPool.cpp 
+set SourceListTest=%SourceListTest% ../Core/Utility/JobProfiler.cpp 
+set SourceListTest=%SourceListTest% ../Core/Platform/Win32WorkerThreadPool.cpp 
 set CompileDefines=/DENABLE_MEM_TRACKING 
 
 if "%BuildConfig%" == "Debug" (
@@ -61,7 +76,7 @@ set CommonCompileFlags=%CommonCompileFlags% /Fo:%OBJDir%
 
 echo.
 echo Building TinkerTest.exe...
-cl %CommonCompileFlags% %CompileIncludePaths% %CompileDefines% %DebugCompileFlagsTest% %SourceListTest% /link %CommonLinkFlags% %DebugLinkFlagsTest% /out:TinkerTest.exe
+cl %CommonCompileFlags% %CompileIncludePaths% %CompileDefines% %DebugCompileFlagsTest% %SourceListTest% /link %CommonLinkFlags% Shlwapi.lib dbghelp.lib Synchronization.lib %DebugLinkFlagsTest% /out:TinkerTest.exe
 
 :DoneBuild
 popd
@@ -0,0 +1,78 @@
+#!/usr/bin/env bash
+
+buildConfig=$1
+if [ "$buildConfig" != "Debug" ] && [ "$buildConfig" != "Release" ]; then
+    echo Invalid build config specified.
+    exit 1
+fi
+
+echo ""
+echo "***** Building Tinker Tests *****"
+
+# CXX picks the compiler, SANITIZE=address,undefined or SANITIZE=thread builds with sanitizers
+compiler=${CXX:-g++}
+commonCompileFlags="-std=c++20 -msse4.2 -g -fno-rtti -ffast-math -pthread -Wall -Werror"
+commonCompileFlags="$commonCompileFlags -Wno-unused-variable -Wno-unused-but-set-variable"
+commonCompileFlags="$commonCompileFlags -Wno-maybe-uninitialized"
+commonLinkFlags="-pthread -rdynamic -ldl"
+
+if [ "$buildConfig" == "Debug" ]; then
+    echo Debug mode specified.
+    commonCompileFlags="$commonCompileFlags -O0"
+else
+    echo Release mode specified.
+    commonCompileFlags="$commonCompileFlags -O2"
+fi
+
+if [ -n "$SANITIZE" ]; then
+    echo "Sanitizers: $SANITIZE"
+    commonCompileFlags="$commonCompileFlags -fsanitize=$SANITIZE -fno-omit-frame-pointer"
+    commonLinkFlags="$commonLinkFlags -fsanitize=$SANITIZE"
+    if [[ "$SANITIZE" == *thread* ]] && [[ "$compiler" == *g++* ]]; then
+        # gcc warns that TSan can't see std::atomic_thread_fence
+        commonCompileFlags="$commonCompileFlags -Wno-tsan"
+    fi
+fi
+
+buildDir="../Build"
+objDir="$buildDir/obj_test"
+mkdir -p $buildDir
+mkdir -p $objDir
+pushd $buildDir > /dev/null
+
+compileIncludePaths="-I ../ -I ../Core -I ../Test"
+compileDefines="-DENABLE_MEM_TRACKING -DASSERTS_ENABLE=1"
+
+sourceListTest="../Test/TestMain.cpp"
+sourceListTest="$sourceListTest ../Core/Platform/LinuxPlatformGameAPI.cpp"
+sourceListTest="$sourceListTest ../Core/Platform/LinuxFile.cpp"
+sourceListTest="$sourceListTest ../Core/Platform/LinuxLogging.cpp"
+sourceListTest="$sourceListTest ../Core/Utility/MemTracker.cpp"
+sourceListTest="$sourceListTest ../Core/DataStructures/Vector.cpp"
+sourceListTest="$sourceListTest ../Core/DataStructures/HashMap.cpp"
+sourceListTest="$sourceListTest ../Core/DataStructures/ConcurrentHashMap.cpp"
+sourceListTest="$sourceListTest ../Core/DataStructures/HandlePool.cpp"
+sourceListTest="$sourceListTest ../Core/DataStructures/SoAVector.cpp"
+sourceListTest="$sourceListTest ../Core/Mem.cpp"
+sourceListTest="$sourceListTest ../Core/Hashing.cpp"
+sourceListTest="$sourceListTest ../Core/Sorting.cpp"
+sourceListTest="$sourceListTest ../Core/StringTable.cpp"
+sourceListTest="$sourceListTest ../Core/Allocators.cpp"
+sourceListTest="$sourceListTest ../Core/TLSFHeap.cpp"
+sourceListTest="$sourceListTest ../Core/Utility/AllocatorRegistry.cpp"
+sourceListTest="$sourceListTest ../Core/Platform/WorkerThreadPool.cpp"
+sourceListTest="$sourceListTest ../Core/Utility/JobProfiler.cpp"
+sourceListTest="$sourceListTest ../Core/Platform/LinuxWorkerThreadPool.cpp"
+
+echo ""
+echo Building TinkerTest...
+objList=""
+for src in $sourceListTest; do
+    obj="$objDir/$(basename ${src%.cpp}).o"
+    $compiler $commonCompileFlags $compileIncludePaths $compileDefines -c $src -o $obj || exit 1
+    objList="$objList $obj"
+done
+$compiler -o TinkerTest $objList $commonLinkFlags || exit 1
+echo Done.
+
+popd > /dev/null
@@ -0,0 +1,127 @@
+#include "Hashing.h"
+#include "TinkerTest.h"
+#include <string.h>
+
+using namespace Tk;
+using namespace Core;
+
+// Pseudo-random bytes that are available at compile time
+struct HashingTestData
+{
+  char m_bytes[4096 + 1];
+};
+
+consteval HashingTestData MakeHashingTestData()
+{
+  HashingTestData data = {};
+  uint32 x = 0x12'34'56'78;
+  for (uint32 i = 0; i < 4096; ++i)
+  {
+    x = x * 1'664'525u + 1'013'904'223u;
+    data.m_bytes[i] = (char)(x >> 24);
+  }
+  data.m_bytes[4096] = '\0';
+  return data;
+}
+
+constexpr HashingTestData g_hashingTestData = MakeHashingTestData();
+
+// Each length is its own constant evaluation
+template <size_t len>
+constexpr uint64 g_hashingTestConstHash = constexpr_xxh3::XXH3_64bits_withSeed_const(
+  g_hashingTestData.m_bytes, len, DEFAULT_STRING_HASH_SEED);
+
+#define HASHING_TEST_LEN(len)                                                            \
+  TINKER_TEST_ASSERT(Hash64(g_hashingTestData.m_bytes, len).m_val                        \
+                     == g_hashingTestConstHash<len>);
+
+void Test_Hashing_CompileTimeMatchesRuntime()
+{
+  // Every XXH3 length class: 0, 1-3, 4-8, 9-16, 17-128, 129-240 and the long loop, with
+  // lengths around the 64 byte stripe and 1024 byte block boundaries
+  HASHING_TEST_LEN(0);
+  HASHING_TEST_LEN(1);
+  HASHING_TEST_LEN(2);
+  HASHING_TEST_LEN(3);
+  HASHING_TEST_LEN(4);
+  HASHING_TEST_LEN(7);
+  HASHING_TEST_LEN(8);
+  HASHING_TEST_LEN(9);
+  HASHING_TEST_LEN(16);
+  HASHING_TEST_LEN(17);
+  HASHING_TEST_LEN(63);
+  HASHING_TEST_LEN(64);
+  HASHING_TEST_LEN(65);
+  HASHING_TEST_LEN(128);
+  HASHING_TEST_LEN(129);
+  HASHING_TEST_LEN(239);
+  HASHING_TEST_LEN(240);
+  HASHING_TEST_LEN(241);
+  HASHING_TEST_LEN(255);
+  HASHING_TEST_LEN(256);
+  HASHING_TEST_LEN(257);
+  HASHING_TEST_LEN(511);
+  HASHING_TEST_LEN(512);
+  HASHING_TEST_LEN(1023);
+  HASHING_TEST_LEN(1024);
+  HASHING_TEST_LEN(1025);
+  HASHING_TEST_LEN(2047);
+  HASHING_TEST_LEN(2048);
+  HASHING_TEST_LEN(2049);
+  HASHING_TEST_LEN(3000);
+  HASHING_TEST_LEN(4095);
+  HASHING_TEST_LEN(4096);
+}
+
+void Test_Hashing_StringLiteralMatchesRuntime()
+{
+  constexpr Hash emptyHash = HASH_64("");
+  TINKER_TEST_ASSERT(emptyHash == HASH_64_RUNTIME("", 0));
+
+  constexpr Hash nameHash = HASH_64("UnitSphere");
+  const char* name = "UnitSphere";
+  TINKER_TEST_ASSERT(nameHash == HASH_64_RUNTIME(name, (uint32)strlen(name)));
+  TINKER_TEST_ASSERT(nameHash != HASH_64("UnitCube"));
+
+  TINKER_TEST_ASSERT(HASH_64("Tinker Engine - compile time and runtime string hashes agree")
+                     == HASH_64_RUNTIME(
+                       "Tinker Engine - compile time and runtime string hashes agree", 60));
+}
+
+void Test_Hashing_StreamingMatchesOneShot()
+{
+  const char* bytes = g_hashingTestData.m_bytes;
+
+  HashState state;
+  for (uint32 len = 0; len <= 4096; ++len)
+  {
+    // Vary the chunk size so chunks straddle the internal buffer in different ways
+    const uint32 chunkSize = 1 + (len * 7) % 300;
+
+    state.Reset();
+    for (uint32 offset = 0; offset < len; offset += chunkSize)
+    {
+      state.Update(bytes + offset, Min(chunkSize, len - offset));
+    }
+    TINKER_TEST_ASSERT(state.Digest() == Hash64(bytes, len));
+  }
+
+  // Digest doesn't consume the state
+  state.Reset();
+  state.Update(bytes, 100);
+  TINKER_TEST_ASSERT(state.Digest() == state.Digest());
+  state.Update(bytes + 100, 100);
+  TINKER_TEST_ASSERT(state.Digest() == Hash64(bytes, 200));
+}
+
+void Test_Hashing_Seed()
+{
+  const char* bytes = g_hashingTestData.m_bytes;
+  TINKER_TEST_ASSERT(Hash64(bytes, 1000, 1) != Hash64(bytes, 1000, 2));
+  TINKER_TEST_ASSERT(Hash64(bytes, 1000) == Hash64(bytes, 1000, DEFAULT_STRING_HASH_SEED));
+
+  HashState state;
+  state.Reset(1);
+  state.Update(bytes, 1000);
+  TINKER_TEST_ASSERT(state.Digest() == Hash64(bytes, 1000, 1));
+}
@@ -1,3 +1,6 @@
+#include "Allocators.h"
+#include "Platform/ParallelSort.h"
+#include "Platform/WorkerThreadPool.h"
 #include "Sorting.h"
 #include "TinkerTest.h"
 
@@ -6,6 +9,10 @@
 #include <array>
 #include <random>
 
+using namespace Tk;
+using namespace Core;
+using namespace Platform;
+
 void Test_SortingIntegers()
 {
   const uint32 numUints = 65'536;
@@ -28,3 +35,349 @@ void Test_SortingIntegers()
     TINKER_ASSERT(uintArr_MergeSorted[i] == uintArr_StdSorted[i]);
   }
 }
+
+// xorshift, so every run sorts the same keys
+static uint64 NextSortTestKey(uint64* state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+void Test_RadixSortIntegers()
+{
+  const uint32 numKeys = 100'000;
+  uint32* keys32 = new uint32[numKeys];
+  uint32* expected32 = new uint32[numKeys];
+  uint32* scratch32 = new uint32[numKeys];
+  uint64* keys64 = new uint64[numKeys];
+  uint64* expected64 = new uint64[numKeys];
+  uint64* scratch64 = new uint64[numKeys];
+  uint64 state = 0x9E37'79B9'7F4A'7C15ull;
+  for (uint32 i = 0; i < numKeys; ++i)
+  {
+    keys64[i] = NextSortTestKey(&state);
+    expected64[i] = keys64[i];
+    keys32[i] = (uint32)keys64[i];
+    expected32[i] = keys32[i];
+  }
+
+  RadixSort(keys32, numKeys, scratch32);
+  RadixSort(keys64, numKeys, scratch64);
+  std::sort(expected32, expected32 + numKeys);
+  std::sort(expected64, expected64 + numKeys);
+  const bool sorted32 = !memcmp(keys32, expected32, numKeys * sizeof(uint32));
+  const bool sorted64 = !memcmp(keys64, expected64, numKeys * sizeof(uint64));
+
+  delete[] keys32;
+  delete[] expected32;
+  delete[] scratch32;
+  delete[] keys64;
+  delete[] expected64;
+  delete[] scratch64;
+  TINKER_TEST_ASSERT(sorted32);
+  TINKER_TEST_ASSERT(sorted64);
+}
+
+void Test_RadixSortSkipsUniformBytes()
+{
+  // Only the low byte differs, so only the first pass runs and the result comes back
+  // from the scratch buffer. Then all equal, where no pass runs at all.
+  const uint32 numKeys = 1000;
+  uint64 keys[numKeys] = {};
+  uint64 scratch[numKeys] = {};
+  for (uint32 i = 0; i < numKeys; ++i)
+  {
+    keys[i] = 0xABCD'0000'0000'0000ull | ((i * 37) & 0xFF);
+  }
+  RadixSort(keys, numKeys, scratch);
+  bool sorted = true;
+  for (uint32 i = 1; i < numKeys; ++i)
+  {
+    sorted &= keys[i - 1] <= keys[i];
+  }
+  TINKER_TEST_ASSERT(sorted);
+  TINKER_TEST_ASSERT(keys[0] == 0xABCD'0000'0000'0000ull);
+  TINKER_TEST_ASSERT(keys[numKeys - 1] == 0xABCD'0000'0000'00FFull);
+
+  for (uint32 i = 0; i < numKeys; ++i)
+  {
+    keys[i] = 42;
+  }
+  RadixSort(keys, numKeys, scratch);
+  bool allSame = true;
+  for (uint32 i = 0; i < numKeys; ++i)
+  {
+    allSame &= keys[i] == 42;
+  }
+  TINKER_TEST_ASSERT(allSame);
+
+  // Nothing to sort
+  RadixSort(keys, 0, scratch);
+  RadixSort(keys, 1, scratch);
+  TINKER_TEST_ASSERT(keys[0] == 42);
+}
+
+void Test_RadixSortPairsStable()
+{
+  // Lots of duplicate keys, equal keys have to keep the order their indices came in
+  const uint32 numPairs = 50'000;
+  RadixSortPair32* pairs32 = new RadixSortPair32[numPairs];
+  RadixSortPair32* scratch32 = new RadixSortPair32[numPairs];
+  RadixSortPair64* pairs64 = new RadixSortPair64[numPairs];
+  RadixSortPair64* scratch64 = new RadixSortPair64[numPairs];
+  uint64 state = 0x1234'5678'9ABC'DEF1ull;
+  for (uint32 i = 0; i < numPairs; ++i)
+  {
+    const uint64 key = NextSortTestKey(&state);
+    pairs32[i] = { (uint32)key % 300, i };
+    pairs64[i] = { (key % 300) << 40, i };
+  }
+
+  RadixSort(pairs32, numPairs, scratch32);
+  RadixSort(pairs64, numPairs, scratch64);
+  bool stable32 = true;
+  bool stable64 = true;
+  for (uint32 i = 1; i < numPairs; ++i)
+  {
+    const RadixSortPair32& prev32 = pairs32[i - 1];
+    const RadixSortPair32& curr32 = pairs32[i];
+    stable32 &= prev32.m_key < curr32.m_key
+                || (prev32.m_key == curr32.m_key && prev32.m_index < curr32.m_index);
+    const RadixSortPair64& prev64 = pairs64[i - 1];
+    const RadixSortPair64& curr64 = pairs64[i];
+    stable64 &= prev64.m_key < curr64.m_key
+                || (prev64.m_key == curr64.m_key && prev64.m_index < curr64.m_index);
+  }
+
+  delete[] pairs32;
+  delete[] scratch32;
+  delete[] pairs64;
+  delete[] scratch64;
+  TINKER_TEST_ASSERT(stable32);
+  TINKER_TEST_ASSERT(stable64);
+}
+
+void Test_RadixSortParallelMatchesSerial()
+{
+  ThreadPool::Startup(3);
+
+  // Past RadixSortParallelMinEles, and not a multiple of the chunk count
+  const uint32 numPairs = RadixSortParallelMinEles * 4 + 13;
+  RadixSortPair64* serial = new RadixSortPair64[numPairs];
+  RadixSortPair64* parallel = new RadixSortPair64[numPairs];
+  RadixSortPair64* scratch = new RadixSortPair64[numPairs];
+  uint32* keys = new uint32[numPairs];
+  uint32* expectedKeys = new uint32[numPairs];
+  uint32* keyScratch = new uint32[numPairs];
+  uint64 state = 0x0F0F'1234'ABCD'0001ull;
+  for (uint32 i = 0; i < numPairs; ++i)
+  {
+    const uint64 key = NextSortTestKey(&state);
+    // Upper 24 bits uniform, so the parallel version skips passes too
+    serial[i] = { key & 0xFF'FFFF'FFFFull, i };
+    parallel[i] = serial[i];
+    keys[i] = (uint32)(key >> 32) % 5000;
+    expectedKeys[i] = keys[i];
+  }
+
+  RadixSort(serial, numPairs, scratch);
+  RadixSortParallel(parallel, numPairs, scratch);
+  bool pairsMatch = true;
+  for (uint32 i = 0; i < numPairs; ++i)
+  {
+    pairsMatch &= serial[i].m_key == parallel[i].m_key;
+    pairsMatch &= serial[i].m_index == parallel[i].m_index;
+  }
+  RadixSortParallel(keys, numPairs, keyScratch);
+  std::sort(expectedKeys, expectedKeys + numPairs);
+  const bool keysMatch = !memcmp(keys, expectedKeys, numPairs * sizeof(uint32));
+
+  delete[] serial;
+  delete[] parallel;
+  delete[] scratch;
+  delete[] keys;
+  delete[] expectedKeys;
+  delete[] keyScratch;
+  ThreadPool::Shutdown();
+  TINKER_TEST_ASSERT(pairsMatch);
+  TINKER_TEST_ASSERT(keysMatch);
+}
+
+struct SortTestItem
+{
+  float m_key;
+  uint32 m_payload;
+};
+
+static bool SortTestItemLess(const SortTestItem& A, const SortTestItem& B)
+{
+  return A.m_key < B.m_key;
+}
+
+// Keys in the same order as std::sort's, and every payload still there exactly once
+static bool SortTestItemsMatch(const SortTestItem* items, const SortTestItem* expected,
+                               uint32 numItems)
+{
+  bool match = true;
+  uint64 payloadSum = 0;
+  uint64 expectedPayloadSum = 0;
+  for (uint32 i = 0; i < numItems; ++i)
+  {
+    match &= items[i].m_key == expected[i].m_key;
+    payloadSum += items[i].m_payload;
+    expectedPayloadSum += expected[i].m_payload;
+  }
+  return match && payloadSum == expectedPayloadSum;
+}
+
+void Test_IntroSortPatterns()
+{
+  // Random, already sorted, reversed, all equal and a few distinct keys. The sorted and
+  // reversed ones are the inputs a bad pivot choice goes quadratic on.
+  const uint32 numItems = 20'000;
+  SortTestItem* items = new SortTestItem[numItems];
+  SortTestItem* expected = new SortTestItem[numItems];
+  bool allMatch = true;
+  uint64 state = 0x2545'F491'4F6C'DD1Dull;
+  for (uint32 uiPattern = 0; uiPattern < 5; ++uiPattern)
+  {
+    for (uint32 i = 0; i < numItems; ++i)
+    {
+      const uint64 rand = NextSortTestKey(&state);
+      float key = 0.0f;
+      switch (uiPattern)
+      {
+        case 0:
+        {
+          key = (float)(rand % 1'000'000) * 0.25f - 1000.0f;
+          break;
+        }
+        case 1:
+        {
+          key = (float)i;
+          break;
+        }
+        case 2:
+        {
+          key = (float)(numItems - i);
+          break;
+        }
+        case 3:
+        {
+          key = 7.0f;
+          break;
+        }
+        default:
+        {
+          key = (float)(rand % 3);
+          break;
+        }
+      }
+      items[i] = { key, i };
+      expected[i] = items[i];
+    }
+
+    Core::IntroSort(items, numItems, SortTestItemLess);
+    std::sort(expected, expected + numItems, SortTestItemLess);
+    allMatch &= SortTestItemsMatch(items, expected, numItems);
+  }
+
+  // Short enough for just the insertion sort, and nothing to sort
+  uint32 shortKeys[5] = { 4, 1, 3, 0, 2 };
+  Core::IntroSort(shortKeys, 5,
+                  [](uint32 A, uint32 B)
+                  {
+                    return A < B;
+                  });
+  Core::IntroSort(shortKeys, 0,
+                  [](uint32 A, uint32 B)
+                  {
+                    return A > B;
+                  });
+
+  delete[] items;
+  delete[] expected;
+  TINKER_TEST_ASSERT(allMatch);
+  for (uint32 i = 0; i < 5; ++i)
+  {
+    TINKER_TEST_ASSERT(shortKeys[i] == i);
+  }
+}
+
+void Test_ParallelSortMatchesStdSort()
+{
+  ThreadPool::Startup(3);
+
+  // Not a multiple of the run count, so the last run is short
+  const uint32 numItems = ParallelSortMinEles * 8 + 101;
+  SortTestItem* items = new SortTestItem[numItems];
+  SortTestItem* expected = new SortTestItem[numItems];
+  LinearAllocator scratchArena;
+  scratchArena.Init(numItems * sizeof(SortTestItem) + CACHE_LINE, CACHE_LINE);
+
+  bool allMatch = true;
+  uint64 state = 0xDEAD'BEEF'0BAD'F00Dull;
+  for (uint32 uiPattern = 0; uiPattern < 3; ++uiPattern)
+  {
+    for (uint32 i = 0; i < numItems; ++i)
+    {
+      const uint64 rand = NextSortTestKey(&state);
+      // Random, lots of duplicates straddling the merges, then reversed
+      const float key = uiPattern == 0 ? (float)(rand % 10'000'000) * 0.5f
+                        : uiPattern == 1 ? (float)(rand % 50)
+                                         : (float)(numItems - i);
+      items[i] = { key, i };
+      expected[i] = items[i];
+    }
+
+    ParallelSort(items, numItems, SortTestItemLess, scratchArena);
+    std::sort(expected, expected + numItems, SortTestItemLess);
+    allMatch &= SortTestItemsMatch(items, expected, numItems);
+  }
+  // The scratch gets handed back
+  const bool arenaRewound = scratchArena.m_nextAllocOffset == 0;
+
+  delete[] items;
+  delete[] expected;
+  scratchArena.ExplicitFree();
+  ThreadPool::Shutdown();
+  TINKER_TEST_ASSERT(allMatch);
+  TINKER_TEST_ASSERT(arenaRewound);
+}
+
+void Test_ParallelSortArenaTooSmall()
+{
+  // No room for the scratch, so it sorts in place on the calling thread instead
+  ThreadPool::Startup(3);
+
+  const uint32 numKeys = ParallelSortMinEles * 2;
+  uint32* keys = new uint32[numKeys];
+  uint32* expected = new uint32[numKeys];
+  LinearAllocator scratchArena;
+  scratchArena.Init(numKeys * sizeof(uint32) / 2, CACHE_LINE);
+  uint64 state = 0x0123'4567'89AB'CDEFull;
+  for (uint32 i = 0; i < numKeys; ++i)
+  {
+    keys[i] = (uint32)NextSortTestKey(&state);
+    expected[i] = keys[i];
+  }
+
+  ParallelSort(keys, numKeys,
+               [](uint32 A, uint32 B)
+               {
+                 return A < B;
+               },
+               scratchArena);
+  std::sort(expected, expected + numKeys);
+  const bool sorted = !memcmp(keys, expected, numKeys * sizeof(uint32));
+  const bool arenaUntouched = scratchArena.m_nextAllocOffset == 0;
+
+  delete[] keys;
+  delete[] expected;
+  scratchArena.ExplicitFree();
+  ThreadPool::Shutdown();
+  TINKER_TEST_ASSERT(sorted);
+  TINKER_TEST_ASSERT(arenaUntouched);
+}
@@ -0,0 +1,226 @@
+#include "DataStructures/ConcurrentHashMap.h"
+#include "TinkerTest.h"
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+void Test_ConcurrentHashMap_Basic()
+{
+  ConcurrentHashMapU32 map;
+  std::unordered_map<uint32, uint32> map_std;
+
+  // Grows from empty, through several rehashes of every shard
+  const uint32 numEles = 50'000;
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    const uint32 key = i * 7919;
+    map.Insert(key, i);
+    map_std[key] = i;
+  }
+  TINKER_TEST_ASSERT(map.Size() == numEles);
+
+  for (auto& it : map_std)
+  {
+    uint32 value = 0;
+    TINKER_TEST_ASSERT(map.Find(it.first, &value));
+    TINKER_TEST_ASSERT(value == it.second);
+  }
+  TINKER_TEST_ASSERT(!map.Contains(1));
+
+  // Overwrite
+  map.Insert(0, 1234);
+  uint32 value = 0;
+  TINKER_TEST_ASSERT(map.Find(0, &value) && value == 1234);
+  TINKER_TEST_ASSERT(map.Size() == numEles);
+}
+
+void Test_ConcurrentHashMap_RemoveAndReinsert()
+{
+  ConcurrentHashMapU64 map;
+  map.Reserve(1024);
+
+  for (uint64 i = 0; i < 1024; ++i)
+  {
+    map.Insert(i, i * 2);
+  }
+
+  for (uint64 i = 0; i < 1024; i += 2)
+  {
+    TINKER_TEST_ASSERT(map.Remove(i));
+  }
+  TINKER_TEST_ASSERT(!map.Remove(0));
+  TINKER_TEST_ASSERT(map.Size() == 512);
+
+  for (uint64 i = 0; i < 1024; ++i)
+  {
+    uint64 value = 0;
+    const bool found = map.Find(i, &value);
+    TINKER_TEST_ASSERT(found == ((i % 2) == 1));
+    if (found)
+    {
+      TINKER_TEST_ASSERT(value == i * 2);
+    }
+  }
+
+  // Revives the tombstones
+  for (uint64 i = 0; i < 1024; i += 2)
+  {
+    map.Insert(i, i * 3);
+  }
+  TINKER_TEST_ASSERT(map.Size() == 1024);
+  for (uint64 i = 0; i < 1024; ++i)
+  {
+    uint64 value = 0;
+    TINKER_TEST_ASSERT(map.Find(i, &value));
+    TINKER_TEST_ASSERT(value == ((i % 2) ? i * 2 : i * 3));
+  }
+
+  // Churn through many keys with a small live set, tombstones get cleaned up on rehash
+  for (uint64 i = 1024; i < 200'000; ++i)
+  {
+    map.Insert(i, i);
+    TINKER_TEST_ASSERT(map.Remove(i));
+  }
+  TINKER_TEST_ASSERT(map.Size() == 1024);
+}
+
+void Test_ConcurrentHashMap_EpochDefersFree()
+{
+  Epoch::Collect();
+  TINKER_TEST_ASSERT(Epoch::NumPendingRetired() == 0);
+
+  ConcurrentHashMap<uint32, uint32, MapHashFn32, 2> map;
+  map.Insert(0, 0);
+
+  // A table swapped out while this thread is reading has to stay alive
+  Epoch::EnterRead();
+  for (uint32 i = 1; i < 64; ++i)
+  {
+    map.Insert(i, i);
+  }
+  TINKER_TEST_ASSERT(Epoch::NumPendingRetired() > 0);
+  Epoch::ExitRead();
+
+  Epoch::Collect();
+  TINKER_TEST_ASSERT(Epoch::NumPendingRetired() == 0);
+}
+
+void Test_ConcurrentHashMap_MoreReadersThanRecords()
+{
+  Epoch::Collect();
+  TINKER_TEST_ASSERT(Epoch::NumPendingRetired() == 0);
+
+  ConcurrentHashMap<uint32, uint32, MapHashFn32, 2> map;
+  map.Insert(0, 0);
+
+  // Every thread reads at the same time, so some of them don't get a record of their own
+  const uint32 numThreads = Epoch::eMaxThreads + 8;
+  std::atomic<uint32> numReading = 0;
+  std::atomic<uint32> numFound = 0;
+  std::atomic<uint32> release = 0;
+  std::thread threads[numThreads];
+  for (uint32 i = 0; i < numThreads; ++i)
+  {
+    threads[i] = std::thread(
+      [&]()
+      {
+        Epoch::ScopedRead read;
+        numFound += map.Contains(0);
+        numReading.fetch_add(1);
+        while (!release.load(std::memory_order_acquire))
+        {
+          std::this_thread::yield();
+        }
+      });
+  }
+  while (numReading.load() < numThreads)
+  {
+    std::this_thread::yield();
+  }
+
+  // Nothing swapped out while they read can be freed
+  for (uint32 i = 1; i < 64; ++i)
+  {
+    map.Insert(i, i);
+  }
+  Epoch::Collect();
+  const bool heldWhileReading = Epoch::NumPendingRetired() > 0;
+
+  release.store(1, std::memory_order_release);
+  for (uint32 i = 0; i < numThreads; ++i)
+  {
+    threads[i].join();
+  }
+  Epoch::Collect();
+
+  TINKER_TEST_ASSERT(numFound == numThreads);
+  TINKER_TEST_ASSERT(heldWhileReading);
+  TINKER_TEST_ASSERT(Epoch::NumPendingRetired() == 0);
+}
+
+void Test_ConcurrentHashMap_ReadersDuringWrites()
+{
+  ConcurrentHashMapU32 map;
+
+  // Keys below numStable are always present, the writer keeps adding and overwriting the
+  // rest which makes every shard rehash several times while the readers are running
+  const uint32 numStable = 4096;
+  const uint32 numWritten = 200'000;
+  for (uint32 i = 0; i < numStable; ++i)
+  {
+    map.Insert(i, i);
+  }
+
+  std::atomic<uint32> writerDone = 0;
+  std::atomic<uint32> numErrors = 0;
+
+  const uint32 numReaders = 4;
+  std::thread readers[numReaders];
+  for (uint32 uiReader = 0; uiReader < numReaders; ++uiReader)
+  {
+    readers[uiReader] = std::thread(
+      [&, uiReader]()
+      {
+        uint32 key = uiReader;
+        while (!writerDone.load(std::memory_order_acquire))
+        {
+          uint32 value = 0;
+          if (!map.Find(key % numStable, &value) || value != key % numStable)
+          {
+            numErrors.fetch_add(1);
+          }
+
+          // Written keys can be missing, but if found the value is always a valid one
+          const uint32 writtenKey = numStable + (key * 31) % numWritten;
+          if (map.Find(writtenKey, &value) && value != writtenKey && value != ~writtenKey)
+          {
+            numErrors.fetch_add(1);
+          }
+          ++key;
+        }
+      });
+  }
+
+  for (uint32 i = 0; i < numWritten; ++i)
+  {
+    const uint32 key = numStable + i;
+    map.Insert(key, key);
+    if (i % 4 == 0)
+    {
+      map.Insert(key, ~key);
+    }
+  }
+  writerDone.store(1, std::memory_order_release);
+
+  for (uint32 uiReader = 0; uiReader < numReaders; ++uiReader)
+  {
+    readers[uiReader].join();
+  }
+
+  TINKER_TEST_ASSERT(numErrors.load() == 0);
+  TINKER_TEST_ASSERT(map.Size() == numStable + numWritten);
+
+  // Nobody is reading anymore so everything retired can go
+  Epoch::Collect();
+  TINKER_TEST_ASSERT(Epoch::NumPendingRetired() == 0);
+}
@@ -0,0 +1,171 @@
+#include "DataStructures/HandlePool.h"
+#include "TinkerTest.h"
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+void Test_HandlePool_Basic()
+{
+  Tk::Core::HandlePool<uint64> pool;
+  pool.Init(16);
+  TINKER_TEST_ASSERT(pool.Size() == 0);
+  TINKER_TEST_ASSERT(pool.Capacity() == 16);
+
+  const uint32 a = pool.Create(10ull);
+  const uint32 b = pool.Create(20ull);
+  const uint32 c = pool.Create(30ull);
+  TINKER_TEST_ASSERT(pool.Size() == 3);
+  TINKER_TEST_ASSERT(*pool.PtrFromHandle(a) == 10);
+  TINKER_TEST_ASSERT(*pool.PtrFromHandle(b) == 20);
+  TINKER_TEST_ASSERT(*pool.PtrFromHandle(c) == 30);
+
+  // Last element moves into the hole, handles still resolve
+  pool.Destroy(a);
+  TINKER_TEST_ASSERT(pool.Size() == 2);
+  TINKER_TEST_ASSERT(pool[0] == 30);
+  TINKER_TEST_ASSERT(pool[1] == 20);
+  TINKER_TEST_ASSERT(*pool.PtrFromHandle(b) == 20);
+  TINKER_TEST_ASSERT(*pool.PtrFromHandle(c) == 30);
+  TINKER_TEST_ASSERT(pool.HandleAtDenseIndex(0) == c);
+  TINKER_TEST_ASSERT(pool.HandleAtDenseIndex(1) == b);
+
+  TINKER_TEST_ASSERT(!pool.IsValid(TINKER_INVALID_HANDLE));
+  TINKER_TEST_ASSERT(pool.TryPtrFromHandle(TINKER_INVALID_HANDLE) == nullptr);
+}
+
+void Test_HandlePool_StaleHandles()
+{
+  Tk::Core::HandlePool<uint32> pool;
+  pool.Init(4);
+
+  const uint32 first = pool.Create(1u);
+  pool.Destroy(first);
+  TINKER_TEST_ASSERT(!pool.IsValid(first));
+  TINKER_TEST_ASSERT(pool.TryPtrFromHandle(first) == nullptr);
+
+  // Reuses the slot, but with a new generation
+  const uint32 second = pool.Create(2u);
+  TINKER_TEST_ASSERT(second != first);
+  TINKER_TEST_ASSERT(Tk::Core::HandlePoolBase::IndexFromHandle(second)
+                     == Tk::Core::HandlePoolBase::IndexFromHandle(first));
+  TINKER_TEST_ASSERT(!pool.IsValid(first));
+  TINKER_TEST_ASSERT(pool.TryPtrFromHandle(first) == nullptr);
+  TINKER_TEST_ASSERT(*pool.PtrFromHandle(second) == 2);
+
+  // Fill up
+  pool.Create(3u);
+  pool.Create(4u);
+  pool.Create(5u);
+  TINKER_TEST_ASSERT(pool.Size() == 4);
+
+  // Clear makes every handle stale
+  pool.Clear();
+  TINKER_TEST_ASSERT(pool.Size() == 0);
+  TINKER_TEST_ASSERT(!pool.IsValid(second));
+}
+
+// Counts live objects so the test can check that the pool constructs and destroys
+struct HandlePoolTestObj
+{
+  static int32 s_numLive;
+  uint32 m_val;
+
+  explicit HandlePoolTestObj(uint32 val)
+    : m_val(val)
+  {
+    ++s_numLive;
+  }
+
+  HandlePoolTestObj(HandlePoolTestObj&& other)
+    : m_val(other.m_val)
+  {
+    ++s_numLive;
+  }
+
+  HandlePoolTestObj& operator=(HandlePoolTestObj&& other)
+  {
+    m_val = other.m_val;
+    return *this;
+  }
+
+  ~HandlePoolTestObj()
+  {
+    --s_numLive;
+  }
+};
+inline int32 HandlePoolTestObj::s_numLive = 0;
+
+void Test_HandlePool_NonTrivial()
+{
+  HandlePoolTestObj::s_numLive = 0;
+  {
+    Tk::Core::HandlePool<HandlePoolTestObj> pool;
+    pool.Init(8);
+    const uint32 a = pool.Create(1u);
+    const uint32 b = pool.Create(2u);
+    pool.Create(3u);
+    TINKER_TEST_ASSERT(HandlePoolTestObj::s_numLive == 3);
+
+    pool.Destroy(a);
+    TINKER_TEST_ASSERT(HandlePoolTestObj::s_numLive == 2);
+    TINKER_TEST_ASSERT(pool.PtrFromHandle(b)->m_val == 2);
+  }
+  TINKER_TEST_ASSERT(HandlePoolTestObj::s_numLive == 0);
+}
+
+void Test_HandlePool_RandomChurn()
+{
+  const uint32 maxEles = 4096;
+  Tk::Core::HandlePool<uint32> pool;
+  pool.Init(maxEles);
+
+  std::unordered_map<uint32, uint32> liveValues; // handle -> value
+  std::vector<uint32> liveHandles;
+  std::vector<uint32> deadHandles;
+
+  std::mt19937 rng(1234);
+  for (uint32 op = 0; op < 200'000; ++op)
+  {
+    const bool create =
+      liveHandles.empty() || (liveHandles.size() < maxEles && (rng() & 1));
+    if (create)
+    {
+      const uint32 handle = pool.Create(op);
+      TINKER_TEST_ASSERT(handle != TINKER_INVALID_HANDLE);
+      TINKER_TEST_ASSERT(liveValues.find(handle) == liveValues.end());
+      liveValues[handle] = op;
+      liveHandles.push_back(handle);
+    }
+    else
+    {
+      const uint32 i = rng() % (uint32)liveHandles.size();
+      const uint32 handle = liveHandles[i];
+      liveHandles[i] = liveHandles.back();
+      liveHandles.pop_back();
+      pool.Destroy(handle);
+      liveValues.erase(handle);
+      deadHandles.push_back(handle);
+    }
+  }
+
+  TINKER_TEST_ASSERT(pool.Size() == liveHandles.size());
+  for (uint32 handle : liveHandles)
+  {
+    TINKER_TEST_ASSERT(*pool.PtrFromHandle(handle) == liveValues[handle]);
+  }
+
+  // Dense storage holds exactly the live set
+  for (uint32 i = 0; i < pool.Size(); ++i)
+  {
+    const uint32 handle = pool.HandleAtDenseIndex(i);
+    TINKER_TEST_ASSERT(liveValues.find(handle) != liveValues.end());
+    TINKER_TEST_ASSERT(pool[i] == liveValues[handle]);
+  }
+
+  // A dead handle only resolves if its slot generation wrapped around back to it
+  for (uint32 handle : deadHandles)
+  {
+    const bool isLive = liveValues.find(handle) != liveValues.end();
+    TINKER_TEST_ASSERT(pool.IsValid(handle) == isLive);
+  }
+}
@@ -64,8 +64,8 @@ void Test_HashMap_Basic_U32()
     TINKER_ASSERT(value == value_std);
   }
 
-  delete keys;
-  delete vals;
+  delete[] keys;
+  delete[] vals;
 }
 
 void Test_HashMap_Basic_U64()
@@ -130,8 +130,8 @@ void Test_HashMap_Basic_U64()
     TINKER_ASSERT(value == value_std);
   }
 
-  delete keys;
-  delete vals;
+  delete[] keys;
+  delete[] vals;
 }
 
 void Test_HashMap_InvalidKey()
@@ -142,3 +142,122 @@ void Test_HashMap_InvalidKey()
   uint32 index = map.FindIndex(HashMapBase::eInvalidIndex);
   TINKER_ASSERT(index == HashMapBase::eInvalidIndex);
 }
+
+void Test_HashMap_GrowFromEmpty()
+{
+  // No reserve, map has to grow on its own
+  HashMapU32 map;
+  const uint32 numEles = 10'000;
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    uint32 index = map.Insert(i, i * 3);
+    TINKER_TEST_ASSERT(index != HashMapBase::eInvalidIndex);
+  }
+  TINKER_TEST_ASSERT(map.Size() == numEles);
+  TINKER_TEST_ASSERT(ISPOW2(map.Capacity()));
+  TINKER_TEST_ASSERT(map.Capacity() >= numEles);
+
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    uint32 index = map.FindIndex(i);
+    TINKER_TEST_ASSERT(index != HashMapBase::eInvalidIndex);
+    TINKER_TEST_ASSERT(map.KeyAtIndex(index) == i);
+    TINKER_TEST_ASSERT(map.DataAtIndex(index) == i * 3);
+  }
+  TINKER_TEST_ASSERT(map.FindIndex(numEles) == HashMapBase::eInvalidIndex);
+
+  // Overwrite does not add an entry
+  map.Insert(5, 1);
+  TINKER_TEST_ASSERT(map.Size() == numEles);
+  TINKER_TEST_ASSERT(map.DataAtIndex(map.FindIndex(5)) == 1);
+
+  map.Clear();
+  TINKER_TEST_ASSERT(map.Size() == 0);
+  TINKER_TEST_ASSERT(map.FindIndex(5) == HashMapBase::eInvalidIndex);
+}
+
+inline uint32 HashMapTestCollideHashFn(uint32 x)
+{
+  return 0;
+}
+
+void Test_HashMap_RemoveKeepsProbeChain()
+{
+  // Every key lands in the same probe sequence
+  HashMap<uint32, uint32, HashMapTestCollideHashFn> map;
+  const uint32 numEles = 100;
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    map.Insert(i, i);
+  }
+
+  // Remove every other key, the remaining keys further down the chain must still be found
+  for (uint32 i = 0; i < numEles; i += 2)
+  {
+    map.Remove(i);
+  }
+  TINKER_TEST_ASSERT(map.Size() == numEles / 2);
+
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    uint32 index = map.FindIndex(i);
+    if (i % 2)
+    {
+      TINKER_TEST_ASSERT(index != HashMapBase::eInvalidIndex);
+      TINKER_TEST_ASSERT(map.DataAtIndex(index) == i);
+    }
+    else
+    {
+      TINKER_TEST_ASSERT(index == HashMapBase::eInvalidIndex);
+    }
+  }
+
+  // Re-inserting doesn't create duplicates
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    map.Insert(i, i + 1);
+  }
+  TINKER_TEST_ASSERT(map.Size() == numEles);
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    TINKER_TEST_ASSERT(map.DataAtIndex(map.FindIndex(i)) == i + 1);
+  }
+}
+
+void Test_HashMap_EraseHeavyChurn()
+{
+  HashMapU64 map;
+  std::unordered_map<uint64, uint64> map_std;
+
+  // Keep the live set small while cycling through many keys so tombstones pile up
+  const uint32 numOps = 200'000;
+  const uint32 numLive = 512;
+  for (uint32 i = 0; i < numOps; ++i)
+  {
+    const uint64 key = (uint64)i * 0x9E37'79B9ull;
+    map.Insert(key, i);
+    map_std[key] = i;
+    if (i >= numLive)
+    {
+      const uint64 keyToRemove = (uint64)(i - numLive) * 0x9E37'79B9ull;
+      map.Remove(keyToRemove);
+      map_std.erase(keyToRemove);
+    }
+  }
+
+  TINKER_TEST_ASSERT(map.Size() == (uint32)map_std.size());
+  TINKER_TEST_ASSERT(map.Capacity() <= 4096);
+
+  uint32 numVisited = 0;
+  for (uint32 i = 0; i < map.Capacity(); ++i)
+  {
+    if (map.IsSlotOccupied(i))
+    {
+      ++numVisited;
+      auto it = map_std.find(map.KeyAtIndex(i));
+      TINKER_TEST_ASSERT(it != map_std.end());
+      TINKER_TEST_ASSERT(it->second == map.DataAtIndex(i));
+    }
+  }
+  TINKER_TEST_ASSERT(numVisited == map.Size());
+}
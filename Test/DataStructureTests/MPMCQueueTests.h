@@ -0,0 +1,178 @@
+#include "DataStructures/MPMCQueue.h"
+#include "TinkerTest.h"
+#include <atomic>
+#include <thread>
+
+void Test_MPMCQueue_FullAndEmpty()
+{
+  MPMCQueue<uint32> queue;
+  queue.Init(8);
+  TINKER_TEST_ASSERT(queue.Capacity() == 8);
+  TINKER_TEST_ASSERT(queue.Size() == 0);
+
+  uint32 x = 0;
+  TINKER_TEST_ASSERT(!queue.TryDequeue(&x));
+
+  // Wraps around the buffer a few times
+  for (uint32 round = 0; round < 4; ++round)
+  {
+    for (uint32 i = 0; i < 8; ++i)
+    {
+      TINKER_TEST_ASSERT(queue.TryEnqueue(round * 8 + i));
+    }
+    TINKER_TEST_ASSERT(!queue.TryEnqueue(1234)); // full
+    TINKER_TEST_ASSERT(queue.Size() == 8);
+
+    for (uint32 i = 0; i < 8; ++i)
+    {
+      TINKER_TEST_ASSERT(queue.TryDequeue(&x));
+      TINKER_TEST_ASSERT(x == round * 8 + i);
+    }
+    TINKER_TEST_ASSERT(!queue.TryDequeue(&x)); // empty
+    TINKER_TEST_ASSERT(queue.Size() == 0);
+  }
+}
+
+void Test_MPMCQueue_Batch()
+{
+  MPMCQueue<uint32> queue;
+  queue.Init(8);
+
+  uint32 in[12] = {};
+  for (uint32 i = 0; i < ARRAYCOUNT(in); ++i)
+  {
+    in[i] = i;
+  }
+  uint32 out[12] = {};
+
+  // Partial batches at the full and empty ends
+  TINKER_TEST_ASSERT(queue.TryEnqueueBatch(in, 5) == 5);
+  TINKER_TEST_ASSERT(queue.TryEnqueueBatch(in + 5, 7) == 3);
+  TINKER_TEST_ASSERT(queue.TryEnqueueBatch(in + 8, 4) == 0);
+  TINKER_TEST_ASSERT(queue.TryDequeueBatch(out, 6) == 6);
+  TINKER_TEST_ASSERT(queue.TryEnqueueBatch(in + 8, 4) == 4);
+  TINKER_TEST_ASSERT(queue.TryDequeueBatch(out + 6, 12) == 6);
+  TINKER_TEST_ASSERT(queue.TryDequeueBatch(out, 12) == 0);
+  TINKER_TEST_ASSERT(queue.TryEnqueueBatch(in, 0) == 0);
+  TINKER_TEST_ASSERT(queue.TryDequeueBatch(out, 0) == 0);
+
+  bool inOrder = true;
+  for (uint32 i = 0; i < ARRAYCOUNT(out); ++i)
+  {
+    inOrder &= out[i] == i;
+  }
+  TINKER_TEST_ASSERT(inOrder);
+}
+
+void Test_MPMCQueue_Concurrent()
+{
+  // Producers and consumers mixing single and batch calls through a small queue that
+  // is full and empty a lot. Every value has to come out exactly once, and each
+  // consumer has to see every producer's values in the order they went in.
+  const uint32 numProducers = 3;
+  const uint32 numConsumers = 3;
+  const uint32 valuesPerProducer = 100'000;
+  const uint32 numValues = numProducers * valuesPerProducer;
+  const uint32 maxBatch = 7;
+  MPMCQueue<uint32> queue;
+  queue.Init(64);
+
+  std::atomic<uint8>* seen = new std::atomic<uint8>[numValues];
+  for (uint32 i = 0; i < numValues; ++i)
+  {
+    seen[i] = 0;
+  }
+  std::atomic<uint32> numTaken = 0;
+  std::atomic<uint32> numOutOfOrder = 0;
+
+  std::thread producers[numProducers];
+  for (uint32 uiProducer = 0; uiProducer < numProducers; ++uiProducer)
+  {
+    producers[uiProducer] = std::thread(
+      [&, uiProducer]()
+      {
+        // Values are producer * valuesPerProducer + sequence
+        uint32 values[maxBatch];
+        uint32 next = 0;
+        while (next < valuesPerProducer)
+        {
+          const uint32 batchSize = Min(next % maxBatch + 1, valuesPerProducer - next);
+          for (uint32 i = 0; i < batchSize; ++i)
+          {
+            values[i] = uiProducer * valuesPerProducer + next + i;
+          }
+          uint32 numEnqueued = 0;
+          if (batchSize == 1)
+          {
+            numEnqueued = queue.TryEnqueue(values[0]) ? 1 : 0;
+          }
+          else
+          {
+            numEnqueued = queue.TryEnqueueBatch(values, batchSize);
+          }
+          next += numEnqueued;
+          if (!numEnqueued)
+          {
+            std::this_thread::yield();
+          }
+        }
+      });
+  }
+
+  std::thread consumers[numConsumers];
+  for (uint32 uiConsumer = 0; uiConsumer < numConsumers; ++uiConsumer)
+  {
+    consumers[uiConsumer] = std::thread(
+      [&, uiConsumer]()
+      {
+        uint32 lastSeen[numProducers];
+        for (uint32 i = 0; i < numProducers; ++i)
+        {
+          lastSeen[i] = 0xFFFFFFFF;
+        }
+        uint32 values[maxBatch];
+        uint32 numCalls = 0;
+        while (numTaken.load(std::memory_order_relaxed) < numValues)
+        {
+          const uint32 maxEles = (numCalls++ + uiConsumer) % maxBatch + 1;
+          const uint32 numDequeued = queue.TryDequeueBatch(values, maxEles);
+          for (uint32 i = 0; i < numDequeued; ++i)
+          {
+            const uint32 producer = values[i] / valuesPerProducer;
+            const uint32 sequence = values[i] % valuesPerProducer;
+            if (lastSeen[producer] != 0xFFFFFFFF && sequence <= lastSeen[producer])
+            {
+              numOutOfOrder.fetch_add(1);
+            }
+            lastSeen[producer] = sequence;
+            seen[values[i]].fetch_add(1);
+          }
+          numTaken.fetch_add(numDequeued);
+          if (!numDequeued)
+          {
+            std::this_thread::yield();
+          }
+        }
+      });
+  }
+
+  for (uint32 uiProducer = 0; uiProducer < numProducers; ++uiProducer)
+  {
+    producers[uiProducer].join();
+  }
+  for (uint32 uiConsumer = 0; uiConsumer < numConsumers; ++uiConsumer)
+  {
+    consumers[uiConsumer].join();
+  }
+
+  uint32 numWrong = 0;
+  for (uint32 i = 0; i < numValues; ++i)
+  {
+    numWrong += seen[i] != 1;
+  }
+  delete[] seen;
+  TINKER_TEST_ASSERT(numWrong == 0);
+  TINKER_TEST_ASSERT(numTaken == numValues);
+  TINKER_TEST_ASSERT(numOutOfOrder == 0);
+  TINKER_TEST_ASSERT(queue.Size() == 0);
+}
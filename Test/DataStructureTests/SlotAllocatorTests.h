@@ -0,0 +1,153 @@
+#include "DataStructures/SlotAllocator.h"
+#include "TinkerTest.h"
+
+void Test_SlotAllocator_LowestFree()
+{
+  Tk::Core::SlotAllocator allocator;
+  allocator.Init(8);
+  TINKER_TEST_ASSERT(allocator.Capacity() == 8);
+
+  for (uint32 i = 0; i < 8; ++i)
+  {
+    TINKER_TEST_ASSERT(allocator.Alloc() == i);
+  }
+  TINKER_TEST_ASSERT(allocator.NumAllocated() == 8);
+  TINKER_TEST_ASSERT(allocator.Alloc() == Tk::Core::SlotAllocator::eInvalidSlot);
+
+  // Freed slots come back lowest first, whatever order they were freed in
+  allocator.Free(6);
+  allocator.Free(2);
+  TINKER_TEST_ASSERT(!allocator.IsAllocated(2));
+  TINKER_TEST_ASSERT(allocator.IsAllocated(3));
+  TINKER_TEST_ASSERT(allocator.NumAllocated() == 6);
+  TINKER_TEST_ASSERT(allocator.Alloc() == 2);
+  TINKER_TEST_ASSERT(allocator.Alloc() == 6);
+  TINKER_TEST_ASSERT(allocator.Alloc() == Tk::Core::SlotAllocator::eInvalidSlot);
+}
+
+void Test_SlotAllocator_WordBoundaries()
+{
+  // Capacity that ends partway through a word
+  Tk::Core::SlotAllocator allocator;
+  allocator.Init(200);
+  for (uint32 i = 0; i < 200; ++i)
+  {
+    allocator.Alloc();
+  }
+  TINKER_TEST_ASSERT(allocator.Alloc() == Tk::Core::SlotAllocator::eInvalidSlot);
+
+  // Only free slots in the second and third words, the first word is full
+  allocator.Free(199);
+  allocator.Free(64);
+  allocator.Free(127);
+  TINKER_TEST_ASSERT(allocator.Alloc() == 64);
+  TINKER_TEST_ASSERT(allocator.Alloc() == 127);
+  TINKER_TEST_ASSERT(allocator.Alloc() == 199);
+  TINKER_TEST_ASSERT(!allocator.IsAllocated(200)); // past capacity
+
+  // Every slot the bitmap can hold
+  allocator.Init(Tk::Core::SlotAllocator::eMaxSlots);
+  uint32 lastSlot = 0;
+  for (uint32 i = 0; i < Tk::Core::SlotAllocator::eMaxSlots; ++i)
+  {
+    lastSlot = allocator.Alloc();
+  }
+  TINKER_TEST_ASSERT(lastSlot == Tk::Core::SlotAllocator::eMaxSlots - 1);
+  TINKER_TEST_ASSERT(allocator.Alloc() == Tk::Core::SlotAllocator::eInvalidSlot);
+  allocator.Free(4000);
+  TINKER_TEST_ASSERT(allocator.Alloc() == 4000);
+}
+
+void Test_MirroredSlotTable_DirtyTracking()
+{
+  const uint32 capacity = 100;
+  const uint32 fallback = 0xFFFF;
+  uint32 dirtySlots[capacity] = {};
+  uint32 dirtyValues[capacity] = {};
+
+  Tk::Core::MirroredSlotTable<2> table;
+  table.Init(capacity, fallback);
+
+  // First flush of each copy writes every slot with the fallback value
+  bool allFallback = true;
+  for (uint32 uiCopy = 0; uiCopy < 2; ++uiCopy)
+  {
+    table.BeginFrame(uiCopy);
+    const uint32 numDirty = table.Flush(dirtySlots, dirtyValues);
+    allFallback &= numDirty == capacity;
+    for (uint32 i = 0; i < numDirty; ++i)
+    {
+      allFallback &= dirtySlots[i] == i && dirtyValues[i] == fallback;
+    }
+  }
+  TINKER_TEST_ASSERT(allFallback);
+
+  // Nothing changed, nothing to write
+  table.BeginFrame(0);
+  TINKER_TEST_ASSERT(table.Flush(dirtySlots, dirtyValues) == 0);
+
+  const uint32 slotA = table.Alloc(10);
+  const uint32 slotB = table.Alloc(20);
+  TINKER_TEST_ASSERT(slotA == 0 && slotB == 1);
+  TINKER_TEST_ASSERT(table.Get(slotB) == 20);
+  TINKER_TEST_ASSERT(table.Flush(dirtySlots, dirtyValues) == 2);
+  TINKER_TEST_ASSERT(dirtySlots[1] == slotB && dirtyValues[1] == 20);
+  TINKER_TEST_ASSERT(table.Flush(dirtySlots, dirtyValues) == 0);
+
+  // The other copy hasn't seen the new slots yet
+  table.BeginFrame(1);
+  TINKER_TEST_ASSERT(table.Flush(dirtySlots, dirtyValues) == 2);
+  TINKER_TEST_ASSERT(dirtySlots[0] == slotA && dirtyValues[0] == 10);
+
+  // Setting the same value isn't a change, unless it's marked dirty by hand
+  table.BeginFrame(0);
+  table.Set(slotA, 10);
+  TINKER_TEST_ASSERT(table.Flush(dirtySlots, dirtyValues) == 0);
+  table.MarkDirty(slotA);
+  table.Set(slotB, 21);
+  TINKER_TEST_ASSERT(table.Flush(dirtySlots, dirtyValues) == 2);
+  table.BeginFrame(1);
+  TINKER_TEST_ASSERT(table.Flush(dirtySlots, dirtyValues) == 2);
+  TINKER_TEST_ASSERT(dirtySlots[1] == slotB && dirtyValues[1] == 21);
+  TINKER_TEST_ASSERT(table.NumAllocated() == 2);
+}
+
+void Test_MirroredSlotTable_DeferredFree()
+{
+  const uint32 capacity = 4;
+  const uint32 fallback = 0xFFFF;
+  uint32 dirtySlots[capacity] = {};
+  uint32 dirtyValues[capacity] = {};
+
+  Tk::Core::MirroredSlotTable<2> table;
+  table.Init(capacity, fallback);
+  table.BeginFrame(0);
+  table.Flush(dirtySlots, dirtyValues);
+  table.BeginFrame(1);
+  table.Flush(dirtySlots, dirtyValues);
+
+  table.BeginFrame(0);
+  const uint32 slot = table.Alloc(7);
+  table.Alloc(8);
+  table.Flush(dirtySlots, dirtyValues);
+
+  // Freed in copy 0: goes back to the fallback right away, but copy 1 may still be
+  // reading the old value so the index isn't handed out again yet
+  table.Free(slot);
+  TINKER_TEST_ASSERT(table.Get(slot) == fallback);
+  TINKER_TEST_ASSERT(table.Flush(dirtySlots, dirtyValues) == 1);
+  TINKER_TEST_ASSERT(dirtySlots[0] == slot && dirtyValues[0] == fallback);
+  TINKER_TEST_ASSERT(table.Alloc(9) == 2);
+
+  table.BeginFrame(1);
+  TINKER_TEST_ASSERT(table.Alloc(10) == 3);
+  TINKER_TEST_ASSERT(table.Alloc(11) == Tk::Core::SlotAllocator::eInvalidSlot);
+
+  // The freed slot counts as allocated until copy 0 comes around again, by which point
+  // every frame that could read it has retired
+  TINKER_TEST_ASSERT(table.NumAllocated() == 4);
+  table.BeginFrame(0);
+  TINKER_TEST_ASSERT(table.NumAllocated() == 3);
+  TINKER_TEST_ASSERT(table.Alloc(12) == slot);
+  TINKER_TEST_ASSERT(table.Get(slot) == 12);
+}
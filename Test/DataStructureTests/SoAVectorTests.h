@@ -0,0 +1,138 @@
+#include "DataStructures/SoAVector.h"
+#include "TinkerTest.h"
+
+struct SoATestTransform
+{
+  float m_pos[3];
+  float m_scale;
+};
+
+void Test_SoAVector_Basic()
+{
+  Tk::Core::SoAVector<uint32, SoATestTransform, uint8> soa;
+  TINKER_TEST_ASSERT(soa.Size() == 0);
+  TINKER_TEST_ASSERT(soa.Capacity() == 0);
+
+  for (uint32 i = 0; i < 100; ++i)
+  {
+    const SoATestTransform transform = { { (float)i, 0.0f, 0.0f }, 2.0f };
+    const uint32 index = soa.PushBack(i * 10, transform, (uint8)i);
+    TINKER_TEST_ASSERT(index == i);
+  }
+  TINKER_TEST_ASSERT(soa.Size() == 100);
+  TINKER_TEST_ASSERT(soa.Capacity() >= 100);
+
+  // Rows survived every regrow, and each column is its own tightly packed array
+  bool rowsMatch = true;
+  for (uint32 i = 0; i < 100; ++i)
+  {
+    rowsMatch &= soa.Get<0>(i) == i * 10;
+    rowsMatch &= soa.Get<1>(i).m_pos[0] == (float)i;
+    rowsMatch &= soa.Get<2>(i) == (uint8)i;
+  }
+  TINKER_TEST_ASSERT(rowsMatch);
+
+  Tk::Core::SoAColumn<uint32> ids = soa.Column<0>();
+  Tk::Core::SoAColumn<uint8> flags = soa.Column<2>();
+  TINKER_TEST_ASSERT(ids.Size() == 100);
+  TINKER_TEST_ASSERT(&ids[1] == ids.Data() + 1);
+  TINKER_TEST_ASSERT(&flags[99] == flags.Data() + 99);
+  uint32 idSum = 0;
+  for (uint32 id : ids)
+  {
+    idSum += id;
+  }
+  TINKER_TEST_ASSERT(idSum == 49'500);
+
+  soa.Set(5, 7u, SoATestTransform{ { 1.0f, 2.0f, 3.0f }, 4.0f }, (uint8)0xFF);
+  TINKER_TEST_ASSERT(soa.Get<0>(5) == 7);
+  TINKER_TEST_ASSERT(soa.Get<1>(5).m_scale == 4.0f);
+  TINKER_TEST_ASSERT(soa.Get<2>(5) == 0xFF);
+}
+
+void Test_SoAVector_ColumnsAligned()
+{
+  // Odd sized fields, every column still has to start on a cache line
+  Tk::Core::SoAVector<uint8, uint16, SoATestTransform, uint64> soa;
+  soa.Reserve(37);
+  TINKER_TEST_ASSERT(soa.Capacity() == 37);
+  soa.Resize(3);
+  TINKER_TEST_ASSERT(((size_t)soa.Column<0>().Data() & (CACHE_LINE - 1)) == 0);
+  TINKER_TEST_ASSERT(((size_t)soa.Column<1>().Data() & (CACHE_LINE - 1)) == 0);
+  TINKER_TEST_ASSERT(((size_t)soa.Column<2>().Data() & (CACHE_LINE - 1)) == 0);
+  TINKER_TEST_ASSERT(((size_t)soa.Column<3>().Data() & (CACHE_LINE - 1)) == 0);
+
+  // 37 bytes of the first column get padded out to a whole cache line, so a SIMD loop
+  // can read past Size() without running into the next column
+  const size_t firstColumnBytes =
+    (const uint8*)soa.Column<1>().Data() - soa.Column<0>().Data();
+  TINKER_TEST_ASSERT(firstColumnBytes == CACHE_LINE);
+}
+
+void Test_SoAVector_ResizeZeroes()
+{
+  Tk::Core::SoAVector<uint32, float> soa;
+  soa.PushBack(1, 1.0f);
+  soa.PushBack(2, 2.0f);
+  soa.Resize(1);
+  TINKER_TEST_ASSERT(soa.Size() == 1);
+
+  // The row that was cut off comes back zeroed, not with its old values
+  soa.Resize(50);
+  TINKER_TEST_ASSERT(soa.Size() == 50);
+  TINKER_TEST_ASSERT(soa.Get<0>(0) == 1);
+  TINKER_TEST_ASSERT(soa.Get<1>(0) == 1.0f);
+  bool allZero = true;
+  for (uint32 i = 1; i < 50; ++i)
+  {
+    allZero &= soa.Get<0>(i) == 0;
+    allZero &= soa.Get<1>(i) == 0.0f;
+  }
+  TINKER_TEST_ASSERT(allZero);
+
+  soa.Clear();
+  TINKER_TEST_ASSERT(soa.Size() == 0);
+  TINKER_TEST_ASSERT(soa.Capacity() >= 50);
+  soa.ExplicitFree();
+  TINKER_TEST_ASSERT(soa.Capacity() == 0);
+}
+
+void Test_SoAVector_SwapRemove()
+{
+  Tk::Core::SoAVector<uint32, uint64> soa;
+  for (uint32 i = 0; i < 5; ++i)
+  {
+    soa.PushBack(i, (uint64)i << 32);
+  }
+
+  // Last row moves into the hole in every column
+  soa.SwapRemove(1);
+  TINKER_TEST_ASSERT(soa.Size() == 4);
+  TINKER_TEST_ASSERT(soa.Get<0>(1) == 4);
+  TINKER_TEST_ASSERT(soa.Get<1>(1) == 4ull << 32);
+  TINKER_TEST_ASSERT(soa.Get<0>(3) == 3);
+
+  // Removing the last row moves nothing
+  soa.SwapRemove(3);
+  TINKER_TEST_ASSERT(soa.Size() == 3);
+  TINKER_TEST_ASSERT(soa.Get<0>(0) == 0);
+  TINKER_TEST_ASSERT(soa.Get<0>(1) == 4);
+  TINKER_TEST_ASSERT(soa.Get<0>(2) == 2);
+  TINKER_TEST_ASSERT(soa.Get<1>(2) == 2ull << 32);
+}
+
+void Test_SoAVector_PushBackSelfReference()
+{
+  Tk::Core::SoAVector<uint32, SoATestTransform> soa;
+  soa.Reserve(2);
+  soa.PushBack(1, SoATestTransform{ { 1.0f, 2.0f, 3.0f }, 4.0f });
+  soa.PushBack(2, SoATestTransform{ { 5.0f, 6.0f, 7.0f }, 8.0f });
+  TINKER_TEST_ASSERT(soa.Size() == soa.Capacity());
+
+  // Full, so the regrow must not free the row being copied before it's written
+  soa.PushBack(soa.Get<0>(1), soa.Get<1>(1));
+  TINKER_TEST_ASSERT(soa.Size() == 3);
+  TINKER_TEST_ASSERT(soa.Get<0>(2) == 2);
+  TINKER_TEST_ASSERT(soa.Get<1>(2).m_pos[2] == 7.0f);
+  TINKER_TEST_ASSERT(soa.Get<1>(2).m_scale == 8.0f);
+}
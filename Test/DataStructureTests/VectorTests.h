@@ -1,3 +1,4 @@
+#include "Allocators.h"
 #include "DataStructures/Vector.h"
 #include "TinkerTest.h"
 
@@ -158,7 +159,7 @@ void Test_VectorResizeDownFromNonEmptyToSmaller()
   vec.PushBackRaw(5);
   TINKER_TEST_ASSERT(vec.Data());
   TINKER_TEST_ASSERT(vec.Size() == 3);
-  TINKER_TEST_ASSERT(vec.Capacity() == 3);
+  TINKER_TEST_ASSERT(vec.Capacity() == 4);
   TINKER_TEST_ASSERT(vec[2] == 5);
   vec.PushBackRaw(4);
   TINKER_TEST_ASSERT(vec.Data());
@@ -168,13 +169,230 @@ void Test_VectorResizeDownFromNonEmptyToSmaller()
   vec.PushBackRaw(3);
   TINKER_TEST_ASSERT(vec.Data());
   TINKER_TEST_ASSERT(vec.Size() == 5);
-  TINKER_TEST_ASSERT(vec.Capacity() == 5);
+  TINKER_TEST_ASSERT(vec.Capacity() == 8);
   TINKER_TEST_ASSERT(vec[4] == 3);
 
   vec.Resize(2);
   TINKER_TEST_ASSERT(vec.Data());
   TINKER_TEST_ASSERT(vec.Size() == 2);
-  TINKER_TEST_ASSERT(vec.Capacity() == 5);
+  TINKER_TEST_ASSERT(vec.Capacity() == 8);
   TINKER_TEST_ASSERT(vec[0] == 1);
   TINKER_TEST_ASSERT(vec[1] == 2);
 }
+
+void Test_VectorPushBackGeometricGrowth()
+{
+  Vector<uint32> vec;
+  uint32 numRegrows = 0;
+  uint32 prevCapacity = vec.Capacity();
+  for (uint32 i = 0; i < 1024; ++i)
+  {
+    vec.PushBackRaw(i);
+    if (vec.Capacity() != prevCapacity)
+    {
+      ++numRegrows;
+      prevCapacity = vec.Capacity();
+    }
+  }
+  TINKER_TEST_ASSERT(vec.Size() == 1024);
+  TINKER_TEST_ASSERT(vec.Capacity() == 1024);
+  TINKER_TEST_ASSERT(numRegrows == 11);
+  for (uint32 i = 0; i < 1024; ++i)
+  {
+    TINKER_TEST_ASSERT(vec[i] == i);
+  }
+}
+
+void Test_VectorAppendN()
+{
+  const uint32 data[5] = { 1, 2, 3, 4, 5 };
+
+  Vector<uint32> vec;
+  vec.PushBackRaw(0);
+  vec.AppendN(&data[0], ARRAYCOUNT(data));
+  TINKER_TEST_ASSERT(vec.Size() == 6);
+  TINKER_TEST_ASSERT(vec.Capacity() == 6);
+  for (uint32 i = 0; i < vec.Size(); ++i)
+  {
+    TINKER_TEST_ASSERT(vec[i] == i);
+  }
+
+  vec.AppendN(&data[0], 0);
+  TINKER_TEST_ASSERT(vec.Size() == 6);
+}
+
+void Test_VectorSwapRemove()
+{
+  Vector<uint32> vec;
+  for (uint32 i = 0; i < 4; ++i)
+  {
+    vec.PushBackRaw(i);
+  }
+
+  vec.SwapRemove(1);
+  TINKER_TEST_ASSERT(vec.Size() == 3);
+  TINKER_TEST_ASSERT(vec[0] == 0);
+  TINKER_TEST_ASSERT(vec[1] == 3);
+  TINKER_TEST_ASSERT(vec[2] == 2);
+
+  vec.SwapRemove(2);
+  TINKER_TEST_ASSERT(vec.Size() == 2);
+  TINKER_TEST_ASSERT(vec[0] == 0);
+  TINKER_TEST_ASSERT(vec[1] == 3);
+}
+
+// Non-POD element type that tracks how many instances are alive
+struct VectorTestTrackedEle
+{
+  static int32 s_numAlive;
+  uint32* m_value;
+
+  VectorTestTrackedEle()
+    : VectorTestTrackedEle(0)
+  {
+  }
+
+  explicit VectorTestTrackedEle(uint32 value)
+  {
+    m_value = new uint32(value);
+    ++s_numAlive;
+  }
+
+  VectorTestTrackedEle(const VectorTestTrackedEle& other)
+    : VectorTestTrackedEle(*other.m_value)
+  {
+  }
+
+  VectorTestTrackedEle(VectorTestTrackedEle&& other)
+  {
+    m_value = other.m_value;
+    other.m_value = nullptr;
+    ++s_numAlive;
+  }
+
+  VectorTestTrackedEle& operator=(VectorTestTrackedEle&& other)
+  {
+    delete m_value;
+    m_value = other.m_value;
+    other.m_value = nullptr;
+    return *this;
+  }
+
+  ~VectorTestTrackedEle()
+  {
+    delete m_value;
+    --s_numAlive;
+  }
+};
+
+int32 VectorTestTrackedEle::s_numAlive = 0;
+
+void Test_VectorEmplaceNonPOD()
+{
+  {
+    Vector<VectorTestTrackedEle> vec;
+    for (uint32 i = 0; i < 100; ++i)
+    {
+      VectorTestTrackedEle& ele = vec.Emplace(i);
+      TINKER_TEST_ASSERT(*ele.m_value == i);
+    }
+    TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 100);
+    for (uint32 i = 0; i < 100; ++i)
+    {
+      TINKER_TEST_ASSERT(*vec[i].m_value == i);
+    }
+
+    vec.SwapRemove(0);
+    TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 99);
+    TINKER_TEST_ASSERT(*vec[0].m_value == 99);
+
+    vec.Resize(10);
+    TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 10);
+    vec.Resize(12);
+    TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 12);
+    TINKER_TEST_ASSERT(*vec[11].m_value == 0);
+
+    Vector<VectorTestTrackedEle> vec2 = std::move(vec);
+    TINKER_TEST_ASSERT(!vec.Data());
+    TINKER_TEST_ASSERT(vec2.Size() == 12);
+    TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 12);
+
+    vec2.Clear();
+    TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 0);
+    vec2.PushBackRaw(VectorTestTrackedEle(7));
+    TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 1);
+  }
+  TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 0);
+}
+
+// Elements that come from the vector itself while it is full, so the regrow has to keep
+// the old memory alive until the new elements are built
+void Test_VectorPushBackSelfReference()
+{
+  Vector<uint32> vec;
+  vec.Reserve(4);
+  for (uint32 i = 0; i < 4; ++i)
+  {
+    vec.PushBackRaw(i + 10);
+  }
+  TINKER_TEST_ASSERT(vec.Size() == vec.Capacity());
+  vec.PushBackRaw(vec[0]);
+  TINKER_TEST_ASSERT(vec.Size() == 5);
+  TINKER_TEST_ASSERT(vec[4] == 10);
+
+  while (vec.Size() < vec.Capacity())
+  {
+    vec.PushBackRaw(vec.Size() + 10);
+  }
+  const uint32 numEles = vec.Size();
+  vec.AppendN((const uint32*)vec.Data(), numEles);
+  TINKER_TEST_ASSERT(vec.Size() == numEles * 2);
+  bool appendedMatches = true;
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    appendedMatches &= vec[numEles + i] == vec[i];
+  }
+  TINKER_TEST_ASSERT(appendedMatches);
+
+  {
+    Vector<VectorTestTrackedEle> trackedVec;
+    trackedVec.Reserve(2);
+    trackedVec.Emplace(1u);
+    trackedVec.Emplace(2u);
+    trackedVec.PushBackRaw(trackedVec[1]);
+    TINKER_TEST_ASSERT(trackedVec.Size() == 3);
+    TINKER_TEST_ASSERT(*trackedVec[2].m_value == 2);
+
+    while (trackedVec.Size() < trackedVec.Capacity())
+    {
+      trackedVec.Emplace(trackedVec.Size() + 1);
+    }
+    const uint32 numTracked = trackedVec.Size();
+    trackedVec.AppendN(trackedVec.begin(), numTracked);
+    TINKER_TEST_ASSERT(trackedVec.Size() == numTracked * 2);
+    TINKER_TEST_ASSERT(*trackedVec[numTracked].m_value == 1);
+    TINKER_TEST_ASSERT(*trackedVec[numTracked * 2 - 1].m_value
+                       == *trackedVec[numTracked - 1].m_value);
+  }
+  TINKER_TEST_ASSERT(VectorTestTrackedEle::s_numAlive == 0);
+}
+
+void Test_VectorWithLinearAllocator()
+{
+  LinearAllocator allocator;
+  allocator.Init(1024 * 16, CACHE_LINE);
+
+  Vector<uint64> vec(&allocator);
+  for (uint32 i = 0; i < 256; ++i)
+  {
+    vec.PushBackRaw(i);
+  }
+  TINKER_TEST_ASSERT(vec.Size() == 256);
+  TINKER_TEST_ASSERT((uint8*)vec.Data() >= (uint8*)allocator.Data());
+  TINKER_TEST_ASSERT((uint8*)vec.Data() + vec.Size() * sizeof(uint64)
+                     <= (uint8*)allocator.Data() + allocator.Size());
+  for (uint32 i = 0; i < 256; ++i)
+  {
+    TINKER_TEST_ASSERT(vec[i] == i);
+  }
+}
@@ -0,0 +1,131 @@
+#include "DataStructures/WorkStealingDeque.h"
+#include "TinkerTest.h"
+#include <atomic>
+#include <thread>
+
+void Test_WorkStealingDeque_OwnerLIFO()
+{
+  WorkStealingDeque<uint32> deque;
+  deque.Init(8);
+  TINKER_TEST_ASSERT(deque.Capacity() == 8);
+  TINKER_TEST_ASSERT(deque.Size() == 0);
+
+  uint32 x = 0;
+  TINKER_TEST_ASSERT(!deque.Pop(&x));
+  TINKER_TEST_ASSERT(!deque.Steal(&x));
+
+  for (uint32 i = 0; i < 8; ++i)
+  {
+    TINKER_TEST_ASSERT(deque.Push(i));
+  }
+  TINKER_TEST_ASSERT(!deque.Push(8)); // full
+  TINKER_TEST_ASSERT(deque.Size() == 8);
+
+  for (uint32 i = 0; i < 8; ++i)
+  {
+    TINKER_TEST_ASSERT(deque.Pop(&x));
+    TINKER_TEST_ASSERT(x == 7 - i);
+  }
+  TINKER_TEST_ASSERT(!deque.Pop(&x));
+  TINKER_TEST_ASSERT(deque.Size() == 0);
+}
+
+void Test_WorkStealingDeque_StealFIFO()
+{
+  WorkStealingDeque<uint32> deque;
+  deque.Init(4);
+
+  // Wraps around the buffer a few times
+  uint32 x = 0;
+  for (uint32 round = 0; round < 4; ++round)
+  {
+    for (uint32 i = 0; i < 4; ++i)
+    {
+      TINKER_TEST_ASSERT(deque.Push(round * 4 + i));
+    }
+    TINKER_TEST_ASSERT(deque.Steal(&x));
+    TINKER_TEST_ASSERT(x == round * 4);
+    TINKER_TEST_ASSERT(deque.Steal(&x));
+    TINKER_TEST_ASSERT(x == round * 4 + 1);
+    TINKER_TEST_ASSERT(deque.Pop(&x));
+    TINKER_TEST_ASSERT(x == round * 4 + 3);
+    TINKER_TEST_ASSERT(deque.Steal(&x));
+    TINKER_TEST_ASSERT(x == round * 4 + 2);
+    TINKER_TEST_ASSERT(!deque.Steal(&x));
+    TINKER_TEST_ASSERT(!deque.Pop(&x));
+  }
+}
+
+void Test_WorkStealingDeque_ConcurrentSteal()
+{
+  // The owner pushes and pops while thieves steal, every value has to come out exactly
+  // once
+  const uint32 numValues = 200'000;
+  const uint32 numThieves = 3;
+  WorkStealingDeque<uint32> deque;
+  deque.Init(256);
+
+  std::atomic<uint8>* seen = new std::atomic<uint8>[numValues];
+  for (uint32 i = 0; i < numValues; ++i)
+  {
+    seen[i] = 0;
+  }
+  std::atomic<uint32> numTaken = 0;
+
+  std::thread thieves[numThieves];
+  for (uint32 uiThief = 0; uiThief < numThieves; ++uiThief)
+  {
+    thieves[uiThief] = std::thread(
+      [&]()
+      {
+        while (numTaken.load(std::memory_order_relaxed) < numValues)
+        {
+          uint32 x;
+          if (deque.Steal(&x))
+          {
+            seen[x].fetch_add(1);
+            numTaken.fetch_add(1);
+          }
+        }
+      });
+  }
+
+  uint32 next = 0;
+  while (next < numValues)
+  {
+    // Push a few, pop one, so the deque keeps going between empty and full
+    for (uint32 i = 0; i < 3 && next < numValues; ++i)
+    {
+      if (deque.Push(next))
+      {
+        ++next;
+      }
+    }
+    uint32 x;
+    if (deque.Pop(&x))
+    {
+      seen[x].fetch_add(1);
+      numTaken.fetch_add(1);
+    }
+  }
+  uint32 x;
+  while (deque.Pop(&x))
+  {
+    seen[x].fetch_add(1);
+    numTaken.fetch_add(1);
+  }
+
+  for (uint32 uiThief = 0; uiThief < numThieves; ++uiThief)
+  {
+    thieves[uiThief].join();
+  }
+
+  uint32 numWrong = 0;
+  for (uint32 i = 0; i < numValues; ++i)
+  {
+    numWrong += seen[i] != 1;
+  }
+  delete[] seen;
+  TINKER_TEST_ASSERT(numWrong == 0);
+  TINKER_TEST_ASSERT(numTaken == numValues);
+}
@@ -0,0 +1,161 @@
+#include "Platform/PlatformGameThreadAPI.h"
+#include "Platform/WorkerThreadPool.h"
+#include "TinkerTest.h"
+#include "Utility/MemTracker.h"
+#include <atomic>
+#include <thread>
+
+// Counts how many copies of itself are still alive
+struct JobCaptureTracker
+{
+  std::atomic<int32>* m_numAlive;
+  uint8 m_padding[24];
+
+  JobCaptureTracker(std::atomic<int32>* numAlive)
+    : m_numAlive(numAlive)
+  {
+    m_numAlive->fetch_add(1);
+  }
+
+  JobCaptureTracker(const JobCaptureTracker& other)
+    : m_numAlive(other.m_numAlive)
+  {
+    m_numAlive->fetch_add(1);
+  }
+
+  ~JobCaptureTracker()
+  {
+    m_numAlive->fetch_sub(1);
+  }
+};
+
+void Test_Jobs_InlineStorage()
+{
+  std::atomic<int32> numAlive = 0;
+  std::atomic<uint32> numRun = 0;
+  uint32 numPooled = 0;
+  {
+    JobCaptureTracker small(&numAlive);
+    uint8 big[InlineJob::eMaxFuncSize] = {};
+
+    WorkerJob* smallJob = CreateNewThreadJob([&numRun, small]() { numRun.fetch_add(1); });
+    // Captures past eMaxFuncSize get their own allocation
+    WorkerJob* bigJob = CreateNewThreadJob(
+      [&numRun, small, big]() { numRun.fetch_add(1 + big[0]); });
+    numPooled += smallJob->m_poolHandle != TINKER_INVALID_HANDLE;
+    numPooled += (bigJob->m_poolHandle != TINKER_INVALID_HANDLE) * 2;
+
+    RunJob(smallJob);
+    RunJob(bigJob);
+    FreeJob(smallJob);
+    FreeJob(bigJob);
+  }
+
+  TINKER_TEST_ASSERT(numRun == 2);
+  TINKER_TEST_ASSERT(numPooled == 1);
+  // The captures were destroyed along with the jobs
+  TINKER_TEST_ASSERT(numAlive == 0);
+}
+
+void Test_Jobs_NoHeapOnceWarm()
+{
+  // The submitting thread's allocations all get sampled, so the sample count shows any
+  // heap allocation made while creating, queueing and freeing jobs
+  using namespace Tk::Core::Utility;
+  const uint32 numWorkers = 3;
+  ThreadPool::Startup(numWorkers);
+
+  const uint32 numJobs = 100'000;
+  std::atomic<uint32> numRun = 0;
+  std::atomic<uint32> releaseWorkers = 0;
+  WorkerJob** jobs = new WorkerJob*[numJobs + numWorkers];
+  uint64 numSamplesBefore = 0;
+  uint64 numSamplesAfter = 0;
+  for (uint32 round = 0; round < 2; ++round)
+  {
+    // The first round holds up every worker so that all the jobs sit in the queue at
+    // once, and the queue and the job pool grow as much as they ever need to
+    const uint32 numBlockers = round == 0 ? numWorkers : 0;
+    releaseWorkers = round;
+    if (round == 1)
+    {
+      SetMemSampleInterval(1);
+      numSamplesBefore = GetMemProfileStats().m_numSamples;
+    }
+
+    JobCounter counter;
+    for (uint32 i = 0; i < numBlockers; ++i)
+    {
+      jobs[numJobs + i] = CreateNewThreadJob(
+        [&releaseWorkers]()
+        {
+          while (!releaseWorkers)
+          {
+            std::this_thread::yield();
+          }
+        });
+      LaunchJob(jobs[numJobs + i], &counter, nullptr);
+    }
+    for (uint32 i = 0; i < numJobs; ++i)
+    {
+      jobs[i] = CreateNewThreadJob([&numRun]() { numRun.fetch_add(1); });
+      LaunchJob(jobs[i], &counter, nullptr);
+    }
+    releaseWorkers = 1;
+    WaitOnJobCounter(&counter, false);
+    for (uint32 i = 0; i < numJobs + numBlockers; ++i)
+    {
+      FreeJob(jobs[i]);
+    }
+
+    if (round == 1)
+    {
+      numSamplesAfter = GetMemProfileStats().m_numSamples;
+      SetMemSampleInterval(MemSampleIntervalDefault);
+    }
+  }
+
+  ThreadPool::Shutdown();
+  delete[] jobs;
+
+  TINKER_TEST_ASSERT(numRun == numJobs * 2);
+  TINKER_TEST_ASSERT(numSamplesAfter == numSamplesBefore);
+}
+
+void Test_Jobs_UnboundedList()
+{
+  ThreadPool::Startup(3);
+
+  const uint32 numJobs = WorkerJobList::eInlineCapacity * 5 + 3;
+  std::atomic<uint32>* counts = new std::atomic<uint32>[numJobs];
+  WorkerJobList jobs;
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    counts[i] = 0;
+    jobs.Add(CreateNewThreadJob([counts, i]() { counts[i].fetch_add(1); }));
+  }
+  const uint32 numInList = jobs.m_numJobs;
+  EnqueueWorkerThreadJobList_Assisted(&jobs);
+  jobs.WaitOnJobs();
+  jobs.FreeList();
+
+  // Reusable after FreeList()
+  jobs.Init(numJobs);
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    jobs.m_jobs[i] = CreateNewThreadJob([counts, i]() { counts[i].fetch_add(1); });
+  }
+  EnqueueWorkerThreadJobList_Unassisted(&jobs);
+  jobs.WaitOnJobs();
+  jobs.FreeList();
+  ThreadPool::Shutdown();
+
+  uint32 numWrong = 0;
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    numWrong += counts[i] != 2;
+  }
+  delete[] counts;
+  TINKER_TEST_ASSERT(numInList == numJobs);
+  TINKER_TEST_ASSERT(numWrong == 0);
+}
@@ -0,0 +1,160 @@
+#include "Platform/PlatformGameThreadAPI.h"
+#include "Platform/WorkerThreadPool.h"
+#include "TinkerTest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+void Test_JobCounter_WaitForAll()
+{
+  ThreadPool::Startup(3);
+
+  const uint32 numJobs = 1000;
+  std::atomic<uint32> numRun = 0;
+  WorkerJob** jobs = new WorkerJob*[numJobs];
+  JobCounter counter;
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    jobs[i] = CreateNewThreadJob([&]() { numRun.fetch_add(1); });
+    LaunchJob(jobs[i], &counter, nullptr);
+  }
+  WaitOnJobCounter(&counter, false);
+  const uint32 numRunAfterWait = numRun;
+
+  // Reusable once it reaches zero
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    jobs[i]->m_done = 0;
+    LaunchJob(jobs[i], &counter, nullptr);
+  }
+  WaitOnJobCounter(&counter, true);
+
+  ThreadPool::Shutdown();
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    FreeJob(jobs[i]);
+  }
+  delete[] jobs;
+
+  TINKER_TEST_ASSERT(numRunAfterWait == numJobs);
+  TINKER_TEST_ASSERT(numRun == numJobs * 2);
+  TINKER_TEST_ASSERT(counter.IsDone());
+}
+
+void Test_JobCounter_DependencyChain()
+{
+  ThreadPool::Startup(3);
+
+  // read -> parse -> upload, several of each, every step has to see all of the
+  // previous one done
+  const uint32 numPerStep = 16;
+  std::atomic<uint32> numRead = 0;
+  std::atomic<uint32> numParsed = 0;
+  std::atomic<uint32> numErrors = 0;
+  JobCounter readDone;
+  JobCounter parseDone;
+  JobCounter uploadDone;
+  WorkerJob* jobs[numPerStep * 3] = {};
+
+  // Launch the later steps first so they really have to wait
+  for (uint32 i = 0; i < numPerStep; ++i)
+  {
+    jobs[numPerStep * 2 + i] = CreateNewThreadJob(
+      [&]()
+      {
+        if (numParsed != numPerStep)
+        {
+          numErrors.fetch_add(1);
+        }
+      });
+  }
+  for (uint32 i = 0; i < numPerStep; ++i)
+  {
+    jobs[numPerStep + i] = CreateNewThreadJob(
+      [&]()
+      {
+        if (numRead != numPerStep)
+        {
+          numErrors.fetch_add(1);
+        }
+        numParsed.fetch_add(1);
+      });
+  }
+  for (uint32 i = 0; i < numPerStep; ++i)
+  {
+    jobs[i] = CreateNewThreadJob(
+      [&]()
+      {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        numRead.fetch_add(1);
+      });
+  }
+
+  // The counters have to be non-zero before anything depends on them
+  readDone.m_count = 1;
+  parseDone.m_count = 1;
+  for (uint32 i = 0; i < numPerStep; ++i)
+  {
+    LaunchJob(jobs[numPerStep * 2 + i], &uploadDone, &parseDone);
+  }
+  for (uint32 i = 0; i < numPerStep; ++i)
+  {
+    LaunchJob(jobs[numPerStep + i], &parseDone, &readDone);
+  }
+  SignalJobCounter(&parseDone);
+  for (uint32 i = 0; i < numPerStep; ++i)
+  {
+    LaunchJob(jobs[i], &readDone, nullptr);
+  }
+  SignalJobCounter(&readDone);
+
+  WaitOnJobCounter(&uploadDone, true);
+  const bool allDone = readDone.IsDone() && parseDone.IsDone();
+  WaitOnJobCounter(&readDone, false);
+  WaitOnJobCounter(&parseDone, false);
+
+  ThreadPool::Shutdown();
+  for (uint32 i = 0; i < ARRAYCOUNT(jobs); ++i)
+  {
+    FreeJob(jobs[i]);
+  }
+
+  TINKER_TEST_ASSERT(allDone);
+  TINKER_TEST_ASSERT(numErrors == 0);
+  TINKER_TEST_ASSERT(numParsed == numPerStep);
+}
+
+void Test_JobCounter_WaitInsideJob()
+{
+  // With one worker, a job waiting on jobs it launched only finishes if the wait
+  // runs them
+  ThreadPool::Startup(1);
+
+  const uint32 numChildren = 64;
+  std::atomic<uint32> numRun = 0;
+  WorkerJob* children[numChildren] = {};
+  JobCounter parentDone;
+  WorkerJob* parent = CreateNewThreadJob(
+    [&]()
+    {
+      JobCounter childrenDone;
+      for (uint32 i = 0; i < numChildren; ++i)
+      {
+        children[i] = CreateNewThreadJob([&]() { numRun.fetch_add(1); });
+        LaunchJob(children[i], &childrenDone, nullptr);
+      }
+      WaitOnJobCounter(&childrenDone, true);
+    });
+  LaunchJob(parent, &parentDone, nullptr);
+  WaitOnJob(parent);
+  WaitOnJobCounter(&parentDone, true);
+
+  ThreadPool::Shutdown();
+  FreeJob(parent);
+  for (uint32 i = 0; i < numChildren; ++i)
+  {
+    FreeJob(children[i]);
+  }
+
+  TINKER_TEST_ASSERT(numRun == numChildren);
+}
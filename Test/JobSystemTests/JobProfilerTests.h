@@ -0,0 +1,126 @@
+#include "Platform/PlatformGameThreadAPI.h"
+#include "Platform/WorkerThreadPool.h"
+#include "TinkerTest.h"
+#include "Utility/JobProfiler.h"
+#include <atomic>
+#include <string.h>
+#include <thread>
+
+static uint32 CountOccurrences(const char* str, const char* substr)
+{
+  uint32 count = 0;
+  const uint32 substrLen = (uint32)strlen(substr);
+  for (const char* found = strstr(str, substr); found;
+       found = strstr(found + substrLen, substr))
+  {
+    ++count;
+  }
+  return count;
+}
+
+// Null terminated, delete[] when done
+static char* WriteJobTraceToString()
+{
+  using namespace Tk::Core::Utility;
+  const uint32 len = WriteJobTraceJSON(nullptr, 0);
+  char* trace = new char[len + 1];
+  const uint32 lenWritten = WriteJobTraceJSON(trace, len);
+  trace[Min(len, lenWritten)] = '\0';
+  return trace;
+}
+
+// Only the workers run them, the calling thread doesn't help
+static void RunNamedJobs(const char* name, uint32 numJobs, std::atomic<uint32>* numRun)
+{
+  ThreadPool::Startup(3);
+  WorkerJobList jobs;
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    jobs.Add(CreateNewThreadJob(name, [numRun]() { numRun->fetch_add(1); }));
+  }
+  EnqueueWorkerThreadJobList_Unassisted(&jobs);
+  while (numRun->load() < numJobs)
+  {
+    std::this_thread::yield();
+  }
+  jobs.WaitOnJobs();
+  jobs.FreeList();
+  ThreadPool::Shutdown();
+}
+
+void Test_JobProfiler_OffRecordsNothing()
+{
+  using namespace Tk::Core::Utility;
+  SetJobProfilerEnabled(false);
+  ClearJobTrace();
+
+  const uint32 numJobs = 64;
+  std::atomic<uint32> numRun = 0;
+  RunNamedJobs("Unprofiled job", numJobs, &numRun);
+
+  char* trace = WriteJobTraceToString();
+  const uint32 numRecorded = CountOccurrences(trace, "\"Unprofiled job\"");
+  delete[] trace;
+
+  TINKER_TEST_ASSERT(numRun == numJobs);
+  TINKER_TEST_ASSERT(numRecorded == 0);
+}
+
+void Test_JobProfiler_Trace()
+{
+  using namespace Tk::Core::Utility;
+  SetJobProfilerEnabled(true);
+  ClearJobTrace();
+
+  const uint32 numJobs = 64;
+  std::atomic<uint32> numRun = 0;
+  RunNamedJobs("Profiled job", numJobs, &numRun);
+  SetJobProfilerEnabled(false);
+
+  char* trace = WriteJobTraceToString();
+  const bool isDocument = !strncmp(trace, "{\n  \"traceEvents\": [", 20);
+  const uint32 numRecorded = CountOccurrences(trace, "\"name\": \"Profiled job\"");
+  // Workers name their threads, and everything that began also ended
+  const bool hasWorkerNames = strstr(trace, "\"name\": \"Worker ") != nullptr;
+  const uint32 numBegins = CountOccurrences(trace, "\"ph\": \"B\"");
+  const uint32 numEnds = CountOccurrences(trace, "\"ph\": \"E\"");
+  delete[] trace;
+
+  TINKER_TEST_ASSERT(numRun == numJobs);
+  TINKER_TEST_ASSERT(isDocument);
+  TINKER_TEST_ASSERT(numRecorded == numJobs);
+  TINKER_TEST_ASSERT(hasWorkerNames);
+  TINKER_TEST_ASSERT(numBegins == numEnds);
+}
+
+void Test_JobProfiler_RingWraps()
+{
+  using namespace Tk::Core::Utility;
+  SetJobProfilerEnabled(true);
+  ClearJobTrace();
+
+  // A thread of its own, so its ring only has these in it
+  const uint32 numScopes = eJobProfilerEventsPerThread + 100;
+  std::thread thread(
+    [numScopes]()
+    {
+      SetJobProfilerThreadName("Ring wrap test");
+      for (uint32 i = 0; i < numScopes; ++i)
+      {
+        JOB_PROFILE_SCOPE("Wrapped scope");
+      }
+      ReleaseJobProfilerThread();
+    });
+  thread.join();
+  SetJobProfilerEnabled(false);
+
+  char* trace = WriteJobTraceToString();
+  const uint32 numRecorded = CountOccurrences(trace, "\"name\": \"Wrapped scope\"");
+  const uint32 numBegins = CountOccurrences(trace, "\"ph\": \"B\"");
+  const uint32 numEnds = CountOccurrences(trace, "\"ph\": \"E\"");
+  delete[] trace;
+
+  // Only the newest events are kept, a begin and an end for each scope
+  TINKER_TEST_ASSERT(numRecorded == eJobProfilerEventsPerThread / 2);
+  TINKER_TEST_ASSERT(numBegins == numEnds);
+}
@@ -0,0 +1,96 @@
+#include "Platform/ParallelFor.h"
+#include "Platform/WorkerThreadPool.h"
+#include "TinkerTest.h"
+#include <atomic>
+
+void Test_ParallelFor_EveryIndexOnce()
+{
+  ThreadPool::Startup(3);
+
+  const uint32 maxItems = 100'003;
+  std::atomic<uint32>* counts = new std::atomic<uint32>[maxItems];
+  // begin, end, grain size
+  const uint32 ranges[][3] = {
+    { 0, 0, 0 }, { 5, 6, 0 }, { 0, 1000, 1 }, { 7, 1000, 0 }, { 0, maxItems, 0 },
+    { 3, maxItems, 64 }, { 0, maxItems, 1 }, // 1 gets clamped to ParallelForMaxChunks
+  };
+
+  uint32 numWrong = 0;
+  for (uint32 uiRange = 0; uiRange < ARRAYCOUNT(ranges); ++uiRange)
+  {
+    for (uint32 i = 0; i < maxItems; ++i)
+    {
+      counts[i] = 0;
+    }
+    const uint32 begin = ranges[uiRange][0];
+    const uint32 end = ranges[uiRange][1];
+    const uint32 grainSize = ranges[uiRange][2];
+    ParallelFor(begin, end, grainSize, [&](uint32 i) { counts[i].fetch_add(1); });
+    for (uint32 i = 0; i < maxItems; ++i)
+    {
+      numWrong += counts[i] != (i >= begin && i < end ? 1u : 0u);
+    }
+  }
+
+  ThreadPool::Shutdown();
+  delete[] counts;
+  TINKER_TEST_ASSERT(numWrong == 0);
+}
+
+struct ParallelReduceTestSpan
+{
+  uint32 m_first;
+  uint32 m_last;
+  uint32 m_isContiguous;
+};
+
+void Test_ParallelReduce_InOrder()
+{
+  ThreadPool::Startup(3);
+
+  const uint32 numItems = 50'000;
+  const uint64 sum = ParallelReduce(
+    0, numItems, 0, (uint64)0, [](uint32 i) { return (uint64)i; },
+    [](uint64 a, uint64 b) { return a + b; });
+
+  // Joining spans only works if they come back in order
+  const ParallelReduceTestSpan identity = { 0xFFFFFFFF, 0, 1 };
+  const ParallelReduceTestSpan span = ParallelReduce(
+    0, numItems, 100, identity,
+    [](uint32 i)
+    {
+      ParallelReduceTestSpan s = { i, i, 1 };
+      return s;
+    },
+    [](const ParallelReduceTestSpan& a, const ParallelReduceTestSpan& b)
+    {
+      if (a.m_first == 0xFFFFFFFF)
+      {
+        return b;
+      }
+      if (b.m_first == 0xFFFFFFFF)
+      {
+        return a;
+      }
+      ParallelReduceTestSpan s = { a.m_first, b.m_last,
+                                   a.m_isContiguous
+                                     && b.m_isContiguous
+                                     && a.m_last + 1 == b.m_first };
+      return s;
+    });
+
+  const float floatSum1 = ParallelReduce(
+    0, numItems, 256, 0.0f, [](uint32 i) { return 1.0f / (i + 1); },
+    [](float a, float b) { return a + b; });
+  const float floatSum2 = ParallelReduce(
+    0, numItems, 256, 0.0f, [](uint32 i) { return 1.0f / (i + 1); },
+    [](float a, float b) { return a + b; });
+
+  ThreadPool::Shutdown();
+
+  TINKER_TEST_ASSERT(sum == (uint64)numItems * (numItems - 1) / 2);
+  TINKER_TEST_ASSERT(span.m_first == 0);
+  TINKER_TEST_ASSERT(span.m_last == numItems - 1);
+  TINKER_TEST_ASSERT(span.m_isContiguous);
+  TINKER_TEST_ASSERT(floatSum1 == floatSum2);
+}
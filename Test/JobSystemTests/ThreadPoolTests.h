@@ -0,0 +1,280 @@
+#include "Platform/PlatformGameThreadAPI.h"
+#include "Platform/WorkerThreadPool.h"
+#include "TinkerTest.h"
+#include "Utility/AllocatorRegistry.h"
+#include <atomic>
+#include <chrono>
+#include <string.h>
+#include <thread>
+
+void Test_ThreadPool_PinnedWorkers()
+{
+  TINKER_TEST_ASSERT(ThreadPool::DefaultNumWorkerThreads() >= 1);
+
+  // Pinning only changes where workers run, every job still has to run once. More
+  // workers than this machine may have cores, so some share.
+  const uint32 pinnings[] = { ThreadPool::CorePinning::ePhysicalCores,
+                              ThreadPool::CorePinning::eLogicalCores };
+  for (uint32 uiPinning = 0; uiPinning < ARRAYCOUNT(pinnings); ++uiPinning)
+  {
+    ThreadPool::Startup(6, pinnings[uiPinning]);
+
+    const uint32 numJobs = 2000;
+    std::atomic<uint32> numRun = 0;
+    WorkerJob** jobs = new WorkerJob*[numJobs];
+    JobCounter counter;
+    for (uint32 i = 0; i < numJobs; ++i)
+    {
+      jobs[i] = CreateNewThreadJob([&]() { numRun.fetch_add(1); });
+      LaunchJob(jobs[i], &counter, nullptr);
+    }
+    WaitOnJobCounter(&counter, true);
+
+    ThreadPool::Shutdown();
+    for (uint32 i = 0; i < numJobs; ++i)
+    {
+      FreeJob(jobs[i]);
+    }
+    delete[] jobs;
+
+    TINKER_TEST_ASSERT(numRun == numJobs);
+  }
+}
+
+void Test_ThreadPool_AssistedJobList()
+{
+  ThreadPool::Startup(3);
+
+  // The caller runs its share, the last numJobs / (workers + 1) jobs, before returning
+  const uint32 numJobs = 18;
+  const uint32 numCallerJobs = numJobs / 4;
+  const std::thread::id callerId = std::this_thread::get_id();
+  std::thread::id ranOn[numJobs];
+  WorkerJobList jobs;
+  jobs.Init(numJobs);
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    jobs.m_jobs[i] =
+      CreateNewThreadJob([&ranOn, i]() { ranOn[i] = std::this_thread::get_id(); });
+  }
+  EnqueueWorkerThreadJobList_Assisted(&jobs);
+
+  uint32 numCallerJobsDone = 0;
+  for (uint32 i = numJobs - numCallerJobs; i < numJobs; ++i)
+  {
+    numCallerJobsDone += jobs.m_jobs[i]->m_done && ranOn[i] == callerId;
+  }
+  jobs.WaitOnJobs();
+
+  uint32 numDone = 0;
+  for (uint32 i = 0; i < numJobs; ++i)
+  {
+    numDone += jobs.m_jobs[i]->m_done;
+  }
+  ThreadPool::Shutdown();
+  jobs.FreeList();
+
+  TINKER_TEST_ASSERT(numCallerJobsDone == numCallerJobs);
+  TINKER_TEST_ASSERT(numDone == numJobs);
+}
+
+void Test_ThreadPool_PriorityOrder()
+{
+  // One worker, held up until everything is queued, then it has to take all the frame
+  // critical jobs before any of the normal ones
+  ThreadPool::Startup(1);
+
+  std::atomic<uint32> blockerStarted = 0;
+  std::atomic<uint32> releaseBlocker = 0;
+  WorkerJob* blocker = CreateNewThreadJob(
+    [&]()
+    {
+      blockerStarted = 1;
+      while (!releaseBlocker)
+      {
+        std::this_thread::yield();
+      }
+    });
+  EnqueueWorkerThreadJob(blocker);
+  while (!blockerStarted)
+  {
+    std::this_thread::yield();
+  }
+
+  const uint32 numJobsPerPriority = 16;
+  std::atomic<uint32> numRun = 0;
+  uint32 runOrder[numJobsPerPriority * 2] = {};
+  WorkerJobList jobs;
+  for (uint32 i = 0; i < numJobsPerPriority * 2; ++i)
+  {
+    // Normal ones queued first
+    const uint32 priority = i < numJobsPerPriority ? JobPriority::eNormal
+                                                   : JobPriority::eFrameCritical;
+    WorkerJob* job = CreateNewThreadJob([&runOrder, &numRun, priority]()
+                                        { runOrder[numRun.fetch_add(1)] = priority; });
+    job->m_priority = priority;
+    jobs.Add(job);
+  }
+  EnqueueWorkerThreadJobList_Unassisted(&jobs);
+  releaseBlocker = 1;
+  WaitOnJob(blocker);
+  jobs.WaitOnJobs();
+
+  uint32 numOutOfOrder = 0;
+  for (uint32 i = 0; i < numJobsPerPriority * 2; ++i)
+  {
+    const uint32 expected =
+      i < numJobsPerPriority ? JobPriority::eFrameCritical : JobPriority::eNormal;
+    numOutOfOrder += runOrder[i] != expected;
+  }
+  ThreadPool::Shutdown();
+  FreeJob(blocker);
+  jobs.FreeList();
+
+  TINKER_TEST_ASSERT(numRun == numJobsPerPriority * 2);
+  TINKER_TEST_ASSERT(numOutOfOrder == 0);
+}
+
+void Test_ThreadPool_BackgroundWorkers()
+{
+  ThreadPool::Startup(4);
+  ThreadPool::SetNumBackgroundWorkers(1);
+  TINKER_TEST_ASSERT(ThreadPool::NumBackgroundWorkers() == 1);
+
+  // Background jobs that never finish on their own hold up the only background worker,
+  // frame critical jobs still get done by the others
+  const uint32 numBackgroundJobs = 8;
+  std::atomic<uint32> releaseBackground = 0;
+  std::thread::id backgroundRanOn[numBackgroundJobs];
+  JobCounter backgroundCounter;
+  WorkerJob* backgroundJobs[numBackgroundJobs];
+  for (uint32 i = 0; i < numBackgroundJobs; ++i)
+  {
+    backgroundJobs[i] = CreateNewThreadJob(
+      [&backgroundRanOn, &releaseBackground, i]()
+      {
+        backgroundRanOn[i] = std::this_thread::get_id();
+        while (!releaseBackground)
+        {
+          std::this_thread::yield();
+        }
+      });
+    backgroundJobs[i]->m_priority = JobPriority::eBackground;
+    LaunchJob(backgroundJobs[i], &backgroundCounter, nullptr);
+  }
+
+  const uint32 numFrameJobs = 64;
+  std::atomic<uint32> numFrameJobsRun = 0;
+  JobCounter frameCounter;
+  WorkerJob* frameJobs[numFrameJobs];
+  for (uint32 i = 0; i < numFrameJobs; ++i)
+  {
+    frameJobs[i] = CreateNewThreadJob([&numFrameJobsRun]() { numFrameJobsRun++; });
+    frameJobs[i]->m_priority = JobPriority::eFrameCritical;
+    LaunchJob(frameJobs[i], &frameCounter, nullptr);
+  }
+  // The calling thread helps, but never with the background jobs
+  WaitOnJobCounter(&frameCounter, true);
+  const bool backgroundStillRunning = !backgroundCounter.IsDone();
+
+  releaseBackground = 1;
+  WaitOnJobCounter(&backgroundCounter, true);
+  uint32 numOnOtherThreads = 0;
+  for (uint32 i = 0; i < numBackgroundJobs; ++i)
+  {
+    numOnOtherThreads += backgroundRanOn[i] != backgroundRanOn[0]
+                         || backgroundRanOn[i] == std::this_thread::get_id();
+  }
+  ThreadPool::Shutdown();
+  for (uint32 i = 0; i < numBackgroundJobs; ++i)
+  {
+    FreeJob(backgroundJobs[i]);
+  }
+  for (uint32 i = 0; i < numFrameJobs; ++i)
+  {
+    FreeJob(frameJobs[i]);
+  }
+
+  TINKER_TEST_ASSERT(numFrameJobsRun == numFrameJobs);
+  TINKER_TEST_ASSERT(backgroundStillRunning);
+  // Every background job ran on the one background worker
+  TINKER_TEST_ASSERT(numOnOtherThreads == 0);
+}
+
+static Tk::Core::Utility::AllocatorStats GetJobPoolStats()
+{
+  using namespace Tk::Core::Utility;
+  AllocatorStatsEntry entries[eMaxRegisteredAllocators];
+  const uint32 numEntries = GetAllocatorStats(entries, eMaxRegisteredAllocators);
+  for (uint32 i = 0; i < numEntries; ++i)
+  {
+    if (!strcmp(entries[i].m_name, "Worker jobs"))
+    {
+      return entries[i].m_stats;
+    }
+  }
+  return {};
+}
+
+void Test_ThreadPool_Restart()
+{
+  // Every restart brings up new worker threads. The jobs leave free elements in the
+  // workers' caches, both in the job pool and in this one, which have to come back when
+  // the workers exit.
+  Tk::Core::PoolAllocator<uint64> pool;
+  pool.Init(64, 1);
+
+  const uint32 numRounds = Tk::Core::PoolAllocatorBase::eMaxThreadCaches;
+  const uint32 numJobs = 256;
+  std::atomic<uint32> numRun = 0;
+  WorkerJob* jobs[numJobs];
+  Tk::Core::Utility::AllocatorStats firstRoundStats = {};
+  uint32 numLeakingRounds = 0;
+  for (uint32 round = 0; round < numRounds; ++round)
+  {
+    ThreadPool::Startup(4);
+    JobCounter counter;
+    for (uint32 i = 0; i < numJobs; ++i)
+    {
+      jobs[i] = CreateNewThreadJob(
+        [&numRun, &pool]()
+        {
+          WorkerJob* inner = CreateNewThreadJob([&numRun]() { numRun.fetch_add(1); });
+          RunJob(inner);
+          FreeJob(inner);
+          pool.Dealloc(pool.Alloc());
+        });
+      LaunchJob(jobs[i], &counter, nullptr);
+    }
+    // Without helping, so that only the workers touch the pools
+    while (!counter.IsDone())
+    {
+      std::this_thread::yield();
+    }
+    ThreadPool::Shutdown();
+    for (uint32 i = 0; i < numJobs; ++i)
+    {
+      FreeJob(jobs[i]);
+    }
+
+    const Tk::Core::Utility::AllocatorStats stats = GetJobPoolStats();
+    if (round == 0)
+    {
+      firstRoundStats = stats;
+    }
+    numLeakingRounds += stats.m_numAllocs != firstRoundStats.m_numAllocs;
+  }
+
+  // Workers finish exiting after Shutdown() returns
+  Tk::Core::PoolAllocatorStats stats = pool.GetStats();
+  for (uint32 i = 0; i < 1000 && stats.m_numCachedFree > 0; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    stats = pool.GetStats();
+  }
+
+  TINKER_TEST_ASSERT(numRun == numRounds * numJobs);
+  TINKER_TEST_ASSERT(numLeakingRounds == 0);
+  TINKER_TEST_ASSERT(stats.m_numAllocated == 0);
+  TINKER_TEST_ASSERT(stats.m_numCachedFree == 0);
+}
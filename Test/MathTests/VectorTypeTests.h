@@ -786,10 +786,10 @@ void Test_m2OpSubEq()
   m2ui aui = m2ui(1, 2, 3, 4);
   m2ui bui = m2ui(5, 6, 7, 8);
   aui -= bui;
-  TINKER_TEST_ASSERT(aui.m_data[0] == -4);
-  TINKER_TEST_ASSERT(aui.m_data[1] == -4);
-  TINKER_TEST_ASSERT(aui.m_data[2] == -4);
-  TINKER_TEST_ASSERT(aui.m_data[3] == -4);
+  TINKER_TEST_ASSERT(aui.m_data[0] == (uint32)-4);
+  TINKER_TEST_ASSERT(aui.m_data[1] == (uint32)-4);
+  TINKER_TEST_ASSERT(aui.m_data[2] == (uint32)-4);
+  TINKER_TEST_ASSERT(aui.m_data[3] == (uint32)-4);
 }
 
 void Test_m2OpMulEq()
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Allocators.h"
+#include "TLSFHeap.h"
+#include "TinkerTest.h"
+#include "Utility/AllocatorRegistry.h"
+#include <atomic>
+#include <string.h>
+#include <thread>
+
+using namespace Tk;
+using namespace Core;
+
+static const Utility::AllocatorStatsEntry*
+FindAllocatorStats(const Utility::AllocatorStatsEntry* entries, uint32 numEntries,
+                   const char* name)
+{
+  for (uint32 i = 0; i < numEntries; ++i)
+  {
+    if (!strcmp(entries[i].m_name, name))
+    {
+      return &entries[i];
+    }
+  }
+  return nullptr;
+}
+
+void Test_AllocatorRegistry_Stats()
+{
+  using namespace Utility;
+  AllocatorStatsEntry entries[eMaxRegisteredAllocators];
+
+  {
+    LinearAllocator linear;
+    linear.Init(1024, 16);
+    RegisterAllocator(linear, "Test linear");
+    linear.Alloc(100, 1);
+    linear.Alloc(200, 1);
+
+    ChainedLinearAllocator chained;
+    chained.Init(256, 16);
+    RegisterAllocator(chained, "Test chained");
+    chained.Alloc(1000, 1);
+
+    PoolAllocator<uint64> pool;
+    pool.Init(64, 8);
+    RegisterAllocator(pool, "Test pool");
+    pool.Alloc();
+    pool.Alloc();
+    pool.Alloc();
+
+    TLSFHeap heap;
+    heap.Init(1024 * 64, 1024 * 64, false);
+    RegisterAllocator(heap, "Test TLSF");
+    void* ptr = heap.Alloc(500);
+
+    uint32 numEntries = GetAllocatorStats(entries, eMaxRegisteredAllocators);
+    const AllocatorStatsEntry* entry =
+      FindAllocatorStats(entries, numEntries, "Test linear");
+    TINKER_TEST_ASSERT(entry);
+    TINKER_TEST_ASSERT(entry->m_stats.m_capacity == 1024);
+    TINKER_TEST_ASSERT(entry->m_stats.m_committed == 1024);
+    TINKER_TEST_ASSERT(entry->m_stats.m_used == 300);
+    TINKER_TEST_ASSERT(entry->m_stats.m_highWaterMark == 300);
+    TINKER_TEST_ASSERT(entry->m_stats.m_numAllocs == 2);
+
+    entry = FindAllocatorStats(entries, numEntries, "Test chained");
+    TINKER_TEST_ASSERT(entry);
+    TINKER_TEST_ASSERT(entry->m_stats.m_used == 1000);
+    TINKER_TEST_ASSERT(entry->m_stats.m_committed >= 1000 + 256);
+    TINKER_TEST_ASSERT(entry->m_stats.m_numAllocs == 1);
+
+    entry = FindAllocatorStats(entries, numEntries, "Test pool");
+    TINKER_TEST_ASSERT(entry);
+    TINKER_TEST_ASSERT(entry->m_stats.m_numAllocs == 3);
+    TINKER_TEST_ASSERT(entry->m_stats.m_used == 3 * pool.ElementSize());
+    TINKER_TEST_ASSERT(entry->m_stats.m_capacity == 64 * pool.ElementSize());
+
+    entry = FindAllocatorStats(entries, numEntries, "Test TLSF");
+    TINKER_TEST_ASSERT(entry);
+    TINKER_TEST_ASSERT(entry->m_stats.m_numAllocs == 1);
+    TINKER_TEST_ASSERT(entry->m_stats.m_used >= 500);
+
+    // Registering again renames, registration survives freeing
+    RegisterAllocator(linear, "Test linear renamed");
+    linear.ExplicitFree();
+    numEntries = GetAllocatorStats(entries, eMaxRegisteredAllocators);
+    TINKER_TEST_ASSERT(!FindAllocatorStats(entries, numEntries, "Test linear"));
+    entry = FindAllocatorStats(entries, numEntries, "Test linear renamed");
+    TINKER_TEST_ASSERT(entry);
+    TINKER_TEST_ASSERT(entry->m_stats.m_used == 0);
+
+    heap.Free(ptr);
+    heap.Shutdown();
+    numEntries = GetAllocatorStats(entries, eMaxRegisteredAllocators);
+    TINKER_TEST_ASSERT(!FindAllocatorStats(entries, numEntries, "Test TLSF"));
+  }
+
+  // Unregistered when destroyed
+  const uint32 numEntries = GetAllocatorStats(entries, eMaxRegisteredAllocators);
+  TINKER_TEST_ASSERT(!FindAllocatorStats(entries, numEntries, "Test linear renamed"));
+  TINKER_TEST_ASSERT(!FindAllocatorStats(entries, numEntries, "Test chained"));
+  TINKER_TEST_ASSERT(!FindAllocatorStats(entries, numEntries, "Test pool"));
+}
+
+static Utility::AllocatorStats GetTestAllocatorStats(const void* allocator)
+{
+  Utility::AllocatorStats stats = {};
+  stats.m_capacity = 4096;
+  stats.m_committed = 4096;
+  stats.m_used = *(const size_t*)allocator;
+  stats.m_highWaterMark = stats.m_used;
+  stats.m_numAllocs = 1;
+  return stats;
+}
+
+void Test_AllocatorRegistry_JSON()
+{
+  using namespace Utility;
+
+  size_t used = 1234;
+  RegisterAllocator(&used, "Test \"quoted\" allocator", GetTestAllocatorStats);
+
+  char buffer[1024 * 32];
+  const uint32 len = WriteAllocatorStatsJSON(buffer, ARRAYCOUNT(buffer) - 1);
+  // Too small a buffer still reports the full length
+  char smallBuffer[16];
+  const uint32 lenSmall = WriteAllocatorStatsJSON(smallBuffer, ARRAYCOUNT(smallBuffer));
+  UnregisterAllocator(&used);
+  const uint32 lenAfter = WriteAllocatorStatsJSON(nullptr, 0);
+
+  TINKER_TEST_ASSERT(len < ARRAYCOUNT(buffer) - 1);
+  buffer[len] = '\0';
+  TINKER_TEST_ASSERT(!strncmp(buffer, "{\n  \"allocators\": [", 19));
+  TINKER_TEST_ASSERT(strstr(buffer, "{ \"name\": \"Test \\\"quoted\\\" allocator\", "
+                                    "\"capacity\": 4096, \"committed\": 4096, "
+                                    "\"used\": 1234, \"peak\": 1234, \"allocs\": 1 }"));
+  TINKER_TEST_ASSERT(!strcmp(buffer + len - 7, "\n  ]\n}\n"));
+  TINKER_TEST_ASSERT(lenSmall == len);
+  TINKER_TEST_ASSERT(lenAfter < len);
+}
+
+void Test_AllocatorRegistry_StatsWhileInUse()
+{
+  using namespace Utility;
+
+  // Arenas belong to one thread but their stats get read from another, e.g. the debug UI
+  LinearAllocator linear;
+  linear.Init(1024 * 64, 16);
+  RegisterAllocator(linear, "Test linear in use");
+  ChainedLinearAllocator chained;
+  chained.Init(1024, 16);
+  RegisterAllocator(chained, "Test chained in use");
+
+  std::atomic<uint32> done = 0;
+  std::thread owner([&]() {
+    for (uint32 frame = 0; frame < 2000; ++frame)
+    {
+      for (uint32 i = 0; i < 32; ++i)
+      {
+        linear.Alloc(64, 16);
+        chained.Alloc(64 + i * 8, 16);
+      }
+      linear.ResetState();
+      chained.ResetState();
+    }
+    done = 1;
+  });
+
+  AllocatorStatsEntry entries[eMaxRegisteredAllocators];
+  uint32 numBadReads = 0;
+  while (!done)
+  {
+    const uint32 numEntries = GetAllocatorStats(entries, eMaxRegisteredAllocators);
+    const AllocatorStatsEntry* linearEntry =
+      FindAllocatorStats(entries, numEntries, "Test linear in use");
+    const AllocatorStatsEntry* chainedEntry =
+      FindAllocatorStats(entries, numEntries, "Test chained in use");
+    numBadReads += !linearEntry || linearEntry->m_stats.m_used > 1024 * 64;
+    numBadReads += !chainedEntry || chainedEntry->m_stats.m_capacity == 0;
+  }
+  owner.join();
+
+  TINKER_TEST_ASSERT(numBadReads == 0);
+  TINKER_TEST_ASSERT(linear.GetStats().m_numAllocs == 2000 * 32);
+  TINKER_TEST_ASSERT(chained.GetStats().m_numAllocs == 2000 * 32);
+}
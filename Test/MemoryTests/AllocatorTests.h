@@ -1,7 +1,13 @@
 #pragma once
 
 #include "Allocators.h"
+#include "Platform/PlatformGameAPI.h"
+#include "Platform/PlatformGameThreadAPI.h"
 #include "TinkerTest.h"
+#include <string.h>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 using namespace Tk;
 using namespace Core;
@@ -55,3 +61,416 @@ void Test_Linear_NoAlignment_WithDealloc()
   ptr = (uint8*)allocator.Alloc(1, 1);
   TINKER_TEST_ASSERT(!ptr);
 }
+
+void Test_Linear_MarkerRewind()
+{
+  LinearAllocator allocator;
+  allocator.Init(1024, 1);
+  allocator.Alloc(100, 1);
+
+  const LinearAllocator::Marker marker = allocator.GetMarker();
+  {
+    ScopedArenaMarker<LinearAllocator> scope(allocator);
+    allocator.Alloc(500, 1);
+    TINKER_TEST_ASSERT(allocator.Size() == 600);
+  }
+  TINKER_TEST_ASSERT(allocator.Size() == 100);
+  TINKER_TEST_ASSERT(allocator.GetMarker() == marker);
+  TINKER_TEST_ASSERT(allocator.GetStats().m_highWaterMark == 600);
+}
+
+void Test_Linear_Reserved_CommitsOnGrowth()
+{
+  const size_t reserveSize = (size_t)1024 * 1024 * 1024;
+  LinearAllocator allocator;
+  allocator.InitReserved(reserveSize, Platform::VirtualMemFlags::eNone);
+  TINKER_TEST_ASSERT(allocator.Capacity() >= reserveSize);
+  TINKER_TEST_ASSERT(allocator.GetStats().m_reserved == 0);
+
+  uint8* first = allocator.Alloc(100, 1);
+  TINKER_TEST_ASSERT(first == allocator.Data());
+  memset(first, 0xAB, 100);
+  const size_t committedSmall = allocator.GetStats().m_reserved;
+  TINKER_TEST_ASSERT(committedSmall >= 100);
+  TINKER_TEST_ASSERT(committedSmall < reserveSize / 16);
+
+  // Still contiguous after growing past what was committed
+  const size_t bigSize = 1024 * 1024 * 8;
+  uint8* big = allocator.Alloc(bigSize, CACHE_LINE);
+  TINKER_TEST_ASSERT(big == first + 128);
+  memset(big, 0xCD, bigSize);
+  TINKER_TEST_ASSERT(first[99] == 0xAB);
+  TINKER_TEST_ASSERT(allocator.GetStats().m_reserved >= 128 + bigSize);
+  TINKER_TEST_ASSERT(allocator.GetStats().m_reserved < reserveSize / 16);
+
+  allocator.ExplicitFree();
+  TINKER_TEST_ASSERT(!allocator.Data());
+}
+
+void Test_Linear_Reserved_FullCapacity()
+{
+  const size_t reserveSize = ReservedArenaCommitGranularity * 4;
+  LinearAllocator allocator;
+  allocator.InitReserved(reserveSize, Platform::VirtualMemFlags::eHugePages);
+  TINKER_TEST_ASSERT(allocator.Capacity() == reserveSize);
+
+  for (uint32 i = 0; i < 4; ++i)
+  {
+    uint8* ptr = allocator.Alloc(ReservedArenaCommitGranularity, 1);
+    TINKER_TEST_ASSERT(ptr);
+    memset(ptr, (int)i, ReservedArenaCommitGranularity);
+  }
+  TINKER_TEST_ASSERT(!allocator.Alloc(1, 1));
+  TINKER_TEST_ASSERT(allocator.GetStats().m_reserved == reserveSize);
+}
+
+void Test_Linear_Reserved_DecommitUnused()
+{
+  LinearAllocator allocator;
+  allocator.InitReserved(1024 * 1024 * 64, Platform::VirtualMemFlags::eNone);
+  allocator.Alloc(100, 1);
+  const LinearAllocator::Marker marker = allocator.GetMarker();
+
+  const size_t spikeSize = 1024 * 1024 * 4;
+  uint8* spike = allocator.Alloc(spikeSize, 1);
+  TINKER_TEST_ASSERT(spike);
+  memset(spike, 0xFF, spikeSize);
+  TINKER_TEST_ASSERT(allocator.GetStats().m_reserved >= spikeSize);
+
+  // Rewinding keeps the pages, decommitting gives back everything past the offset
+  allocator.RewindTo(marker);
+  TINKER_TEST_ASSERT(allocator.GetStats().m_reserved >= spikeSize);
+  allocator.DecommitUnused();
+  TINKER_TEST_ASSERT(allocator.GetStats().m_reserved == ReservedArenaCommitGranularity);
+
+  // Recommitted pages come back zeroed
+  uint8* again = allocator.Alloc(spikeSize, 1);
+  TINKER_TEST_ASSERT(again == spike);
+  TINKER_TEST_ASSERT(again[spikeSize - 1] == 0);
+  TINKER_TEST_ASSERT(allocator.GetStats().m_highWaterMark == 100 + spikeSize);
+}
+
+// Chained linear allocator
+void Test_Chained_GrowsAcrossBlocks()
+{
+  ChainedLinearAllocator allocator;
+  allocator.Init(256, 1);
+
+  // Way more than one block, each allocation filled so overlaps show up as bad values
+  uint8* ptrs[100] = {};
+  for (uint32 i = 0; i < ARRAYCOUNT(ptrs); ++i)
+  {
+    ptrs[i] = allocator.Alloc(50, 16);
+    TINKER_TEST_ASSERT(ptrs[i]);
+    TINKER_TEST_ASSERT(((size_t)ptrs[i] & 15) == 0);
+    memset(ptrs[i], i, 50);
+  }
+  for (uint32 i = 0; i < ARRAYCOUNT(ptrs); ++i)
+  {
+    for (uint32 j = 0; j < 50; ++j)
+    {
+      TINKER_TEST_ASSERT(ptrs[i][j] == (uint8)i);
+    }
+  }
+
+  ArenaStats stats = allocator.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numBlocks > 1);
+  TINKER_TEST_ASSERT(stats.m_used >= 100 * 50);
+  TINKER_TEST_ASSERT(stats.m_reserved >= stats.m_used);
+  TINKER_TEST_ASSERT(stats.m_highWaterMark == stats.m_used);
+
+  // Bigger than a block
+  uint8* big = allocator.Alloc(4096, 64);
+  TINKER_TEST_ASSERT(big);
+  TINKER_TEST_ASSERT(((size_t)big & 63) == 0);
+  memset(big, 0xFF, 4096);
+  TINKER_TEST_ASSERT(ptrs[ARRAYCOUNT(ptrs) - 1][0] == ARRAYCOUNT(ptrs) - 1);
+}
+
+void Test_Chained_RewindReusesBlocks()
+{
+  ChainedLinearAllocator allocator;
+  allocator.Init(1024, 16);
+  allocator.Alloc(16, 16);
+
+  const ChainedLinearAllocator::Marker marker = allocator.GetMarker();
+  uint8* firstPass[64] = {};
+  for (uint32 i = 0; i < ARRAYCOUNT(firstPass); ++i)
+  {
+    firstPass[i] = allocator.Alloc(100, 16);
+  }
+  const ArenaStats afterFirstPass = allocator.GetStats();
+
+  // Same allocations after a rewind land in the same blocks, nothing new is allocated
+  allocator.RewindTo(marker);
+  TINKER_TEST_ASSERT(allocator.Size() == 16);
+  for (uint32 i = 0; i < ARRAYCOUNT(firstPass); ++i)
+  {
+    TINKER_TEST_ASSERT(allocator.Alloc(100, 16) == firstPass[i]);
+  }
+  ArenaStats stats = allocator.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numBlocks == afterFirstPass.m_numBlocks);
+  TINKER_TEST_ASSERT(stats.m_reserved == afterFirstPass.m_reserved);
+  TINKER_TEST_ASSERT(stats.m_used == afterFirstPass.m_used);
+
+  // High water mark survives resets, unused blocks can be given back
+  allocator.ResetState();
+  stats = allocator.GetStats();
+  TINKER_TEST_ASSERT(stats.m_used == 0);
+  TINKER_TEST_ASSERT(stats.m_highWaterMark == afterFirstPass.m_used);
+  allocator.FreeUnusedBlocks();
+  stats = allocator.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numBlocks == 1);
+  TINKER_TEST_ASSERT(stats.m_reserved < afterFirstPass.m_reserved);
+  TINKER_TEST_ASSERT(allocator.Alloc(2000, 16));
+}
+
+void Test_FrameArena_DoubleBuffered()
+{
+  FrameArena<2> arena;
+  arena.Init(512, 16);
+
+  // Frame 1's data has to survive frame 0 being reset and refilled
+  arena.BeginFrame(0);
+  uint32* frame0 = (uint32*)arena.Alloc(sizeof(uint32) * 256, 16);
+  frame0[0] = 0xAAAA;
+  arena.BeginFrame(1);
+  uint32* frame1 = (uint32*)arena.Alloc(sizeof(uint32) * 256, 16);
+  frame1[0] = 0xBBBB;
+
+  arena.BeginFrame(0);
+  uint32* frame0Again = (uint32*)arena.Alloc(sizeof(uint32) * 256, 16);
+  TINKER_TEST_ASSERT(frame0Again == frame0);
+  frame0Again[0] = 0xCCCC;
+  TINKER_TEST_ASSERT(frame1[0] == 0xBBBB);
+
+  TINKER_TEST_ASSERT(arena.GetStats(0).m_used == sizeof(uint32) * 256);
+  TINKER_TEST_ASSERT(arena.GetStats(1).m_used == sizeof(uint32) * 256);
+  arena.ExplicitFree();
+}
+
+// Pool allocator
+void Test_Pool_GrowsPastFirstPage()
+{
+  PoolAllocator<uint64> pool;
+  pool.Init(64, 1);
+  TINKER_TEST_ASSERT(pool.GetStats().m_numPages == 1);
+  TINKER_TEST_ASSERT(pool.GetStats().m_capacity == 64);
+
+  // Pointers handed out before the pool grows stay valid after
+  const uint32 numEles = 1000;
+  std::vector<uint32> handles;
+  std::vector<uint64*> ptrs;
+  std::unordered_set<uint32> uniqueHandles;
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    const uint32 handle = pool.Alloc();
+    TINKER_TEST_ASSERT(handle != TINKER_INVALID_HANDLE);
+    TINKER_TEST_ASSERT(uniqueHandles.insert(handle).second);
+    handles.push_back(handle);
+    ptrs.push_back(pool.PtrFromHandle(handle));
+    *ptrs.back() = i;
+  }
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    TINKER_TEST_ASSERT(pool.PtrFromHandle(handles[i]) == ptrs[i]);
+    TINKER_TEST_ASSERT(*ptrs[i] == i);
+  }
+
+  PoolAllocatorStats stats = pool.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numPages == 16);
+  TINKER_TEST_ASSERT(stats.m_capacity == 1024);
+  TINKER_TEST_ASSERT(stats.m_numAllocated == numEles);
+
+  for (uint32 handle : handles)
+  {
+    pool.Dealloc(handle);
+  }
+  stats = pool.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numAllocated == 0);
+  TINKER_TEST_ASSERT(stats.m_numCachedFree <= PoolAllocatorBase::eCacheSize);
+
+  // Freed elements get reused before the pool grows again
+  for (uint32 i = 0; i < numEles; ++i)
+  {
+    handles[i] = pool.Alloc();
+  }
+  TINKER_TEST_ASSERT(pool.GetStats().m_numPages == 16);
+}
+
+void Test_Pool_Alignment()
+{
+  PoolAllocator<uint8, 100, 64> pool;
+  TINKER_TEST_ASSERT(pool.GetStats().m_capacity == 128);
+  for (uint32 i = 0; i < 300; ++i)
+  {
+    const size_t ptrAsNum = (size_t)pool.PtrFromHandle(pool.Alloc());
+    TINKER_TEST_ASSERT((ptrAsNum & 63) == 0);
+  }
+}
+
+void Test_Pool_MultiThreaded()
+{
+  const uint32 numThreads = 8;
+  const uint32 numElesPerThread = 2000;
+  const uint32 numIters = 20;
+
+  PoolAllocator<uint64> pool;
+  pool.Init(256, 1);
+
+  // Each thread writes its own id into every element it owns and checks that nobody else
+  // scribbled over them before freeing, half of them on another thread
+  std::vector<std::vector<uint32>> handedOff(numThreads);
+  std::vector<uint32> numFailures(numThreads, 0);
+  std::vector<std::thread> threads;
+  for (uint32 t = 0; t < numThreads; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      std::vector<uint32> handles(numElesPerThread);
+      for (uint32 iter = 0; iter < numIters; ++iter)
+      {
+        for (uint32 i = 0; i < numElesPerThread; ++i)
+        {
+          handles[i] = pool.Alloc();
+          *pool.PtrFromHandle(handles[i]) = ((uint64)t << 32) | i;
+        }
+        for (uint32 i = 0; i < numElesPerThread; ++i)
+        {
+          if (*pool.PtrFromHandle(handles[i]) != (((uint64)t << 32) | i))
+          {
+            ++numFailures[t];
+          }
+        }
+        for (uint32 i = 0; i < numElesPerThread / 2; ++i)
+        {
+          pool.Dealloc(handles[i]);
+        }
+        if (iter == numIters - 1)
+        {
+          handedOff[t].assign(handles.begin() + numElesPerThread / 2, handles.end());
+        }
+        else
+        {
+          for (uint32 i = numElesPerThread / 2; i < numElesPerThread; ++i)
+          {
+            pool.Dealloc(handles[i]);
+          }
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  std::unordered_set<uint32> uniqueHandles;
+  for (uint32 t = 0; t < numThreads; ++t)
+  {
+    TINKER_TEST_ASSERT(numFailures[t] == 0);
+    for (uint32 handle : handedOff[t])
+    {
+      TINKER_TEST_ASSERT(uniqueHandles.insert(handle).second);
+    }
+  }
+
+  const uint32 numLive = numThreads * numElesPerThread / 2;
+  PoolAllocatorStats stats = pool.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numAllocated == numLive);
+  TINKER_TEST_ASSERT(stats.m_capacity >= numLive);
+
+  // Freed from the main thread, not the ones that allocated them
+  for (uint32 t = 0; t < numThreads; ++t)
+  {
+    for (uint32 handle : handedOff[t])
+    {
+      pool.Dealloc(handle);
+    }
+  }
+  TINKER_TEST_ASSERT(pool.GetStats().m_numAllocated == 0);
+}
+
+void Test_Pool_ThreadExit()
+{
+  PoolAllocator<uint64> pool;
+  pool.Init(64, 1);
+
+  // More threads than there are caches, one after the other. Each one exits with free
+  // elements in its cache, which go back to the shared list along with its cache index.
+  const uint32 numThreads = PoolAllocatorBase::eMaxThreadCaches * 2;
+  const uint32 numElesPerThread = 40;
+  uint32 numCachedFreeAfterExit = 0;
+  for (uint32 t = 0; t < numThreads; ++t)
+  {
+    std::thread thread([&pool]() {
+      uint32 handles[numElesPerThread];
+      for (uint32 i = 0; i < numElesPerThread; ++i)
+      {
+        handles[i] = pool.Alloc();
+      }
+      for (uint32 i = 0; i < numElesPerThread; ++i)
+      {
+        pool.Dealloc(handles[i]);
+      }
+    });
+    thread.join();
+    numCachedFreeAfterExit += pool.GetStats().m_numCachedFree;
+  }
+
+  const PoolAllocatorStats stats = pool.GetStats();
+  TINKER_TEST_ASSERT(numCachedFreeAfterExit == 0);
+  TINKER_TEST_ASSERT(stats.m_numAllocated == 0);
+  // Every thread found the elements the last one left behind
+  TINKER_TEST_ASSERT(stats.m_numPages == 1);
+}
+
+void Test_ThreadScratch_PerThread()
+{
+  // Each thread gets its own arena, which a thread that was never set up creates lazily
+  ChainedLinearAllocator* mainScratch = &GetThreadScratch();
+  ChainedLinearAllocator* otherScratch = nullptr;
+  uint8* otherAlloc = nullptr;
+  std::thread other([&]() {
+    otherScratch = &GetThreadScratch();
+    otherAlloc = otherScratch->Alloc(64, 16);
+  });
+  other.join();
+  TINKER_TEST_ASSERT(otherScratch && otherScratch != mainScratch);
+  TINKER_TEST_ASSERT(otherAlloc);
+
+  InitThreadScratch(1024);
+  ChainedLinearAllocator& scratch = GetThreadScratch();
+  TINKER_TEST_ASSERT(scratch.m_blockSize == 1024);
+  uint8* outer = scratch.Alloc(16, 16);
+  {
+    ScopedThreadScratch scratchScope(scratch);
+    scratch.Alloc(4096, 16); // past the first block
+    TINKER_TEST_ASSERT(scratch.Size() > 4096);
+  }
+  TINKER_TEST_ASSERT(scratch.Size() == 16);
+  TINKER_TEST_ASSERT(scratch.Alloc(16, 16) == outer + 16);
+
+  ShutdownThreadScratch();
+  TINKER_TEST_ASSERT(GetThreadScratch().m_blockSize == ThreadScratchDefaultBlockSize);
+  ShutdownThreadScratch();
+}
+
+void Test_ThreadScratch_RewoundAfterJob()
+{
+  ChainedLinearAllocator& scratch = GetThreadScratch();
+  uint8* before = scratch.Alloc(32, 16);
+  const size_t sizeBefore = scratch.Size();
+
+  uint8* inJob = nullptr;
+  Platform::WorkerJob* job = Platform::CreateNewThreadJob([&]() {
+    inJob = GetThreadScratch().Alloc(1024 * 1024 * 2, 16);
+    memset(inJob, 1, 1024 * 1024 * 2);
+  });
+  Platform::RunJob(job);
+  TINKER_TEST_ASSERT(job->m_done);
+  TINKER_TEST_ASSERT(inJob && before);
+  TINKER_TEST_ASSERT(scratch.Size() == sizeBefore);
+  Platform::FreeJob(job);
+
+  ShutdownThreadScratch();
+}
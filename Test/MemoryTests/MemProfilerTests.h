@@ -0,0 +1,167 @@
+#pragma once
+
+#include "TinkerTest.h"
+#include "Utility/MemTracker.h"
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace Tk;
+using namespace Core;
+using namespace Utility;
+
+// Addresses that no real allocation can have, so that samples recorded by the tests can't
+// be confused with allocations made elsewhere
+static uint64 g_memProfilerFakeAllocs[8][256];
+
+void Test_MemProfiler_SampleEverything()
+{
+  SetMemSampleInterval(1);
+  const MemProfileStats before = GetMemProfileStats();
+
+  for (uint32 i = 0; i < 256; ++i)
+  {
+    RecordMemAlloc(256, &g_memProfilerFakeAllocs[0][i]);
+  }
+  MemProfileStats stats = GetMemProfileStats();
+  TINKER_TEST_ASSERT(stats.m_numSamples - before.m_numSamples == 256);
+  TINKER_TEST_ASSERT(stats.m_allocatedBytes - before.m_allocatedBytes == 256 * 256);
+  TINKER_TEST_ASSERT(stats.m_liveBytes - before.m_liveBytes == 256 * 256);
+  TINKER_TEST_ASSERT(stats.m_numCallSites > 0);
+
+  for (uint32 i = 0; i < 256; ++i)
+  {
+    RecordMemDealloc(&g_memProfilerFakeAllocs[0][i]);
+  }
+  stats = GetMemProfileStats();
+  TINKER_TEST_ASSERT(stats.m_liveBytes == before.m_liveBytes);
+  TINKER_TEST_ASSERT(stats.m_allocatedBytes - before.m_allocatedBytes == 256 * 256);
+
+  // Frees of pointers that were never sampled are ignored
+  RecordMemDealloc(&g_memProfilerFakeAllocs[0][0]);
+  TINKER_TEST_ASSERT(GetMemProfileStats().m_liveBytes == before.m_liveBytes);
+
+  SetMemSampleInterval(MemSampleIntervalDefault);
+}
+
+void Test_MemProfiler_SampleRate()
+{
+  const uint64 interval = 4096;
+  const uint32 numAllocs = 200'000;
+  const uint64 allocSize = 64;
+  SetMemSampleInterval(interval);
+  const MemProfileStats before = GetMemProfileStats();
+
+  for (uint32 i = 0; i < numAllocs; ++i)
+  {
+    void* ptr = &g_memProfilerFakeAllocs[1][i & 255];
+    RecordMemAlloc(allocSize, ptr);
+    RecordMemDealloc(ptr);
+  }
+
+  // Sampled about once per interval bytes, and the weights add back up to about the
+  // real number of bytes
+  const MemProfileStats stats = GetMemProfileStats();
+  const uint64 expectedSamples = numAllocs * allocSize / interval;
+  const uint64 numSamples = stats.m_numSamples - before.m_numSamples;
+  TINKER_TEST_ASSERT(numSamples > expectedSamples * 3 / 4);
+  TINKER_TEST_ASSERT(numSamples < expectedSamples * 5 / 4);
+
+  const uint64 expectedBytes = numAllocs * allocSize;
+  const uint64 allocatedBytes = stats.m_allocatedBytes - before.m_allocatedBytes;
+  TINKER_TEST_ASSERT(allocatedBytes > expectedBytes * 3 / 4);
+  TINKER_TEST_ASSERT(allocatedBytes < expectedBytes * 5 / 4);
+  TINKER_TEST_ASSERT(stats.m_liveBytes == before.m_liveBytes);
+
+  SetMemSampleInterval(MemSampleIntervalDefault);
+}
+
+void Test_MemProfiler_FoldedOutput()
+{
+  SetMemSampleInterval(1);
+  for (uint32 i = 0; i < 16; ++i)
+  {
+    RecordMemAlloc(1024, &g_memProfilerFakeAllocs[2][i]);
+  }
+  SetMemSampleInterval(MemSampleIntervalDefault);
+
+  const uint32 len = WriteMemProfileFolded(nullptr, 0, MemProfileValue::eLiveBytes);
+  TINKER_TEST_ASSERT(len > 0);
+  std::vector<char> folded(len);
+  TINKER_TEST_ASSERT(
+    WriteMemProfileFolded(folded.data(), len, MemProfileValue::eLiveBytes) == len);
+  TINKER_TEST_ASSERT(folded.back() == '\n');
+
+  // Every line is "frame;frame;...;frame value", and the values add up to the live bytes
+  uint64 totalLiveBytes = 0;
+  uint32 lineStart = 0;
+  for (uint32 i = 0; i < len; ++i)
+  {
+    if (folded[i] != '\n')
+    {
+      continue;
+    }
+    uint32 valueStart = i;
+    while (valueStart > lineStart && folded[valueStart - 1] >= '0'
+           && folded[valueStart - 1] <= '9')
+    {
+      --valueStart;
+    }
+    TINKER_TEST_ASSERT(valueStart < i);
+    TINKER_TEST_ASSERT(valueStart > lineStart + 1 && folded[valueStart - 1] == ' ');
+
+    uint64 value = 0;
+    for (uint32 j = valueStart; j < i; ++j)
+    {
+      value = value * 10 + (folded[j] - '0');
+    }
+    totalLiveBytes += value;
+    lineStart = i + 1;
+  }
+  TINKER_TEST_ASSERT(totalLiveBytes == GetMemProfileStats().m_liveBytes);
+  TINKER_TEST_ASSERT(totalLiveBytes >= 16 * 1024);
+
+  for (uint32 i = 0; i < 16; ++i)
+  {
+    RecordMemDealloc(&g_memProfilerFakeAllocs[2][i]);
+  }
+}
+
+void Test_MemProfiler_MultiThreaded()
+{
+  const uint32 numThreads = 4;
+  const uint32 numIters = 1000;
+  SetMemSampleInterval(1);
+  const MemProfileStats before = GetMemProfileStats();
+
+  std::vector<std::thread> threads;
+  for (uint32 t = 0; t < numThreads; ++t)
+  {
+    threads.emplace_back([t]() {
+      SetMemSampleInterval(1);
+      for (uint32 iter = 0; iter < numIters; ++iter)
+      {
+        for (uint32 i = 0; i < 256; ++i)
+        {
+          RecordMemAlloc(128, &g_memProfilerFakeAllocs[4 + t][i]);
+        }
+        for (uint32 i = 0; i < 256; ++i)
+        {
+          RecordMemDealloc(&g_memProfilerFakeAllocs[4 + t][i]);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  const MemProfileStats stats = GetMemProfileStats();
+  TINKER_TEST_ASSERT(stats.m_numSamples - before.m_numSamples
+                     == numThreads * numIters * 256);
+  TINKER_TEST_ASSERT(stats.m_liveBytes == before.m_liveBytes);
+  TINKER_TEST_ASSERT(stats.m_numDroppedSamples == before.m_numDroppedSamples);
+
+  SetMemSampleInterval(MemSampleIntervalDefault);
+}
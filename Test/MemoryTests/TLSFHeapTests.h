@@ -0,0 +1,218 @@
+#pragma once
+
+#include "TLSFHeap.h"
+#include "TinkerTest.h"
+#include <random>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace Tk;
+using namespace Core;
+
+void Test_TLSF_AllocFreeMerge()
+{
+  TLSFHeap heap;
+  heap.Init(1024 * 64, 1024 * 64, false);
+  TINKER_TEST_ASSERT(heap.GetStats().m_numPools == 1);
+
+  void* a = heap.Alloc(100);
+  void* b = heap.Alloc(200);
+  void* c = heap.Alloc(300);
+  TINKER_TEST_ASSERT(a && b && c);
+  TINKER_TEST_ASSERT(((size_t)a & (TLSFHeap::eAlignSize - 1)) == 0);
+  TINKER_TEST_ASSERT(((size_t)b & (TLSFHeap::eAlignSize - 1)) == 0);
+  TINKER_TEST_ASSERT(TLSFHeap::UsableSize(a) >= 100);
+  TINKER_TEST_ASSERT(TLSFHeap::UsableSize(b) >= 200);
+  TINKER_TEST_ASSERT(heap.GetStats().m_numAllocs == 3);
+
+  // Freeing the middle block and then its neighbours merges everything back into one
+  // block, so the whole pool can be handed out again
+  heap.Free(b);
+  heap.Free(a);
+  heap.Free(c);
+  TLSFHeapStats stats = heap.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numAllocs == 0);
+  TINKER_TEST_ASSERT(stats.m_allocated == 0);
+  TINKER_TEST_ASSERT(stats.m_highWaterMark >= 600);
+
+  void* big = heap.Alloc(1024 * 60);
+  TINKER_TEST_ASSERT(big == a);
+  TINKER_TEST_ASSERT(heap.GetStats().m_numPools == 1);
+  heap.Free(big);
+
+  heap.Free(nullptr);
+  heap.Shutdown();
+  TINKER_TEST_ASSERT(!heap.IsInitted());
+}
+
+void Test_TLSF_Alignment()
+{
+  TLSFHeap heap;
+  heap.Init(1024 * 256, 1024 * 256, false);
+
+  const size_t alignments[] = { 1, 8, 16, 32, 64, 256, 4096 };
+  std::vector<void*> ptrs;
+  for (uint32 i = 0; i < 64; ++i)
+  {
+    for (size_t alignment : alignments)
+    {
+      const size_t size = 1 + (i * 37) % 500;
+      uint8* ptr = (uint8*)heap.AllocAligned(size, alignment);
+      TINKER_TEST_ASSERT(ptr);
+      TINKER_TEST_ASSERT(((size_t)ptr & (Max(alignment, (size_t)16) - 1)) == 0);
+      TINKER_TEST_ASSERT(TLSFHeap::UsableSize(ptr) >= size);
+      memset(ptr, 0xAB, size);
+      ptrs.push_back(ptr);
+    }
+  }
+  for (void* ptr : ptrs)
+  {
+    heap.Free(ptr);
+  }
+  TINKER_TEST_ASSERT(heap.GetStats().m_numAllocs == 0);
+  heap.Shutdown();
+}
+
+void Test_TLSF_GrowsPastFirstPool()
+{
+  TLSFHeap heap;
+  heap.Init(1024 * 16, 1024 * 16, false);
+
+  std::vector<uint8*> ptrs;
+  for (uint32 i = 0; i < 256; ++i)
+  {
+    uint8* ptr = (uint8*)heap.Alloc(1024);
+    TINKER_TEST_ASSERT(ptr);
+    memset(ptr, (int)i, 1024);
+    ptrs.push_back(ptr);
+  }
+
+  // Bigger than the grow size, gets its own pool
+  uint8* huge = (uint8*)heap.Alloc(1024 * 1024);
+  TINKER_TEST_ASSERT(huge);
+  memset(huge, 0xFF, 1024 * 1024);
+
+  TLSFHeapStats stats = heap.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numPools > 2);
+  TINKER_TEST_ASSERT(stats.m_reserved >= 256 * 1024 + 1024 * 1024);
+  TINKER_TEST_ASSERT(stats.m_numAllocs == 257);
+
+  for (uint32 i = 0; i < 256; ++i)
+  {
+    for (uint32 j = 0; j < 1024; ++j)
+    {
+      TINKER_TEST_ASSERT(ptrs[i][j] == (uint8)i);
+    }
+    heap.Free(ptrs[i]);
+  }
+  heap.Free(huge);
+  TINKER_TEST_ASSERT(heap.GetStats().m_allocated == 0);
+  heap.Shutdown();
+}
+
+// Fills every allocation with a pattern derived from its slot and checks nothing got
+// overwritten by the heap's bookkeeping or another allocation
+void Test_TLSF_RandomChurn()
+{
+  TLSFHeap heap;
+  heap.Init(1024 * 64, 1024 * 64, false);
+
+  struct LiveAlloc
+  {
+    uint8* m_ptr;
+    size_t m_size;
+    uint8 m_pattern;
+  };
+  std::vector<LiveAlloc> live;
+  size_t liveBytes = 0;
+
+  std::mt19937 rng(1234);
+  for (uint32 op = 0; op < 100'000; ++op)
+  {
+    if (live.empty() || (live.size() < 2000 && (rng() & 1)))
+    {
+      // Mostly small, some large
+      const size_t size = (rng() & 15) ? 1 + rng() % 256 : 1 + rng() % (1024 * 32);
+      const size_t alignment = (rng() & 7) ? 1 : (size_t)16 << (rng() % 6);
+      uint8* ptr = (uint8*)heap.AllocAligned(size, alignment);
+      TINKER_TEST_ASSERT(ptr);
+      TINKER_TEST_ASSERT(((size_t)ptr & (alignment - 1)) == 0);
+      const uint8 pattern = (uint8)op;
+      memset(ptr, pattern, size);
+      live.push_back({ ptr, size, pattern });
+      liveBytes += size;
+    }
+    else
+    {
+      const uint32 i = rng() % (uint32)live.size();
+      const LiveAlloc alloc = live[i];
+      for (size_t j = 0; j < alloc.m_size; ++j)
+      {
+        TINKER_TEST_ASSERT(alloc.m_ptr[j] == alloc.m_pattern);
+      }
+      live[i] = live.back();
+      live.pop_back();
+      liveBytes -= alloc.m_size;
+      heap.Free(alloc.m_ptr);
+    }
+  }
+
+  TLSFHeapStats stats = heap.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numAllocs == live.size());
+  TINKER_TEST_ASSERT(stats.m_allocated >= liveBytes);
+  for (const LiveAlloc& alloc : live)
+  {
+    heap.Free(alloc.m_ptr);
+  }
+  TINKER_TEST_ASSERT(heap.GetStats().m_allocated == 0);
+  heap.Shutdown();
+}
+
+void Test_TLSF_MultiThreaded()
+{
+  const uint32 numThreads = 8;
+  const uint32 numAllocsPerThread = 1000;
+  const uint32 numIters = 20;
+
+  TLSFHeap heap;
+  heap.Init(1024 * 64, 1024 * 64, true);
+
+  std::vector<uint32> numFailures(numThreads, 0);
+  std::vector<std::thread> threads;
+  for (uint32 t = 0; t < numThreads; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      std::vector<uint32*> ptrs(numAllocsPerThread);
+      for (uint32 iter = 0; iter < numIters; ++iter)
+      {
+        for (uint32 i = 0; i < numAllocsPerThread; ++i)
+        {
+          ptrs[i] = (uint32*)heap.Alloc(sizeof(uint32) * (1 + i % 16));
+          *ptrs[i] = (t << 16) | i;
+        }
+        for (uint32 i = 0; i < numAllocsPerThread; ++i)
+        {
+          if (*ptrs[i] != ((t << 16) | i))
+          {
+            ++numFailures[t];
+          }
+          heap.Free(ptrs[i]);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (uint32 t = 0; t < numThreads; ++t)
+  {
+    TINKER_TEST_ASSERT(numFailures[t] == 0);
+  }
+  TLSFHeapStats stats = heap.GetStats();
+  TINKER_TEST_ASSERT(stats.m_numAllocs == 0);
+  TINKER_TEST_ASSERT(stats.m_allocated == 0);
+  heap.Shutdown();
+}
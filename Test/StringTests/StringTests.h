@@ -0,0 +1,192 @@
+#include "StringTable.h"
+#include "StringTypes.h"
+#include "TinkerTest.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace Tk;
+using namespace Core;
+
+void Test_StrBuilder_Append()
+{
+  char buffer[64];
+  memset(buffer, 'x', sizeof(buffer)); // Builder must not rely on zeroed memory
+  StrBuilder str(buffer, ARRAYCOUNT(buffer));
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "") == 0);
+
+  str.Append("Mesh_").Append("abc", 2).AppendChar('.').Append("ckMsh");
+  TINKER_TEST_ASSERT(str.Len() == 13);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "Mesh_ab.ckMsh") == 0);
+
+  str.Truncate(4);
+  str.NullTerminate();
+  TINKER_TEST_ASSERT(strcmp(buffer, "Mesh") == 0);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "Mesh") == 0);
+  str.Clear();
+  TINKER_TEST_ASSERT(str.Len() == 0);
+  TINKER_TEST_ASSERT(str.LenRemaining() == ARRAYCOUNT(buffer) - 1);
+}
+
+void Test_StrBuilder_Integers()
+{
+  char buffer[64];
+  char expected[64];
+  StrBuilder str(buffer, ARRAYCOUNT(buffer));
+
+  const uint64 values[] = { 0, 1, 9, 10, 99, 100, 101, 12345, 1'000'000, 4'294'967'295,
+                            18'446'744'073'709'551'615ull };
+  for (uint32 i = 0; i < ARRAYCOUNT(values); ++i)
+  {
+    str.Clear();
+    str.AppendU64(values[i]);
+    snprintf(expected, sizeof(expected), "%llu", (unsigned long long)values[i]);
+    TINKER_TEST_ASSERT(strcmp(str.CStr(), expected) == 0);
+  }
+
+  const int64 signedValues[] = { 0, -1, 7, -10, -12345, 9'223'372'036'854'775'807ll,
+                                 -9'223'372'036'854'775'807ll - 1 };
+  for (uint32 i = 0; i < ARRAYCOUNT(signedValues); ++i)
+  {
+    str.Clear();
+    str.AppendI64(signedValues[i]);
+    snprintf(expected, sizeof(expected), "%lld", (long long)signedValues[i]);
+    TINKER_TEST_ASSERT(strcmp(str.CStr(), expected) == 0);
+  }
+}
+
+void Test_StrBuilder_Floats()
+{
+  char buffer[64];
+  char expected[64];
+  StrBuilder str(buffer, ARRAYCOUNT(buffer));
+
+  // Exact in binary, so several of these land exactly halfway when rounded
+  const double values[] = { 0.0, 1.0, -1.0, 0.5, 0.25, 0.125, 2.0625, -3.75, 100.03125,
+                            65536.5, 0.0078125 };
+  for (uint32 i = 0; i < ARRAYCOUNT(values); ++i)
+  {
+    for (uint32 decimals = 0; decimals <= 6; ++decimals)
+    {
+      str.Clear();
+      str.AppendFloat(values[i], decimals);
+      snprintf(expected, sizeof(expected), "%.*f", (int)decimals, values[i]);
+      TINKER_TEST_ASSERT(strcmp(str.CStr(), expected) == 0);
+    }
+  }
+
+  str.Clear();
+  str.AppendFloat(0.999, 2);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "1.00") == 0);
+  str.Clear();
+  str.AppendFloat(12.3456f, 2);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "12.35") == 0);
+  str.Clear();
+  str.AppendFloat(1.5e25, 2);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "1.50e+25") == 0);
+  str.Clear();
+  str.AppendFloat(DBL_MAX, 2);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "1.80e+308") == 0);
+  // The mantissa rounds up to 10, which moves into the exponent
+  str.Clear();
+  str.AppendFloat(9.999e25, 2);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "1.00e+26") == 0);
+  str.Clear();
+  str.AppendFloat(-9.9999e29, 3);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "-1.000e+30") == 0);
+
+  str.Clear();
+  str.AppendFloat(INFINITY, 2);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "inf") == 0);
+  str.Clear();
+  str.AppendFloat(-INFINITY, 2);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "-inf") == 0);
+  str.Clear();
+  str.AppendFloat(NAN, 2);
+  TINKER_TEST_ASSERT(strcmp(str.CStr(), "nan") == 0);
+}
+
+void Test_StrBuilder_LinearAllocator()
+{
+  LinearAllocator allocator;
+  allocator.Init(256, 1);
+
+  StrBuilder a(&allocator, 64);
+  StrBuilder b(&allocator, 64);
+  a.Append("first");
+  b.Append("second");
+  TINKER_TEST_ASSERT(strcmp(a.CStr(), "first") == 0);
+  TINKER_TEST_ASSERT(strcmp(b.CStr(), "second") == 0);
+  TINKER_TEST_ASSERT(allocator.Size() == 128);
+}
+
+void Test_StringTable_Intern()
+{
+  StringTable table;
+  table.Init(1024);
+
+  const uint32 sphere = table.Intern("UnitSphere");
+  const uint32 cube = table.Intern("UnitCube");
+  TINKER_TEST_ASSERT(sphere != StringTable::eInvalidID);
+  TINKER_TEST_ASSERT(cube != StringTable::eInvalidID);
+  TINKER_TEST_ASSERT(sphere != cube);
+  TINKER_TEST_ASSERT(table.NumStrings() == 2);
+
+  // Same string from different memory gives the same ID and doesn't take up more space
+  char copy[32];
+  strcpy(copy, "UnitSphere");
+  TINKER_TEST_ASSERT(table.Intern(copy) == sphere);
+  TINKER_TEST_ASSERT(table.NumStrings() == 2);
+
+  TINKER_TEST_ASSERT(strcmp(table.Str(sphere), "UnitSphere") == 0);
+  TINKER_TEST_ASSERT(table.Len(cube) == 8);
+
+  // Not null terminated input
+  const uint32 unit = table.Intern("UnitCube", 4);
+  TINKER_TEST_ASSERT(strcmp(table.Str(unit), "Unit") == 0);
+
+  const uint32 empty = table.Intern("", 0);
+  TINKER_TEST_ASSERT(empty != StringTable::eInvalidID);
+  TINKER_TEST_ASSERT(table.Len(empty) == 0);
+  TINKER_TEST_ASSERT(strcmp(table.Str(empty), "") == 0);
+}
+
+void Test_StringTable_Find()
+{
+  StringTable table;
+  table.Init(1024);
+
+  const uint32 sphere = table.Intern("UnitSphere");
+  TINKER_TEST_ASSERT(table.Find("UnitSphere") == sphere);
+  TINKER_TEST_ASSERT(table.Find("UnitCube") == StringTable::eInvalidID);
+
+  // Hashes match the compile time hash of the same string
+  TINKER_TEST_ASSERT(table.GetHash(sphere) == HASH_64("UnitSphere"));
+  TINKER_TEST_ASSERT(table.FindByHash(HASH_64("UnitSphere")) == sphere);
+  TINKER_TEST_ASSERT(table.FindByHash(HASH_64("UnitCube")) == StringTable::eInvalidID);
+}
+
+void Test_StringTable_Many()
+{
+  StringTable table;
+  table.Init(1024 * 64);
+
+  char buffer[32];
+  for (uint32 i = 0; i < 2000; ++i)
+  {
+    StrBuilder name(buffer, ARRAYCOUNT(buffer));
+    name.Append("Asset_").AppendU64(i);
+    TINKER_TEST_ASSERT(table.Intern(name.Data(), name.Len()) == i);
+  }
+  TINKER_TEST_ASSERT(table.NumStrings() == 2000);
+
+  // Earlier strings stay put as the table grows
+  for (uint32 i = 0; i < 2000; ++i)
+  {
+    StrBuilder name(buffer, ARRAYCOUNT(buffer));
+    name.Append("Asset_").AppendU64(i);
+    TINKER_TEST_ASSERT(strcmp(table.Str(i), name.CStr()) == 0);
+    TINKER_TEST_ASSERT(table.Find(name.Data(), name.Len()) == i);
+  }
+}
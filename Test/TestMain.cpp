@@ -1,9 +1,25 @@
+#include "AlgorithmTests/HashingTests.h"
 #include "AlgorithmTests/SortingTests.h"
+#include "DataStructureTests/ConcurrentHashMapTests.h"
+#include "DataStructureTests/HandlePoolTests.h"
 #include "DataStructureTests/HashMapTests.h"
+#include "DataStructureTests/MPMCQueueTests.h"
 #include "DataStructureTests/RingBufferTests.h"
+#include "DataStructureTests/SlotAllocatorTests.h"
+#include "DataStructureTests/SoAVectorTests.h"
 #include "DataStructureTests/VectorTests.h"
+#include "DataStructureTests/WorkStealingDequeTests.h"
+#include "JobSystemTests/JobAllocationTests.h"
+#include "JobSystemTests/JobCounterTests.h"
+#include "JobSystemTests/JobProfilerTests.h"
+#include "JobSystemTests/ParallelForTests.h"
+#include "JobSystemTests/ThreadPoolTests.h"
 #include "MathTests/VectorTypeTests.h"
+#include "MemoryTests/AllocatorRegistryTests.h"
 #include "MemoryTests/AllocatorTests.h"
+#include "MemoryTests/MemProfilerTests.h"
+#include "MemoryTests/TLSFHeapTests.h"
+#include "StringTests/StringTests.h"
 #include "TinkerTest.h"
 
 uint8 g_AssertFailedFlag = 0;
@@ -60,6 +76,17 @@ int main()
   TINKER_TEST("Ring Buffer Enqueue Many Dequeue Many",
               Test_RingBufferEnqueueManyDequeueMany);
 
+  TINKER_TEST_PRINT_NAME("Work Stealing Deque");
+  TINKER_TEST("Work Stealing Deque Owner LIFO", Test_WorkStealingDeque_OwnerLIFO);
+  TINKER_TEST("Work Stealing Deque Steal FIFO", Test_WorkStealingDeque_StealFIFO);
+  TINKER_TEST("Work Stealing Deque Concurrent Steal",
+              Test_WorkStealingDeque_ConcurrentSteal);
+
+  TINKER_TEST_PRINT_NAME("MPMC Queue");
+  TINKER_TEST("MPMC Queue Full And Empty", Test_MPMCQueue_FullAndEmpty);
+  TINKER_TEST("MPMC Queue Batch", Test_MPMCQueue_Batch);
+  TINKER_TEST("MPMC Queue Concurrent", Test_MPMCQueue_Concurrent);
+
   TINKER_TEST_PRINT_NAME("Memory Allocators");
   TINKER_TEST("Linear, 1K 1-byte size, 1-aligned allocs, no allocator alignment",
               Test_Linear_NoAlignment);
@@ -68,6 +95,51 @@ int main()
   TINKER_TEST(
     "Linear, 1K 1-byte size, 1-aligned allocs, no allocator alignment, w/ dealloc",
     Test_Linear_NoAlignment_WithDealloc);
+  TINKER_TEST("Linear, marker rewind", Test_Linear_MarkerRewind);
+  TINKER_TEST("Linear, reserved, commits on growth",
+              Test_Linear_Reserved_CommitsOnGrowth);
+  TINKER_TEST("Linear, reserved, full capacity", Test_Linear_Reserved_FullCapacity);
+  TINKER_TEST("Linear, reserved, decommit unused", Test_Linear_Reserved_DecommitUnused);
+  TINKER_TEST("Chained linear, grows across blocks", Test_Chained_GrowsAcrossBlocks);
+  TINKER_TEST("Chained linear, rewind reuses blocks", Test_Chained_RewindReusesBlocks);
+  TINKER_TEST("Frame arena, double buffered", Test_FrameArena_DoubleBuffered);
+  TINKER_TEST("Pool, grows past first page", Test_Pool_GrowsPastFirstPage);
+  TINKER_TEST("Pool, 64-aligned elements", Test_Pool_Alignment);
+  TINKER_TEST("Pool, multithreaded alloc/dealloc", Test_Pool_MultiThreaded);
+  TINKER_TEST("Pool, thread exit returns its cache", Test_Pool_ThreadExit);
+  TINKER_TEST("Thread scratch, one arena per thread", Test_ThreadScratch_PerThread);
+  TINKER_TEST("Thread scratch, rewound after job", Test_ThreadScratch_RewoundAfterJob);
+  TINKER_TEST("TLSF, alloc/free merges neighbours", Test_TLSF_AllocFreeMerge);
+  TINKER_TEST("TLSF, aligned allocs", Test_TLSF_Alignment);
+  TINKER_TEST("TLSF, grows past first pool", Test_TLSF_GrowsPastFirstPool);
+  TINKER_TEST("TLSF, random churn", Test_TLSF_RandomChurn);
+  TINKER_TEST("TLSF, multithreaded alloc/free", Test_TLSF_MultiThreaded);
+  TINKER_TEST("Allocator registry, stats", Test_AllocatorRegistry_Stats);
+  TINKER_TEST("Allocator registry, JSON", Test_AllocatorRegistry_JSON);
+  TINKER_TEST("Allocator registry, stats of arenas in use",
+              Test_AllocatorRegistry_StatsWhileInUse);
+  TINKER_TEST("Mem profiler, sample every alloc", Test_MemProfiler_SampleEverything);
+  TINKER_TEST("Mem profiler, sample rate", Test_MemProfiler_SampleRate);
+  TINKER_TEST("Mem profiler, folded stacks output", Test_MemProfiler_FoldedOutput);
+  TINKER_TEST("Mem profiler, multithreaded", Test_MemProfiler_MultiThreaded);
+
+  TINKER_TEST_PRINT_NAME("Job System");
+  TINKER_TEST("Job counter, wait for all", Test_JobCounter_WaitForAll);
+  TINKER_TEST("Job counter, dependency chain", Test_JobCounter_DependencyChain);
+  TINKER_TEST("Job counter, wait inside job", Test_JobCounter_WaitInsideJob);
+  TINKER_TEST("Parallel for, every index once", Test_ParallelFor_EveryIndexOnce);
+  TINKER_TEST("Parallel reduce, chunks reduced in order", Test_ParallelReduce_InOrder);
+  TINKER_TEST("Thread pool, pinned workers", Test_ThreadPool_PinnedWorkers);
+  TINKER_TEST("Thread pool, assisted job list", Test_ThreadPool_AssistedJobList);
+  TINKER_TEST("Thread pool, priority order", Test_ThreadPool_PriorityOrder);
+  TINKER_TEST("Thread pool, background workers", Test_ThreadPool_BackgroundWorkers);
+  TINKER_TEST("Thread pool, restarts return job pool caches", Test_ThreadPool_Restart);
+  TINKER_TEST("Jobs, inline capture storage", Test_Jobs_InlineStorage);
+  TINKER_TEST("Jobs, no heap allocations once warm", Test_Jobs_NoHeapOnceWarm);
+  TINKER_TEST("Jobs, lists past the inline capacity", Test_Jobs_UnboundedList);
+  TINKER_TEST("Job profiler, off records nothing", Test_JobProfiler_OffRecordsNothing);
+  TINKER_TEST("Job profiler, trace of a job list", Test_JobProfiler_Trace);
+  TINKER_TEST("Job profiler, ring keeps the newest events", Test_JobProfiler_RingWraps);
 
   TINKER_TEST_PRINT_NAME("Vector");
   TINKER_TEST("Vector Constructor Default", Test_VectorConstructorDefault);
@@ -83,12 +155,76 @@ int main()
   TINKER_TEST("Vector Resize Up From Non Empty", Test_VectorResizeUpFromNonEmpty);
   TINKER_TEST("Vector Resize Down From Non Empty to Smaller",
               Test_VectorResizeDownFromNonEmptyToSmaller);
+  TINKER_TEST("Vector Push Back Geometric Growth", Test_VectorPushBackGeometricGrowth);
+  TINKER_TEST("Vector Append N", Test_VectorAppendN);
+  TINKER_TEST("Vector Swap Remove", Test_VectorSwapRemove);
+  TINKER_TEST("Vector Emplace Non-POD", Test_VectorEmplaceNonPOD);
+  TINKER_TEST("Vector Push Back Self Reference", Test_VectorPushBackSelfReference);
+  TINKER_TEST("Vector With Linear Allocator", Test_VectorWithLinearAllocator);
 
   TINKER_TEST_PRINT_NAME("Sorting");
   TINKER_TEST("MergeSort Integers", Test_SortingIntegers);
+  TINKER_TEST("RadixSort Integers", Test_RadixSortIntegers);
+  TINKER_TEST("RadixSort Skips Uniform Bytes", Test_RadixSortSkipsUniformBytes);
+  TINKER_TEST("RadixSort Pairs Stable", Test_RadixSortPairsStable);
+  TINKER_TEST("RadixSort Parallel Matches Serial", Test_RadixSortParallelMatchesSerial);
+  TINKER_TEST("IntroSort Patterns", Test_IntroSortPatterns);
+  TINKER_TEST("ParallelSort Matches std::sort", Test_ParallelSortMatchesStdSort);
+  TINKER_TEST("ParallelSort Arena Too Small", Test_ParallelSortArenaTooSmall);
+
+  TINKER_TEST_PRINT_NAME("Hashing");
+  TINKER_TEST("Hashing Compile Time Matches Runtime",
+              Test_Hashing_CompileTimeMatchesRuntime);
+  TINKER_TEST("Hashing String Literal Matches Runtime",
+              Test_Hashing_StringLiteralMatchesRuntime);
+  TINKER_TEST("Hashing Streaming Matches One Shot", Test_Hashing_StreamingMatchesOneShot);
+  TINKER_TEST("Hashing Seed", Test_Hashing_Seed);
 
   TINKER_TEST_PRINT_NAME("HashMap");
   TINKER_TEST("HashMap Basic U32", Test_HashMap_Basic_U32);
   TINKER_TEST("HashMap Basic U64", Test_HashMap_Basic_U64);
   TINKER_TEST("HashMap Invalid key", Test_HashMap_InvalidKey);
+  TINKER_TEST("HashMap Grow From Empty", Test_HashMap_GrowFromEmpty);
+  TINKER_TEST("HashMap Remove Keeps Probe Chain", Test_HashMap_RemoveKeepsProbeChain);
+  TINKER_TEST("HashMap Erase Heavy Churn", Test_HashMap_EraseHeavyChurn);
+
+  TINKER_TEST_PRINT_NAME("Concurrent HashMap");
+  TINKER_TEST("Concurrent HashMap Basic", Test_ConcurrentHashMap_Basic);
+  TINKER_TEST("Concurrent HashMap Remove And Reinsert",
+              Test_ConcurrentHashMap_RemoveAndReinsert);
+  TINKER_TEST("Concurrent HashMap Epoch Defers Free",
+              Test_ConcurrentHashMap_EpochDefersFree);
+  TINKER_TEST("Concurrent HashMap More Readers Than Records",
+              Test_ConcurrentHashMap_MoreReadersThanRecords);
+  TINKER_TEST("Concurrent HashMap Readers During Writes",
+              Test_ConcurrentHashMap_ReadersDuringWrites);
+
+  TINKER_TEST_PRINT_NAME("Handle Pool");
+  TINKER_TEST("Handle Pool Basic", Test_HandlePool_Basic);
+  TINKER_TEST("Handle Pool Stale Handles", Test_HandlePool_StaleHandles);
+  TINKER_TEST("Handle Pool Non Trivial", Test_HandlePool_NonTrivial);
+  TINKER_TEST("Handle Pool Random Churn", Test_HandlePool_RandomChurn);
+
+  TINKER_TEST_PRINT_NAME("SoA Vector");
+  TINKER_TEST("SoA Vector Basic", Test_SoAVector_Basic);
+  TINKER_TEST("SoA Vector Columns Aligned", Test_SoAVector_ColumnsAligned);
+  TINKER_TEST("SoA Vector Resize Zeroes", Test_SoAVector_ResizeZeroes);
+  TINKER_TEST("SoA Vector Swap Remove", Test_SoAVector_SwapRemove);
+  TINKER_TEST("SoA Vector Push Back Self Reference",
+              Test_SoAVector_PushBackSelfReference);
+
+  TINKER_TEST_PRINT_NAME("Slot Allocator");
+  TINKER_TEST("Slot Allocator Lowest Free", Test_SlotAllocator_LowestFree);
+  TINKER_TEST("Slot Allocator Word Boundaries", Test_SlotAllocator_WordBoundaries);
+  TINKER_TEST("Mirrored Slot Table Dirty Tracking", Test_MirroredSlotTable_DirtyTracking);
+  TINKER_TEST("Mirrored Slot Table Deferred Free", Test_MirroredSlotTable_DeferredFree);
+
+  TINKER_TEST_PRINT_NAME("Strings");
+  TINKER_TEST("StrBuilder Append", Test_StrBuilder_Append);
+  TINKER_TEST("StrBuilder Integers", Test_StrBuilder_Integers);
+  TINKER_TEST("StrBuilder Floats", Test_StrBuilder_Floats);
+  TINKER_TEST("StrBuilder Linear Allocator", Test_StrBuilder_LinearAllocator);
+  TINKER_TEST("StringTable Intern", Test_StringTable_Intern);
+  TINKER_TEST("StringTable Find", Test_StringTable_Find);
+  TINKER_TEST("StringTable Many", Test_StringTable_Many);
 }
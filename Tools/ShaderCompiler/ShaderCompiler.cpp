@@ -79,10 +79,7 @@ namespace Tk
     static void AppendArgs_(const wchar_t** argsToAppend, uint32 numArgsToAppend,
                             Tk::Core::Vector<const wchar_t*>& argsOut)
     {
-      for (uint32 i = 0; i < numArgsToAppend; ++i)
-      {
-        argsOut.PushBackRaw(argsToAppend[i]);
-      }
+      argsOut.AppendN(argsToAppend, numArgsToAppend);
     }
 
 #define AppendArgsToList(args, argsList) AppendArgs_(args, ARRAYCOUNT(args), argsList);
@@ -141,10 +138,9 @@ namespace Tk
       {
         // For now, just write out the spv file
         static const uint32 filepathMax = 2048;
-        Tk::Core::StrFixedBuffer<2048> shaderFilepathSpv;
-        shaderFilepathSpv.Clear();
+        char shaderFilepathSpvBuffer[filepathMax];
+        Tk::Core::StrBuilder shaderFilepathSpv(shaderFilepathSpvBuffer, filepathMax);
         shaderFilepathSpv.Append(SHADERS_SPV_DIR);
-        char* shaderFilenameSpvStart = shaderFilepathSpv.EndOfStrPtr();
 
         // Remove .hlsl ext, replace with .spv
         static const char* hlslExt = "hlsl";
@@ -155,18 +151,18 @@ namespace Tk
 
         // Complete string with .spv extension and null terminator
         shaderFilepathSpv.Append("spv");
-        shaderFilepathSpv.NullTerminate();
+        const char* shaderFilepathSpvStr = shaderFilepathSpv.CStr();
         uint32 fileErr = Tk::Platform::WriteEntireFile(
-          shaderFilepathSpv.m_data, (uint32)pShader->GetBufferSize(),
+          shaderFilepathSpvStr, (uint32)pShader->GetBufferSize(),
           (uint8*)pShader->GetBufferPointer());
         if (!fileErr)
         {
-          printf("Wrote: %s\n", shaderFilepathSpv.m_data);
+          printf("Wrote: %s\n", shaderFilepathSpvStr);
         }
         else
         {
           errCode = ErrCode::NonShaderError;
-          printf("Error writing spv file: %s\n", shaderFilepathSpv.m_data);
+          printf("Error writing spv file: %s\n", shaderFilepathSpvStr);
         }
       }
 